@@ -37,15 +37,61 @@
 #define ANTLRFileStream_H
 
 #include <antlr/Definitions.h>
+#include <antlr/ANTLRInputStream.h>
+#include <string>
 
 
 namespace antlr4 {
 
-class ANTLR_API ANTLRFileStream
+/**
+ * This is an {@link ANTLRInputStream} that is loaded from a file all at once
+ * when you construct the object.
+ * <p/>
+ * Where the platform supports it, the file is memory-mapped read-only
+ * instead of being read into a buffer, so opening a stream costs the same
+ * for any file size. Only the pages the lexer actually touches become
+ * resident. The file must be UTF-8 encoded and must not be modified while
+ * the stream is open.
+ */
+class ANTLR_API ANTLRFileStream : public ANTLRInputStream
 {
 public:
-    
-    
+
+    /** Opens and maps {@code fileName}.
+     *
+     *  @throws std::runtime_error if the file can't be opened or mapped
+     */
+    ANTLRFileStream(const std::string& fileName);
+
+    ANTLR_OVERRIDE
+    ~ANTLRFileStream();
+
+    ANTLR_OVERRIDE
+    std::string getSourceName();
+
+protected:
+
+    void load(const std::string& fileName);
+
+    void unload();
+
+private:
+
+    ANTLRFileStream(const ANTLRFileStream&);
+
+    ANTLRFileStream& operator=(const ANTLRFileStream&);
+
+protected:
+
+    std::string fileName;
+
+    /** Start of the mapped view of the file, or NULL if the file is empty
+     *  or was read into {@link #buffer}.
+     */
+    ANTLR_NULLABLE
+    void* mapping;
+
+    size_t mappingSize;
 };
 
 } /* namespace antlr4 */
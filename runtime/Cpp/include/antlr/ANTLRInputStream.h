@@ -37,15 +37,166 @@
 #define ANTLRInputStream_H
 
 #include <antlr/Definitions.h>
+#include <antlr/CharStream.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
 
 
 namespace antlr4 {
 
-class ANTLR_API ANTLRInputStream
+/**
+ * A {@link CharStream} over UTF-8 encoded text held in memory. The symbols
+ * of the stream are Unicode code points and {@link #index} counts code
+ * points, not bytes.
+ * <p/>
+ * The text is never expanded into an array of code points. Code points are
+ * decoded from the bytes on the fly as the stream moves forward. To support
+ * {@link #seek} and {@link #LA} with negative offsets, the stream records
+ * the byte offset of every {@link #INDEX_INTERVAL}th code point. This index
+ * is built lazily, only up to the furthest position that was visited, and
+ * it needs one {@code size_t} per {@link #INDEX_INTERVAL} code points.
+ * <p/>
+ * Malformed UTF-8 sequences decode to U+FFFD one byte at a time.
+ */
+class ANTLR_API ANTLRInputStream : public CharStream
 {
 public:
-    
-    
+
+    ANTLRInputStream();
+
+    /** Copy data in string to a local buffer. */
+    ANTLRInputStream(const std::string& input);
+
+    /** Read {@code numberOfBytes} bytes of UTF-8 from {@code data} without
+     *  copying them. {@code data} must outlive this stream.
+     */
+    ANTLRInputStream(ANTLR_NULLABLE const char* data, size_t numberOfBytes);
+
+    ANTLR_OVERRIDE
+    ~ANTLRInputStream();
+
+    /** Reset the stream so that it's in the same state it was
+     *  when the object was created *except* the data array is not
+     *  touched.
+     */
+    void reset();
+
+    ANTLR_OVERRIDE
+    void consume();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t LA(antlr_int32_t i);
+
+    antlr_int32_t LT(antlr_int32_t i);
+
+    /** Return the current input symbol index 0..n where n indicates the
+     *  last symbol has been read.  The index is the index of char to
+     *  be returned from LA(1).
+     */
+    ANTLR_OVERRIDE
+    antlr_int32_t index();
+
+    /** Returns the number of code points in the stream. The first call
+     *  decodes the rest of the input.
+     */
+    ANTLR_OVERRIDE
+    antlr_int32_t size();
+
+    /** mark/release do nothing; we have entire buffer */
+    ANTLR_OVERRIDE
+    antlr_int32_t mark();
+
+    ANTLR_OVERRIDE
+    void release(antlr_int32_t marker);
+
+    /** Move to code point {@code index}, or to EOF if {@code index} lies past
+     *  the end of the input. Short moves walk the bytes from the current
+     *  position; longer ones start from the nearest entry of the offset index.
+     */
+    ANTLR_OVERRIDE
+    void seek(antlr_int32_t index);
+
+    ANTLR_OVERRIDE
+    std::string getText(const Interval& interval);
+
+    /** Points into the UTF-8 data this stream was created from. Only
+     *  decodes the input up to {@code interval.b}.
+     */
+    ANTLR_OVERRIDE
+    TextView getTextView(const Interval& interval);
+
+    ANTLR_OVERRIDE
+    std::string getSourceName();
+
+    ANTLR_OVERRIDE
+    std::string toString() const;
+
+    /** Decodes the UTF-8 sequence at the start of the {@code available}
+     *  bytes at {@code bytes} and stores the length of its encoding in
+     *  {@code length}. A malformed or truncated sequence decodes to U+FFFD
+     *  with a length of 1.
+     */
+    static antlr_int32_t decode(const char* bytes, size_t available, size_t& length);
+
+protected:
+
+    /** Points {@link #data} at {@code numberOfBytes} bytes of UTF-8. */
+    void load(ANTLR_NULLABLE const char* data, size_t numberOfBytes);
+
+    /** Returns the byte offset of code point {@code index}, which must not
+     *  lie past the end of the input, extending the offset index as needed.
+     */
+    size_t offsetOf(antlr_int32_t index);
+
+    /** Decodes the code point starting at byte {@code offset} and stores
+     *  the length of its encoding in {@code length}.
+     */
+    antlr_int32_t decode(size_t offset, size_t& length) const;
+
+private:
+
+    ANTLRInputStream(const ANTLRInputStream&);
+
+    ANTLRInputStream& operator=(const ANTLRInputStream&);
+
+public:
+
+    /** What is name or source of this char stream? */
+    std::string name;
+
+    /** Number of code points between two entries of the offset index. */
+    static const antlr_int32_t INDEX_INTERVAL;
+
+protected:
+
+    /** The UTF-8 data being scanned */
+    ANTLR_NULLABLE
+    const char* data;
+
+    /** How many bytes are actually in the buffer */
+    size_t numBytes;
+
+    /** 0..n-1 index into the code points of the stream; the code point at
+     *  {@code p} is LA(1)
+     */
+    antlr_int32_t p;
+
+    /** Byte offset of the code point at {@link #p} */
+    size_t offset;
+
+    /** How many code points are in the stream; -1 until the end of the
+     *  input has been decoded
+     */
+    antlr_int32_t n;
+
+    /** {@code checkpoints[k]} is the byte offset of code point
+     *  {@code k * INDEX_INTERVAL}
+     */
+    std::vector<size_t> checkpoints;
+
+    /** Holds the data when it was copied into this stream */
+    std::string buffer;
 };
 
 } /* namespace antlr4 */
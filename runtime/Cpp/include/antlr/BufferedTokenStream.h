@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,254 @@
  * Gael Hatchue
  */
 
+
 #ifndef BufferedTokenStream_H
 #define BufferedTokenStream_H
 
 #include <antlr/Definitions.h>
+#include <antlr/CommonToken.h>
+#include <antlr/TokenStream.h>
+#include <memory>
+#include <string>
+#include <vector>
 
 
 namespace antlr4 {
 
-class ANTLR_API BufferedTokenStream
+class Token;
+class TokenSource;
+
+/** Buffer all input tokens but do on-demand fetching of new tokens from lexer.
+ *  Useful when the parser or lexer has to set context/mode info before proper
+ *  lexing of future tokens. The ST template parser needs this, for example,
+ *  because it has to constantly flip back and forth between inside/output
+ *  templates. E.g., {@code <names:{hi, <it>}>} has to parse names as part
+ *  of an expression but {@code "hi, <it>"} as a nested template.
+ * <p/>
+ *  You can't use this stream if you pass whitespace or other off-channel
+ *  tokens to the parser. The stream can't ignore off-channel tokens.
+ *  ({@link UnbufferedTokenStream} is the same way.) Use
+ *  {@link CommonTokenStream}.
+ * <p/>
+ *  The buffer does not keep a {@link Token} object per token. The type of
+ *  every token is kept in one contiguous array so that {@link #LA} is a
+ *  single load, and the channel, start/stop indexes, line and column are
+ *  kept in parallel arrays allocated {@link #CHUNK_SIZE} tokens at a time,
+ *  so growing the buffer never moves them. {@link #get} and {@link #LT}
+ *  materialize a {@link CommonToken} from those arrays the first time a
+ *  token is asked for. Tokens that cannot be rebuilt from the arrays, such
+ *  as tokens with text set by a lexer action or tokens of another class,
+ *  are kept as they came from the token source.
+ * <p/>
+ *  Tokens are pulled with {@link TokenSource#nextTokens} in batches of up
+ *  to {@link #BATCH_SIZE} when the source supports it. Fetching stays on
+ *  demand, so a batch is only as large as the tokens the stream needs;
+ *  {@link #fill} asks for full batches.
+ */
+class ANTLR_API BufferedTokenStream : public TokenStream
 {
 public:
-    
-    
+
+    explicit BufferedTokenStream(ANTLR_NOTNULL TokenSource* tokenSource);
+
+    ANTLR_OVERRIDE
+    ~BufferedTokenStream();
+
+    ANTLR_OVERRIDE
+    TokenSource* getTokenSource();
+
+    /** Reset this token stream by setting its token source. */
+    virtual void setTokenSource(ANTLR_NOTNULL TokenSource* tokenSource);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t index();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t mark();
+
+    ANTLR_OVERRIDE
+    void release(antlr_int32_t marker);
+
+    void reset();
+
+    ANTLR_OVERRIDE
+    void seek(antlr_int32_t index);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t size();
+
+    ANTLR_OVERRIDE
+    void consume();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t LA(antlr_int32_t i);
+
+    ANTLR_OVERRIDE
+    const Token* LT(antlr_int32_t k);
+
+    ANTLR_OVERRIDE
+    const Token* get(antlr_int32_t index);
+
+    ANTLR_OVERRIDE
+    std::string getSourceName();
+
+    ANTLR_OVERRIDE
+    std::string getText(const misc::Interval& interval);
+
+    /** Get the text of all tokens in this buffer. */
+    ANTLR_OVERRIDE
+    std::string getText();
+
+    ANTLR_OVERRIDE
+    std::string getText(ANTLR_NULLABLE const Token* start, ANTLR_NULLABLE const Token* stop);
+
+    /** Get all tokens from lexer until EOF */
+    void fill();
+
+protected:
+
+    /** Make sure index {@code i} in tokens has a token.
+     *
+     * @return {@code true} if a token is located at index {@code i}, otherwise
+     *    {@code false}.
+     * @see #get(int i)
+     */
+    bool sync(antlr_int32_t i);
+
+    /** Add {@code n} elements to buffer.
+     *
+     * @return The actual number of elements added to the buffer.
+     */
+    antlr_int32_t fetch(antlr_int32_t n);
+
+    /** Appends {@code token} to the buffer, taking ownership of it. */
+    void add(antlr_auto_ptr<Token>& token);
+
+    /** Appends a copy of {@code token}, produced by a batch, to the buffer. */
+    void add(const CommonToken& token);
+
+    /** Returns the buffer index of the token {@code LT(k)} refers to, or -1
+     *  if there is no such token.
+     */
+    virtual antlr_int32_t lookaheadIndex(antlr_int32_t k);
+
+    /** Returns the buffer index of the token {@code k} tokens before the
+     *  current one, or -1 if there is no such token.
+     */
+    virtual antlr_int32_t lookbackIndex(antlr_int32_t k);
+
+    /** Allowed derived classes to modify the behavior of operations which change
+     *  the current stream position by adjusting the target token index of a seek
+     *  operation. The default implementation simply returns {@code i}. If an
+     *  exception is thrown in this method, the current stream index should not be
+     *  changed.
+     * <p/>
+     *  For example, {@link CommonTokenStream} overrides this method to ensure that
+     *  the seek target is always an on-channel token.
+     *
+     * @param i The target token index.
+     * @return The adjusted target token index.
+     */
+    virtual antlr_int32_t adjustSeekIndex(antlr_int32_t i);
+
+    void lazyInit();
+
+    void setup();
+
+    /** Given a starting index, return the index of the next token on channel.
+     *  Return i if tokens[i] is on channel. Return the index of the EOF token
+     *  if there are no tokens on channel between i and EOF.
+     */
+    antlr_int32_t nextTokenOnChannel(antlr_int32_t i, antlr_int32_t channel);
+
+    /** Given a starting index, return the index of the previous token on
+     *  channel. Return i if tokens[i] is on channel. Return -1 if there are no
+     *  tokens on channel between i and 0.
+     */
+    antlr_int32_t previousTokenOnChannel(antlr_int32_t i, antlr_int32_t channel);
+
+    /** The channel of the buffered token at {@code index}. */
+    antlr_int32_t getChannel(antlr_int32_t index) const;
+
+private:
+
+    BufferedTokenStream(const BufferedTokenStream&);
+
+    BufferedTokenStream& operator=(const BufferedTokenStream&);
+
+    void clear();
+
+    /** Copies the fields of {@code token} to the end of the buffer, leaving
+     *  its token slot empty.
+     */
+    void addFields(const Token& token);
+
+    /** Returns true if {@code token} can be rebuilt from the buffered fields.
+     *  The first rebuildable token determines {@link #source}.
+     */
+    bool isRebuildable(const Token& token);
+
+protected:
+
+    /** log2 of {@link #CHUNK_SIZE}. */
+    static const antlr_int32_t CHUNK_BITS = 10;
+
+    /** Number of tokens in each chunk of the buffer. */
+    static const antlr_int32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+
+    /** Most tokens requested from the token source at once. */
+    static const antlr_int32_t BATCH_SIZE;
+
+    /** The fields of {@link #CHUNK_SIZE} consecutive tokens. */
+    struct TokenChunk
+    {
+        antlr_int32_t channels[CHUNK_SIZE];
+        antlr_int32_t startIndexes[CHUNK_SIZE];
+        antlr_int32_t stopIndexes[CHUNK_SIZE];
+        antlr_int32_t lines[CHUNK_SIZE];
+        antlr_int32_t charPositions[CHUNK_SIZE];
+
+        /** Tokens materialized by {@link #get} or kept from the token source,
+         *  {@code NULL} until then.
+         */
+        Token* tokens[CHUNK_SIZE];
+    };
+
+    TokenSource* tokenSource;
+
+    /** The type of every token fetched from the token source. */
+    std::vector<antlr_int32_t> types;
+
+    /** The remaining fields, {@link #CHUNK_SIZE} tokens per chunk. */
+    std::vector<TokenChunk*> chunks;
+
+    /** The source pair of the tokens materialized from the buffer, taken
+     *  from the first {@link CommonToken} the token source returns.
+     */
+    const CommonToken::Source* source;
+
+    /** The index into the tokens list of the current token (next token
+     *  to consume). tokens[p] should be LT(1). p=-1 indicates need
+     *  to initialize with first token. The ctor doesn't get a token.
+     *  First call to LT(1) or whatever gets the first token and sets p=0;
+     */
+    antlr_int32_t p;
+
+    /** Set to {@code true} when the EOF token is fetched. Do not continue
+     *  fetching tokens after that point, or multiple EOF tokens could end up
+     *  in the {@link #tokens} array.
+     */
+    bool fetchedEOF;
+
+    /** Receives the tokens of {@link TokenSource#nextTokens}; empty until
+     *  the first batch, and while the source does not support batches.
+     */
+    std::vector<CommonToken> batch;
+
+    /** Set to {@code false} once the token source turns out to produce
+     *  tokens one at a time.
+     */
+    bool batching;
 };
 
 } /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,60 @@
  * Gael Hatchue
  */
 
+
 #ifndef CharStream_H
 #define CharStream_H
 
 #include <antlr/Definitions.h>
+#include <antlr/IntStream.h>
+#include <antlr/misc/Interval.h>
+#include <antlr/misc/TextView.h>
+#include <string>
 
+using namespace antlr4::misc;
 
 namespace antlr4 {
 
-class ANTLR_API CharStream
+/** A source of characters for an ANTLR lexer. */
+class ANTLR_API CharStream : public IntStream
 {
 public:
-    
-    
+
+    ANTLR_OVERRIDE
+    ~CharStream();
+
+    /**
+     * This method returns the text for a range of characters within this input
+     * stream. This method is guaranteed to not throw an exception if the
+     * specified {@code interval} lies entirely within a marked range. For more
+     * information about marked ranges, see {@link IntStream#mark}.
+     *
+     * @param interval an interval within the stream
+     * @return the text of the specified interval, UTF-8 encoded
+     *
+     * @throws std::invalid_argument if {@code interval.a < 0}, or if
+     * {@code interval.b < interval.a - 1}, or if {@code interval.b} lies at or
+     * past the end of the stream
+     * @throws std::logic_error if the stream does not support
+     * getting the text of the specified interval
+     */
+    virtual std::string getText(const Interval& interval) = 0;
+
+    /**
+     * Returns the text of {@code interval} without copying it, pointing
+     * directly into the stream's own buffer. The view stays valid as long
+     * as the stream does. Streams that do not keep their whole input in one
+     * contiguous buffer return a view with {@code NULL} data, which is what
+     * this default implementation does; callers then fall back to
+     * {@link #getText}.
+     *
+     * @param interval an interval within the stream
+     * @return a view of the UTF-8 text of the specified interval
+     *
+     * @throws std::invalid_argument under the same conditions as
+     * {@link #getText}
+     */
+    virtual TextView getTextView(const Interval& interval);
 };
 
 } /* namespace antlr4 */
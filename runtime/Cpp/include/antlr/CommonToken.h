@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,168 @@
  * Gael Hatchue
  */
 
+
 #ifndef CommonToken_H
 #define CommonToken_H
 
 #include <antlr/Definitions.h>
+#include <antlr/WritableToken.h>
+#include <antlr/misc/Pair.h>
+#include <antlr/misc/TextView.h>
+#include <string>
 
 
 namespace antlr4 {
 
-class ANTLR_API CommonToken
+class CharStream;
+class TokenSource;
+
+/** The token implementation used by lexers.
+ * <p/>
+ *  Programs routinely keep every token of their input in memory, so the
+ *  layout is kept small: the start/stop indexes, line, column and token
+ *  index take 4 bytes each and the type and channel share the remaining 4,
+ *  24 bytes in total. The token source and input stream are not stored in
+ *  each token; all tokens of a source point to one {@link Source} pair owned
+ *  by that source, which must outlive its tokens.
+ * <p/>
+ *  The text is not copied out of the input. {@link #getText} reads it from
+ *  the input stream when asked, and {@link #getTextView} returns it without
+ *  allocating by pointing into the stream's buffer. Only text explicitly
+ *  set with {@link #setText} is stored in the token.
+ */
+class ANTLR_API CommonToken : public WritableToken
 {
 public:
-    
-    
+
+    typedef misc::Pair<TokenSource*, CharStream*> Source;
+
+    explicit CommonToken(antlr_int32_t type);
+
+    CommonToken(ANTLR_NULLABLE const Source* source, antlr_int32_t type, antlr_int32_t channel,
+                antlr_int32_t start, antlr_int32_t stop);
+
+    CommonToken(antlr_int32_t type, const std::string& text);
+
+    CommonToken(const CommonToken& other);
+
+    ANTLR_OVERRIDE
+    ~CommonToken();
+
+    CommonToken& operator=(const CommonToken& other);
+
+    /** Returns the text set with {@link #setText} if any, and otherwise the
+     *  text of the input between the start and stop indexes. A token whose
+     *  indexes lie past the end of the input has the text {@code "<EOF>"}.
+     */
+    ANTLR_OVERRIDE
+    std::string getText() const;
+
+    /** Same as {@link #getText} without copying the text. The view points
+     *  into the input stream's buffer, or into the text set with
+     *  {@link #setText}, and is only valid as long as those are. If the input
+     *  stream cannot provide a view, the returned view has {@code NULL} data.
+     */
+    misc::TextView getTextView() const;
+
+    /** Overrides the text of this token. Tokens whose text comes from the
+     *  input should not need this.
+     */
+    ANTLR_OVERRIDE
+    void setText(const std::string& text);
+
+    /** Returns true if the text was set with {@link #setText} rather than
+     *  being read from the input.
+     */
+    bool hasText() const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getType() const;
+
+    /** @throws std::invalid_argument if {@code ttype} is neither
+     *  {@link Token#EOF_} nor in 0..{@link #MAX_TOKEN_TYPE}
+     */
+    ANTLR_OVERRIDE
+    void setType(antlr_int32_t ttype);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getLine() const;
+
+    ANTLR_OVERRIDE
+    void setLine(antlr_int32_t line);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getCharPositionInLine() const;
+
+    ANTLR_OVERRIDE
+    void setCharPositionInLine(antlr_int32_t pos);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getChannel() const;
+
+    /** @throws std::invalid_argument if {@code channel} lies outside
+     *  {@link #MIN_CHANNEL}..{@link #MAX_CHANNEL}
+     */
+    ANTLR_OVERRIDE
+    void setChannel(antlr_int32_t channel);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getTokenIndex() const;
+
+    ANTLR_OVERRIDE
+    void setTokenIndex(antlr_int32_t index);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStartIndex() const;
+
+    void setStartIndex(antlr_int32_t start);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStopIndex() const;
+
+    void setStopIndex(antlr_int32_t stop);
+
+    ANTLR_OVERRIDE
+    TokenSource* getTokenSource() const;
+
+    ANTLR_OVERRIDE
+    CharStream* getInputStream() const;
+
+    /** The pair shared by all tokens of the same source; never {@code NULL}. */
+    const Source* getSource() const;
+
+    std::string toString() const;
+
+public:
+
+    /** The source of tokens that were not created by a token source. */
+    static const Source EMPTY_SOURCE;
+
+    /** The largest token type a CommonToken can hold. */
+    static const antlr_int32_t MAX_TOKEN_TYPE;
+
+    static const antlr_int32_t MIN_CHANNEL;
+
+    static const antlr_int32_t MAX_CHANNEL;
+
+protected:
+
+    const Source* source;
+
+    /** Text set with {@link #setText}, or {@code NULL} to read the text from
+     *  the input stream.
+     */
+    std::string* text;
+
+    antlr_int32_t start;
+    antlr_int32_t stop;
+    antlr_int32_t line;
+    antlr_int32_t charPositionInLine;
+    antlr_int32_t index;
+
+    /** The token type, with {@link Token#EOF_} stored as 0xFFFF. */
+    antlr_uint16_t type;
+    antlr_int16_t channel;
 };
 
 } /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,101 @@
  * Gael Hatchue
  */
 
+
 #ifndef CommonTokenStream_H
 #define CommonTokenStream_H
 
 #include <antlr/Definitions.h>
+#include <antlr/BufferedTokenStream.h>
+#include <vector>
 
 
 namespace antlr4 {
 
-class ANTLR_API CommonTokenStream
+class TokenSource;
+
+/** The most common stream of tokens where every token is buffered up
+ *  and tokens are filtered for a certain channel (the parser will only
+ *  see these tokens).
+ * <p/>
+ *  Even though it buffers all of the tokens, this token stream pulls tokens
+ *  from the tokens source on demand. In other words, until you ask for a
+ *  token using consume(), LT(), etc. the stream does not pull from the lexer.
+ * <p/>
+ *  The only difference between this stream and {@link BufferedTokenStream} superclass
+ *  is that this stream knows how to ignore off channel tokens. There may be
+ *  a performance advantage to using the superclass if you don't pass
+ *  whitespace and comments etc. to the parser on a hidden channel (i.e.,
+ *  you set {@code $channel} instead of calling {@code skip()} in lexer rules.)
+ * <p/>
+ *  Rather than walking over off-channel tokens one at a time, the stream
+ *  records the buffer index of every on-channel token as it is fetched.
+ *  {@link #LT}, {@link #consume} and {@link #seek} then find the k-th
+ *  on-channel token with a single lookup in that index, however many hidden
+ *  tokens lie in between.
+ *
+ *  @see UnbufferedTokenStream
+ *  @see BufferedTokenStream
+ */
+class ANTLR_API CommonTokenStream : public BufferedTokenStream
 {
 public:
-    
-    
+
+    explicit CommonTokenStream(ANTLR_NOTNULL TokenSource* tokenSource);
+
+    CommonTokenStream(ANTLR_NOTNULL TokenSource* tokenSource, antlr_int32_t channel);
+
+    ANTLR_OVERRIDE
+    ~CommonTokenStream();
+
+    ANTLR_OVERRIDE
+    void setTokenSource(ANTLR_NOTNULL TokenSource* tokenSource);
+
+    /** Count EOF just once. */
+    antlr_int32_t getNumberOfOnChannelTokens();
+
+protected:
+
+    ANTLR_OVERRIDE
+    antlr_int32_t adjustSeekIndex(antlr_int32_t i);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t lookaheadIndex(antlr_int32_t k);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t lookbackIndex(antlr_int32_t k);
+
+    /** Adds the next buffered token to {@link #onChannel} if it is on
+     *  channel, fetching it first if necessary.
+     *
+     * @return {@code false} if all tokens up to EOF are already indexed
+     */
+    bool indexNext();
+
+    /** Returns the position in {@link #onChannel} of the first on-channel
+     *  token at or after buffer index {@code i}, or the position of EOF if
+     *  {@code i} lies past it.
+     */
+    antlr_int32_t onChannelPosition(antlr_int32_t i);
+
+    /** Returns the position of the current token in {@link #onChannel}. */
+    antlr_int32_t currentPosition();
+
+protected:
+
+    /** Skip tokens on any channel but this one; this is how we skip whitespace... */
+    antlr_int32_t channel;
+
+    /** Buffer indexes of the tokens on {@link #channel}, in order. The EOF
+     *  token is always included whatever its channel.
+     */
+    std::vector<antlr_int32_t> onChannel;
+
+    /** Number of buffered tokens already considered for {@link #onChannel}. */
+    antlr_int32_t indexed;
+
+    /** Position of {@link #p} in {@link #onChannel}, or -1 if unknown. */
+    antlr_int32_t q;
 };
 
 } /* namespace antlr4 */
@@ -68,9 +68,13 @@
 /* Integer data types */
 #ifdef HAVE_INTTYPES_H
 #   include <inttypes.h>
+    typedef int16_t antlr_int16_t;
+    typedef uint16_t antlr_uint16_t;
     typedef int32_t antlr_int32_t;
     typedef uint32_t antlr_uint32_t;
 #else /* HAVE_INTTYPES_H */
+    typedef short antlr_int16_t;
+    typedef unsigned short antlr_uint16_t;
     typedef int antlr_int32_t;
     typedef unsigned int antlr_uint32_t;
 #endif /* HAVE_INTTYPES_H */
@@ -38,6 +38,8 @@
 
 #include <antlr/Definitions.h>
 
+namespace antlr4 { class RuleContext; }
+
 namespace antlr4 {
 
 /** A lexer is recognizer that draws input symbols from a character stream.
@@ -48,6 +50,20 @@ namespace antlr4 {
 class ANTLR_API Lexer /* : Recognizer<Integer, LexerATNSimulator>,
                            TokenSource */
 {
+public:
+
+    virtual ~Lexer();
+
+    /** Evaluates the lexer predicate {@code predIndex} of rule {@code ruleIndex}.
+     *  Generated lexers override this; the default accepts everything.
+     */
+    virtual bool sempred(ANTLR_NULLABLE RuleContext* localctx, antlr_int32_t ruleIndex, antlr_int32_t predIndex);
+
+    /** Executes the lexer action {@code actionIndex} of rule {@code ruleIndex}
+     *  after a token has been matched. Generated lexers override this.
+     */
+    virtual void action(ANTLR_NULLABLE RuleContext* localctx, antlr_int32_t ruleIndex, antlr_int32_t actionIndex);
+
 public:
     
     static const antlr_int32_t DEFAULT_MODE;
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,50 @@
  * Gael Hatchue
  */
 
+
 #ifndef LexerNoViableAltException_H
 #define LexerNoViableAltException_H
 
 #include <antlr/Definitions.h>
+#include <antlr/RecognitionException.h>
+#include <string>
 
+namespace antlr4 { class CharStream; }
+namespace antlr4 { class Lexer; }
+namespace antlr4 { namespace atn { class ATNConfigSet; } }
 
 namespace antlr4 {
 
-class ANTLR_API LexerNoViableAltException
+class ANTLR_API LexerNoViableAltException : public RecognitionException
 {
 public:
-    
-    
+
+    LexerNoViableAltException(ANTLR_NULLABLE Lexer* lexer,
+                              ANTLR_NOTNULL CharStream* input,
+                              antlr_int32_t startIndex,
+                              ANTLR_NULLABLE const atn::ATNConfigSet* deadEndConfigs);
+
+    ~LexerNoViableAltException() throw();
+
+    antlr_int32_t getStartIndex() const;
+
+    ANTLR_NULLABLE
+    const atn::ATNConfigSet* getDeadEndConfigs() const;
+
+    std::string toString() const;
+
+private:
+
+    static std::string getMessage(CharStream* input, antlr_int32_t startIndex);
+
+private:
+
+    /** Matching attempted at what input index? */
+    const antlr_int32_t startIndex;
+
+    /** Which configurations did we try at input.index() that couldn't match input.LA(1)? */
+    ANTLR_NULLABLE
+    const atn::ATNConfigSet* deadEndConfigs;
 };
 
 } /* namespace antlr4 */
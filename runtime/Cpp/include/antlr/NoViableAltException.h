@@ -37,15 +37,63 @@
 #define NoViableAltException_H
 
 #include <antlr/Definitions.h>
+#include <antlr/RecognitionException.h>
 
+namespace antlr4 { class Parser; }
+namespace antlr4 { class ParserRuleContext; }
+namespace antlr4 { class Token; }
+namespace antlr4 { class TokenStream; }
+namespace antlr4 { namespace atn { class ATNConfigSet; } }
 
 namespace antlr4 {
 
-class ANTLR_API NoViableAltException
+/** Indicates that the parser could not decide which of two or more paths
+ *  to take based upon the remaining input. It tracks the starting token
+ *  of the offending input and also knows where the parser was
+ *  in the various paths when the error. Reported by reportNoViableAlternative()
+ */
+class ANTLR_API NoViableAltException : public RecognitionException
 {
 public:
-    
-    
+
+    NoViableAltException(ANTLR_NULLABLE Parser* recognizer,
+                         ANTLR_NOTNULL TokenStream* input,
+                         ANTLR_NOTNULL const Token* startToken,
+                         ANTLR_NOTNULL const Token* offendingToken,
+                         ANTLR_NULLABLE const atn::ATNConfigSet* deadEndConfigs,
+                         ANTLR_NULLABLE ParserRuleContext* ctx);
+
+    ~NoViableAltException() throw();
+
+    ANTLR_NOTNULL
+    const Token* getStartToken() const;
+
+    ANTLR_NOTNULL
+    const Token* getOffendingToken() const;
+
+    /** The configurations of the DFA state prediction stopped in; owned by
+     *  the DFA. {@code NULL} when prediction failed during full-context
+     *  prediction, whose configuration sets don't outlive the call.
+     */
+    ANTLR_NULLABLE
+    const atn::ATNConfigSet* getDeadEndConfigs() const;
+
+private:
+
+    /** The token object at the start index; the input stream might
+     * 	not be buffering tokens so get a reference to it. (At the
+     *  time the error occurred, of course the stream needs to keep a
+     *  buffer all of the tokens but later we might not have access to those.)
+     */
+    ANTLR_NOTNULL
+    const Token* startToken;
+
+    ANTLR_NOTNULL
+    const Token* offendingToken;
+
+    /** Which configurations did we try at input.index() that couldn't match input.LT(1)? */
+    ANTLR_NULLABLE
+    const atn::ATNConfigSet* deadEndConfigs;
 };
 
 } /* namespace antlr4 */
@@ -38,14 +38,21 @@
 
 #include <antlr/Definitions.h>
 
+namespace antlr4 { class RuleContext; }
 
 namespace antlr4 {
 
+/** This is all the parsing support code essentially; most of it is error recovery stuff. */
 class ANTLR_API Parser
 {
 public:
-    
-    
+
+    virtual ~Parser();
+
+    /** Evaluates the parser predicate {@code predIndex} of rule {@code ruleIndex}.
+     *  Generated parsers override this; the default accepts everything.
+     */
+    virtual bool sempred(ANTLR_NULLABLE RuleContext* localctx, antlr_int32_t ruleIndex, antlr_int32_t predIndex);
 };
 
 } /* namespace antlr4 */
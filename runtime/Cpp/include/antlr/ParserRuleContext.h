@@ -37,15 +37,20 @@
 #define ParserRuleContext_H
 
 #include <antlr/Definitions.h>
+#include <antlr/RuleContext.h>
 
 
 namespace antlr4 {
 
-class ANTLR_API ParserRuleContext
+/** A rule invocation record for parsing.
+ */
+class ANTLR_API ParserRuleContext : public RuleContext
 {
 public:
-    
-    
+
+    ParserRuleContext();
+
+    ParserRuleContext(ANTLR_NULLABLE ParserRuleContext* parent, antlr_int32_t invokingStateNumber);
 };
 
 } /* namespace antlr4 */
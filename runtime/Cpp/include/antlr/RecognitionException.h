@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,85 @@
  * Gael Hatchue
  */
 
+
 #ifndef RecognitionException_H
 #define RecognitionException_H
 
 #include <antlr/Definitions.h>
+#include <stdexcept>
+#include <string>
 
+namespace antlr4 { class IntStream; }
+namespace antlr4 { class RuleContext; }
 
 namespace antlr4 {
 
-class ANTLR_API RecognitionException
+/** The root of the ANTLR exception hierarchy. In general, ANTLR tracks just
+ *  3 kinds of errors: prediction errors, failed predicate errors, and
+ *  mismatched input errors. In each case, the parser knows where it is
+ *  in the input, where it is in the ATN, the rule invocation stack,
+ *  and what kind of problem occurred.
+ */
+class ANTLR_API RecognitionException : public std::runtime_error
 {
 public:
-    
-    
+
+    RecognitionException(const std::string& message, ANTLR_NULLABLE IntStream* input);
+
+    RecognitionException(const std::string& message, ANTLR_NULLABLE IntStream* input,
+                         ANTLR_NULLABLE RuleContext* ctx);
+
+    ~RecognitionException() throw();
+
+    /**
+     * Get the ATN state number the parser was in at the time the error
+     * occurred. For {@link NoViableAltException} and
+     * {@link LexerNoViableAltException} exceptions, this is the
+     * {@link DecisionState} number. For others, it is the state whose outgoing
+     * edge we couldn't match.
+     * <p/>
+     * If the state number is not known, this method returns -1.
+     */
+    antlr_int32_t getOffendingState() const;
+
+    /**
+     * Gets the input stream which is the symbol source for the recognizer where
+     * this exception was thrown.
+     * <p/>
+     * If the input stream is not available, this method returns {@code NULL}.
+     */
+    ANTLR_NULLABLE
+    IntStream* getInputStream() const;
+
+    /**
+     * Gets the {@link RuleContext} at the time this exception was thrown.
+     * <p/>
+     * If the context is not available, this method returns {@code NULL}.
+     */
+    ANTLR_NULLABLE
+    RuleContext* getCtx() const;
+
+protected:
+
+    void setOffendingState(antlr_int32_t offendingState);
+
+private:
+
+    ANTLR_NULLABLE
+    IntStream* input;
+
+    /** The {@link RuleContext} at the time this exception was thrown. */
+    ANTLR_NULLABLE
+    RuleContext* ctx;
+
+    /**
+     * The ATN state number the parser was in at the time the error
+     * occurred. For {@link NoViableAltException} and
+     * {@link LexerNoViableAltException} exceptions, this is the
+     * {@link DecisionState} number. For others, it is the state whose outgoing
+     * edge we couldn't match.
+     */
+    antlr_int32_t offendingState;
 };
 
 } /* namespace antlr4 */
@@ -37,15 +37,58 @@
 #define RuleContext_H
 
 #include <antlr/Definitions.h>
+#include <string>
 
 
 namespace antlr4 {
 
+/** A rule context is a record of a single rule invocation. It knows
+ *  which context invoked it, if any. If there is no parent context, then
+ *  naturally the invoking state is not valid.  The parent link
+ *  provides a chain upwards from the current rule invocation to the root
+ *  of the invocation tree, forming a stack. We actually carry no
+ *  information about the rule associated with this context (except
+ *  when parsing). We keep only the state number of the invoking state from
+ *  the ATN submachine that invoked this. Contrast this with the s
+ *  pointer inside ParserRuleContext that tracks the current state
+ *  being "executed" for the current rule.
+ * <p/>
+ *  The parent contexts are useful for computing lookahead sets and
+ *  getting error information.
+ */
 class ANTLR_API RuleContext
 {
 public:
-    
-    
+
+    RuleContext();
+
+    RuleContext(ANTLR_NULLABLE RuleContext* parent, antlr_int32_t invokingState);
+
+    virtual ~RuleContext();
+
+    antlr_int32_t depth() const;
+
+    /** A context is empty if there is no invoking state; meaning nobody call
+     *  current context.
+     */
+    bool isEmpty() const;
+
+    ANTLR_NULLABLE
+    RuleContext* getParent() const;
+
+    virtual antlr_int32_t getRuleIndex() const;
+
+public:
+
+    /** What context invoked this rule? */
+    ANTLR_NULLABLE
+    RuleContext* parent;
+
+    /** What state invoked the rule associated with this context?
+     *  The "return address" is the followState of invokingState
+     *  If parent is null, this should be -1.
+     */
+    antlr_int32_t invokingState;
 };
 
 } /* namespace antlr4 */
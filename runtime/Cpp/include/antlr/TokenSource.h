@@ -37,15 +37,69 @@
 #define TokenSource_H
 
 #include <antlr/Definitions.h>
+#include <antlr/Token.h>
+#include <memory>
+#include <string>
 
 
 namespace antlr4 {
 
+class CharStream;
+class CommonToken;
+
+/** A source of tokens must provide a sequence of tokens via nextToken()
+ *  and also must reveal it's source of characters; CommonToken's text is
+ *  computed from a CharStream; it only store indices into the char stream.
+ * <p/>
+ *  Errors from the lexer are never passed to the parser.  Either you want
+ *  to keep going or you do not upon token recognition error.  If you do not
+ *  want to continue lexing then you do not want to continue parsing.  Just
+ *  throw an exception not under RecognitionException and it will naturally
+ *  toss you all the way out of the recognizers.  If you want to continue
+ *  lexing then you should not throw an exception to the parser--it has already
+ *  requested a token.  Keep lexing until you get a valid one.  Just report
+ *  errors and keep going, looking for a valid token.
+ */
 class ANTLR_API TokenSource
 {
 public:
-    
-    
+
+    virtual ~TokenSource();
+
+    /** Return a Token object from your input stream (usually a CharStream).
+     *  Do not fail/return upon lexing error; keep chewing on the characters
+     *  until you get a good one; errors are not passed through to the parser.
+     *  The caller owns the returned token.
+     */
+    ANTLR_NOTNULL
+    virtual antlr_auto_ptr<Token> nextToken() = 0;
+
+    /** Produces up to {@code maxCount} tokens at once into {@code buffer},
+     *  stopping after EOF, and returns how many were produced. Sources that
+     *  produce {@link CommonToken}s override this to run their matching loop
+     *  over a whole batch without a virtual call or an allocation per token;
+     *  they can then implement {@link #nextToken} as a batch of one.
+     * <p/>
+     *  The default implementation returns 0, telling the caller that this
+     *  source produces its tokens one at a time with {@link #nextToken}.
+     */
+    virtual antlr_int32_t nextTokens(ANTLR_NOTNULL CommonToken* buffer, antlr_int32_t maxCount);
+
+    virtual antlr_int32_t getLine() const = 0;
+
+    virtual antlr_int32_t getCharPositionInLine() const = 0;
+
+    /** From what character stream was this token created?  You don't have to
+     *  implement but it's nice to know where a Token comes from if you have
+     *  include files etc... on the input.
+     */
+    ANTLR_NULLABLE
+    virtual CharStream* getInputStream() = 0;
+
+    /** Where are you getting tokens from? normally the implication will simply
+     *  ask lexers input stream.
+     */
+    virtual std::string getSourceName() = 0;
 };
 
 } /* namespace antlr4 */
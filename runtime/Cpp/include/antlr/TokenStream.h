@@ -37,15 +37,115 @@
 #define TokenStream_H
 
 #include <antlr/Definitions.h>
+#include <antlr/IntStream.h>
+#include <string>
 
+namespace antlr4 { class Token; }
+namespace antlr4 { class TokenSource; }
+namespace antlr4 { namespace misc { class Interval; } }
 
 namespace antlr4 {
 
-class ANTLR_API TokenStream
+/**
+ * An {@link IntStream} whose symbols are {@link Token} instances.
+ */
+class ANTLR_API TokenStream : public IntStream
 {
 public:
-    
-    
+
+    ANTLR_OVERRIDE
+    ~TokenStream();
+
+    /**
+     * Get the {@link Token} instance associated with the value returned by
+     * {@link #LA LA(k)}. This method has the same pre- and post-conditions as
+     * {@link IntStream#LA}. In addition, when the preconditions of this method
+     * are met, the return value is non-null and the value of
+     * {@code LT(k).getType()==LA(k)}.
+     *
+     * @see IntStream#LA
+     */
+    ANTLR_NOTNULL
+    virtual const Token* LT(antlr_int32_t k) = 0;
+
+    /**
+     * Gets the {@link Token} at the specified {@code index} in the stream. When
+     * the preconditions of this method are met, the return value is non-null.
+     * <p/>
+     * The preconditions for this method are the same as the preconditions of
+     * {@link IntStream#seek}. If the behavior of {@code seek(index)} is
+     * unspecified for the current state and given {@code index}, then the
+     * behavior of this method is also unspecified.
+     * <p/>
+     * The symbol referred to by {@code index} differs from {@code seek()} only
+     * in the case of filtering streams where {@code index} lies before the end
+     * of the stream. Unlike {@code seek()}, this method does not adjust
+     * {@code index} to point to a non-ignored symbol.
+     *
+     * @throws std::out_of_range if {code index} is less than 0
+     * @throws std::logic_error if the stream does not support
+     * retrieving the token at the specified index
+     */
+    ANTLR_NOTNULL
+    virtual const Token* get(antlr_int32_t index) = 0;
+
+    /**
+     * Gets the underlying {@link TokenSource} which provides tokens for this
+     * stream.
+     */
+    ANTLR_NOTNULL
+    virtual TokenSource* getTokenSource() = 0;
+
+    /**
+     * Return the text of all tokens within the specified {@code interval}. This
+     * method behaves like the following code (including potential exceptions
+     * for violating preconditions of {@link #get}, but may be optimized by the
+     * specific implementation.
+     *
+     * <pre>
+     * TokenStream stream = ...;
+     * String text = "";
+     * for (int i = interval.a; i <= interval.b; i++) {
+     *   text += stream.get(i).getText();
+     * }
+     * </pre>
+     *
+     * @param interval The interval of tokens within this stream to get text
+     * for.
+     * @return The text of all tokens within the specified interval in this
+     * stream.
+     */
+    virtual std::string getText(const misc::Interval& interval) = 0;
+
+    /**
+     * Return the text of all tokens in the stream. This method behaves like the
+     * following code, including potential exceptions from the calls to
+     * {@link IntStream#size} and {@link #getText(Interval)}, but may be
+     * optimized by the specific implementation.
+     *
+     * <pre>
+     * TokenStream stream = ...;
+     * String text = stream.getText(new Interval(0, stream.size()));
+     * </pre>
+     *
+     * @return The text of all tokens in the stream.
+     */
+    virtual std::string getText() = 0;
+
+    /**
+     * Return the text of all tokens in this stream between {@code start} and
+     * {@code stop} (inclusive).
+     * <p/>
+     * If the specified {@code start} or {@code stop} token was not provided by
+     * this stream, or if the {@code stop} occurred before the {@code start}
+     * token, the behavior is unspecified.
+     *
+     * @param start The first token in the interval to get text for.
+     * @param stop The last token in the interval to get text for (inclusive).
+     * @return The text of all tokens lying between the specified {@code start}
+     * and {@code stop} tokens.
+     */
+    virtual std::string getText(ANTLR_NULLABLE const Token* start, ANTLR_NULLABLE const Token* stop) = 0;
 };
 
 } /* namespace antlr4 */
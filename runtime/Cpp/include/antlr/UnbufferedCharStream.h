@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,201 @@
  * Gael Hatchue
  */
 
+
 #ifndef UnbufferedCharStream_H
 #define UnbufferedCharStream_H
 
 #include <antlr/Definitions.h>
+#include <antlr/CharStream.h>
+#include <istream>
+#include <string>
+#include <vector>
 
 
 namespace antlr4 {
 
-class ANTLR_API UnbufferedCharStream
+/** Do not buffer up the entire char stream. It does keep a small buffer
+ *  for efficiency and also buffers while a mark exists (set by the
+ *  lookahead prediction in parser). "Unbuffered" here refers to fact
+ *  that it doesn't buffer all data, not that's it's on demand loading of char.
+ * <p/>
+ *  The input is read from a {@code std::istream} as UTF-8, in blocks of
+ *  up to {@link #bufferSize} bytes, and each block is decoded into code
+ *  points in one go. The code points live in a ring buffer that
+ *  holds the characters from the oldest outstanding {@link #mark} (or the
+ *  current character when there is none) to the furthest one read ahead.
+ *  Consuming and releasing marks only move the start of the ring, so memory
+ *  is bounded by the marked window plus one block, and nothing is copied
+ *  when a mark is released.
+ * <p/>
+ *  A block holds only the bytes the input has already buffered
+ *  ({@code readsome()}); the stream waits on the input only when it has
+ *  nothing buffered and the next character is needed, and then for a
+ *  single byte, so interactive input is not held back until a block fills.
+ *  Malformed UTF-8 sequences decode to U+FFFD one byte at a time.
+ */
+class ANTLR_API UnbufferedCharStream : public CharStream
 {
 public:
-    
-    
+
+    explicit UnbufferedCharStream(std::istream& input);
+
+    UnbufferedCharStream(std::istream& input, size_t bufferSize);
+
+    ANTLR_OVERRIDE
+    ~UnbufferedCharStream();
+
+    ANTLR_OVERRIDE
+    void consume();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t LA(antlr_int32_t i);
+
+    /** Return a marker that we can release later.
+     * <p/>
+     *  The specific marker value used for this class allows for some level of
+     *  protection against misuse where {@code seek()} is called on a mark or
+     *  {@code release()} is called in the wrong order.
+     */
+    ANTLR_OVERRIDE
+    antlr_int32_t mark();
+
+    /** Decrement number of markers, resetting buffer if we hit 0.
+     *
+     * @throws std::logic_error if {@code marker} is not the most recent
+     * outstanding mark
+     */
+    ANTLR_OVERRIDE
+    void release(antlr_int32_t marker);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t index();
+
+    /** Seek to absolute character index, which might not be in the current
+     *  sliding window.  Move {@code p} to {@code index-bufferStartIndex}.
+     *
+     * @throws std::logic_error if {@code index} lies outside the buffered
+     * window
+     */
+    ANTLR_OVERRIDE
+    void seek(antlr_int32_t index);
+
+    /** @throws std::logic_error always; an unbuffered stream cannot know
+     *  its size.
+     */
+    ANTLR_OVERRIDE
+    antlr_int32_t size();
+
+    ANTLR_OVERRIDE
+    std::string getSourceName();
+
+    /** @throws std::logic_error if {@code interval} lies outside the
+     *  buffered window
+     */
+    ANTLR_OVERRIDE
+    std::string getText(const Interval& interval);
+
+protected:
+
+    /** Make sure we have 'want' elements from current position {@link #p p}.
+     *  Last valid {@code p} index is {@code data.length-1}.  {@code p+need-1}
+     *  is the char index 'need' elements ahead.  If we need 1 element,
+     *  {@code (p+1-1)==p} must be less than {@code data.length}.
+     */
+    void sync(antlr_int32_t want);
+
+    /** Decodes at least {@code count} more code points into the buffer,
+     *  unless EOF comes first, reading blocks from the input as needed.
+     */
+    void fill(antlr_int32_t count);
+
+    /** Reads the bytes the input has buffered, up to {@link #bufferSize},
+     *  after the undecoded ones. Blocks for one byte only if the input has
+     *  nothing buffered; sets {@link #inputExhausted} if it has no more.
+     */
+    void readBlock();
+
+    /** Returns {@code true} if the undecoded bytes start with a whole
+     *  UTF-8 sequence.
+     */
+    bool hasCompleteSequence() const;
+
+    /** Appends code point {@code c} to the ring, growing it when full. */
+    void add(antlr_int32_t c);
+
+    /** Forgets every character before the current one. */
+    void dropConsumed();
+
+    /** The code point at absolute index {@code index}, which must be
+     *  buffered.
+     */
+    antlr_int32_t at(antlr_int32_t index) const;
+
+private:
+
+    UnbufferedCharStream(const UnbufferedCharStream&);
+
+    UnbufferedCharStream& operator=(const UnbufferedCharStream&);
+
+public:
+
+    /** The name or source of this char stream. */
+    std::string name;
+
+    /** Number of bytes read from the input at once by default. */
+    static const size_t DEFAULT_BUFFER_SIZE;
+
+protected:
+
+    std::istream* input;
+
+    /** Most bytes taken from the input per read. */
+    size_t bufferSize;
+
+    /** The last block read; bytes {@link #bytesStart} to {@link #bytesEnd}
+     *  are not decoded yet.
+     */
+    std::vector<char> bytes;
+    size_t bytesStart;
+    size_t bytesEnd;
+
+    /** Set once the input returned no byte: it has no more. */
+    bool inputExhausted;
+
+    /** Ring buffer of code points; its size is a power of two. The
+     *  character at absolute index {@code i} is stored at
+     *  {@code data[i & (data.size() - 1)]}.
+     */
+    std::vector<antlr_int32_t> data;
+
+    /** Absolute index of the oldest buffered character. */
+    antlr_int32_t bufferStart;
+
+    /** The number of characters currently in the ring, EOF included. */
+    antlr_int32_t n;
+
+    /** Set once EOF has been added to the ring. */
+    bool reachedEOF;
+
+    /** Absolute character index. It's the index of the character about to
+     *  be read via {@code LA(1)}. Goes from 0 to the number of characters
+     *  in the entire stream, although the stream size is unknown before
+     *  the end is reached.
+     */
+    antlr_int32_t currentCharIndex;
+
+    /** The number of outstanding marks; the ring keeps everything from
+     *  {@link #bufferStart} while there are any.
+     */
+    antlr_int32_t numMarkers;
+
+    /** This is the {@code LA(-1)} character for the current position. */
+    antlr_int32_t lastChar;
+
+    /** When {@code numMarkers > 0}, this is the {@code LA(-1)} character for
+     *  the first character in the ring. Otherwise, this is unspecified.
+     */
+    antlr_int32_t lastCharBufferStart;
 };
 
 } /* namespace antlr4 */
@@ -37,15 +37,30 @@
 #define WritableToken_H
 
 #include <antlr/Definitions.h>
+#include <antlr/Token.h>
+#include <string>
 
 
 namespace antlr4 {
 
-class ANTLR_API WritableToken
+class ANTLR_API WritableToken : public Token
 {
 public:
-    
-    
+
+    ANTLR_OVERRIDE
+    ~WritableToken();
+
+    virtual void setText(const std::string& text) = 0;
+
+    virtual void setType(antlr_int32_t ttype) = 0;
+
+    virtual void setLine(antlr_int32_t line) = 0;
+
+    virtual void setCharPositionInLine(antlr_int32_t pos) = 0;
+
+    virtual void setChannel(antlr_int32_t channel) = 0;
+
+    virtual void setTokenIndex(antlr_int32_t index) = 0;
 };
 
 } /* namespace antlr4 */
@@ -33,23 +33,149 @@
  * Gael Hatchue
  */
 
+
 #ifndef ATN_H
 #define ATN_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/ATNType.h>
+#include <vector>
+
+namespace antlr4 { namespace atn { class ATNState; } }
+namespace antlr4 { namespace atn { class DecisionState; } }
+namespace antlr4 { namespace atn { class RuleStartState; } }
+namespace antlr4 { namespace atn { class RuleStopState; } }
+namespace antlr4 { namespace atn { class TokensStartState; } }
+namespace antlr4 { namespace misc { class IntervalSet; } }
 
+using namespace antlr4::misc;
 
 namespace antlr4 {
 namespace atn {
 
+/** The augmented transition network of a grammar.  The ATN owns every
+ *  state added to it (and, through them, every transition).
+ * <p/>
+ *  Besides the state objects, {@link #buildLayout} keeps a flat copy of the
+ *  graph: per-state arrays indexed by state number, and the transitions of
+ *  all states packed in one array, grouped by source state. Walking the
+ *  flat copy touches a few contiguous arrays instead of chasing pointers
+ *  through state and transition objects.
+ */
 class ANTLR_API ATN
 {
 public:
 
-    
+    /** Used for runtime deserialization of ATNs from strings */
+    ATN();
+
+    ~ATN();
+
+    /** Adds {@code state} to the ATN, taking ownership of it.  A {@code NULL}
+     *  state reserves a state number without creating a state.
+     *
+     *  @throws std::length_error if the ATN already has more states than
+     *  {@link ATNConfig#MAX_STATE_NUMBER}
+     */
+    void addState(ANTLR_NULLABLE ATNState* state);
+
+    /** Deletes {@code state}; its slot is kept so state numbers don't shift. */
+    void removeState(ANTLR_NOTNULL ATNState* state);
+
+    antlr_int32_t defineDecisionState(ANTLR_NOTNULL DecisionState* s);
+
+    ANTLR_NULLABLE
+    DecisionState* getDecisionState(antlr_int32_t decision) const;
+
+    antlr_int32_t getNumberOfDecisions() const;
+
+    /** Rebuilds the flat layout ({@link #stateType}, {@link #stateRuleIndex},
+     *  {@link #transitionOffsets}, {@link #packedTransitions} and
+     *  {@link #transitionSets}) from {@link #states}. {@link ATNDeserializer}
+     *  calls it; an ATN built by hand must call it again after changing
+     *  its states or transitions.
+     */
+    void buildLayout();
+
+    /** Number of transitions of state {@code s} in the flat layout. */
+    antlr_int32_t getNumberOfPackedTransitions(antlr_int32_t s) const;
+
+private:
+
+    ATN(const ATN&);
+
+    ATN& operator=(const ATN&);
+
 public:
-    
-	static const antlr_int32_t INVALID_ALT_NUMBER;    
+
+    static const antlr_int32_t INVALID_ALT_NUMBER;
+
+    std::vector<ATNState*> states;
+
+    /** Each subrule/rule is a decision point and we must track them so we
+     *  can go back later and build DFA predictors for them.  This includes
+     *  all the rules, subrules, optional blocks, ()+, ()* etc...
+     */
+    std::vector<DecisionState*> decisionToState;
+
+    std::vector<RuleStartState*> ruleToStartState;
+
+    std::vector<RuleStopState*> ruleToStopState;
+
+    // runtime for parsers, lexers
+    ATNType grammarType; // ATNType.LEXER, ...
+
+    antlr_int32_t maxTokenType;
+
+    // runtime for lexer only
+    std::vector<antlr_int32_t> ruleToTokenType;
+
+    std::vector<antlr_int32_t> ruleToActionIndex;
+
+    std::vector<TokensStartState*> modeToStartState;
+
+    /** A transition in the flat layout. The arguments depend on
+     *  {@link #type}: the label of an {@link Transition#ATOM}, the bounds of
+     *  a {@link Transition#RANGE}, the index in {@link #transitionSets} of a
+     *  {@link Transition#SET} or {@link Transition#NOT_SET}, the follow state
+     *  number and rule index of a {@link Transition#RULE}, and the rule index
+     *  and predicate or action index of a {@link Transition#PREDICATE} or
+     *  {@link Transition#ACTION}.
+     */
+    struct PackedTransition
+    {
+        /** {@link Transition#getSerializationType} of the transition */
+        antlr_int32_t type;
+
+        /** State number of the target */
+        antlr_int32_t target;
+
+        antlr_int32_t arg1;
+
+        antlr_int32_t arg2;
+    };
+
+    /** {@link ATNState#getStateType} of each state, by state number;
+     *  {@link ATNState#INVALID_TYPE} where a state was removed.
+     */
+    std::vector<antlr_int32_t> stateType;
+
+    /** {@link ATNState#ruleIndex} of each state, by state number. */
+    std::vector<antlr_int32_t> stateRuleIndex;
+
+    /** The transitions of state {@code s} are
+     *  {@code packedTransitions[transitionOffsets[s]]} up to, excluding,
+     *  {@code packedTransitions[transitionOffsets[s+1]]}, in the order of
+     *  {@link ATNState#transition}.
+     */
+    std::vector<antlr_int32_t> transitionOffsets;
+
+    std::vector<PackedTransition> packedTransitions;
+
+    /** Label sets of the set transitions, pointing into the transitions
+     *  owned by the states.
+     */
+    std::vector<const IntervalSet*> transitionSets;
 };
 
 
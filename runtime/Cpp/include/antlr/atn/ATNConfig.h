@@ -38,7 +38,7 @@
 
 #include <antlr/Definitions.h>
 #include <antlr/Recognizer.h>
-#include <antlr/misc/Key.h>
+#include <antlr/misc/HashKeyHelper.h>
 #include <string>
 
 
@@ -58,14 +58,39 @@ namespace atn {
  *  chain used to arrive at the state.  The semantic context is
  *  the tree of semantic predicates encountered before reaching
  *  an ATN state.
+ * <p/>
+ *  Configurations are plain values: there is no virtual base or vtable,
+ *  they are trivially copyable, and hashing and equality go through
+ *  {@link #hashCode}/{@link #equals} or a comparator instead of virtual
+ *  calls, so {@link ATNConfigSet} can store and compare them in place.
+ * <p/>
+ *  A configuration is 16 bytes on 64-bit targets: the context pointer, the
+ *  state number and alt packed into one word, and the semantic context
+ *  index and reachesIntoOuterContext flag packed into another. State
+ *  numbers and alts have 16 bits, which is what the serialized ATN holds,
+ *  so every deserialized ATN fits; the semantic context index has 31 bits,
+ *  so interning contexts during prediction can't run out. The state is found
+ *  with {@code atn->states[stateNumber]}, and the semantic context with
+ *  {@link SemanticContextCache#get} on the cache of the DFA that the
+ *  configuration was computed for.
  */
-class ANTLR_API ATNConfig : public virtual Key<ATNConfig>
+class ANTLR_API ATNConfig
 {
 public:
-    
+
+    /** Largest state number a configuration can refer to; {@link ATN#addState}
+     *  rejects ATNs with more states. All ones is
+     *  {@link ATNState#INVALID_STATE_NUMBER}.
+     */
+    static const antlr_int32_t MAX_STATE_NUMBER = 0xFFFE;
+
+    /** Largest alternative a configuration can predict */
+    static const antlr_int32_t MAX_ALT = 0xFFFF;
+
+    /** Largest lexer action index a configuration can carry */
+    static const antlr_int32_t MAX_LEXER_ACTION_INDEX = 0x7FFFFFFE;
+
     ATNConfig();
-    
-    ATNConfig(const ATNConfig& old);
 
     ATNConfig(ANTLR_NOTNULL const ATNState* state,antlr_int32_t alt,
               ANTLR_NULLABLE const PredictionContext* context);
@@ -73,50 +98,48 @@ public:
     ATNConfig(ANTLR_NOTNULL const ATNState* state,
               antlr_int32_t alt,
               ANTLR_NULLABLE const PredictionContext* context,
-              ANTLR_NOTNULL const SemanticContext* semanticContext);
+              antlr_uint32_t semanticContextIndex);
 
     ATNConfig(ANTLR_NOTNULL const ATNConfig* c, ANTLR_NOTNULL const ATNState* state);
 
     ATNConfig(ANTLR_NOTNULL const ATNConfig* c, ANTLR_NOTNULL const ATNState* state,
-              ANTLR_NOTNULL const SemanticContext* semanticContext);
+              antlr_uint32_t semanticContextIndex);
 
     ATNConfig(ANTLR_NOTNULL const ATNConfig* c,
-              ANTLR_NOTNULL const SemanticContext* semanticContext);
+              antlr_uint32_t semanticContextIndex);
 
     ATNConfig(ANTLR_NOTNULL const ATNConfig* c, ANTLR_NOTNULL const ATNState* state,
               ANTLR_NULLABLE const PredictionContext* context);
 
     ATNConfig(ANTLR_NOTNULL const ATNConfig* c, ANTLR_NOTNULL const ATNState* state,
               ANTLR_NULLABLE const PredictionContext* context,
-              ANTLR_NOTNULL const SemanticContext* semanticContext);
+              antlr_uint32_t semanticContextIndex);
 
     /** An ATN configuration is equal to another if both have
      *  the same state, they predict the same alternative, and
      *  syntactic/semantic contexts are the same.
      */
-    ANTLR_OVERRIDE
-    bool equals(const Key<ATNConfig>* o) const;
+    bool equals(const ATNConfig& other) const;
+
+    bool operator==(const ATNConfig& other) const;
+
+    bool operator!=(const ATNConfig& other) const;
 
-    ANTLR_OVERRIDE
     antlr_int32_t hashCode() const;
-    
-    ANTLR_OVERRIDE
-    ATNConfig* clone() const;
 
-    ANTLR_OVERRIDE
+    /** Lexer action to execute if this configuration reaches an accept
+     *  state, or -1; see {@link LexerATNConfig}.
+     */
+    antlr_int32_t getLexerActionIndex() const;
+
+    void setLexerActionIndex(antlr_int32_t actionIndex);
+
     std::string toString() const;
 
     template <typename Symbol, typename ATNInterpreter>
     std::string toString(ANTLR_NULLABLE const Recognizer<Symbol, ATNInterpreter>* recog, bool showAlt) const;
 
 public:
-    
-    /** The ATN state associated with this configuration */
-    ANTLR_NOTNULL
-    const ATNState* state;
-
-    /** What alt (or lexer rule) is predicted by this configuration */
-    antlr_int32_t alt;
 
     /** The stack of invoking states leading to the rule/states associated
      *  with this config.  We track only those contexts pushed during
@@ -125,6 +148,20 @@ public:
     ANTLR_NULLABLE
     const PredictionContext* context;
 
+    /** Number of the ATN state associated with this configuration */
+    antlr_uint32_t stateNumber : 16;
+
+    /** What alt (or lexer rule) is predicted by this configuration */
+    antlr_uint32_t alt : 16;
+
+    /** Index of the semantic context in the {@link SemanticContextCache}
+     *  of the DFA; 0 is {@link SemanticContext#NONE}. Lexer configurations
+     *  never carry predicates, the lexer evaluates them during closure, so
+     *  theirs holds the lexer action index plus one instead; see
+     *  {@link #getLexerActionIndex}.
+     */
+    antlr_uint32_t semanticContextIndex : 31;
+
     /**
      * We cannot execute predicates dependent upon local context unless
      * we know for sure we are in the correct context. Because there is
@@ -132,14 +169,10 @@ public:
      * dependent predicates unless we are in the rule that initially
      * invokes the ATN simulator.
      *
-     * closure() tracks the depth of how far we dip into the
-     * outer context: depth > 0.  Note that it may not be totally
-     * accurate depth since I don't ever decrement. TODO: make it a boolean then
+     * closure() sets this once a configuration dips into the outer
+     * context.
      */
-    antlr_int32_t reachesIntoOuterContext;
-
-    ANTLR_NOTNULL
-    const SemanticContext* semanticContext;
+    antlr_uint32_t reachesIntoOuterContext : 1;
     
 };
 
@@ -147,4 +180,54 @@ public:
 } /* namespace atn */
 } /* namespace antlr4 */
 
+
+namespace antlr4 {
+namespace misc {
+
+/** Lets hash containers and {@link ObjectEqualityComparator} key on
+ *  configurations through {@link ATNConfig#hashCode} and
+ *  {@link ATNConfig#equals}.
+ */
+template<>
+class ANTLR_API HashKeyHelper<atn::ATNConfig, false>
+{
+public:
+    // Hash function
+    size_t operator()(const atn::ATNConfig& key) const
+    {
+        return static_cast<size_t>(key.hashCode());
+    }
+
+    // Comparison function. This is not always an equality comparison!!
+    bool operator()(const atn::ATNConfig& left, const atn::ATNConfig& right) const
+    {
+#if defined(ANTLR_USING_MSC_HASH_MAP)
+        // when using MS hash_map, this function indicates if left < right
+        return left.hashCode() < right.hashCode();
+#else
+        return left.equals(right);
+#endif
+    }
+
+    // Hash function to antlr_int32_t value
+    antlr_int32_t hashCode(const atn::ATNConfig& key) const
+    {
+        return key.hashCode();
+    }
+
+    // Indicates if two values are equal
+    bool areEqual(const atn::ATNConfig& left, const atn::ATNConfig& right) const
+    {
+        return left.equals(right);
+    }
+
+#if defined(ANTLR_USING_MSC_HASH_MAP)
+    // Bucket size used by VC++ hash_map
+    enum { bucket_size  = 4 };
+#endif
+};
+
+} /* namespace misc */
+} /* namespace antlr4 */
+
 #endif /* ifndef ATN_CONFIG_H */
@@ -39,18 +39,25 @@
 #include <antlr/Definitions.h>
 #include <antlr/atn/ATNConfig.h>
 #include <antlr/atn/ATNState.h>
+#include <antlr/atn/MergeCache.h>
 #include <antlr/atn/PredictionContext.h>
-#include <antlr/misc/Array2DHashSet.h>
-#include <antlr/misc/DoubleKeyMap.h>
+#include <antlr/misc/Arena.h>
+#include <antlr/misc/ArenaVector.h>
+#include <antlr/misc/FlatHashSet.h>
+#include <antlr/misc/BitSet.h>
 #include <antlr/misc/HashSet.h>
 #include <antlr/misc/Key.h>
 #include <antlr/misc/KeyPtr.h>
+#include <antlr/misc/SmallVector.h>
 #include <memory>
 #include <vector>
 
 
 
+namespace antlr4 { namespace atn { class ATN; } }
 namespace antlr4 { namespace atn { class ATNSimulator; } }
+namespace antlr4 { namespace atn { class PredictionContextCache; } }
+namespace antlr4 { namespace atn { class SemanticContextCache; } }
 
 using namespace antlr4::misc;
 
@@ -248,31 +255,7 @@ namespace atn {
 class ANTLR_API ATNConfigSet : public virtual Key<ATNConfigSet>
 {
 public:
-    
-    class AbstractConfigHashSet : public Array2DHashSet<ATNConfig>
-    {
-    public:
-        
-        AbstractConfigHashSet(const AbstractEqualityComparator<ATNConfig>* comparator);
 
-        AbstractConfigHashSet(const AbstractEqualityComparator<ATNConfig>* comparator,
-            antlr_int32_t initialCapacity, antlr_int32_t initialBucketCapacity);
-    };
-    
-    /*
-    The reason that we need this is because we don't want the hash map to use
-    the standard hash code and equals. We need all configurations with the same
-    (s,i,_,semctx) to be equal. Unfortunately, this key effectively doubles
-    the number of objects associated with ATNConfigs. The other solution is to
-    use a hash table that lets us specify the equals/hashcode operation.
-     */
-    class ConfigHashSet : public AbstractConfigHashSet
-    {
-    public:
-        
-        ConfigHashSet();
-    };
-    
     class ConfigEqualityComparator : public AbstractEqualityComparator<ATNConfig>
     {
     public:
@@ -292,13 +275,221 @@ public:
         static const ConfigEqualityComparator INSTANCE;
     };
 
-    
+protected:
+
+    /*
+    The lookup table holds indexes into configs rather than copies of the
+    configs, so that merging a context into an existing config updates the
+    one instance that elements() and get(i) return. Index -1 refers to the
+    config being probed by contains(). Hashing and equality are delegated to
+    a config comparator; we need all configurations with the same
+    (s,i,_,semctx) to be equal.
+     */
+    class ConfigIndexComparator : public AbstractEqualityComparator<antlr_int32_t>
+    {
+    public:
+
+        ConfigIndexComparator(const ATNConfigSet& set,
+                              ANTLR_NOTNULL const AbstractEqualityComparator<ATNConfig>* comparator);
+
+        ANTLR_OVERRIDE
+        antlr_int32_t hashCode(const antlr_int32_t& o) const;
+
+        ANTLR_OVERRIDE
+        bool equals(const antlr_int32_t& a, const antlr_int32_t& b) const;
+
+    private:
+
+        const ATNConfigSet& set;
+
+        ANTLR_NOTNULL
+        const AbstractEqualityComparator<ATNConfig>* comparator;
+    };
+
+    typedef FlatHashSet<antlr_int32_t> ConfigIndexHashSet;
+
+    /** A set of alternatives. Those below {@link #INLINE_ALTS} are bits
+     *  of {@link #words}; higher ones, which only very wide decisions have,
+     *  go to a {@link BitSet} on the heap, created on first use and freed
+     *  by {@link #release}.
+     */
+    struct AltMask
+    {
+        static const antlr_int32_t WORD_COUNT = 2;
+
+        static const antlr_int32_t INLINE_ALTS = WORD_COUNT * 32;
+
+        antlr_uint32_t words[WORD_COUNT];
+
+        ANTLR_NULLABLE
+        BitSet* high;
+
+        /** Makes the set empty without freeing {@link #high} */
+        void reset();
+
+        /** Frees {@link #high} and makes the set empty */
+        void release();
+
+        bool get(antlr_int32_t alt) const;
+
+        void set(antlr_int32_t alt);
+
+        void clear(antlr_int32_t alt);
+
+        /** Returns the smallest alternative, or
+         *  {@link ATN#INVALID_ALT_NUMBER} if the set is empty.
+         */
+        antlr_int32_t first() const;
+
+        void toBitSet(BitSet& bits) const;
+    };
+
+    /** The alternatives of the configs that share a state {@code s}, and
+     *  in a table keyed by context also a context {@code x}.
+     */
+    struct AltSubset
+    {
+        antlr_int32_t stateNumber;
+
+        /** {@code null} in a table that isn't keyed by context */
+        ANTLR_NULLABLE
+        const PredictionContext* context;
+
+        AltMask alts;
+
+        antlr_int32_t cardinality;
+    };
+
+    /**
+     * Groups the configs of a set by {@code (s, x)}, or by {@code s} alone,
+     * and counts the groups predicting one alternative and more than one as
+     * alternatives are added and removed. Small tables are searched
+     * linearly; past {@link ATNConfigSet#SMALL_SET_SIZE} subsets a lookup
+     * table of indexes is created, like {@link ATNConfigSet#configLookup}.
+     * The subsets and the lookup table live in the arena, when there is one.
+     */
+    class AltSubsetTable
+    {
+    public:
+
+        AltSubsetTable(bool byContext, ANTLR_NULLABLE Arena* arena);
+
+        ~AltSubsetTable();
+
+        /** Returns the index of the subset of {@code (s, x)}, adding an
+         *  empty one if there is none.
+         */
+        antlr_int32_t getOrAdd(antlr_int32_t s, const PredictionContext* x);
+
+        /** Returns true if {@code alt} wasn't in subset {@code i} yet */
+        bool addAlt(antlr_int32_t i, antlr_int32_t alt);
+
+        void removeAlt(antlr_int32_t i, antlr_int32_t alt);
+
+        void clear();
+
+        /** Like {@link #clear}, but also gives up the storage of the subsets */
+        void release();
+
+        /** Subsets in the order they were first seen; some may be empty
+         *  after {@link #removeAlt}.
+         */
+        ArenaVector<AltSubset> subsets;
+
+        /** How many subsets have exactly one alternative */
+        antlr_int32_t singleAltCount;
+
+        /** How many subsets have more than one alternative */
+        antlr_int32_t multiAltCount;
+
+    private:
+
+        class IndexComparator : public AbstractEqualityComparator<antlr_int32_t>
+        {
+        public:
+
+            IndexComparator(const AltSubsetTable& table);
+
+            ANTLR_OVERRIDE
+            antlr_int32_t hashCode(const antlr_int32_t& o) const;
+
+            ANTLR_OVERRIDE
+            bool equals(const antlr_int32_t& a, const antlr_int32_t& b) const;
+
+        private:
+
+            const AltSubsetTable& table;
+        };
+
+        /** Index -1 refers to {@link #probe} */
+        const AltSubset& lookupSubset(antlr_int32_t index) const;
+
+        antlr_int32_t hashSubset(const AltSubset& o) const;
+
+        bool equalSubsets(const AltSubset& a, const AltSubset& b) const;
+
+        void createLookup();
+
+        void destroyLookup();
+
+        void updateCounts(antlr_int32_t before, antlr_int32_t after);
+
+        /** Frees the {@link AltMask#high} part of each subset, if any */
+        void releaseHighAlts();
+
+    private:
+
+        AltSubsetTable(const AltSubsetTable&);
+
+        AltSubsetTable& operator=(const AltSubsetTable&);
+
+    private:
+
+        const bool byContext;
+
+        ANTLR_NULLABLE
+        Arena* arena;
+
+        ANTLR_NULLABLE
+        ConfigIndexHashSet* lookup;
+
+        /** Set once a subset holds an alternative past {@link AltMask#INLINE_ALTS} */
+        bool highAlts;
+
+        IndexComparator indexComparator;
+
+        AltSubset probe;
+    };
+
+public:
+
+    /** Sets of up to this many configs keep them inline and find
+     *  duplicates by linear search, without a lookup table.
+     */
+    static const antlr_uint32_t SMALL_SET_SIZE = 6;
+
+    typedef SmallVector<ATNConfig, SMALL_SET_SIZE> ConfigList;
+
 public:
+
+    ~ATNConfigSet();
     
     ATNConfigSet();
 
     ATNConfigSet(bool fullCtx);
 
+    /** Contexts created when merging configs are added to
+     *  {@code contextCache}, which owns them and must outlive this set.
+     */
+    ATNConfigSet(bool fullCtx, ANTLR_NULLABLE PredictionContextCache* contextCache);
+
+    /** Like {@link #ATNConfigSet(bool, PredictionContextCache*)}, but the
+     *  lookup table and the alternative tracking live in {@code arena}. The arena must not be reset
+     *  before this set is destroyed or made readonly, whichever comes first.
+     */
+    ATNConfigSet(bool fullCtx, ANTLR_NULLABLE PredictionContextCache* contextCache,
+                 ANTLR_NULLABLE Arena* arena);
+
     //ATNConfigSet(const ATNConfigSet& old);
 
     ANTLR_OVERRIDE
@@ -307,25 +498,65 @@ public:
     /**
      * Adding a new config means merging contexts with existing configs for
      * {@code (s, i, pi, _)}, where {@code s} is the
-     * {@link ATNConfig#state}, {@code i} is the {@link ATNConfig#alt}, and
-     * {@code pi} is the {@link ATNConfig#semanticContext}. We use
+     * {@link ATNConfig#stateNumber}, {@code i} is the {@link ATNConfig#alt}, and
+     * {@code pi} is the {@link ATNConfig#semanticContextIndex}. We use
      * {@code (s,i,pi)} as key.
      * <p/>
      * This method updates {@link #dipsIntoOuterContext} and
      * {@link #hasSemanticContext} when necessary.
      */
     bool add(const ATNConfig& config,
-        ANTLR_NULLABLE DoubleKeyMap< KeyPtr<PredictionContext>,KeyPtr<PredictionContext>,KeyPtr<PredictionContext> >* mergeCache);
+        ANTLR_NULLABLE MergeCache* mergeCache);
 
     /** Return a List holding list of configs */
-    const std::vector<ATNConfig>& elements() const;
+    const ConfigList& elements() const;
 
-    antlr_auto_ptr< HashSet<ATNState> > getStates() const;
+    antlr_auto_ptr< HashSet<const ATNState*> > getStates(const ATN& atn) const;
 
-    antlr_auto_ptr< std::vector<const SemanticContext*> > getPredicates() const;
+    /** The predicates of the configs, looked up in {@code semanticContexts},
+     *  the cache of the DFA the configs were computed for.
+     */
+    antlr_auto_ptr< std::vector<const SemanticContext*> > getPredicates(const SemanticContextCache& semanticContexts) const;
 
     const ATNConfig& get(antlr_int32_t i) const;
 
+    /** Gets the complete set of represented alternatives for the configuration set. */
+    BitSet getAlts() const;
+
+    /** Returns the only alternative predicted by the configs, or
+     *  {@link ATN#INVALID_ALT_NUMBER} if there are several or none.
+     */
+    antlr_int32_t getUniqueAlt() const;
+
+    /** True if {@link #add} keeps the alternatives of each {@code (s, x)}
+     *  and of each state up to date. Sets built with a custom comparator,
+     *  like the lexer's {@link OrderedATNConfigSet}, don't, and a set stops
+     *  once it is made readonly.
+     */
+    bool tracksAltSubsets() const;
+
+    /** Appends the alternatives of the configs of each {@code (s, x)}
+     *  to {@code altsets}; see
+     *  {@link PredictionMode#getConflictingAltSubsets}. Requires
+     *  {@link #tracksAltSubsets}.
+     */
+    void getAltSubsets(std::vector<BitSet>& altsets) const;
+
+    /** True if the configs of some {@code (s, x)} predict more than one
+     *  alternative. Requires {@link #tracksAltSubsets}.
+     */
+    bool hasConflictingAltSubset() const;
+
+    /** True if the configs of some {@code (s, x)} predict exactly one
+     *  alternative. Requires {@link #tracksAltSubsets}.
+     */
+    bool hasNonConflictingAltSubset() const;
+
+    /** True if the configs of some state predict exactly one alternative.
+     *  Requires {@link #tracksAltSubsets}.
+     */
+    bool hasStateAssociatedWithOneAlt() const;
+
     void optimizeConfigs(const ATNSimulator& interpreter);
 
     //ANTLR_OVERRIDE
@@ -359,8 +590,16 @@ public:
 
     bool isReadonly() const;
 
+    /** Making the set readonly frees the lookup table and the alternative
+     *  tracking; queries about alternatives then scan the configs.
+     */
     void setReadonly(bool readonly);
 
+    /** Approximate number of heap bytes held by this set, including the set
+     *  itself but not the prediction contexts, which may be shared.
+     */
+    size_t getBytesUsed() const;
+
     ANTLR_OVERRIDE
     std::string toString() const;
 
@@ -385,22 +624,60 @@ public:
 
     //ANTLR_OVERRIDE
     //boolean removeAll(Collection<?> c);
-    
-    
+
+protected:
+
+    ATNConfigSet(bool fullCtx, ANTLR_NULLABLE PredictionContextCache* contextCache,
+                 ANTLR_NOTNULL const AbstractEqualityComparator<ATNConfig>* comparator,
+                 ANTLR_NULLABLE Arena* arena);
+
+    const ATNConfig& lookupConfig(antlr_int32_t index) const;
+
+    /** Hash of {@link #configs} in order, from {@link ATNConfig#hashCode}. */
+    antlr_int32_t hashConfigs() const;
+
+    /** Returns the index of the config equal to {@code config} under
+     *  {@link #comparator}, or -1. Only used while {@link #configLookup}
+     *  hasn't been created.
+     */
+    antlr_int32_t findSmall(const ATNConfig& config) const;
+
+    /** Creates {@link #configLookup} in {@link #arena} or on the heap and
+     *  fills it with the indexes of {@link #configs}.
+     */
+    void createLookup();
+
+    /** Destroys {@link #configLookup}, if any, and sets it to {@code null} */
+    void destroyLookup();
+
+    /** Records the alternative of the config just appended to {@link #configs} */
+    void trackNewConfig();
+
+    /** Moves config {@code i} from the subset of its old context to the
+     *  one of {@code context}.
+     */
+    void trackMergedConfig(antlr_int32_t i, const PredictionContext* context);
+
+private:
+
+    ATNConfigSet(const ATNConfigSet&);
+
+    ATNConfigSet& operator=(const ATNConfigSet&);
     
     
 public:
 
-    /** All configs but hashed by (s, i, _, pi) not incl context.  Wiped out
-     *  when we go readonly as this set becomes a DFA state.
+    /** Indexes of all configs but hashed by (s, i, _, pi) not incl context.
+     *  Only created once the set grows past {@link #SMALL_SET_SIZE}, and
+     *  wiped out when we go readonly as this set becomes a DFA state.
      */
-    antlr_auto_ptr<AbstractConfigHashSet> configLookup;
+    ANTLR_NULLABLE
+    ConfigIndexHashSet* configLookup;
 
     /** Track the elements as they are added to the set; supports get(i) */
-    std::vector<ATNConfig> configs;
+    ConfigList configs;
 
     // TODO: these fields make me pretty uncomfortable but nice to pack up info together, saves recomputation
-    // TODO: can we track conflicts as they are added to save scanning configs later?
     antlr_int32_t uniqueAlt;
 
     // Used in parser and lexer. In lexer, it indicates we hit a pred
@@ -414,6 +691,11 @@ public:
      */
     const bool fullCtx;
 
+    /** Set by the parser simulator once it has computed the conflicting
+     *  alternatives of a DFA state's configurations.
+     */
+    antlr_auto_ptr<BitSet> conflictingAlts;
+
     
 protected:
 
@@ -425,17 +707,59 @@ protected:
       */
     bool readonly;
 
-    antlr_auto_ptr< std::vector<bool> > conflictingAlts;
+    /** Set for the lexer's sets, whose configs keep a lexer action index
+     *  in {@link ATNConfig#semanticContextIndex}; see {@link LexerATNConfig}.
+     */
+    bool lexerConfigs;
+
+    ANTLR_NULLABLE
+    PredictionContextCache* contextCache;
+
+    /** Holds {@link #configLookup}, its buckets and the alternative tracking;
+     *  {@code null} for the heap
+     */
+    ANTLR_NULLABLE
+    Arena* arena;
+
+    /** Decides which configs are merged */
+    ANTLR_NOTNULL
+    const AbstractEqualityComparator<ATNConfig>* comparator;
+
+    ConfigIndexComparator configIndexComparator;
 
 private:
 
     antlr_int32_t cachedHashCode;
+
+    /** The config contains() is looking up; see {@link ConfigIndexComparator} */
+    mutable const ATNConfig* probe;
+
+    /** False for sets built with a custom comparator or made readonly; see
+     *  {@link #tracksAltSubsets}
+     */
+    bool trackAlts;
+
+    /** Every alternative added so far and how many there are */
+    AltMask alts;
+    antlr_int32_t altCount;
+
+    /** Alternatives by {@code (s, x)}, tracked as configs are added and
+     *  their contexts merged, so conflict detection doesn't rescan the set.
+     */
+    AltSubsetTable contextAltSubsets;
+
+    /** Alternatives by state alone; configs never change state */
+    AltSubsetTable stateAltSubsets;
+
+    /** The {@link #contextAltSubsets} index of each config in {@link #configs} */
+    ArenaVector<antlr_int32_t> configSubsets;
 };
 
 template <typename U>
 std::vector<U>& ATNConfigSet::toArray(std::vector<U>& a) const
 {
-    return configLookup->toArray(a);
+    a.assign(configs.begin(), configs.end());
+    return a;
 }
 
 
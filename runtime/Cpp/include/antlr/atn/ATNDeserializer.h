@@ -0,0 +1,147 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef ATN_DESERIALIZER_H
+#define ATN_DESERIALIZER_H
+
+#include <antlr/Definitions.h>
+#include <antlr/misc/IntervalSet.h>
+#include <memory>
+#include <vector>
+
+namespace antlr4 { namespace atn { class ATN; } }
+namespace antlr4 { namespace atn { class ATNState; } }
+namespace antlr4 { namespace atn { class Transition; } }
+
+using namespace antlr4::misc;
+
+namespace antlr4 {
+namespace atn {
+
+/** Loads the serialized ATN the tool emits into generated recognizers.
+ * <p/>
+ *  The serialized form is a sequence of 16-bit values: the format version,
+ *  the 8 values of {@link #SERIALIZED_UUID}, then the grammar type and max
+ *  token type followed by the states, non-greedy decisions, rules, modes,
+ *  label sets, edges and decisions. Every value but the version is stored
+ *  plus 2, so that the common values 0 and -1 don't need escaping in the
+ *  generated string literal.
+ * <p/>
+ *  The result has its flat layout already built (see {@link ATN#buildLayout}).
+ */
+class ANTLR_API ATNDeserializer
+{
+public:
+
+    /** Deserializes {@code length} values starting at {@code data}.
+     *  Throws {@code std::invalid_argument} if the data has another version
+     *  or UUID, or ends too early, and {@code std::logic_error} if it doesn't
+     *  describe a valid ATN.
+     */
+    static antlr_auto_ptr<ATN> deserialize(const antlr_uint32_t* data, size_t length);
+
+    static antlr_auto_ptr<ATN> deserialize(const std::vector<antlr_uint32_t>& data);
+
+protected:
+
+    ATNDeserializer(const antlr_uint32_t* data, size_t length);
+
+    antlr_auto_ptr<ATN> deserialize();
+
+    /** Returns the next value, undoing the +2 shift. */
+    antlr_int32_t next();
+
+    void readStates(ATN* atn);
+
+    void readRules(ATN* atn);
+
+    void readModes(ATN* atn);
+
+    void readSets(std::vector<IntervalSet>& sets);
+
+    void readEdges(ATN* atn, const std::vector<IntervalSet>& sets);
+
+    void readDecisions(ATN* atn);
+
+    /** Adds the transitions that can be derived from the serialized ones:
+     *  the return edges of rule stop states and the links between block
+     *  start and end states and between loops and their loopback states.
+     */
+    void deriveEdges(ATN* atn);
+
+    static void verifyATN(const ATN* atn);
+
+    static void checkCondition(bool condition, const char* message);
+
+    ANTLR_NOTNULL
+    static ATNState* stateFactory(antlr_int32_t type, antlr_int32_t ruleIndex);
+
+    ANTLR_NOTNULL
+    static Transition* edgeFactory(const ATN* atn, antlr_int32_t type, antlr_int32_t src, antlr_int32_t trg,
+                                   antlr_int32_t arg1, antlr_int32_t arg2, antlr_int32_t arg3,
+                                   const std::vector<IntervalSet>& sets);
+
+    ANTLR_NOTNULL
+    static ATNState* stateAt(const ATN* atn, antlr_int32_t stateNumber);
+
+private:
+
+    ATNDeserializer(const ATNDeserializer&);
+
+    ATNDeserializer& operator=(const ATNDeserializer&);
+
+public:
+
+    static const antlr_int32_t SERIALIZED_VERSION;
+
+    /** The UUID 33761B2D-78BB-4A43-8B0B-4F5BEE8AACF3 of the serialized
+     *  features, as the 8 values following the version.
+     */
+    static const antlr_uint32_t SERIALIZED_UUID[8];
+
+protected:
+
+    const antlr_uint32_t* data;
+
+    size_t length;
+
+    size_t p;
+};
+
+
+} /* namespace atn */
+} /* namespace antlr4 */
+
+#endif /* ifndef ATN_DESERIALIZER_H */
@@ -33,14 +33,19 @@
  * Gael Hatchue
  */
 
+
 #ifndef ATN_SIMULATOR_H
 #define ATN_SIMULATOR_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/ATNConfig.h>
+#include <memory>
+#include <vector>
 
-
+namespace antlr4 { namespace atn { class ATN; } }
 namespace antlr4 { namespace atn { class PredictionContext; } }
-
+namespace antlr4 { namespace atn { class PredictionContextCache; } }
+namespace antlr4 { namespace dfa { class DFAState; } }
 
 namespace antlr4 {
 namespace atn {
@@ -49,8 +54,81 @@ class ANTLR_API ATNSimulator
 {
 public:
 
-	const PredictionContext* getCachedContext(const PredictionContext* context) const;
-    
+    virtual ~ATNSimulator();
+
+    virtual void reset() = 0;
+
+    /** Returns the copy of {@code context} held by {@link #sharedContextCache},
+     *  copying {@code context} and its ancestors into the cache as needed.
+     *  This lets simulators build contexts in a scratch cache and only keep
+     *  those that end up referenced by a DFA state.
+     */
+    ANTLR_NOTNULL
+    const PredictionContext* getCachedContext(ANTLR_NOTNULL const PredictionContext* context) const;
+
+    ANTLR_NOTNULL
+    PredictionContextCache* getSharedContextCache() const;
+
+protected:
+
+    /** {@code sharedContextCache} may be {@code NULL}, in which case the
+     *  simulator uses a private cache of its own.
+     */
+    ATNSimulator(ANTLR_NOTNULL const ATN* atn,
+                 ANTLR_NULLABLE PredictionContextCache* sharedContextCache);
+
+private:
+
+    ATNSimulator(const ATNSimulator&);
+
+    ATNSimulator& operator=(const ATNSimulator&);
+
+public:
+
+    /** Must distinguish between missing edge and edge we know leads nowhere */
+    ANTLR_NOTNULL
+    static dfa::DFAState* const ERROR;
+
+    ANTLR_NOTNULL
+    const ATN* const atn;
+
+protected:
+
+    /** A config whose successors a closure operation is still visiting: its
+     *  epsilon transitions or, when {@code returns} is set, the return
+     *  states of its context. Closures keep these on {@link #closureStack}
+     *  instead of recursing, so the nesting depth of the input doesn't
+     *  bound the native stack.
+     */
+    struct ClosureFrame
+    {
+        ATNConfig config;
+
+        /** Index of the next transition or return state to follow */
+        antlr_int32_t next;
+
+        antlr_int32_t depth;
+
+        bool collectPredicates;
+
+        bool returns;
+    };
+
+    /** Frames of the closure operations in progress. Each operation pops
+     *  what it pushed, so the stack keeps its capacity between them.
+     */
+    std::vector<ClosureFrame> closureStack;
+
+    /** The context cache maps all PredictionContext objects that are equals()
+     *  to a single cached copy. This cache is shared across all contexts
+     *  in all ATNConfigs in all DFA states.  It owns the contexts it holds.
+     */
+    ANTLR_NOTNULL
+    PredictionContextCache* sharedContextCache;
+
+private:
+
+    antlr_auto_ptr<PredictionContextCache> ownedContextCache;
 };
 
 
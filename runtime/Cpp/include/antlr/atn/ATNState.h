@@ -33,47 +33,124 @@
  * Gael Hatchue
  */
 
+
 #ifndef ATN_STATE_H
 #define ATN_STATE_H
 
 #include <antlr/Definitions.h>
 #include <antlr/misc/Key.h>
+#include <string>
+#include <vector>
 
+namespace antlr4 { namespace atn { class ATN; } }
+namespace antlr4 { namespace atn { class Transition; } }
 
 using namespace antlr4::misc;
 
 namespace antlr4 {
 namespace atn {
 
+/** A state in the ATN.  The state owns its outgoing transitions; they
+ *  are deleted along with the state, which is itself owned by the
+ *  {@link ATN} it was added to.
+ */
 class ANTLR_API ATNState : public virtual Key<ATNState>
 {
 public:
 
     ANTLR_OVERRIDE
-    bool equals(const Key<ATNState>*) const
-    {
-        return false;
-    }
+    ~ATNState();
 
     ANTLR_OVERRIDE
-    antlr_int32_t hashCode() const
-    {
-        return 0;
-    }
-    
+    antlr_int32_t hashCode() const;
+
+    ANTLR_OVERRIDE
+    bool equals(const Key<ATNState>* o) const;
+
     ANTLR_OVERRIDE
-    ATNState* clone() const
-    {
-        return NULL;
-    }
-    
+    ATNState* clone() const;
+
+    virtual bool isNonGreedyExitState() const;
+
+    ANTLR_OVERRIDE
+    std::string toString() const;
+
+    const std::vector<Transition*>& getTransitions() const;
+
+    antlr_int32_t getNumberOfTransitions() const;
+
+    /** Adds {@code e} to this state, taking ownership of it. */
+    void addTransition(ANTLR_NOTNULL Transition* e);
+
+    void addTransition(antlr_int32_t index, ANTLR_NOTNULL Transition* e);
+
+    const Transition* transition(antlr_int32_t i) const;
+
+    /** Replaces (and deletes) the transition at index {@code i}. */
+    void setTransition(antlr_int32_t i, ANTLR_NOTNULL Transition* e);
+
+    /** Removes the transition at {@code index}; ownership passes to the caller. */
+    Transition* removeTransition(antlr_int32_t index);
+
+    virtual antlr_int32_t getStateType() const = 0;
+
+    bool onlyHasEpsilonTransitions() const;
+
+    void setRuleIndex(antlr_int32_t ruleIndex);
+
+protected:
+
+    ATNState();
+
+private:
+
+    ATNState(const ATNState&);
+
+    ATNState& operator=(const ATNState&);
+
+    static std::vector<std::string> getSerializationNames();
+
 public:
-    
+
+    static const antlr_int32_t INITIAL_NUM_TRANSITIONS;
+
+    // constants for serialization
+    static const antlr_int32_t INVALID_TYPE;
+    static const antlr_int32_t BASIC;
+    static const antlr_int32_t RULE_START;
+    static const antlr_int32_t BLOCK_START;
+    static const antlr_int32_t PLUS_BLOCK_START;
+    static const antlr_int32_t STAR_BLOCK_START;
+    static const antlr_int32_t TOKEN_START;
+    static const antlr_int32_t RULE_STOP;
+    static const antlr_int32_t BLOCK_END;
+    static const antlr_int32_t STAR_LOOP_BACK;
+    static const antlr_int32_t STAR_LOOP_ENTRY;
+    static const antlr_int32_t PLUS_LOOP_BACK;
+    static const antlr_int32_t LOOP_END;
+
+    static const std::vector<std::string> serializationNames;
+
+    static const antlr_int32_t INVALID_STATE_NUMBER;
+
+    /** Which ATN are we in? */
+    ANTLR_NULLABLE
+    ATN* atn;
+
     antlr_int32_t stateNumber;
+
+    antlr_int32_t ruleIndex; // at runtime, we don't have Rule objects
+
+    bool epsilonOnlyTransitions;
+
+protected:
+
+    /** Track the transitions emanating from this ATN state. */
+    std::vector<Transition*> transitions;
 };
 
 
 } /* namespace atn */
 } /* namespace antlr4 */
 
-#endif /* ifndef DFA_STATE_H */
+#endif /* ifndef ATN_STATE_H */
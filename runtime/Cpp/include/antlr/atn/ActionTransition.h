@@ -49,15 +49,6 @@ public:
     
     ActionTransition(ANTLR_NOTNULL const ATNState* target, antlr_int32_t ruleIndex, antlr_int32_t actionIndex, bool isCtxDependent);
     
-    ANTLR_OVERRIDE
-    antlr_int32_t getSerializationType() const;
-    
-    ANTLR_OVERRIDE
-    bool isEpsilon() const;
-    
-    ANTLR_OVERRIDE
-    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const;
-    
     ANTLR_OVERRIDE
     std::string toString() const;
     
@@ -37,15 +37,54 @@
 #define ARRAY_PREDICTION_CONTEXT_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/PredictionContext.h>
+#include <string>
+#include <vector>
 
+namespace antlr4 { namespace atn { class SingletonPredictionContext; } }
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API ArrayPredictionContext
+class ANTLR_API ArrayPredictionContext : public PredictionContext
 {
 public:
 
+    ArrayPredictionContext(ANTLR_NOTNULL const SingletonPredictionContext* a);
+
+    ArrayPredictionContext(const std::vector<const PredictionContext*>& parents,
+                           const std::vector<antlr_int32_t>& returnStates);
+
+    ANTLR_OVERRIDE
+    bool isEmpty() const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t size() const;
+
+    ANTLR_OVERRIDE
+    const PredictionContext* getParent(antlr_int32_t index) const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getReturnState(antlr_int32_t index) const;
+
+    ANTLR_OVERRIDE
+    bool equals(const Key<PredictionContext>* o) const;
+
+    ANTLR_OVERRIDE
+    std::string toString() const;
+
+public:
+
+    /** Parent can be null only if full ctx mode and we make an array
+     *  from {@link #EMPTY} and non-empty. We merge {@link #EMPTY} by using null parent and
+     *  returnState == {@link #EMPTY_RETURN_STATE}.
+     */
+    const std::vector<const PredictionContext*> parents;
+
+    /** Sorted for merge, no duplicates; if present,
+     *  {@link #EMPTY_RETURN_STATE} is always last.
+     */
+    const std::vector<antlr_int32_t> returnStates;
 };
 
 
@@ -48,16 +48,10 @@ class ANTLR_API AtomTransition : public Transition
 public:
     AtomTransition(ANTLR_NOTNULL const ATNState* target, antlr_int32_t label);
     
-    ANTLR_OVERRIDE
-    antlr_int32_t getSerializationType() const;
-    
     ANTLR_OVERRIDE
     ANTLR_NOTNULL
     antlr_auto_ptr<IntervalSet> label() const;
     
-    ANTLR_OVERRIDE
-    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const;
-    
     ANTLR_OVERRIDE
     std::string toString() const;
     
@@ -33,19 +33,24 @@
  * Gael Hatchue
  */
 
+
 #ifndef BASIC_BLOCK_START_STATE_H
 #define BASIC_BLOCK_START_STATE_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/BlockStartState.h>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API BasicBlockStartState
+class ANTLR_API BasicBlockStartState : public BlockStartState
 {
 public:
 
+    BasicBlockStartState();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStateType() const;
 };
 
 
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,28 @@
  * Gael Hatchue
  */
 
+
 #ifndef BLOCK_START_STATE_H
 #define BLOCK_START_STATE_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/DecisionState.h>
 
+namespace antlr4 { namespace atn { class BlockEndState; } }
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API BlockStartState
+/**  The start of a regular {@code (...)} block. */
+class ANTLR_API BlockStartState : public DecisionState
 {
+protected:
+
+    BlockStartState();
+
 public:
 
+    const BlockEndState* endState;
 };
 
 
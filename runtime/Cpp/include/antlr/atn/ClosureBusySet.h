@@ -0,0 +1,145 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef CLOSURE_BUSY_SET_H
+#define CLOSURE_BUSY_SET_H
+
+#include <antlr/Definitions.h>
+#include <antlr/atn/ATNConfig.h>
+#include <vector>
+
+namespace antlr4 { namespace atn { class ATNState; } }
+
+namespace antlr4 {
+namespace atn {
+
+/** The configs, or states, a closure operation has already visited.
+ * <p/>
+ *  Entries are bucketed by {@link ATNState#stateNumber} in a table that
+ *  lives as long as its simulator. Each bucket is stamped with the epoch
+ *  it was last written in, and a bucket with an older stamp counts as
+ *  empty, so {@link #reset} starts a new closure by bumping the epoch
+ *  instead of clearing or reallocating the table. The configs of a bucket
+ *  are chained through one array that {@link #reset} truncates, keeping
+ *  its capacity.
+ * <p/>
+ *  A set tracks either configs or states; don't mix the two {@code add}
+ *  overloads between resets. It isn't synchronized; each simulator has its
+ *  own.
+ */
+class ANTLR_API ClosureBusySet
+{
+public:
+
+    ClosureBusySet();
+
+    /** Sizes the table for state numbers below {@code stateCount}; it grows
+     *  if a larger one is added.
+     */
+    ClosureBusySet(antlr_uint32_t stateCount);
+
+    /** Empties the set in constant time. */
+    void reset();
+
+    /** Adds {@code config}; returns false if an equal config was added
+     *  since the last {@link #reset}.
+     */
+    bool add(const ATNConfig& config);
+
+    /** Marks {@code state} visited; returns false if it already was since
+     *  the last {@link #reset}.
+     */
+    bool add(ANTLR_NOTNULL const ATNState* state);
+
+    bool contains(const ATNConfig& config) const;
+
+    bool contains(ANTLR_NOTNULL const ATNState* state) const;
+
+    /** Number of configs or states added since the last {@link #reset}. */
+    antlr_uint32_t size() const;
+
+    antlr_uint32_t getEpoch() const;
+
+private:
+
+    ClosureBusySet(const ClosureBusySet&);
+
+    ClosureBusySet& operator=(const ClosureBusySet&);
+
+protected:
+
+    struct Bucket
+    {
+        /** The bucket is empty unless this is the current epoch. */
+        antlr_uint32_t epoch;
+
+        /** Index of the last config added to the bucket in {@link #chain}, or -1 */
+        antlr_int32_t head;
+    };
+
+    struct Link
+    {
+        ATNConfig config;
+
+        /** Index of the previous config of the same bucket, or -1 */
+        antlr_int32_t next;
+    };
+
+    /** Returns the bucket of state {@code stateNumber}, emptied if it's stale. */
+    Bucket& bucketFor(antlr_int32_t stateNumber);
+
+    /** Returns the bucket of state {@code stateNumber} if it was written in the
+     *  current epoch, {@code null} otherwise.
+     */
+    ANTLR_NULLABLE
+    const Bucket* currentBucket(antlr_int32_t stateNumber) const;
+
+protected:
+
+    std::vector<Bucket> buckets;
+
+    std::vector<Link> chain;
+
+    /** Starts at 1; stamps of 0 are never current. */
+    antlr_uint32_t epoch;
+
+    antlr_uint32_t n;
+};
+
+
+} /* namespace atn */
+} /* namespace antlr4 */
+
+#endif /* ifndef CLOSURE_BUSY_SET_H */
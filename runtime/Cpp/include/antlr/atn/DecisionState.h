@@ -33,19 +33,26 @@
  * Gael Hatchue
  */
 
+
 #ifndef DECISION_STATE_H
 #define DECISION_STATE_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/ATNState.h>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API DecisionState
+class ANTLR_API DecisionState : public ATNState
 {
+protected:
+
+    DecisionState();
+
 public:
 
+    antlr_int32_t decision;
+    bool nonGreedy;
 };
 
 
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,40 @@
  * Gael Hatchue
  */
 
+
 #ifndef EMPTY_PREDICTION_CONTEXT_H
 #define EMPTY_PREDICTION_CONTEXT_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/SingletonPredictionContext.h>
+#include <string>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API EmptyPredictionContext
+class ANTLR_API EmptyPredictionContext : public SingletonPredictionContext
 {
 public:
 
+    EmptyPredictionContext();
+
+    ANTLR_OVERRIDE
+    bool isEmpty() const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t size() const;
+
+    ANTLR_OVERRIDE
+    const PredictionContext* getParent(antlr_int32_t index) const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getReturnState(antlr_int32_t index) const;
+
+    ANTLR_OVERRIDE
+    bool equals(const Key<PredictionContext>* o) const;
+
+    ANTLR_OVERRIDE
+    std::string toString() const;
 };
 
 
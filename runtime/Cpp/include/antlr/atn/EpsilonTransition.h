@@ -47,15 +47,6 @@ class ANTLR_API EpsilonTransition : public Transition
 public:
     EpsilonTransition(ANTLR_NOTNULL const ATNState* target);
 
-    ANTLR_OVERRIDE
-    antlr_int32_t getSerializationType() const;
-
-    ANTLR_OVERRIDE
-    bool isEpsilon() const;
-
-    ANTLR_OVERRIDE
-    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const;
-
     ANTLR_OVERRIDE
     std::string toString() const;
 };
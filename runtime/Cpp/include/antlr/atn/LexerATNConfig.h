@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,42 @@
  * Gael Hatchue
  */
 
+
 #ifndef LEXER_ATN_CONFIG_H
 #define LEXER_ATN_CONFIG_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/ATNConfig.h>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API LexerATNConfig
+/** An {@link ATNConfig} built by the lexer simulator.  The action index is
+ *  stored in {@link ATNConfig#semanticContextIndex}, which lexer
+ *  configurations don't otherwise use, so a {@code LexerATNConfig} can be
+ *  copied into an {@link ATNConfigSet} without slicing anything off. Like a
+ *  semantic context, the action is part of the configuration's identity.
+ */
+class ANTLR_API LexerATNConfig : public ATNConfig
 {
 public:
 
+    LexerATNConfig(ANTLR_NOTNULL const ATNState* state,
+                   antlr_int32_t alt,
+                   ANTLR_NULLABLE const PredictionContext* context);
+
+    LexerATNConfig(ANTLR_NOTNULL const ATNState* state,
+                   antlr_int32_t alt,
+                   ANTLR_NULLABLE const PredictionContext* context,
+                   antlr_int32_t actionIndex);
+
+    LexerATNConfig(ANTLR_NOTNULL const ATNConfig& c, ANTLR_NOTNULL const ATNState* state);
+
+    LexerATNConfig(ANTLR_NOTNULL const ATNConfig& c, ANTLR_NOTNULL const ATNState* state,
+                   antlr_int32_t actionIndex);
+
+    LexerATNConfig(ANTLR_NOTNULL const ATNConfig& c, ANTLR_NOTNULL const ATNState* state,
+                   ANTLR_NULLABLE const PredictionContext* context);
 };
 
 
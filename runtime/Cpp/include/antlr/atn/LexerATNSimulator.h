@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,303 @@
  * Gael Hatchue
  */
 
+
 #ifndef LEXER_ATN_SIMULATOR_H
 #define LEXER_ATN_SIMULATOR_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/ATNConfig.h>
+#include <antlr/atn/ATNSimulator.h>
+#include <antlr/misc/Arena.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace antlr4 { class CharStream; }
+namespace antlr4 { class Lexer; }
+namespace antlr4 { namespace atn { class ATNConfigSet; } }
+namespace antlr4 { namespace atn { class ATNState; } }
+namespace antlr4 { namespace atn { class Transition; } }
+namespace antlr4 { namespace dfa { class DFA; } }
+namespace antlr4 { namespace dfa { class DFAState; } }
+namespace antlr4 { namespace dfa { class FrozenDFA; } }
 
+using namespace antlr4::dfa;
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API LexerATNSimulator
+/** "dup" of ParserInterpreter
+ * <p/>
+ * DFA edges are cached per state in {@link DFAState#edges}, a flat array
+ * indexed directly by the input symbol for {@link #MIN_DFA_EDGE}..{@link #MAX_DFA_EDGE}.
+ * Symbols above that and up to {@link #MAX_BMP_DFA_EDGE} are cached in the
+ * page table {@link DFAState#edgePages} unless disabled with
+ * {@link #setBmpEdgeCacheEnabled}. Only a miss in both falls back to computing
+ * the ATN closure.
+ * <p/>
+ * The DFAs in {@code decisionToDFA} may be shared with lexers on other
+ * threads: cached edges are followed without locking, and new states and
+ * edges are added while holding {@link DFA#lock}.
+ */
+class ANTLR_API LexerATNSimulator : public ATNSimulator
 {
+protected:
+
+    /** When we hit an accept state in either the DFA or the ATN, we
+     *  have to notify the character stream to start buffering characters
+     *  via {@link IntStream#mark} and record the current state. The current sim state
+     *  includes the current index into the input, the current line,
+     *  and current character position in that line. Note that the Lexer is
+     *  tracking the starting line and characterization of the token. These
+     *  variables track the "state" of the simulator when it hits an accept state.
+     * <p/>
+     *  We track these variables separately for the DFA and ATN simulation
+     *  because the DFA simulation often has to fail over to the ATN
+     *  simulation. If the ATN simulation fails, we need the DFA to fall
+     *  back to its previously accepted state, if any. If the ATN succeeds,
+     *  then the ATN does the accept and the DFA simulator that invoked it
+     *  can simply return the predicted token type.
+     */
+    class SimState
+    {
+    public:
+
+        SimState();
+
+        void reset();
+
+    public:
+
+        antlr_int32_t index;
+        antlr_int32_t line;
+        antlr_int32_t charPos;
+        const DFAState* dfaState;
+    };
+
+public:
+
+    LexerATNSimulator(ANTLR_NOTNULL const ATN* atn,
+                      std::vector<DFA*>& decisionToDFA,
+                      ANTLR_NULLABLE PredictionContextCache* sharedContextCache);
+
+    LexerATNSimulator(ANTLR_NULLABLE Lexer* recog,
+                      ANTLR_NOTNULL const ATN* atn,
+                      std::vector<DFA*>& decisionToDFA,
+                      ANTLR_NULLABLE PredictionContextCache* sharedContextCache);
+
+    void copyState(ANTLR_NOTNULL const LexerATNSimulator* simulator);
+
+    antlr_int32_t match(ANTLR_NOTNULL CharStream* input, antlr_int32_t mode);
+
+    ANTLR_OVERRIDE
+    void reset();
+
+    ANTLR_NOTNULL
+    DFA* getDFA(antlr_int32_t mode) const;
+
+    /** Get the text matched so far for the current token.
+     */
+    std::string getText(ANTLR_NOTNULL CharStream* input) const;
+
+    antlr_int32_t getLine() const;
+
+    void setLine(antlr_int32_t line);
+
+    antlr_int32_t getCharPositionInLine() const;
+
+    void setCharPositionInLine(antlr_int32_t charPositionInLine);
+
+    void consume(ANTLR_NOTNULL CharStream* input);
+
+    /** Enables or disables caching of DFA edges for symbols above
+     *  {@link #MAX_DFA_EDGE} (enabled by default).
+     */
+    void setBmpEdgeCacheEnabled(bool enabled);
+
+    bool isBmpEdgeCacheEnabled() const;
+
+protected:
+
+    antlr_int32_t matchATN(ANTLR_NOTNULL CharStream* input);
+
+    antlr_int32_t execATN(ANTLR_NOTNULL CharStream* input, ANTLR_NOTNULL const DFAState* ds0);
+
+    /** Matches a token by walking {@code frozen} alone. Returns
+     *  {@code false}, leaving {@code input} and the position to be restored
+     *  by the caller, if the table is missing an edge on the way and the
+     *  token has to be matched by {@link #execATN} instead.
+     */
+    bool execFrozenDFA(ANTLR_NOTNULL CharStream* input, ANTLR_NOTNULL const FrozenDFA* frozen,
+                       antlr_int32_t& result);
+
+    /**
+     * Get an existing target state for an edge in the DFA. If the target state
+     * for the edge has not yet been computed or is otherwise not available,
+     * this method returns {@code NULL}.
+     *
+     * @param s The current DFA state
+     * @param t The next input symbol
+     * @return The existing target DFA state for the given input symbol
+     * {@code t}, or {@code NULL} if the target state for this edge is not
+     * already cached
+     */
+    ANTLR_NULLABLE
+    const DFAState* getExistingTargetState(ANTLR_NOTNULL const DFAState* s, antlr_int32_t t) const;
+
+    /**
+     * Compute a target state for an edge in the DFA, and attempt to add the
+     * computed state and corresponding edge to the DFA.
+     *
+     * @param input The input stream
+     * @param s The current DFA state
+     * @param t The next input symbol
+     *
+     * @return The computed target DFA state for the given input symbol
+     * {@code t}. If {@code t} does not lead to a valid DFA state, this method
+     * returns {@link #ERROR}.
+     */
+    ANTLR_NOTNULL
+    const DFAState* computeTargetState(ANTLR_NOTNULL CharStream* input, ANTLR_NOTNULL const DFAState* s, antlr_int32_t t);
+
+    antlr_int32_t failOrAccept(SimState& prevAccept, ANTLR_NOTNULL CharStream* input,
+                               ANTLR_NOTNULL const ATNConfigSet* reach, antlr_int32_t t);
+
+    /** Given a starting configuration set, figure out all ATN configurations
+     *  we can reach upon input {@code t}. Parameter {@code reach} is a return
+     *  parameter.
+     */
+    void getReachableConfigSet(ANTLR_NOTNULL CharStream* input,
+                               ANTLR_NOTNULL const ATNConfigSet* closureConfigs,
+                               ANTLR_NOTNULL ATNConfigSet* reach,
+                               antlr_int32_t t);
+
+    void accept(ANTLR_NOTNULL CharStream* input, antlr_int32_t ruleIndex, antlr_int32_t actionIndex,
+                antlr_int32_t index, antlr_int32_t line, antlr_int32_t charPos);
+
+    ANTLR_NULLABLE
+    const ATNState* getReachableTarget(const Transition* trans, antlr_int32_t t) const;
+
+    ANTLR_NOTNULL
+    antlr_auto_ptr<ATNConfigSet> computeStartState(ANTLR_NOTNULL CharStream* input,
+                                                   ANTLR_NOTNULL const ATNState* p);
+
+    /**
+     * Since the alternatives within any lexer decision are ordered by
+     * preference, this method stops pursuing the closure as soon as an accept
+     * state is reached. After the first accept state is reached by depth-first
+     * search from {@code config}, all other (potentially reachable) states for
+     * this rule would have a lower priority.
+     *
+     * The search keeps the configs still being expanded on
+     * {@link #closureStack} instead of recursing.
+     *
+     * @return {@code true} if an accept state is reached, otherwise
+     * {@code false}.
+     */
+    bool closure(ANTLR_NOTNULL CharStream* input, const ATNConfig& config, ANTLR_NOTNULL ATNConfigSet* configs,
+                 bool currentAltReachedAcceptState, bool speculative);
+
+    /** Enters {@code config} during {@link #closure}: adds it to
+     *  {@code configs} if it ends the rule or has non-epsilon edges, and
+     *  pushes a frame over its return states or epsilon edges.
+     */
+    void closureEnter(const ATNConfig& config, ANTLR_NOTNULL ATNConfigSet* configs,
+                      bool& currentAltReachedAcceptState);
+
+    /** Computes the configuration reached from {@code config} by following
+     *  the epsilon transition {@code t}, storing it in {@code c}.
+     *
+     *  @return {@code false} if {@code t} can't be followed
+     */
+    bool getEpsilonTarget(ANTLR_NOTNULL CharStream* input,
+                          const ATNConfig& config,
+                          ANTLR_NOTNULL const Transition* t,
+                          ANTLR_NOTNULL ATNConfigSet* configs,
+                          bool speculative,
+                          ATNConfig& c);
+
+    /**
+     * Evaluate a predicate specified in the lexer.
+     * <p/>
+     * If {@code speculative} is {@code true}, this method was called before
+     * {@link #consume} for the matched character. This method should call
+     * {@link #consume} before evaluating the predicate to ensure position
+     * sensitive values, including {@link Lexer#getText}, {@link Lexer#getLine},
+     * and {@link Lexer#getCharPositionInLine}, properly reflect the current
+     * lexer state. This method should restore {@code input} and the simulator
+     * to the original state before returning (i.e. undo the actions made by the
+     * call to {@link #consume}.
+     *
+     * @param input The input stream.
+     * @param ruleIndex The rule containing the predicate.
+     * @param predIndex The index of the predicate within the rule.
+     * @param speculative {@code true} if the current index in {@code input} is
+     * one character before the predicate's location.
+     *
+     * @return {@code true} if the specified predicate evaluates to
+     * {@code true}.
+     */
+    bool evaluatePredicate(ANTLR_NOTNULL CharStream* input, antlr_int32_t ruleIndex, antlr_int32_t predIndex,
+                           bool speculative);
+
+    void captureSimState(SimState& settings, ANTLR_NOTNULL CharStream* input,
+                         ANTLR_NOTNULL const DFAState* dfaState) const;
+
+    ANTLR_NOTNULL
+    const DFAState* addDFAEdge(ANTLR_NOTNULL const DFAState* from, antlr_int32_t t,
+                               ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& q);
+
+    /** The caller must hold the lock of the current mode's DFA. */
+    void addDFAEdge(ANTLR_NOTNULL const DFAState* p, antlr_int32_t t, ANTLR_NOTNULL const DFAState* q);
+
+    /** Add a new DFA state if there isn't one with this set of
+     *  configurations already. This method also detects the first
+     *  configuration containing an ATN rule stop state. Later, when
+     *  traversing the DFA, we will know which rule to accept.
+     *  Takes ownership of {@code configs}. The caller must hold the lock of
+     *  the current mode's DFA.
+     */
+    ANTLR_NOTNULL
+    const DFAState* addDFAState(ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& configs);
+
 public:
 
+    static const antlr_int32_t MIN_DFA_EDGE;
+    static const antlr_int32_t MAX_DFA_EDGE;
+    static const antlr_int32_t MAX_BMP_DFA_EDGE;
+
+protected:
+
+    ANTLR_NULLABLE
+    Lexer* const recog;
+
+    /** The current token's starting index into the character stream.
+     *  Shared across DFA to ATN simulation in case the ATN fails and the
+     *  DFA did not have a previous accept state. In this case, we use the
+     *  ATN-generated exception object.
+     */
+    antlr_int32_t startIndex;
+
+    /** line number 1..n within the input */
+    antlr_int32_t line;
+
+    /** The index of the character relative to the beginning of the line 0..n-1 */
+    antlr_int32_t charPositionInLine;
+
+    std::vector<DFA*>& decisionToDFA;
+
+    antlr_int32_t mode;
+
+    /** Used during DFA/ATN exec to record the most recent accept configuration info */
+    SimState prevAccept;
+
+    bool bmpEdgeCacheEnabled;
+
+    /** Holds the lookup tables of the configuration sets built while
+     *  matching a token; reset at the end of {@link #match}.
+     */
+    Arena predictionArena;
 };
 
 
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,29 @@
  * Gael Hatchue
  */
 
+
 #ifndef LOOP_END_STATE_H
 #define LOOP_END_STATE_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/ATNState.h>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API LoopEndState
+/** Mark the end of a * or + loop. */
+class ANTLR_API LoopEndState : public ATNState
 {
 public:
 
+    LoopEndState();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStateType() const;
+
+public:
+
+    const ATNState* loopBackState;
 };
 
 
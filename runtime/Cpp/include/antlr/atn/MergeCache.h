@@ -0,0 +1,202 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef MERGE_CACHE_H
+#define MERGE_CACHE_H
+
+#include <antlr/Definitions.h>
+#include <vector>
+
+namespace antlr4 { namespace atn { class PredictionContext; } }
+namespace antlr4 { namespace atn { class PredictionContextCache; } }
+
+namespace antlr4 {
+namespace atn {
+
+/** Remembers the results of {@link PredictionContext#merge}, so merging the
+ *  same two graphs again costs a table lookup. Maps graphs a and b to merged
+ *  result c. (a,b)->c. (b,a) is looked up under the same entry.
+ * <p/>
+ *  Contexts are hash-consed by {@link PredictionContextCache}, so the cache
+ *  is keyed on the pair of context pointers and never walks a graph. It is a
+ *  flat, set-associative table of fixed capacity: each key maps to a set of
+ *  {@link #WAYS} entries, and when the set is full an entry is evicted using
+ *  the clock (second chance) algorithm. Memory use is therefore bounded no
+ *  matter how long the parse runs.
+ * <p/>
+ *  The cache doesn't own any context. Entries must be dropped before the
+ *  contexts they refer to are deleted, either with {@link #clear} or, for
+ *  the contexts of a single cache, with {@link #removeContextsOf}. It isn't
+ *  synchronized; each simulator has its own.
+ * <p/>
+ *  A simulator drops the entries of its short-lived contexts after every
+ *  prediction, so the cache counts them as they are recorded: once the
+ *  cache holding those contexts is named with {@link #setTransientCache},
+ *  removing its contexts costs nothing when no entry refers to them, and
+ *  otherwise never follows a context pointer.
+ */
+class ANTLR_API MergeCache
+{
+public:
+
+    /** Creates a cache holding up to {@link #DEFAULT_CAPACITY} entries. */
+    MergeCache();
+
+    /** Creates a cache holding up to {@code capacity} entries, rounded up to
+     *  a power of two no smaller than {@link #WAYS}.
+     */
+    MergeCache(antlr_uint32_t capacity);
+
+    /** Returns the result recorded for merging {@code a} and {@code b}, or
+     *  {@code null} if there is none.
+     */
+    ANTLR_NULLABLE
+    const PredictionContext* get(ANTLR_NOTNULL const PredictionContext* a,
+                                 ANTLR_NOTNULL const PredictionContext* b,
+                                 bool rootIsWildcard);
+
+    /** Records {@code result} as the merge of {@code a} and {@code b},
+     *  evicting another entry if the set is full.
+     */
+    void put(ANTLR_NOTNULL const PredictionContext* a,
+             ANTLR_NOTNULL const PredictionContext* b,
+             bool rootIsWildcard,
+             ANTLR_NOTNULL const PredictionContext* result);
+
+    /** Drops every entry. The statistics are kept. */
+    void clear();
+
+    /** Names the cache whose contexts {@link #removeContextsOf} is
+     *  regularly called for. Must be called while the cache is empty.
+     */
+    void setTransientCache(ANTLR_NULLABLE const PredictionContextCache* cache);
+
+    /** Drops the entries that refer to a context owned by {@code cache},
+     *  keeping those whose contexts outlive it.
+     */
+    void removeContextsOf(ANTLR_NOTNULL const PredictionContextCache* cache);
+
+    /** Number of entries referring to a context of the transient cache */
+    antlr_uint32_t transientSize() const;
+
+    antlr_uint32_t size() const;
+
+    antlr_uint32_t getCapacity() const;
+
+    /** Number of {@link #get} calls that found an entry. */
+    antlr_uint32_t getHits() const;
+
+    /** Number of {@link #get} calls that found no entry. */
+    antlr_uint32_t getMisses() const;
+
+    /** Number of entries replaced by {@link #put} to make room. */
+    antlr_uint32_t getEvictions() const;
+
+    void resetStatistics();
+
+private:
+
+    MergeCache(const MergeCache&);
+
+    MergeCache& operator=(const MergeCache&);
+
+protected:
+
+    struct Entry
+    {
+        ANTLR_NULLABLE
+        const PredictionContext* a;
+
+        const PredictionContext* b;
+
+        const PredictionContext* result;
+
+        bool rootIsWildcard;
+
+        /** Set by a hit, cleared when the clock hand passes over it. */
+        bool referenced;
+
+        /** Set if a context of the entry is owned by the transient cache */
+        bool transient;
+    };
+
+    void init(antlr_uint32_t capacity);
+
+    /** Returns the first entry of the set {@code (a,b)} maps to. */
+    antlr_uint32_t setFor(const PredictionContext* a, const PredictionContext* b, bool rootIsWildcard) const;
+
+    static antlr_int32_t pointerBits(const void* p);
+
+    bool isTransient(const PredictionContext* a, const PredictionContext* b,
+                     const PredictionContext* result) const;
+
+public:
+
+    static const antlr_uint32_t DEFAULT_CAPACITY = 1024;
+
+    static const antlr_uint32_t WAYS = 4;
+
+protected:
+
+    /** {@link #getCapacity} / {@link #WAYS} sets of {@link #WAYS} entries
+     *  each. An entry with a {@code null} {@link Entry#a} is free.
+     */
+    std::vector<Entry> entries;
+
+    /** The clock hand of each set, as an index within the set. */
+    std::vector<antlr_uint32_t> hands;
+
+    antlr_uint32_t setMask;
+
+    antlr_uint32_t n;
+
+    ANTLR_NULLABLE
+    const PredictionContextCache* transientCache;
+
+    /** Number of entries with {@link Entry#transient} set */
+    antlr_uint32_t numTransient;
+
+    antlr_uint32_t hits;
+
+    antlr_uint32_t misses;
+
+    antlr_uint32_t evictions;
+};
+
+
+} /* namespace atn */
+} /* namespace antlr4 */
+
+#endif /* ifndef MERGE_CACHE_H */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,30 @@
  * Gael Hatchue
  */
 
+
 #ifndef ORDERED_ATN_CONFIG_SET_H
 #define ORDERED_ATN_CONFIG_SET_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/ATNConfigSet.h>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API OrderedATNConfigSet
+/** A config set that only merges configs which are equal in every respect,
+ *  context included, so configs are kept in the order they were added;
+ *  used by the lexer simulator.
+ */
+class ANTLR_API OrderedATNConfigSet : public ATNConfigSet
 {
 public:
 
+    OrderedATNConfigSet();
+
+    /** Keeps the lookup table in {@code arena}; see
+     *  {@link ATNConfigSet#ATNConfigSet(bool, PredictionContextCache*, Arena*)}.
+     */
+    OrderedATNConfigSet(ANTLR_NULLABLE Arena* arena);
 };
 
 
@@ -37,15 +37,504 @@
 #define PARSER_ATN_SIMULATOR_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/ATNConfig.h>
+#include <antlr/atn/ATNSimulator.h>
+#include <antlr/atn/ClosureBusySet.h>
+#include <antlr/atn/MergeCache.h>
+#include <antlr/atn/PredictionContext.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/atn/PredictionMode.h>
+#include <antlr/misc/Arena.h>
+#include <antlr/misc/BitSet.h>
+#include <antlr/misc/KeyPtr.h>
+#include <memory>
+#include <vector>
 
+namespace antlr4 { class NoViableAltException; }
+namespace antlr4 { class Parser; }
+namespace antlr4 { class ParserRuleContext; }
+namespace antlr4 { class RuleContext; }
+namespace antlr4 { class TokenStream; }
+namespace antlr4 { namespace atn { class ActionTransition; } }
+namespace antlr4 { namespace atn { class ATNConfigSet; } }
+namespace antlr4 { namespace atn { class ATNState; } }
+namespace antlr4 { namespace atn { class DecisionState; } }
+namespace antlr4 { namespace atn { class PredicateTransition; } }
+namespace antlr4 { namespace atn { class RuleTransition; } }
+namespace antlr4 { namespace atn { class SemanticContext; } }
+namespace antlr4 { namespace atn { class Transition; } }
+namespace antlr4 { namespace dfa { class DFA; } }
+namespace antlr4 { namespace dfa { class DFAState; } }
+namespace antlr4 { namespace dfa { class FrozenDFA; } }
+
+using namespace antlr4::dfa;
+using namespace antlr4::misc;
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API ParserATNSimulator
+/**
+ * The embodiment of the adaptive LL(*), ALL(*), parsing strategy.
+ * <p/>
+ * The basic complexity of the adaptive strategy makes it harder to understand.
+ * We begin with ATN simulation to build paths in a DFA. Subsequent prediction
+ * requests go through the DFA first. If they reach a state without an edge for
+ * the current symbol, the algorithm fails over to the ATN simulation to
+ * complete the DFA path for the current input (until it finds a conflict state
+ * or uniquely predicting state).
+ * <p/>
+ * All of that is done without using the outer context because we want to
+ * create a DFA that is not dependent upon the rule invocation stack when we do
+ * a prediction. One DFA works in all contexts. We avoid using context not
+ * necessarily because it's slower, although it can be, but because of the DFA
+ * caching problem. The closure routine only considers the rule invocation
+ * stack created during prediction beginning in the decision rule. For example,
+ * if prediction occurs without invoking another rule's ATN, there are no
+ * context stacks in the configurations. When lack of context leads to a
+ * conflict, we don't know if it's an ambiguity or a weakness in the strong
+ * LL(*) parsing strategy (versus full LL(*)).
+ * <p/>
+ * When SLL yields a configuration set with conflict, we rewind the input and
+ * retry the ATN simulation, this time using full outer context without adding
+ * to the DFA. Configuration context stacks will be the full invocation stacks
+ * from the start rule. If we get a conflict using full context, then we can
+ * definitively say we have a true ambiguity for that input sequence. If we
+ * don't get a conflict, it implies that the decision is sensitive to the outer
+ * context. (It is not context-sensitive in the sense of context-sensitive
+ * grammars.)
+ * <p/>
+ * The next time we reach this DFA state with an SLL conflict, through DFA
+ * simulation, we will again retry the ATN simulation using full context mode.
+ * This is slow because we can't save the results and have to "interpret" the
+ * ATN each time we get that input.
+ * <p/>
+ * {@link #getSLLPredictionCount} and {@link #getLLFallbackCount} report how
+ * many predictions were made and how many of them had to fall back to full
+ * context, which tells how much a grammar relies on the slow path.
+ * <p/>
+ * Prediction contexts built during a single prediction are kept in a scratch
+ * cache that is emptied when the prediction ends; only the contexts of
+ * configurations that end up in a DFA state are copied to the shared context
+ * cache.
+ * <p/>
+ * The DFAs in {@code decisionToDFA} and the shared context cache may be
+ * shared by parsers running on different threads, so a DFA warmed up by one
+ * parser speeds up all of them. Prediction follows existing DFA edges
+ * without locking; new states and edges are added while holding
+ * {@link DFA#lock}.
+ */
+class ANTLR_API ParserATNSimulator : public ATNSimulator
 {
 public:
 
+    /** Testing only! */
+    ParserATNSimulator(ANTLR_NOTNULL const ATN* atn,
+                       std::vector<DFA*>& decisionToDFA,
+                       ANTLR_NULLABLE PredictionContextCache* sharedContextCache);
+
+    ParserATNSimulator(ANTLR_NULLABLE Parser* parser,
+                       ANTLR_NOTNULL const ATN* atn,
+                       std::vector<DFA*>& decisionToDFA,
+                       ANTLR_NULLABLE PredictionContextCache* sharedContextCache);
+
+    /** Drops the cached context merges. Call it before clearing the shared
+     *  context cache.
+     */
+    ANTLR_OVERRIDE
+    void reset();
+
+    /** Predicts the alternative to take at {@code decision} for the input
+     *  at the current position of {@code input}, which is left unchanged.
+     *  {@code outerContext} is the invocation stack of the decision rule; it
+     *  is only consulted if the SLL prediction reaches a conflict.
+     *
+     *  @throws NoViableAltException if no alternative matches the input
+     */
+    antlr_int32_t adaptivePredict(ANTLR_NOTNULL TokenStream* input, antlr_int32_t decision,
+                                  ANTLR_NULLABLE ParserRuleContext* outerContext);
+
+    void setPredictionMode(PredictionMode::Mode mode);
+
+    PredictionMode::Mode getPredictionMode() const;
+
+    /** Number of {@link #adaptivePredict} calls, all of which start with SLL
+     *  prediction through the DFA.
+     */
+    antlr_uint32_t getSLLPredictionCount() const;
+
+    /** Number of predictions where SLL reached a conflict and full LL
+     *  prediction was run.
+     */
+    antlr_uint32_t getLLFallbackCount() const;
+
+    /** The cache of context merges, whose hit and miss counts show how much
+     *  merging work predictions share.
+     */
+    const MergeCache& getMergeCache() const;
+
+    /** Resets the prediction counts and the statistics of the merge cache. */
+    void resetPredictionCounters();
+
+protected:
+
+    /** Performs ATN simulation to compute a predicted alternative based
+     *  upon the remaining input, but also updates the DFA cache to avoid
+     *  having to traverse the ATN again for the same input sequence.
+
+     There are some key conditions we're looking for after computing a new
+     set of ATN configs (proposed DFA state):
+           * if the set is empty, there is no viable alternative for current symbol
+           * does the state uniquely predict an alternative?
+           * does the state have a conflict that would prevent us from
+             putting it on the work list?
+
+     We also have some key operations to do:
+           * add an edge from previous DFA state to potentially new DFA state, D,
+             upon current symbol but only if adding to work list, which means in all
+             cases except no viable alternative (and possibly non-greedy decisions?)
+           * collecting predicates and adding semantic context to DFA accept states
+           * adding rule context to context-sensitive DFA accept states
+           * consuming an input symbol
+           * reporting a conflict
+           * reporting an ambiguity
+           * reporting a context sensitivity
+           * reporting insufficient predicates
+
+     cover these cases:
+        dead end
+        single alt
+        single alt + preds
+        conflict
+        conflict + preds
+     */
+    antlr_int32_t execATN(ANTLR_NOTNULL DFA* dfa, ANTLR_NOTNULL const DFAState* s0,
+                          ANTLR_NOTNULL TokenStream* input, antlr_int32_t startIndex,
+                          ANTLR_NULLABLE ParserRuleContext* outerContext);
+
+    /**
+     * Performs the same prediction as {@link #execATN} by walking the frozen
+     * table of {@code dfa}. Since the frozen states have no configurations,
+     * a dead end is reported without dead-end configurations.
+     *
+     * @return the predicted alternative, or {@link ATN#INVALID_ALT_NUMBER}
+     * if the table is missing an edge on the way and the prediction has to
+     * be made by {@link #execATN} instead
+     */
+    antlr_int32_t execFrozenDFA(ANTLR_NOTNULL DFA* dfa, ANTLR_NOTNULL const FrozenDFA* frozen,
+                                ANTLR_NOTNULL TokenStream* input, antlr_int32_t startIndex,
+                                ANTLR_NULLABLE ParserRuleContext* outerContext);
+
+    /**
+     * Get an existing target state for an edge in the DFA. If the target state
+     * for the edge has not yet been computed or is otherwise not available,
+     * this method returns {@code NULL}.
+     *
+     * @param previousD The current DFA state
+     * @param t The next input symbol
+     * @return The existing target DFA state for the given input symbol
+     * {@code t}, or {@code NULL} if the target state for this edge is not
+     * already cached
+     */
+    ANTLR_NULLABLE
+    const DFAState* getExistingTargetState(ANTLR_NOTNULL const DFAState* previousD, antlr_int32_t t) const;
+
+    /**
+     * Compute a target state for an edge in the DFA, and attempt to add the
+     * computed state and corresponding edge to the DFA.
+     *
+     * @param dfa The DFA
+     * @param previousD The current DFA state
+     * @param t The next input symbol
+     *
+     * @return The computed target DFA state for the given input symbol
+     * {@code t}. If {@code t} does not lead to a valid DFA state, this method
+     * returns {@link #ERROR}.
+     */
+    ANTLR_NOTNULL
+    const DFAState* computeTargetState(ANTLR_NOTNULL DFA* dfa, ANTLR_NOTNULL const DFAState* previousD, antlr_int32_t t);
+
+    void predicateDFAState(ANTLR_NOTNULL DFAState* dfaState, ANTLR_NOTNULL const DecisionState* decisionState);
+
+    // comes back with reach.uniqueAlt set to a valid alt
+    antlr_int32_t execATNWithFullContext(ANTLR_NOTNULL DFA* dfa,
+                                         ANTLR_NULLABLE const DFAState* D, // how far we got before failing over
+                                         ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& s0,
+                                         ANTLR_NOTNULL TokenStream* input, antlr_int32_t startIndex,
+                                         ANTLR_NULLABLE ParserRuleContext* outerContext);
+
+    /** Returns the configurations reached from {@code closureConfigs} upon
+     *  {@code t}, or {@code NULL} if there are none.
+     */
+    ANTLR_NULLABLE
+    antlr_auto_ptr<ATNConfigSet> computeReachSet(ANTLR_NOTNULL const ATNConfigSet* closureConfigs, antlr_int32_t t,
+                                                 bool fullCtx);
+
+    /**
+     * Return a configuration set containing only the configurations from
+     * {@code configs} which are in a {@link RuleStopState}. If all
+     * configurations in {@code configs} are already in a rule stop state, this
+     * method simply returns {@code configs}.
+     *
+     * @param configs the configuration set to update
+     *
+     * @return {@code configs} if all configurations in {@code configs} are in a
+     * rule stop state, otherwise return a new configuration set containing only
+     * the configurations from {@code configs} which are in a rule stop state
+     */
+    ANTLR_NOTNULL
+    antlr_auto_ptr<ATNConfigSet> removeAllConfigsNotInRuleStopState(ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& configs);
+
+    ANTLR_NOTNULL
+    antlr_auto_ptr<ATNConfigSet> computeStartState(ANTLR_NOTNULL const ATNState* p,
+                                                   ANTLR_NULLABLE RuleContext* ctx,
+                                                   bool fullCtx);
+
+    ANTLR_NULLABLE
+    const ATNState* getReachableTarget(ANTLR_NOTNULL const Transition* trans, antlr_int32_t ttype) const;
+
+    /** Returns the predicate of each alternative in {@code ambigAlts}, indexed
+     *  by alternative, or {@code NULL} if none of them is predicated. Combined
+     *  predicates are owned by {@link #_dfa}.
+     */
+    ANTLR_NULLABLE
+    antlr_auto_ptr< std::vector<const SemanticContext*> > getPredsForAmbigAlts(const BitSet& ambigAlts,
+                                                                             ANTLR_NOTNULL const ATNConfigSet* configs,
+                                                                             antlr_int32_t nalts);
+
+    /** Fills the predicate list of {@code dfaState} from {@code altToPred}.
+     *
+     *  @return {@code false} if no alternative is actually predicated
+     */
+    bool getPredicatePredictions(const BitSet& ambigAlts,
+                                 const std::vector<const SemanticContext*>& altToPred,
+                                 ANTLR_NOTNULL DFAState* dfaState) const;
+
+    /** Look through a list of predicate/alt pairs, returning alts for the
+     *  pairs that win. A {@code NONE} predicate indicates an alt containing an
+     *  unpredicated config which behaves as "always true." If !complete
+     *  then we stop at the first predicate that evaluates to true. This
+     *  includes pairs with null predicates.
+     */
+    BitSet evalSemanticContext(ANTLR_NOTNULL const DFAState* dfaState,
+                               ANTLR_NULLABLE ParserRuleContext* outerContext,
+                               bool complete);
+
+    /** Same as above for the predicates of {@code state} in a frozen table */
+    BitSet evalSemanticContext(const FrozenDFA& frozen, antlr_int32_t state,
+                               ANTLR_NULLABLE ParserRuleContext* outerContext,
+                               bool complete);
+
+    /* TODO: If we are doing predicates, there is no point in pursuing
+         closure operations if we reach a DFA state that uniquely predicts
+         alternative. We will not be caching that DFA state and it is a
+         waste to pursue the closure. Might have to advance when we do
+         ambig detection thought :(
+      */
+
+    /** Adds the closure of {@code config} to {@code configs}. The configs
+     *  still being expanded are kept on {@link #closureStack} rather than
+     *  the native stack, and visited in the order a recursive walk would.
+     */
+    void closure(const ATNConfig& config,
+                 ANTLR_NOTNULL ATNConfigSet* configs,
+                 ClosureBusySet& closureBusy,
+                 bool collectPredicates,
+                 bool fullCtx);
+
+    /** Enters {@code config}: pushes a frame over the return states of its
+     *  context if it is in a rule stop state, otherwise continues with
+     *  {@link #closure_}.
+     */
+    void closureCheckingStopState(const ATNConfig& config,
+                                  ANTLR_NOTNULL ATNConfigSet* configs,
+                                  bool collectPredicates,
+                                  bool fullCtx,
+                                  antlr_int32_t depth);
+
+    /** Adds {@code config} to {@code configs} if it has non-epsilon edges,
+     *  and pushes a frame that walks its epsilon edges.
+     */
+    void closure_(const ATNConfig& config,
+                  ANTLR_NOTNULL ATNConfigSet* configs,
+                  bool collectPredicates,
+                  antlr_int32_t depth);
+
+    /** Computes the configuration reached from {@code config} by following
+     *  the epsilon transition {@code t}, storing it in {@code c}.
+     *
+     *  @return {@code false} if {@code t} can't be followed
+     */
+    bool getEpsilonTarget(const ATNConfig& config,
+                          ANTLR_NOTNULL const Transition* t,
+                          bool collectPredicates,
+                          bool inContext,
+                          bool fullCtx,
+                          ATNConfig& c);
+
+    void actionTransition(const ATNConfig& config, ANTLR_NOTNULL const ActionTransition* t, ATNConfig& c) const;
+
+    bool predTransition(const ATNConfig& config,
+                        ANTLR_NOTNULL const PredicateTransition* pt,
+                        bool collectPredicates,
+                        bool inContext,
+                        bool fullCtx,
+                        ATNConfig& c);
+
+    void ruleTransition(const ATNConfig& config, ANTLR_NOTNULL const RuleTransition* t, ATNConfig& c);
+
+    BitSet getConflictingAlts(ANTLR_NOTNULL const ATNConfigSet* configs) const;
+
+    /**
+     Sam pointed out a problem with the previous definition, v3, of
+     ambiguous states. If we have another state associated with conflicting
+     alternatives, we should keep going. For example, the following grammar
+
+     s : (ID | ID ID?) ';' ;
+
+     When the ATN simulation reaches the state before ';', it has a DFA
+     state that looks like: [12|1|[], 6|2|[], 12|2|[]]. Naturally
+     12|1|[] and 12|2|[] conflict, but we cannot stop processing this node
+     because alternative to has another way to continue, via [6|2|[]].
+     The key is that we have a single state that has config's only associated
+     with a single alternative, 2, and crucially the state transitions
+     among the configurations are all non-epsilon transitions. That means
+     we don't consider any conflicts that include alternative 2. So, we
+     ignore the conflict between alts 1 and 2. We ignore a set of
+     conflicting alts when there is an intersection with an alternative
+     associated with a single alt state in the state->config-list map.
+
+     It's also the case that we might have two conflicting configurations but
+     also a 3rd nonconflicting configuration for a different alternative:
+     [1|1|[], 1|2|[], 8|3|[]]. This can come about from grammar:
+
+     a : A | A | A B ;
+
+     After matching input A, we reach the stop state for rule A, state 1.
+     State 8 is the state right before B. Clearly alternatives 1 and 2
+     conflict and no amount of further lookahead will separate the two.
+     However, alternative 3 will be able to continue and so we do not
+     stop working on this state. In the previous example, we're concerned
+     with states associated with the conflicting alternatives. Here alt
+     3 is not associated with the conflicting configs, but since we can continue
+     looking for input reasonably, I don't declare the state done. We
+     ignore a set of conflicting alts when we have an alternative
+     that we still need to pursue.
+     */
+    BitSet getConflictingAltsOrUniqueAlt(ANTLR_NOTNULL const ATNConfigSet* configs) const;
+
+    NoViableAltException noViableAlt(ANTLR_NOTNULL TokenStream* input,
+                                     ANTLR_NULLABLE ParserRuleContext* outerContext,
+                                     ANTLR_NULLABLE const ATNConfigSet* configs,
+                                     antlr_int32_t startIndex) const;
+
+    static antlr_int32_t getUniqueAlt(ANTLR_NOTNULL const ATNConfigSet* configs);
+
+    /**
+     * Add an edge to the DFA, if possible. This method calls
+     * {@link #addDFAState} to ensure the {@code to} state is present in the
+     * DFA. If {@code from} is {@code NULL}, or if {@code t} is outside the
+     * range of edges that can be represented in the DFA tables, this method
+     * returns without adding the edge to the DFA.
+     * <p/>
+     * If {@code to} is {@link #ERROR}, the edge records the dead end and
+     * {@code ERROR} is returned. Otherwise {@code to} is a proposed state
+     * owned by the caller; see {@link #addDFAState}. Takes {@link DFA#lock}
+     * while changing the DFA.
+     *
+     * @param dfa The DFA
+     * @param from The source state for the edge
+     * @param t The input symbol
+     * @param to The target state for the edge
+     *
+     * @return The state stored in the DFA for {@code to}, which may be an
+     * existing state equal to it.
+     */
+    ANTLR_NOTNULL
+    const DFAState* addDFAEdge(ANTLR_NOTNULL DFA* dfa,
+                               ANTLR_NULLABLE const DFAState* from,
+                               antlr_int32_t t,
+                               ANTLR_NOTNULL DFAState* to);
+
+    /**
+     * Add state {@code D} to the DFA if it is not already present, and return
+     * the actual instance stored in the DFA. If a state equivalent to {@code D}
+     * is already in the DFA, the existing state is returned and {@code D} is
+     * left untouched. Otherwise the contents of {@code D} are moved into a new
+     * state allocated by {@link DFA#addState}, and its configurations are
+     * moved to the shared context cache. {@code D} remains owned by the
+     * caller either way.
+     * <p/>
+     * If {@code D} is {@link #ERROR}, this method returns {@link #ERROR} and
+     * does not change the DFA. The caller must hold {@link DFA#lock}.
+     *
+     * @param dfa The dfa
+     * @param D The DFA state to add
+     * @return The state stored in the DFA. This will be either the existing
+     * state if {@code D} is already in the DFA, or the new state holding the
+     * contents of {@code D}.
+     */
+    ANTLR_NOTNULL
+    const DFAState* addDFAState(ANTLR_NOTNULL DFA* dfa, ANTLR_NOTNULL DFAState* D);
+
+private:
+
+    ParserATNSimulator(const ParserATNSimulator&);
+
+    ParserATNSimulator& operator=(const ParserATNSimulator&);
+
+protected:
+
+    ANTLR_NULLABLE
+    Parser* const parser;
+
+    std::vector<DFA*>& decisionToDFA;
+
+    /** SLL, LL, or LL + exact ambig detection? */
+    PredictionMode::Mode mode;
+
+    /** Caches the merges of prediction contexts. {@link MergeCache}
+     *  isn't synchronized but we're ok since two threads shouldn't reuse same
+     *  parser/atnsim object because it can only handle one input at a time.
+     *  Its size is bounded, so it is kept across predictions; after each one
+     *  the entries referring to {@link #transientContexts} are dropped, while
+     *  merges of contexts from the shared context cache stay cached. It
+     *  counts the entries of {@link #transientContexts}, so a prediction
+     *  that created none doesn't scan it.
+     */
+    MergeCache mergeCache;
+
+    /** Owns the prediction contexts created during the current prediction
+     *  that the shared context cache doesn't already hold. Cleared along
+     *  with {@link #mergeCache} once the prediction is done.
+     */
+    PredictionContextCache transientContexts;
+
+    /** Holds the lookup tables of the configuration sets built during the
+     *  current prediction. Reset along with {@link #mergeCache}.
+     */
+    Arena predictionArena;
+
+    /** The configs visited by the current closure operation, indexed by
+     *  state number; reset before each closure instead of allocated.
+     */
+    ClosureBusySet closureBusy;
+
+    // LAME globals to avoid parameters!!!!! I need these down deep in predTransition
+    ANTLR_NULLABLE
+    TokenStream* _input;
+
+    antlr_int32_t _startIndex;
+
+    ANTLR_NULLABLE
+    ParserRuleContext* _outerContext;
+
+    /** The DFA of the current prediction; owns combined semantic contexts */
+    ANTLR_NULLABLE
+    DFA* _dfa;
+
+    antlr_uint32_t sllPredictions;
+
+    antlr_uint32_t llFallbacks;
 };
 
 
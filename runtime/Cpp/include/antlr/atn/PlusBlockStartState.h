@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,35 @@
  * Gael Hatchue
  */
 
+
 #ifndef PLUS_BLOCK_START_STATE_H
 #define PLUS_BLOCK_START_STATE_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/BlockStartState.h>
 
+namespace antlr4 { namespace atn { class PlusLoopbackState; } }
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API PlusBlockStartState
+/** Start of {@code (A|B|...)+} loop. Technically a decision state, but
+ *  we don't use for code generation; somebody might need it, so I'm defining
+ *  it for completeness. In reality, the {@link PlusLoopbackState} node is the
+ *  real decision-making note for {@code A+}.
+ */
+class ANTLR_API PlusBlockStartState : public BlockStartState
 {
 public:
 
+    PlusBlockStartState();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStateType() const;
+
+public:
+
+    const PlusLoopbackState* loopBackState;
 };
 
 
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,27 @@
  * Gael Hatchue
  */
 
+
 #ifndef PLUS_LOOPBACK_STATE_H
 #define PLUS_LOOPBACK_STATE_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/DecisionState.h>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API PlusLoopbackState
+/** Decision state for {@code A+} and {@code (A|B)+}.  It has two transitions:
+ *  one to the loop back to start of the block and one to exit.
+ */
+class ANTLR_API PlusLoopbackState : public DecisionState
 {
 public:
 
+    PlusLoopbackState();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStateType() const;
 };
 
 
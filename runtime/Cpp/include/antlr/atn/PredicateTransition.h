@@ -50,16 +50,8 @@ public:
     PredicateTransition(ANTLR_NOTNULL const ATNState* target, antlr_int32_t ruleIndex,
             antlr_int32_t predIndex, bool isCtxDependent);
 
-    ANTLR_OVERRIDE
-    antlr_int32_t getSerializationType() const;
-
-    ANTLR_OVERRIDE
-    bool isEpsilon() const;
-
-    ANTLR_OVERRIDE
-    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const;
-
-    antlr_auto_ptr<SemanticContext::Predicate> getPredicate() const;
+    ANTLR_NOTNULL
+    const SemanticContext::Predicate* getPredicate() const;
 
     ANTLR_OVERRIDE
     std::string toString() const;
@@ -67,7 +59,10 @@ public:
 public:
     const antlr_int32_t ruleIndex;
     const antlr_int32_t predIndex;
-    const bool isCtxDependent;  // e.g., $i ref in pred    
+    const bool isCtxDependent;  // e.g., $i ref in pred
+
+protected:
+    const SemanticContext::Predicate predicate;
 };
 
 
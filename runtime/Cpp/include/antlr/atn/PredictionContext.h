@@ -33,34 +33,279 @@
  * Gael Hatchue
  */
 
+
 #ifndef PREDICTION_CONTEXT_H
 #define PREDICTION_CONTEXT_H
 
 #include <antlr/Definitions.h>
-#include <antlr/misc/DoubleKeyMap.h>
+#include <antlr/misc/HashMap.h>
 #include <antlr/misc/Key.h>
 #include <antlr/misc/KeyPtr.h>
 #include <string>
+#include <vector>
+
+namespace antlr4 { class RuleContext; }
+namespace antlr4 { namespace atn { class ATN; } }
+namespace antlr4 { namespace atn { class MergeCache; } }
+namespace antlr4 { namespace atn { class PredictionContextCache; } }
+namespace antlr4 { namespace atn { class SingletonPredictionContext; } }
+namespace antlr4 { namespace atn { class ArrayPredictionContext; } }
 
 using namespace antlr4::misc;
 
 namespace antlr4 {
 namespace atn {
 
+/** A node of the graph-structured stack of rule invocations tracked by the
+ *  ATN simulators.  Contexts are immutable once created; they are owned by
+ *  the {@link PredictionContextCache} they were added to, except for
+ *  {@link #EMPTY} which is a static instance.
+ * <p/>
+ *  A cache never holds two equal contexts, so contexts interned in the same
+ *  cache compare by identity; {@link #equals} only walks the graph when the
+ *  contexts come from different caches or were never added to one.
+ */
 class ANTLR_API PredictionContext : public virtual Key<PredictionContext>
 {
 public:
-    
-    std::string toString() const { return std::string(); }
-
-    static PredictionContext* merge(
-        const PredictionContext*, const PredictionContext*,
-        bool,
-        DoubleKeyMap< KeyPtr<PredictionContext>,KeyPtr<PredictionContext>,KeyPtr<PredictionContext> >*)
-    {
-        return NULL;
-    }
-    
+
+    ANTLR_OVERRIDE
+    ~PredictionContext();
+
+    virtual antlr_int32_t size() const = 0;
+
+    ANTLR_NULLABLE
+    virtual const PredictionContext* getParent(antlr_int32_t index) const = 0;
+
+    virtual antlr_int32_t getReturnState(antlr_int32_t index) const = 0;
+
+    /** This means only the {@link #EMPTY} context is in set. */
+    virtual bool isEmpty() const;
+
+    bool hasEmptyPath() const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t hashCode() const;
+
+    ANTLR_OVERRIDE
+    PredictionContext* clone() const;
+
+    ANTLR_OVERRIDE
+    std::string toString() const = 0;
+
+    /** Convert a {@link RuleContext} tree to a {@link PredictionContext} graph.
+     *  Return {@link #EMPTY} if {@code outerContext} is empty or null.
+     *  New contexts are added to {@code contextCache}, which owns them.
+     */
+    ANTLR_NOTNULL
+    static const PredictionContext* fromRuleContext(ANTLR_NOTNULL const ATN* atn,
+                                                    ANTLR_NULLABLE const RuleContext* outerContext,
+                                                    ANTLR_NOTNULL PredictionContextCache* contextCache);
+
+    /** Merges two context graphs. Any context created by the merge is added
+     *  to {@code contextCache}, which owns it; the result is therefore valid
+     *  for as long as {@code a}, {@code b} and {@code contextCache} are.
+     *  Results are looked up in and recorded into {@code mergeCache}, if any.
+     */
+    ANTLR_NOTNULL
+    static const PredictionContext* merge(
+        ANTLR_NOTNULL const PredictionContext* a, ANTLR_NOTNULL const PredictionContext* b,
+        bool rootIsWildcard,
+        ANTLR_NULLABLE MergeCache* mergeCache,
+        ANTLR_NOTNULL PredictionContextCache* contextCache);
+
+    /**
+     * Merge two {@link SingletonPredictionContext} instances.
+     *
+     * <p/>
+     *
+     * Stack tops equal, parents merge is same; return left graph.<br/>
+     * <embed src="images/SingletonMerge_SameRootSamePar.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Same stack top, parents differ; merge parents giving array node, then
+     * remainders of those graphs. A new root node is created to point to the
+     * merged parents.<br/>
+     * <embed src="images/SingletonMerge_SameRootDiffPar.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Different stack tops pointing to same parent. Make array node for the
+     * root where both element in the root point to the same (original)
+     * parent.<br/>
+     * <embed src="images/SingletonMerge_DiffRootSamePar.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Different stack tops pointing to different parents. Make array node for
+     * the root where each element points to the corresponding original
+     * parent.<br/>
+     * <embed src="images/SingletonMerge_DiffRootDiffPar.svg" type="image/svg+xml"/>
+     *
+     * @param a the first {@link SingletonPredictionContext}
+     * @param b the second {@link SingletonPredictionContext}
+     * @param rootIsWildcard {@code true} if this is a local-context merge,
+     * otherwise false to indicate a full-context merge
+     * @param mergeCache
+     */
+    ANTLR_NOTNULL
+    static const PredictionContext* mergeSingletons(
+        ANTLR_NOTNULL const SingletonPredictionContext* a, ANTLR_NOTNULL const SingletonPredictionContext* b,
+        bool rootIsWildcard,
+        ANTLR_NULLABLE MergeCache* mergeCache,
+        ANTLR_NOTNULL PredictionContextCache* contextCache);
+
+    /**
+     * Handle case where at least one of {@code a} or {@code b} is
+     * {@link #EMPTY}. In the following diagrams, the symbol {@code $} is used
+     * to represent {@link #EMPTY}.
+     *
+     * <h2>Local-Context Merges</h2>
+     *
+     * These local-context merge operations are used when {@code rootIsWildcard}
+     * is true.
+     *
+     * <p/>
+     *
+     * {@link #EMPTY} is superset of any graph; return {@link #EMPTY}.<br/>
+     * <embed src="images/LocalMerge_EmptyRoot.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * {@link #EMPTY} and anything is {@code #EMPTY}, so merged parent is
+     * {@code #EMPTY}; return left graph.<br/>
+     * <embed src="images/LocalMerge_EmptyParent.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Special case of last merge if local context.<br/>
+     * <embed src="images/LocalMerge_DiffRoots.svg" type="image/svg+xml"/>
+     *
+     * <h2>Full-Context Merges</h2>
+     *
+     * These full-context merge operations are used when {@code rootIsWildcard}
+     * is false.
+     *
+     * <p/>
+     *
+     * <embed src="images/FullMerge_EmptyRoots.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Must keep all contexts; {@link #EMPTY} in array is a special value (and
+     * null parent).<br/>
+     * <embed src="images/FullMerge_EmptyRoot.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * <embed src="images/FullMerge_SameRoot.svg" type="image/svg+xml"/>
+     *
+     * @param a the first {@link SingletonPredictionContext}
+     * @param b the second {@link SingletonPredictionContext}
+     * @param rootIsWildcard {@code true} if this is a local-context merge,
+     * otherwise false to indicate a full-context merge
+     */
+    ANTLR_NULLABLE
+    static const PredictionContext* mergeRoot(
+        ANTLR_NOTNULL const SingletonPredictionContext* a, ANTLR_NOTNULL const SingletonPredictionContext* b,
+        bool rootIsWildcard,
+        ANTLR_NOTNULL PredictionContextCache* contextCache);
+
+    /**
+     * Merge two {@link ArrayPredictionContext} instances.
+     *
+     * <p/>
+     *
+     * Different tops, different parents.<br/>
+     * <embed src="images/ArrayMerge_DiffTopDiffPar.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Shared top, same parents.<br/>
+     * <embed src="images/ArrayMerge_ShareTopSamePar.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Shared top, different parents.<br/>
+     * <embed src="images/ArrayMerge_ShareTopDiffPar.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Shared top, all shared parents.<br/>
+     * <embed src="images/ArrayMerge_ShareTopSharePar.svg" type="image/svg+xml"/>
+     *
+     * <p/>
+     *
+     * Equal tops, merge parents and reduce top to
+     * {@link SingletonPredictionContext}.<br/>
+     * <embed src="images/ArrayMerge_EqualTop.svg" type="image/svg+xml"/>
+     */
+    ANTLR_NOTNULL
+    static const PredictionContext* mergeArrays(
+        ANTLR_NOTNULL const ArrayPredictionContext* a, ANTLR_NOTNULL const ArrayPredictionContext* b,
+        bool rootIsWildcard,
+        ANTLR_NULLABLE MergeCache* mergeCache,
+        ANTLR_NOTNULL PredictionContextCache* contextCache);
+
+    /** Returns the copy of {@code context} owned by {@code contextCache},
+     *  adding copies of {@code context} and of any of its ancestors that the
+     *  cache doesn't hold yet. {@code visited} maps contexts already handled
+     *  in this pass to their cached copy.
+     */
+    ANTLR_NOTNULL
+    static const PredictionContext* getCachedContext(
+        ANTLR_NOTNULL const PredictionContext* context,
+        ANTLR_NOTNULL PredictionContextCache* contextCache,
+        HashMap<const PredictionContext*, const PredictionContext*>& visited);
+
+protected:
+
+    PredictionContext(antlr_int32_t cachedHashCode);
+
+    /** Returns {@code true} if this context and {@code other} are held by
+     *  the same {@link PredictionContextCache}, in which case they are equal
+     *  only if they are the same object.
+     */
+    bool isInternedWith(ANTLR_NOTNULL const PredictionContext* other) const;
+
+    static antlr_int32_t calculateEmptyHashCode();
+
+    static antlr_int32_t calculateHashCode(ANTLR_NOTNULL const PredictionContext* parent, antlr_int32_t returnState);
+
+    static antlr_int32_t calculateHashCode(const std::vector<const PredictionContext*>& parents,
+                                           const std::vector<antlr_int32_t>& returnStates);
+
+private:
+
+    PredictionContext(const PredictionContext&);
+
+    PredictionContext& operator=(const PredictionContext&);
+
+public:
+
+    /** Represents {@code $} in local context prediction, which means wildcard.
+     *  {@code *+x = *}.
+     */
+    static const PredictionContext* const EMPTY;
+
+    /** Represents {@code $} in an array in full context mode, when {@code $}
+     *  doesn't mean wildcard: {@code $ + x = [$,x]}. Here,
+     *  {@code $} = {@link #EMPTY_RETURN_STATE}.
+     */
+    static const antlr_int32_t EMPTY_RETURN_STATE;
+
+    const antlr_int32_t cachedHashCode;
+
+private:
+
+    friend class PredictionContextCache;
+
+    /** The cache this context was interned in, set when it is added. */
+    ANTLR_NULLABLE
+    const PredictionContextCache* owner;
+
+    static const antlr_int32_t INITIAL_HASH;
 };
 
 
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,107 @@
  * Gael Hatchue
  */
 
+
 #ifndef PREDICTION_CONTEXT_CACHE_H
 #define PREDICTION_CONTEXT_CACHE_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/PredictionContext.h>
+#include <antlr/misc/HashMap.h>
+#include <antlr/misc/KeyPtr.h>
+#include <antlr/misc/Mutex.h>
 
+using namespace antlr4::misc;
 
 namespace antlr4 {
 namespace atn {
 
+/** Used to cache {@link PredictionContext} objects. Its used for the shared
+ *  context cash associated with contexts in DFA states. This cache
+ *  can be used for both lexers and parsers.
+ * <p/>
+ *  The cache hash-conses contexts: it never holds two equal contexts, so two
+ *  contexts interned in the same cache are equal only if they are the same
+ *  object (see {@link PredictionContext#equals}). The cache owns every
+ *  context added to it; contexts live until the cache is cleared or
+ *  destroyed.
+ * <p/>
+ *  All operations are synchronized, so one cache can be shared by
+ *  recognizers running on different threads. The contexts are spread over
+ *  {@link #SHARD_COUNT} independently locked shards, chosen by hash code,
+ *  so threads interning different contexts rarely contend for a lock.
+ */
 class ANTLR_API PredictionContextCache
 {
 public:
 
+    PredictionContextCache();
+
+    /** Creates a cache that returns the contexts of {@code sharedCache}
+     *  instead of adding equal contexts of its own. Used for the contexts
+     *  created during a single prediction, which are thrown away afterwards
+     *  while the shared cache keeps the contexts of the DFA states.
+     */
+    PredictionContextCache(ANTLR_NULLABLE const PredictionContextCache* sharedCache);
+
+    ~PredictionContextCache();
+
+    /** Add a context to the cache and return it. If the context already exists,
+     *  return that one instead and do not add a new context to the cache.
+     *  The cache takes ownership of {@code ctx}; when an equal context is
+     *  already cached, {@code ctx} is deleted.
+     */
+    const PredictionContext* add(ANTLR_NOTNULL const PredictionContext* ctx);
+
+    ANTLR_NULLABLE
+    const PredictionContext* get(ANTLR_NOTNULL const PredictionContext* ctx) const;
+
+    /** Returns {@code true} if {@code ctx} was interned in this cache. */
+    bool owns(ANTLR_NOTNULL const PredictionContext* ctx) const;
+
+    antlr_int32_t size() const;
+
+    /** Deletes every context held by this cache. */
+    void clear();
+
+private:
+
+    PredictionContextCache(const PredictionContextCache&);
+
+    PredictionContextCache& operator=(const PredictionContextCache&);
+
+protected:
+
+    typedef HashMap<KeyPtr<PredictionContext>, const PredictionContext*> ContextHashMap;
+
+    struct Shard
+    {
+        ContextHashMap cache;
+
+        Mutex mutex;
+    };
+
+    /** Returns the shard holding contexts with the hash code of {@code ctx}.
+     *  Uses the high bits of the hash code, the low ones pick the bucket
+     *  within the shard.
+     */
+    Shard& shardFor(ANTLR_NOTNULL const PredictionContext* ctx) const;
+
+    ANTLR_NULLABLE
+    const PredictionContext* getLocal(ANTLR_NOTNULL const PredictionContext* ctx) const;
+
+public:
+
+    static const antlr_uint32_t SHARD_BITS = 4;
+
+    static const antlr_uint32_t SHARD_COUNT = 1 << SHARD_BITS;
+
+protected:
+
+    ANTLR_NULLABLE
+    const PredictionContextCache* sharedCache;
+
+    mutable Shard shards[SHARD_COUNT];
 };
 
 
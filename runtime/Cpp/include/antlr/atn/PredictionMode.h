@@ -37,15 +37,171 @@
 #define PREDICTION_MODE_H
 
 #include <antlr/Definitions.h>
+#include <antlr/misc/BitSet.h>
+#include <antlr/misc/HashMap.h>
+#include <memory>
+#include <vector>
 
+namespace antlr4 { namespace atn { class ATN; } }
+namespace antlr4 { namespace atn { class ATNConfigSet; } }
+namespace antlr4 { namespace atn { class PredictionContextCache; } }
+
+using namespace antlr4::misc;
 
 namespace antlr4 {
 namespace atn {
 
+/**
+ * This class provides the prediction modes used by {@link ParserATNSimulator}
+ * and the helpers it uses to decide when SLL prediction can stop.
+ */
 class ANTLR_API PredictionMode
 {
 public:
 
+    enum Mode
+    {
+        /** Do only local context prediction (SLL style) and using
+         *  heuristic which almost always works but is much faster
+         *  than precise answer.
+         */
+        SLL,
+
+        /** Full LL(*) that always gets right answer. For speed
+         *  reasons, we terminate the prediction process when we know for
+         *  sure which alt to predict. We don't always know what
+         *  the ambiguity is in this mode.
+         */
+        LL,
+
+        /** Tell the full LL prediction algorithm to pursue lookahead until
+         *  it has uniquely predicted an alternative without conflict or it's
+         *  certain that it's found an ambiguous input sequence.  when this
+         *  variable is false. When true, the prediction process will
+         *  continue looking for the exact ambiguous sequence even if
+         *  it has already figured out which alternative to predict.
+         */
+        LL_EXACT_AMBIG_DETECTION
+    };
+
+    typedef std::vector<BitSet> AltSubsets;
+
+public:
+
+    /**
+     * Computes the SLL prediction termination condition.
+     * <p/>
+     * This method computes the SLL prediction termination condition for both of
+     * the following cases.
+     * <ul>
+     * <li>The usual SLL+LL fallback upon SLL conflict</li>
+     * <li>Pure SLL without LL fallback</li>
+     * </ul>
+     * <p/>
+     * In pure SLL mode, configurations that differ only by their semantic
+     * context are first combined; the contexts created while doing so are
+     * added to {@code contextCache}.
+     * <p/>
+     * Assuming combined SLL+LL parsing, an SLL configuration set with only
+     * conflicting subsets should fall back to full LL, even if the
+     * configuration sets don't resolve to the same alternative (e.g.
+     * {@code {1,2}} and {@code {3,4}}. If there is at least one non-conflicting
+     * configuration, SLL could continue with the hopes that more lookahead will
+     * resolve via one of those non-conflicting configurations.
+     */
+    static bool hasSLLConflictTerminatingPrediction(Mode mode, ANTLR_NOTNULL const ATN* atn,
+                                                    ANTLR_NOTNULL const ATNConfigSet* configs,
+                                                    ANTLR_NOTNULL PredictionContextCache* contextCache);
+
+    /**
+     * Checks if any configuration in {@code configs} is in a
+     * {@link RuleStopState}. Configurations meeting this condition have reached
+     * the end of the decision rule (local context) or end of start rule (full
+     * context).
+     */
+    static bool hasConfigInRuleStopState(ANTLR_NOTNULL const ATN* atn, ANTLR_NOTNULL const ATNConfigSet* configs);
+
+    /**
+     * Checks if all configurations in {@code configs} are in a
+     * {@link RuleStopState}. Configurations meeting this condition have reached
+     * the end of the decision rule (local context) or end of start rule (full
+     * context).
+     */
+    static bool allConfigsInRuleStopStates(ANTLR_NOTNULL const ATN* atn, ANTLR_NOTNULL const ATNConfigSet* configs);
+
+    /**
+     * Full LL prediction termination.
+     * <p/>
+     * Can we stop looking ahead during ATN simulation or is there some
+     * uncertainty as to which alternative we will ultimately pick, after
+     * consuming more input? Returns the unique alternative predicted by all
+     * subsets if they resolve to a single viable alternative, otherwise
+     * {@link ATN#INVALID_ALT_NUMBER}.
+     */
+    static antlr_int32_t resolvesToJustOneViableAlt(const AltSubsets& altsets);
+
+    /** Determines if every alternative subset in {@code altsets} contains more
+     *  than one alternative.
+     */
+    static bool allSubsetsConflict(const AltSubsets& altsets);
+
+    /** Determines if any single alternative subset in {@code altsets} contains
+     *  exactly one alternative.
+     */
+    static bool hasNonConflictingAltSet(const AltSubsets& altsets);
+
+    /** Determines if any single alternative subset in {@code altsets} contains
+     *  more than one alternative.
+     */
+    static bool hasConflictingAltSet(const AltSubsets& altsets);
+
+    /** Determines if every alternative subset in {@code altsets} is equivalent. */
+    static bool allSubsetsEqual(const AltSubsets& altsets);
+
+    /** Returns the unique alternative predicted by all alternative subsets in
+     *  {@code altsets}. If no such alternative exists, this method returns
+     *  {@link ATN#INVALID_ALT_NUMBER}.
+     */
+    static antlr_int32_t getUniqueAlt(const AltSubsets& altsets);
+
+    /** Gets the complete set of represented alternatives for a collection of
+     *  alternative subsets. This method returns the union of each {@link BitSet}
+     *  in {@code altsets}.
+     */
+    static BitSet getAlts(const AltSubsets& altsets);
+
+    /**
+     * This function gets the conflicting alt subsets from a configuration set.
+     * For each configuration {@code c} in {@code configs}:
+     *
+     * <pre>
+     * map[c] U= c.{@link ATNConfig#alt alt} # map hash/equals uses s and x, not
+     * alt and not pred
+     * </pre>
+     * Sets that {@link ATNConfigSet#tracksAltSubsets track} the subsets as
+     * configs are added return them without scanning the configs.
+     */
+    ANTLR_NOTNULL
+    static antlr_auto_ptr<AltSubsets> getConflictingAltSubsets(ANTLR_NOTNULL const ATNConfigSet* configs);
+
+    /**
+     * Get a map from state to alt subset from a configuration set. For each
+     * configuration {@code c} in {@code configs}:
+     *
+     * <pre>
+     * map[c.{@link ATNConfig#stateNumber stateNumber}] U= c.{@link ATNConfig#alt alt}
+     * </pre>
+     */
+    ANTLR_NOTNULL
+    static antlr_auto_ptr< HashMap<antlr_int32_t, BitSet> > getStateToAltMap(ANTLR_NOTNULL const ATNConfigSet* configs);
+
+    static bool hasStateAssociatedWithOneAlt(ANTLR_NOTNULL const ATNConfigSet* configs);
+
+    static antlr_int32_t getSingleViableAlt(const AltSubsets& altsets);
+
+private:
+
+    PredictionMode();
 };
 
 
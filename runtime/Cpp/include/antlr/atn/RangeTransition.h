@@ -47,16 +47,10 @@ class ANTLR_API RangeTransition : public Transition
 public:
     RangeTransition(ANTLR_NOTNULL const ATNState* target, antlr_int32_t from, antlr_int32_t to);
 
-    ANTLR_OVERRIDE
-    antlr_int32_t getSerializationType() const;
-
     ANTLR_OVERRIDE
     ANTLR_NOTNULL
     antlr_auto_ptr<IntervalSet> label() const;
 
-    ANTLR_OVERRIDE
-    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const;
-
     ANTLR_OVERRIDE
     std::string toString() const;
     
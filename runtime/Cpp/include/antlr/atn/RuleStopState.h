@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,29 @@
  * Gael Hatchue
  */
 
+
 #ifndef RULE_STOP_STATE_H
 #define RULE_STOP_STATE_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/ATNState.h>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API RuleStopState
+/** The last node in the ATN for a rule, unless that rule is the start symbol.
+ *  In that case, there is one transition to EOF. Later, we might encode
+ *  references to all calls to this rule to compute FOLLOW sets for
+ *  error handling.
+ */
+class ANTLR_API RuleStopState : public ATNState
 {
 public:
 
+    RuleStopState();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStateType() const;
 };
 
 
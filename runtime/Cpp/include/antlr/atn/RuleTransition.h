@@ -51,13 +51,7 @@ public:
                    ANTLR_NOTNULL const ATNState* followState);
     
     ANTLR_OVERRIDE
-    antlr_int32_t getSerializationType() const;
-    
-    ANTLR_OVERRIDE
-    bool isEpsilon() const;
-    
-    ANTLR_OVERRIDE
-    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const;
+    std::string toString() const;
     
 public:
     /** Ptr to the rule definition object for this rule ref */
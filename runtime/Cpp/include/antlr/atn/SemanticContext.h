@@ -39,42 +39,166 @@
 #include <antlr/Definitions.h>
 #include <antlr/misc/Key.h>
 #include <string>
+#include <vector>
 
+namespace antlr4 { class Parser; }
+namespace antlr4 { class RuleContext; }
+namespace antlr4 { namespace atn { class SemanticContextCache; } }
 
 using namespace antlr4::misc;
 
 namespace antlr4 {
 namespace atn {
 
+/** A tree structure used to record the semantic context in which
+ *  an ATN configuration is valid.  It's either a single predicate,
+ *  a conjunction {@code p1&&p2}, or a sum of products {@code p1||p2}.
+ * <p/>
+ *  I have scoped the {@link AND}, {@link OR}, and {@link Predicate} subclasses of
+ *  {@link SemanticContext} within the scope of this outer class.
+ * <p/>
+ *  Contexts built by {@link #and_} and {@link #or_} only point to their
+ *  operands and are interned in, and owned by, the {@code cache} passed in.
+ */
 class ANTLR_API SemanticContext : public virtual Key<SemanticContext>
 {
 public:
 
-    SemanticContext() { }
-    
-    SemanticContext(const SemanticContext&) : Key<SemanticContext>() { }
-    
+    class Predicate;
+
+    class AND;
+
+    class OR;
+
+public:
+
+    ANTLR_OVERRIDE
+    ~SemanticContext();
+
+    /**
+     * For context independent predicates, we evaluate them without a local
+     * context (i.e., null context). That way, we can evaluate them without
+     * having to create proper rule-specific context during prediction (as
+     * opposed to the parser, which creates them naturally). In a practical
+     * sense, this avoids a cast exception from RuleContext to myruleContext.
+     * <p/>
+     * For context dependent predicates, we must pass in a local context so that
+     * references such as $arg evaluate properly as _localctx.arg. We only
+     * capture context dependent predicates in the context in which we begin
+     * prediction, so we passed in the outer context here in case of context
+     * dependent predicate evaluation.
+     */
+    virtual bool eval(ANTLR_NULLABLE Parser* parser, ANTLR_NULLABLE RuleContext* outerContext) const = 0;
+
+    ANTLR_OVERRIDE
+    SemanticContext* clone() const;
+
+    virtual std::string toString() const = 0;
+
+    ANTLR_NULLABLE
+    static const SemanticContext* and_(ANTLR_NULLABLE const SemanticContext* a,
+                                       ANTLR_NULLABLE const SemanticContext* b,
+                                       SemanticContextCache& cache);
+
+    /**
+     *
+     *  @see ParserATNSimulator#getPredsForAmbigAlts
+     */
+    ANTLR_NULLABLE
+    static const SemanticContext* or_(ANTLR_NULLABLE const SemanticContext* a,
+                                      ANTLR_NULLABLE const SemanticContext* b,
+                                      SemanticContextCache& cache);
+
+protected:
+
+    SemanticContext();
+
+private:
+
+    SemanticContext(const SemanticContext&);
+
+    SemanticContext& operator=(const SemanticContext&);
+
+public:
+
+    /**
+     * The default {@link SemanticContext}, which is semantically equivalent to
+     * a predicate of the form {@code {true}?}.
+     */
+    static const Predicate NONE;
+};
+
+class ANTLR_API SemanticContext::Predicate : public SemanticContext
+{
+public:
+
+    Predicate();
+
+    Predicate(antlr_int32_t ruleIndex, antlr_int32_t predIndex, bool isCtxDependent);
+
+    ANTLR_OVERRIDE
+    bool eval(ANTLR_NULLABLE Parser* parser, ANTLR_NULLABLE RuleContext* outerContext) const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t hashCode() const;
+
+    ANTLR_OVERRIDE
+    bool equals(const Key<SemanticContext>* o) const;
+
+    ANTLR_OVERRIDE
+    std::string toString() const;
+
+public:
+
+    const antlr_int32_t ruleIndex;
+    const antlr_int32_t predIndex;
+    const bool isCtxDependent;  // e.g., $i ref in pred
+};
+
+class ANTLR_API SemanticContext::AND : public SemanticContext
+{
+public:
+
+    AND(ANTLR_NOTNULL const SemanticContext* a, ANTLR_NOTNULL const SemanticContext* b);
+
+    ANTLR_OVERRIDE
+    bool eval(ANTLR_NULLABLE Parser* parser, ANTLR_NULLABLE RuleContext* outerContext) const;
+
     ANTLR_OVERRIDE
-    antlr_int32_t hashCode() const { return 0; }
-    
+    antlr_int32_t hashCode() const;
+
     ANTLR_OVERRIDE
-    bool equals(const Key<SemanticContext>*) const { return false; }
-    
+    bool equals(const Key<SemanticContext>* o) const;
+
+    ANTLR_OVERRIDE
+    std::string toString() const;
+
+public:
+
+    std::vector<const SemanticContext*> opnds;
+};
+
+class ANTLR_API SemanticContext::OR : public SemanticContext
+{
+public:
+
+    OR(ANTLR_NOTNULL const SemanticContext* a, ANTLR_NOTNULL const SemanticContext* b);
+
+    ANTLR_OVERRIDE
+    bool eval(ANTLR_NULLABLE Parser* parser, ANTLR_NULLABLE RuleContext* outerContext) const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t hashCode() const;
+
     ANTLR_OVERRIDE
-    SemanticContext* clone() const { return NULL; }
+    bool equals(const Key<SemanticContext>* o) const;
 
     ANTLR_OVERRIDE
-    std::string toString() const { return std::string(); }
-    
-    class Predicate
-    {
-    public:
-        Predicate(int, int, bool) { }
-    };
+    std::string toString() const;
 
 public:
 
-    static const SemanticContext NONE;
+    std::vector<const SemanticContext*> opnds;
 };
 
 
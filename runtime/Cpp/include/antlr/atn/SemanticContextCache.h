@@ -0,0 +1,144 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#ifndef SEMANTIC_CONTEXT_CACHE_H
+#define SEMANTIC_CONTEXT_CACHE_H
+
+#include <antlr/Definitions.h>
+#include <antlr/atn/SemanticContext.h>
+#include <antlr/misc/AtomicPointer.h>
+#include <antlr/misc/HashMap.h>
+#include <antlr/misc/KeyPtr.h>
+#include <antlr/misc/Mutex.h>
+
+using namespace antlr4::misc;
+
+namespace antlr4 {
+namespace atn {
+
+/** Interns the {@link SemanticContext.AND} and {@link SemanticContext.OR}
+ *  contexts built by {@link SemanticContext#and_} and
+ *  {@link SemanticContext#or_}. The cache never holds two equal contexts,
+ *  so combining the same operands again returns the context built the first
+ *  time, and the number of contexts is bounded by the distinct combinations
+ *  of predicates instead of growing with every prediction.
+ * <p/>
+ *  The cache also numbers the contexts that {@link ATNConfig}s refer to;
+ *  see {@link #getIndex}. Index {@link #NONE_INDEX} is
+ *  {@link SemanticContext#NONE}.
+ * <p/>
+ *  The cache owns every context added to it; contexts live until the cache
+ *  is cleared or destroyed. All operations but {@link #get} are
+ *  synchronized on a lock of the cache's own, so one cache can be shared by
+ *  recognizers running on different threads; {@link #get} doesn't lock.
+ */
+class ANTLR_API SemanticContextCache
+{
+public:
+
+    static const antlr_uint32_t NONE_INDEX = 0;
+
+    /** Largest index; {@link ATNConfig#semanticContextIndex} has 31 bits */
+    static const antlr_uint32_t MAX_INDEX = 0x7FFFFFFF;
+
+    SemanticContextCache();
+
+    ~SemanticContextCache();
+
+    /** Add a context to the cache and return it. If an equal context
+     *  already exists, return that one instead. The cache takes ownership of
+     *  {@code ctx}; when an equal context is already cached, {@code ctx} is
+     *  deleted.
+     */
+    ANTLR_NOTNULL
+    const SemanticContext* add(ANTLR_NOTNULL const SemanticContext* ctx);
+
+    /** Returns the index of {@code ctx}, numbering it if it has none yet.
+     *  Equal contexts get the same index. {@code ctx} must be
+     *  {@link SemanticContext#NONE}, a context returned by {@link #add}, or
+     *  a predicate of the ATN, and isn't owned by the cache.
+     *
+     *  @throws std::bad_alloc if more than {@link #MAX_INDEX} contexts
+     *  would be numbered, which memory runs out long before
+     */
+    antlr_uint32_t getIndex(ANTLR_NOTNULL const SemanticContext* ctx);
+
+    /** Returns the context numbered {@code index} by {@link #getIndex}. */
+    ANTLR_NOTNULL
+    const SemanticContext* get(antlr_uint32_t index) const;
+
+    antlr_int32_t size() const;
+
+    /** Deletes every context held by this cache. */
+    void clear();
+
+private:
+
+    SemanticContextCache(const SemanticContextCache&);
+
+    SemanticContextCache& operator=(const SemanticContextCache&);
+
+protected:
+
+    typedef HashMap<KeyPtr<SemanticContext>, const SemanticContext*> ContextHashMap;
+
+    typedef HashMap<KeyPtr<SemanticContext>, antlr_uint32_t> IndexHashMap;
+
+    typedef AtomicPointer<const SemanticContext> Slot;
+
+    /** Chunk {@code k} holds {@code FIRST_CHUNK_SIZE << k} indexes, so
+     *  a cache that numbers few contexts stays small. Chunks are allocated
+     *  as indexes reach them; together they cover {@link #MAX_INDEX}.
+     */
+    static const antlr_uint32_t FIRST_CHUNK_SIZE = 64;
+
+    static const antlr_uint32_t NUM_CHUNKS = 26;
+
+    ContextHashMap cache;
+
+    IndexHashMap indexes;
+
+    /** Contexts by index, read without the lock by {@link #get} */
+    AtomicPointer<Slot> chunks[NUM_CHUNKS];
+
+    mutable Mutex mutex;
+};
+
+
+} /* namespace atn */
+} /* namespace antlr4 */
+
+#endif /* ifndef SEMANTIC_CONTEXT_CACHE_H */
@@ -51,22 +51,27 @@ public:
     // TODO (sam): should we really allow null here?
     SetTransition(ANTLR_NOTNULL const ATNState* target, ANTLR_NULLABLE const IntervalSet* set);
 
-    ANTLR_OVERRIDE
-    antlr_int32_t getSerializationType() const;
-    
     ANTLR_OVERRIDE
     ANTLR_NOTNULL
     antlr_auto_ptr<IntervalSet> label() const;
     
-    ANTLR_OVERRIDE
-    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const;
-    
     ANTLR_OVERRIDE
     std::string toString() const;
     
 public:
     
     IntervalSet set;
+
+protected:
+
+    /** Constructor for {@link NotSetTransition}. */
+    SetTransition(ANTLR_NOTNULL const ATNState* target,
+                  antlr_int32_t serializationType,
+                  ANTLR_NULLABLE const IntervalSet* set);
+
+private:
+
+    void init(ANTLR_NULLABLE const IntervalSet* set);
 };
 
 
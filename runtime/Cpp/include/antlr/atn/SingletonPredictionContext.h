@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,50 @@
  * Gael Hatchue
  */
 
+
 #ifndef SINGLETON_PREDICTION_CONTEXT_H
 #define SINGLETON_PREDICTION_CONTEXT_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/PredictionContext.h>
+#include <string>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API SingletonPredictionContext
+class ANTLR_API SingletonPredictionContext : public PredictionContext
 {
 public:
 
+    SingletonPredictionContext(ANTLR_NULLABLE const PredictionContext* parent, antlr_int32_t returnState);
+
+    /** Returns {@link PredictionContext#EMPTY} for {@code ($, EMPTY_RETURN_STATE)},
+     *  otherwise a new context the caller is responsible for (usually by
+     *  handing it to a {@link PredictionContextCache}).
+     */
+    static const PredictionContext* create(ANTLR_NULLABLE const PredictionContext* parent, antlr_int32_t returnState);
+
+    ANTLR_OVERRIDE
+    antlr_int32_t size() const;
+
+    ANTLR_OVERRIDE
+    const PredictionContext* getParent(antlr_int32_t index) const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getReturnState(antlr_int32_t index) const;
+
+    ANTLR_OVERRIDE
+    bool equals(const Key<PredictionContext>* o) const;
+
+    ANTLR_OVERRIDE
+    std::string toString() const;
+
+public:
+
+    ANTLR_NULLABLE
+    const PredictionContext* const parent;
+
+    const antlr_int32_t returnState;
 };
 
 
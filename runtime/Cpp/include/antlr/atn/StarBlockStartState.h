@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,25 @@
  * Gael Hatchue
  */
 
+
 #ifndef STAR_BLOCK_START_STATE_H
 #define STAR_BLOCK_START_STATE_H
 
 #include <antlr/Definitions.h>
-
+#include <antlr/atn/BlockStartState.h>
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API StarBlockStartState
+/** The block that begins a closure loop. */
+class ANTLR_API StarBlockStartState : public BlockStartState
 {
 public:
 
+    StarBlockStartState();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStateType() const;
 };
 
 
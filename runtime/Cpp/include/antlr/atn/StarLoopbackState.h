@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,19 +33,28 @@
  * Gael Hatchue
  */
 
+
 #ifndef STAR_LOOPBACK_STATE_H
 #define STAR_LOOPBACK_STATE_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/ATNState.h>
 
+namespace antlr4 { namespace atn { class StarLoopEntryState; } }
 
 namespace antlr4 {
 namespace atn {
 
-class ANTLR_API StarLoopbackState
+class ANTLR_API StarLoopbackState : public ATNState
 {
 public:
 
+    StarLoopbackState();
+
+    ANTLR_OVERRIDE
+    antlr_int32_t getStateType() const;
+
+    const StarLoopEntryState* getLoopEntryState() const;
 };
 
 
@@ -37,11 +37,9 @@
 #define TRANSITION_H
 
 #include <antlr/Definitions.h>
-#include <antlr/misc/HashMap.h>
 #include <antlr/misc/IntervalSet.h>
 #include <memory>
 #include <string>
-#include <typeinfo>
 #include <vector>
 
 
@@ -68,51 +66,82 @@ class ANTLR_API Transition
 {
 public:
     
-    ~Transition();
-    
-    static antlr_int32_t getSerializationType(const std::type_info& type);
+    virtual ~Transition();
 
-    virtual antlr_int32_t getSerializationType() const = 0;
+    /** The kind of this transition, one of the serialization constants
+     *  below. The kind is fixed at construction so the simulators can
+     *  dispatch on it without a virtual call.
+     */
+    antlr_int32_t getSerializationType() const
+    {
+        return serializationType;
+    }
 
     /** Are we epsilon, action, sempred? */
-    virtual bool isEpsilon() const;
+    bool isEpsilon() const
+    {
+        return serializationType == EPSILON
+            || serializationType == RULE
+            || serializationType == PREDICATE
+            || serializationType == ACTION;
+    }
 
     ANTLR_NULLABLE
     virtual antlr_auto_ptr<IntervalSet> label() const;
 
-    virtual bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const = 0;
+    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const
+    {
+        switch (serializationType) {
+        case ATOM:
+            return symbol == arg1;
+        case RANGE:
+            return symbol >= arg1 && symbol <= arg2;
+        case SET:
+            return matchSet->contains(symbol);
+        case NOT_SET:
+            return symbol >= minVocabSymbol
+                && symbol <= maxVocabSymbol
+                && !matchSet->contains(symbol);
+        case WILDCARD:
+            return symbol >= minVocabSymbol && symbol <= maxVocabSymbol;
+        default:
+            return false;
+        }
+    }
     
     virtual std::string toString() const = 0;
 
 protected:
     
-    Transition(ANTLR_NOTNULL const ATNState* target);
+    /** {@code arg1} and {@code arg2} are the label of an {@link #ATOM} or
+     *  the bounds of a {@link #RANGE}; {@code matchSet} is the label set of
+     *  a {@link #SET} or {@link #NOT_SET}.
+     */
+    Transition(ANTLR_NOTNULL const ATNState* target,
+               antlr_int32_t serializationType,
+               antlr_int32_t arg1 = 0,
+               antlr_int32_t arg2 = 0,
+               ANTLR_NULLABLE const IntervalSet* matchSet = NULL);
 
 private:
+
+    Transition(const Transition&);
+    Transition& operator=(const Transition&);
     
     static std::vector<std::string> getSerializationNames();
-
-#if defined(HAVE_CX11)
-    static HashMap<std::size_t, antlr_int32_t> getSerializationTypes();
-    static const HashMap<std::size_t, antlr_int32_t> serializationTypes;    
-#else
-    typedef std::pair<const std::type_info*, antlr_int32_t> TypeInfo;
-    static std::vector<TypeInfo> getSerializationTypes();
-    static const std::vector<TypeInfo> serializationTypes;    
-#endif
     
 public:
     
     // constants for serialization
-    static const antlr_int32_t EPSILON;
-    static const antlr_int32_t RANGE;
-    static const antlr_int32_t RULE;
-    static const antlr_int32_t PREDICATE;
-    static const antlr_int32_t ATOM;
-    static const antlr_int32_t ACTION;
-    static const antlr_int32_t SET;
-    static const antlr_int32_t NOT_SET;
-    static const antlr_int32_t WILDCARD;
+    static const antlr_int32_t EPSILON      = 1;
+    static const antlr_int32_t RANGE        = 2;
+    static const antlr_int32_t RULE         = 3;
+    static const antlr_int32_t PREDICATE    = 4; // e.g., {isType(input.LT(1))}?
+    static const antlr_int32_t ATOM         = 5;
+    static const antlr_int32_t ACTION       = 6;
+    static const antlr_int32_t SET          = 7; // ~(A|B) or ~atom, wildcard, which convert to next 2
+    static const antlr_int32_t NOT_SET      = 8;
+    static const antlr_int32_t WILDCARD     = 9;
     
     static const std::vector<std::string> serializationNames;
     
@@ -120,6 +149,16 @@ public:
     ANTLR_NOTNULL
     const ATNState* target;
 
+private:
+
+    const antlr_int32_t serializationType;
+
+    const antlr_int32_t arg1;
+
+    const antlr_int32_t arg2;
+
+    const IntervalSet* const matchSet;
+
 };
 
 
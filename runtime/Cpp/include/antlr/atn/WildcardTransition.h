@@ -47,12 +47,6 @@ class ANTLR_API WildcardTransition : public Transition
 public:
     WildcardTransition(ANTLR_NOTNULL const ATNState* target);
 
-    ANTLR_OVERRIDE
-    antlr_int32_t getSerializationType() const;
-
-    ANTLR_OVERRIDE
-    bool matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const;
-
     ANTLR_OVERRIDE
     std::string toString() const;
 };
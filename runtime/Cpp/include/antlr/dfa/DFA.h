@@ -37,9 +37,14 @@
 #define DFA_H
 
 #include <antlr/Definitions.h>
+#include <antlr/atn/SemanticContextCache.h>
 #include <antlr/dfa/DFAState.h>
+#include <antlr/dfa/FrozenDFA.h>
+#include <antlr/misc/Arena.h>
+#include <antlr/misc/AtomicPointer.h>
 #include <antlr/misc/HashMap.h>
 #include <antlr/misc/KeyPtr.h>
+#include <antlr/misc/Mutex.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -52,6 +57,17 @@ using namespace antlr4::misc;
 namespace antlr4 {
 namespace dfa {
 
+/** The DFA for one decision, built lazily during prediction.
+ * <p/>
+ *  A DFA may be shared by every recognizer created for the same grammar,
+ *  including recognizers running on different threads. Prediction walks
+ *  {@link #s0} and the state edges without locking; adding states and
+ *  edges is serialized on {@link #lock}.
+ * <p/>
+ *  Once warmed up, a DFA can be {@link #freeze frozen} into a compact
+ *  {@link FrozenDFA}. Simulators walk the frozen table first and only go
+ *  back to the ATN, growing {@link #states} again, on edges it is missing.
+ */
 class ANTLR_API DFA
 {
 public:
@@ -60,11 +76,55 @@ public:
 
     DFA(ANTLR_NOTNULL const DecisionState* atnStartState, antlr_int32_t decision);
 
+    /** Destroys every state in {@link #states} and deletes the frozen
+     *  table; {@link #semanticContexts} deletes its own contexts.
+     */
+    virtual ~DFA();
+
+    /** Packs the states of this DFA into a {@link FrozenDFA}, then destroys
+     *  them along with their ATN configuration sets and empties
+     *  {@link #states}, {@link #arena} and {@link #s0}. Returns the
+     *  approximate number of bytes reclaimed.
+     * <p/>
+     *  Does nothing and returns 0 if this DFA has no start state yet or is
+     *  already frozen. No recognizer may be using this DFA while it is
+     *  being frozen.
+     */
+    size_t freeze();
+
+    bool isFrozen() const;
+
+    /** Returns a frozen copy of the current states without changing this
+     *  DFA, or {@code null} if it has no start state yet. Takes
+     *  {@link #lock}.
+     */
+    antlr_auto_ptr<FrozenDFA> toFrozen() const;
+
+    /** Makes {@code table} the frozen table of this DFA, which then owns it.
+     *  The states learned so far are kept and only used on edges missing
+     *  from {@code table}. No recognizer may be using this DFA meanwhile.
+     *
+     *  @throws std::logic_error if this DFA is already frozen
+     */
+    void setFrozen(ANTLR_NOTNULL antlr_auto_ptr<FrozenDFA>& table);
+
+    /** Returns the table built by {@link #freeze}, or {@code null} */
+    ANTLR_NULLABLE
+    const FrozenDFA* getFrozen() const;
+
     /**
      * Return a list of all states in this DFA, ordered by state number.
+     * Takes {@link #lock} while reading {@link #states}.
      */
     antlr_auto_ptr< std::vector<const DFAState*> > getStates() const;
 
+    /** Moves {@code proposed} into a new state allocated in {@link #arena},
+     *  numbers it and adds it to {@link #states}. The caller must hold
+     *  {@link #lock} and have checked that no equal state exists.
+     */
+    ANTLR_NOTNULL
+    DFAState* addState(ANTLR_NOTNULL DFAState& proposed);
+
     ANTLR_OVERRIDE
     std::string toString() const;
 
@@ -75,19 +135,44 @@ public:
 protected:
     
     static bool compareStatesForSort (const DFAState* o1, const DFAState* o2);
+
+    /** Copies the states into a new frozen table; the caller must hold
+     *  {@link #lock} and have checked that {@link #s0} is set.
+     */
+    ANTLR_NOTNULL
+    FrozenDFA* createFrozen(ANTLR_NOTNULL const DFAState* start) const;
+
+private:
+
+    DFA(const DFA&);
+
+    DFA& operator=(const DFA&);
     
 public:
 
     typedef HashMap<KeyPtr<DFAState>, DFAState*> StateHashMap;
     
     /** A set of all DFA states. Use {@link Map} so we can get old state back
-     *  ({@link Set} only allows you to see if it's there).
+     *  ({@link Set} only allows you to see if it's there). Only accessed
+     *  while holding {@link #lock}.
      */
     ANTLR_NOTNULL
     antlr_auto_ptr< StateHashMap > states;
     
     ANTLR_NULLABLE
-    const DFAState* s0;
+    AtomicPointer<const DFAState> s0;
+
+    /** Set once by {@link #freeze} and owned by this DFA */
+    ANTLR_NULLABLE
+    AtomicPointer<const FrozenDFA> frozen;
+
+    /** Serializes writers adding states, edges and semantic contexts. */
+    mutable Mutex lock;
+
+    /** Holds the states of this DFA and their edge tables, which live as
+     *  long as the DFA does. Only used while holding {@link #lock}.
+     */
+    Arena arena;
 
     const antlr_int32_t decision;
 
@@ -95,6 +180,14 @@ public:
     ANTLR_NOTNULL
     const DecisionState* atnStartState;
 
+    /** Semantic contexts combined with {@link SemanticContext#and_} and
+     *  {@link SemanticContext#or_} while computing the states of this DFA.
+     *  Configurations and predicates of those states point into this cache.
+     *  Synchronized on its own lock, so prediction never takes
+     *  {@link #lock} to combine predicates.
+     */
+    SemanticContextCache semanticContexts;
+
     /** Set of configs for a DFA state with at least one conflict? Mainly used as "return value"
      *  from {@link ParserATNSimulator#predictATN} for retry.
      */
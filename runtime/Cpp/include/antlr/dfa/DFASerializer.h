@@ -54,11 +54,13 @@ public:
 	DFASerializer(ANTLR_NOTNULL const DFA* dfa,
             ANTLR_NULLABLE const std::vector<std::string>* tokenNames);
 
+	virtual ~DFASerializer();
+
 	std::string toString() const;
 
 protected:
     
-	std::string getEdgeLabel(antlr_uint32_t i) const;
+	virtual std::string getEdgeLabel(antlr_uint32_t i) const;
 
     std::string getStateString(const DFAState& s) const;
     
@@ -0,0 +1,176 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef DFA_SNAPSHOT_H
+#define DFA_SNAPSHOT_H
+
+#include <antlr/Definitions.h>
+#include <antlr/dfa/FrozenDFA.h>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace antlr4 { namespace dfa { class DFA; } }
+
+namespace antlr4 {
+namespace dfa {
+
+/** A binary image of the DFAs of a grammar, so a new process can start
+ *  predicting with the DFAs an earlier one learned instead of an empty
+ *  cache.
+ * <p/>
+ *  {@link #write} stores each DFA as the arrays of a {@link FrozenDFA}.
+ *  Where the platform supports it, a snapshot is read by mapping the file
+ *  into memory; {@link #apply} then gives each DFA a frozen table that
+ *  reads the mapped arrays in place, so loading allocates once per
+ *  decision and never per state, and only the pages prediction touches
+ *  become resident. A snapshot compiled into the program as a static
+ *  array of words is read in place the same way.
+ * <p/>
+ *  The file starts with a versioned header holding a checksum of the
+ *  serialized ATN the DFAs were built from and a checksum of the rest of
+ *  the file, so a snapshot of another grammar, or of another version of
+ *  the same grammar, is never applied. Snapshots are written in the byte
+ *  order of the machine writing them.
+ * <p/>
+ *  DFA states with predicates refer to semantic contexts that only exist
+ *  in the process that built them, so they are left out: edges to them are
+ *  written as missing and predicted again from the ATN.
+ */
+class ANTLR_API DFASnapshot
+{
+public:
+
+    /** Maps {@code fileName} and checks its header and checksum.
+     *
+     *  @throws std::runtime_error if the file can't be read or isn't a
+     *  valid snapshot
+     */
+    DFASnapshot(const std::string& fileName);
+
+    /** Reads the {@code length} words of a snapshot at {@code data} in
+     *  place, such as a static table compiled into the program. The
+     *  words must outlive this snapshot and the DFAs it is applied to.
+     *
+     *  @throws std::runtime_error if the words aren't a valid snapshot
+     */
+    DFASnapshot(ANTLR_NOTNULL const antlr_int32_t* data, size_t length);
+
+    ~DFASnapshot();
+
+    /** Writes the DFAs of {@code decisionToDFA}, built from the ATN
+     *  serialized as {@code serializedATN}, to {@code out}. A frozen DFA is
+     *  written from its frozen table and any other from a copy of its
+     *  current states; DFAs without a start state are left out.
+     */
+    static void write(std::ostream& out, const std::vector<DFA*>& decisionToDFA,
+                      const antlr_uint32_t* serializedATN, size_t length);
+
+    static antlr_int32_t checksum(const antlr_uint32_t* serializedATN, size_t length);
+
+    /** Returns true if this snapshot was written for {@code serializedATN} */
+    bool matches(const antlr_uint32_t* serializedATN, size_t length) const;
+
+    /** Gives each DFA of {@code decisionToDFA} that isn't frozen yet its
+     *  table from this snapshot. This snapshot must outlive those DFAs, and
+     *  no recognizer may be using them meanwhile.
+     *
+     *  @return the number of DFAs given a table; 0 if this snapshot wasn't
+     *  written for {@code serializedATN}
+     */
+    antlr_uint32_t apply(std::vector<DFA*>& decisionToDFA,
+                         const antlr_uint32_t* serializedATN, size_t length) const;
+
+    /** Number of DFAs in this snapshot */
+    antlr_uint32_t size() const;
+
+public:
+
+    static const antlr_int32_t SNAPSHOT_MAGIC;
+
+    static const antlr_int32_t SNAPSHOT_VERSION;
+
+private:
+
+    DFASnapshot(const DFASnapshot&);
+
+    DFASnapshot& operator=(const DFASnapshot&);
+
+    void load();
+
+    void unload();
+
+    /** Checks the header, finds the arrays of every DFA and checks that
+     *  their edges stay within the tables.
+     */
+    void parse();
+
+    /** Returns the next {@code n} words of the file */
+    const antlr_int32_t* take(size_t& offset, size_t n) const;
+
+    struct Section
+    {
+        antlr_int32_t decision;
+
+        FrozenDFA::Tables tables;
+    };
+
+private:
+
+    std::string fileName;
+
+    /** Start of the mapped view of the file, or NULL if the file was read
+     *  into {@link #buffer}.
+     */
+    ANTLR_NULLABLE
+    void* mapping;
+
+    size_t mappingSize;
+
+    std::vector<antlr_int32_t> buffer;
+
+    const antlr_int32_t* words;
+
+    size_t numWords;
+
+    std::vector<Section> sections;
+};
+
+
+} /* namespace dfa */
+} /* namespace antlr4 */
+
+#endif /* ifndef DFA_SNAPSHOT_H */
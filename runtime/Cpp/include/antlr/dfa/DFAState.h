@@ -38,6 +38,8 @@
 
 #include <antlr/Definitions.h>
 #include <antlr/atn/ATNConfigSet.h>
+#include <antlr/misc/Arena.h>
+#include <antlr/misc/AtomicPointer.h>
 #include <antlr/misc/HashSet.h>
 #include <antlr/misc/Key.h>
 #include <memory>
@@ -74,11 +76,21 @@ namespace dfa {
  *  A DFA state may have multiple references to a particular state,
  *  but with different ATN contexts (with same or different alts)
  *  meaning that state was reached via a different set of rule invocations.
+ * <p/>
+ *  Once a state has been added to a {@link DFA}, only its edges change.
+ *  Edges are read without locking through {@link #getEdge} and
+ *  {@link #getPagedEdge}; they are added with {@link #setEdge} and
+ *  {@link #setPagedEdge} while holding {@link DFA#lock}.
  */
 class ANTLR_API DFAState : public Key<DFAState>
 {
 public:
     
+    /** A single DFA edge, published atomically so readers never see a
+     *  partially initialized target.
+     */
+    typedef AtomicPointer<const DFAState> Edge;
+
     /** Map a predicate to a predicted alternative. */
     class PredPrediction
     {
@@ -86,6 +98,8 @@ public:
         
         PredPrediction(const SemanticContext* pred, antlr_int32_t alt);
 
+        virtual ~PredPrediction();
+
         ANTLR_OVERRIDE
         std::string toString() const;
         
@@ -106,12 +120,42 @@ public:
     DFAState(antlr_int32_t stateNumber);
 
     DFAState(ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& configs);
+
+    /** Takes over the configurations, predicates and accept information of
+     *  {@code proposed}, which must not have any edges yet. Edge tables are
+     *  allocated in {@code arena}, which must outlive this state.
+     */
+    DFAState(ANTLR_NOTNULL DFAState& proposed, ANTLR_NULLABLE Arena* arena);
     
     /** Get the set of all alts mentioned by all ATN configurations in this
      *  DFA state.
      */
     antlr_auto_ptr< HashSet<antlr_int32_t> > getAltSet() const;
 
+    /** Returns the target of {@code edges[i]}, or {@code null} if that edge
+     *  hasn't been computed yet. Never blocks.
+     */
+    ANTLR_NULLABLE
+    const DFAState* getEdge(antlr_int32_t i) const;
+
+    /** Sets {@code edges[i]}, allocating {@link #edges} with
+     *  {@code numEdges} entries on first use. The caller must hold the lock
+     *  of the DFA containing this state.
+     */
+    void setEdge(antlr_int32_t i, antlr_uint32_t numEdges, ANTLR_NOTNULL const DFAState* target);
+
+    /** Returns the target for {@code symbol} in {@link #edgePages}, or
+     *  {@code null} if that edge hasn't been computed yet. Never blocks.
+     */
+    ANTLR_NULLABLE
+    const DFAState* getPagedEdge(antlr_int32_t symbol) const;
+
+    /** Sets the target for {@code symbol} in {@link #edgePages}, allocating
+     *  the page table and the page on first use. The caller must hold the
+     *  lock of the DFA containing this state.
+     */
+    void setPagedEdge(antlr_int32_t symbol, ANTLR_NOTNULL const DFAState* target);
+
     ANTLR_OVERRIDE
     antlr_int32_t hashCode() const;
 
@@ -148,10 +192,21 @@ public:
      *  {@link Token#EOF} maps to {@code edges[0]}.
      */
     ANTLR_NULLABLE
-    const DFAState** edges;
-    
+    AtomicPointer<Edge> edges;
+
+    /** Number of entries in {@link #edges}; set before the array is published. */
     antlr_uint32_t numEdges;
 
+    /** Lexer only: edges for symbols past the end of {@link #edges} and up to
+     *  0xFFFF, as a table of {@link #NUM_EDGE_PAGES} pages of
+     *  {@link #EDGE_PAGE_SIZE} targets each, indexed by
+     *  {@code symbol >> EDGE_PAGE_SHIFT}. Both the table and its pages are
+     *  allocated on first use, so states that only see ASCII input don't pay
+     *  for them.
+     */
+    ANTLR_NULLABLE
+    AtomicPointer< AtomicPointer<Edge> > edgePages;
+
     bool isAcceptState;
 
     /** if accept state, what ttype do we match or alt do we predict?
@@ -187,6 +242,24 @@ public:
     const PredPrediction** predicates;
     
     antlr_uint32_t numPredicates;
+
+    /** Where the edge tables come from; {@code null} for the heap. Guarded
+     *  by the lock of the DFA containing this state, like the edges.
+     */
+    ANTLR_NULLABLE
+    Arena* arena;
+
+public:
+
+    static const antlr_int32_t EDGE_PAGE_SHIFT;
+    static const antlr_int32_t EDGE_PAGE_SIZE;
+    static const antlr_int32_t NUM_EDGE_PAGES;
+
+private:
+
+    DFAState(const DFAState&);
+
+    DFAState& operator=(const DFAState&);
 };
 
 
@@ -0,0 +1,121 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#ifndef DFA_WARM_UP_H
+#define DFA_WARM_UP_H
+
+#include <antlr/Definitions.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace antlr4 { class CharStream; }
+namespace antlr4 { namespace dfa { class DFA; } }
+
+namespace antlr4 {
+namespace dfa {
+
+/** Drives recognizers over a sample corpus and saves the DFAs they
+ *  learned as {@link DFASnapshot} files, one {@code <recognizer>.dfa} per
+ *  recognizer. A later process loads those files, or the same words
+ *  compiled into the program as a static array, and applies them to its
+ *  DFAs, so they start out populated.
+ * <p/>
+ *  Subclasses implement {@link #recognize}, typically by creating the
+ *  lexer and parser over the input and invoking the start rule. Each
+ *  recognizer whose DFAs are saved is registered with
+ *  {@link #addRecognizer} along with its shared DFAs and serialized ATN.
+ */
+class ANTLR_API DFAWarmUp
+{
+public:
+
+    DFAWarmUp();
+
+    virtual ~DFAWarmUp();
+
+    /** Saves the DFAs of {@code decisionToDFA}, built from the ATN
+     *  serialized as the {@code length} words at {@code serializedATN}, as
+     *  {@code <recognizerName>.dfa}. Both must outlive this warm-up.
+     */
+    void addRecognizer(const std::string& recognizerName, std::vector<DFA*>& decisionToDFA,
+                       ANTLR_NOTNULL const antlr_uint32_t* serializedATN, size_t length);
+
+    /** Recognizes each file of {@code corpus} in turn.
+     *
+     *  @throws std::runtime_error if a file can't be read
+     */
+    void run(const std::vector<std::string>& corpus);
+
+    /** Writes the snapshot of each recognizer to {@code directory} and
+     *  returns the names of the files written.
+     *
+     *  @throws std::runtime_error if a file can't be written
+     */
+    std::vector<std::string> write(const std::string& directory) const;
+
+protected:
+
+    /** Runs the recognizers over {@code input} */
+    virtual void recognize(ANTLR_NOTNULL CharStream* input) = 0;
+
+private:
+
+    DFAWarmUp(const DFAWarmUp&);
+
+    DFAWarmUp& operator=(const DFAWarmUp&);
+
+    struct Recognizer
+    {
+        std::string name;
+
+        std::vector<DFA*>* decisionToDFA;
+
+        const antlr_uint32_t* serializedATN;
+
+        size_t length;
+    };
+
+private:
+
+    std::vector<Recognizer> recognizers;
+};
+
+
+} /* namespace dfa */
+} /* namespace antlr4 */
+
+#endif /* ifndef DFA_WARM_UP_H */
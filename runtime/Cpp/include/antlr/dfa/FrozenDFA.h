@@ -0,0 +1,209 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef FROZEN_DFA_H
+#define FROZEN_DFA_H
+
+#include <antlr/Definitions.h>
+#include <antlr/dfa/DFAState.h>
+#include <cstddef>
+#include <vector>
+
+namespace antlr4 { namespace atn { class ATN; } }
+
+namespace antlr4 {
+namespace dfa {
+
+/** A read-only copy of a {@link DFA} with every state packed into one
+ *  contiguous transition table.
+ * <p/>
+ *  States are numbered densely from 0 in {@link DFAState#stateNumber}
+ *  order. {@link #getTarget} looks up row {@code state}, column
+ *  {@code column} of the table; the column is the index the simulator uses
+ *  for {@link DFAState#getEdge}, so {@code t+1} for a parser and
+ *  {@code t-MIN_DFA_EDGE} for a lexer. Lexer edges kept in
+ *  {@link DFAState#edgePages} are stored per row in a sorted overflow list
+ *  under their symbol. Accept information and predicates are kept in
+ *  arrays parallel to the rows; the ATN configuration sets are not kept
+ *  at all, so a simulator that runs off the table has to go back to the
+ *  ATN.
+ * <p/>
+ *  A frozen table never changes and may be read by any number of threads.
+ *  Its arrays are either owned by the table or, for a table loaded from a
+ *  {@link DFASnapshot}, point into memory owned by someone else.
+ */
+class ANTLR_API FrozenDFA
+{
+public:
+
+    /** The edge for this column was never computed */
+    static const antlr_int32_t NO_EDGE = -1;
+
+    /** The edge for this column leads to {@link ATNSimulator#ERROR} */
+    static const antlr_int32_t ERROR_EDGE = -2;
+
+    enum
+    {
+        ACCEPT = 1,
+        REQUIRES_FULL_CONTEXT = 2,
+
+        /** Some configuration of the state has a transition on EOF, so
+         *  only the ATN knows where EOF leads.
+         */
+        MATCHES_EOF = 4
+    };
+
+    /** The arrays making up a frozen table */
+    struct Tables
+    {
+        antlr_int32_t startState;
+
+        antlr_uint32_t numStates;
+
+        antlr_uint32_t numColumns;
+
+        /** {@code numStates} rows of {@code numColumns} targets */
+        const antlr_int32_t* edges;
+
+        /** Row {@code s} of the overflow edges is
+         *  {@code [overflowStart[s], overflowStart[s+1])}
+         */
+        const antlr_uint32_t* overflowStart;
+
+        const antlr_int32_t* overflowColumns;
+
+        const antlr_int32_t* overflowTargets;
+
+        /** {@link #ACCEPT}, {@link #REQUIRES_FULL_CONTEXT} and
+         *  {@link #MATCHES_EOF} bits
+         */
+        const unsigned char* flags;
+
+        const antlr_int32_t* predictions;
+
+        const antlr_int32_t* lexerRuleIndexes;
+
+        const antlr_int32_t* lexerActionIndexes;
+
+        /** The predicates of state {@code s} are
+         *  {@code [predicateStart[s], predicateStart[s+1])}; {@code null}
+         *  if no state has predicates.
+         */
+        const antlr_uint32_t* predicateStart;
+
+        const DFAState::PredPrediction* predicates;
+    };
+
+    /** Copies {@code states}, which must be ordered by state number and
+     *  numbered densely from 0, starting from {@code s0}. The configs of the
+     *  states refer to states of {@code atn}.
+     */
+    FrozenDFA(const ATN& atn, const std::vector<const DFAState*>& states, ANTLR_NOTNULL const DFAState* s0);
+
+    /** Reads the arrays of {@code tables} in place. They must outlive this
+     *  table.
+     */
+    FrozenDFA(const Tables& tables);
+
+    const Tables& getTables() const;
+
+    antlr_int32_t getStartState() const;
+
+    /** Returns the state reached from {@code state} on {@code column},
+     *  {@link #NO_EDGE} or {@link #ERROR_EDGE}.
+     */
+    antlr_int32_t getTarget(antlr_int32_t state, antlr_int32_t column) const;
+
+    bool isAcceptState(antlr_int32_t state) const;
+
+    bool requiresFullContext(antlr_int32_t state) const;
+
+    /** Returns {@code true} if the ATN configurations of {@code state} have
+     *  a transition on EOF. Otherwise EOF can only end a match there.
+     */
+    bool matchesEOF(antlr_int32_t state) const;
+
+    antlr_int32_t getPrediction(antlr_int32_t state) const;
+
+    antlr_int32_t getLexerRuleIndex(antlr_int32_t state) const;
+
+    antlr_int32_t getLexerActionIndex(antlr_int32_t state) const;
+
+    /** Number of predicates of {@code state}; 0 if it has none */
+    antlr_uint32_t getNumPredicates(antlr_int32_t state) const;
+
+    const DFAState::PredPrediction& getPredicate(antlr_int32_t state, antlr_uint32_t i) const;
+
+    antlr_uint32_t getNumStates() const;
+
+    antlr_uint32_t getNumColumns() const;
+
+    /** Number of heap bytes held by the table; memory it only points to
+     *  isn't counted.
+     */
+    size_t getBytesUsed() const;
+
+private:
+
+    FrozenDFA(const FrozenDFA&);
+
+    FrozenDFA& operator=(const FrozenDFA&);
+
+    static antlr_int32_t targetOf(ANTLR_NULLABLE const DFAState* target);
+
+    static bool hasEOFTransition(const ATN& atn, ANTLR_NOTNULL const DFAState* state);
+
+private:
+
+    Tables tables;
+
+    // storage of the tables built from a DFA
+    std::vector<antlr_int32_t> edges;
+    std::vector<antlr_uint32_t> overflowStart;
+    std::vector<antlr_int32_t> overflowColumns;
+    std::vector<antlr_int32_t> overflowTargets;
+    std::vector<unsigned char> flags;
+    std::vector<antlr_int32_t> predictions;
+    std::vector<antlr_int32_t> lexerRuleIndexes;
+    std::vector<antlr_int32_t> lexerActionIndexes;
+    std::vector<antlr_uint32_t> predicateStart;
+    std::vector<DFAState::PredPrediction> predicates;
+};
+
+
+} /* namespace dfa */
+} /* namespace antlr4 */
+
+#endif /* ifndef FROZEN_DFA_H */
@@ -48,9 +48,11 @@ public:
 
 	LexerDFASerializer(ANTLR_NOTNULL const DFA* dfa);
 
+protected:
+
 	ANTLR_OVERRIDE
-	std::string getEdgeLabel(antlr_uint32_t i);
-    
+	std::string getEdgeLabel(antlr_uint32_t i) const;
+
 };
 
 
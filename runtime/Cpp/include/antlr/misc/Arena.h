@@ -0,0 +1,147 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <antlr/Definitions.h>
+#include <cstddef>
+#include <new>
+
+namespace antlr4 {
+namespace misc {
+
+
+/** A bump allocator that hands out memory from large blocks and releases
+ *  it all at once.
+ * <p/>
+ *  Prediction builds and throws away many small configuration sets and
+ *  hash tables; drawing them from an arena replaces a malloc/free pair per
+ *  object with a pointer bump, and {@link #reset} frees the lot when
+ *  prediction finishes. The arena never runs destructors: objects placed
+ *  in it must be destroyed by their owner before {@link #reset} or the
+ *  arena's destruction. An arena is not thread-safe.
+ */
+class ANTLR_API Arena
+{
+public:
+
+    /** Frees every block */
+    ~Arena();
+
+    Arena();
+
+    /** Uses blocks of {@code blockSize} bytes */
+    Arena(size_t blockSize);
+
+    /** Returns {@code size} bytes aligned on {@code alignment}, which must
+     *  be a power of 2. Requests larger than a quarter of the block size get
+     *  a block of their own.
+     */
+    ANTLR_NOTNULL
+    void* allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+
+    /** Returns {@code n} value-initialized objects of type {@code T} */
+    template <typename T>
+    ANTLR_NOTNULL
+    T* newArray(size_t n);
+
+    /** Releases everything allocated so far. One block is kept so the next
+     *  round of allocations doesn't have to go back to the heap.
+     */
+    void reset();
+
+    /** Number of bytes handed out since the last {@link #reset} */
+    size_t getBytesAllocated() const;
+
+    /** Number of bytes held in blocks, used or not */
+    size_t getBytesReserved() const;
+
+private:
+
+    Arena(const Arena&);
+
+    Arena& operator=(const Arena&);
+
+    struct Block
+    {
+        Block* next;
+        size_t size;
+    };
+
+    /** Starts a block of at least {@code size} usable bytes */
+    void newBlock(size_t size);
+
+    static void freeBlocks(Block* block);
+
+public:
+
+    static const size_t DEFAULT_BLOCK_SIZE;
+
+    static const size_t DEFAULT_ALIGNMENT;
+
+private:
+
+    const size_t blockSize;
+
+    /** Blocks of {@link #blockSize} bytes, most recent first */
+    Block* blocks;
+
+    /** Blocks holding a single large allocation */
+    Block* largeBlocks;
+
+    char* cursor;
+
+    char* limit;
+
+    size_t bytesAllocated;
+
+    size_t bytesReserved;
+};
+
+template <typename T>
+T* Arena::newArray(size_t n)
+{
+    T* array = static_cast<T*>(allocate(sizeof(T) * n));
+    for (size_t i = 0; i < n; i++)
+        new (&array[i]) T();
+    return array;
+}
+
+
+} /* namespace misc */
+} /* namespace antlr4 */
+
+#endif /* ifndef ARENA_H */
@@ -0,0 +1,193 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef ARENA_VECTOR_H
+#define ARENA_VECTOR_H
+
+#include <antlr/Definitions.h>
+#include <antlr/misc/Arena.h>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace antlr4 {
+namespace misc {
+
+
+/** A vector of plain values whose storage is drawn from an {@link Arena},
+ *  or from the heap when there is none. Elements are copied with
+ *  {@code memcpy} and never destroyed, so {@code T} must be a plain value.
+ *  Storage taken from the arena is only given back when the arena is
+ *  reset; the arena must not be reset while the vector still uses it.
+ */
+template <typename T>
+class ANTLR_API ArenaVector
+{
+public:
+
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef size_t size_type;
+
+    ~ArenaVector();
+
+    ArenaVector(ANTLR_NULLABLE Arena* arena);
+
+    iterator begin() { return items; }
+
+    iterator end() { return items + numItems; }
+
+    const_iterator begin() const { return items; }
+
+    const_iterator end() const { return items + numItems; }
+
+    size_type size() const { return numItems; }
+
+    bool empty() const { return numItems == 0; }
+
+    size_type capacity() const { return maxItems; }
+
+    /** Number of heap bytes held; storage in the arena isn't counted */
+    size_t getHeapBytes() const { return arena == NULL ? maxItems * sizeof(T) : 0; }
+
+    T& operator[](size_type i) { return items[i]; }
+
+    const T& operator[](size_type i) const { return items[i]; }
+
+    T& back() { return items[numItems - 1]; }
+
+    const T& back() const { return items[numItems - 1]; }
+
+    void push_back(const T& value);
+
+    /** Removes the elements but keeps the storage */
+    void clear() { numItems = 0; }
+
+    /** Removes the elements and gives up the storage */
+    void release();
+
+private:
+
+    ArenaVector(const ArenaVector&);
+
+    ArenaVector& operator=(const ArenaVector&);
+
+    void grow();
+
+public:
+
+    /** Capacity of the first block of storage */
+    static const size_type INITIAL_CAPACITY = 4;
+
+private:
+
+    ANTLR_NULLABLE
+    Arena* arena;
+
+    T* items;
+
+    size_type numItems;
+
+    size_type maxItems;
+};
+
+
+template <typename T>
+const typename ArenaVector<T>::size_type ArenaVector<T>::INITIAL_CAPACITY;
+
+template <typename T>
+ArenaVector<T>::~ArenaVector()
+{
+    release();
+}
+
+template <typename T>
+ArenaVector<T>::ArenaVector(ANTLR_NULLABLE Arena* arena)
+    :   arena(arena),
+        items(NULL),
+        numItems(0),
+        maxItems(0)
+{
+}
+
+template <typename T>
+void ArenaVector<T>::push_back(const T& value)
+{
+    if (numItems == maxItems) {
+        // value may live in the storage we're about to give up
+        T copy(value);
+        grow();
+        items[numItems] = copy;
+    }
+    else {
+        items[numItems] = value;
+    }
+    numItems++;
+}
+
+template <typename T>
+void ArenaVector<T>::release()
+{
+    if (arena == NULL) {
+        ::operator delete(items);
+    }
+    items = NULL;
+    numItems = 0;
+    maxItems = 0;
+}
+
+template <typename T>
+void ArenaVector<T>::grow()
+{
+    size_type capacity = maxItems == 0 ? INITIAL_CAPACITY : maxItems * 2;
+    T* grown = static_cast<T*>(arena != NULL
+        ? arena->allocate(capacity * sizeof(T))
+        : ::operator new(capacity * sizeof(T)));
+    if (numItems > 0) {
+        std::memcpy(grown, items, numItems * sizeof(T));
+    }
+    if (arena == NULL) {
+        ::operator delete(items);
+    }
+    items = grown;
+    maxItems = capacity;
+}
+
+
+} /* namespace misc */
+} /* namespace antlr4 */
+
+#endif /* ifndef ARENA_VECTOR_H */
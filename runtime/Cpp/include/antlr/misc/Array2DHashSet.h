@@ -38,6 +38,7 @@
 
 #include <antlr/Definitions.h>
 #include <antlr/misc/AbstractEqualityComparator.h>
+#include <antlr/misc/Arena.h>
 #include <antlr/misc/Key.h>
 #include <antlr/misc/MurmurHash.h>
 #include <antlr/misc/ObjectEqualityComparator.h>
@@ -47,6 +48,7 @@
 #include <cstring>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 namespace antlr4 {
 namespace misc {
@@ -79,6 +81,14 @@ public:
     Array2DHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator,
             antlr_int32_t initialCapacity, antlr_int32_t initialBucketCapacity);
 
+    /** Draws the table and its buckets from {@code arena}, which must
+     *  outlive this set. Buckets replaced while growing are not reclaimed
+     *  until the arena is reset.
+     */
+    Array2DHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator,
+            antlr_int32_t initialCapacity, antlr_int32_t initialBucketCapacity,
+            ANTLR_NULLABLE Arena* arena);
+
     /**
      * Add {@code o} to set if not there; return existing value if already
      * there. This method performs the same operation as {@link #add} aside from
@@ -177,7 +187,13 @@ protected:
      * @return the newly constructed array
      */
     TVal* createBucket(antlr_int32_t capacity) const;
-    
+
+    /** Releases a bucket returned by {@link #createBucket} */
+    void destroyBucket(TVal* bucket, antlr_int32_t capacity) const;
+
+    /** Releases a table returned by {@link #createBuckets}, not its buckets */
+    void destroyBuckets(TVal** table, antlr_int32_t* sizes) const;
+
     /* De-allocate buckets */
     void cleanup();
 
@@ -206,6 +222,10 @@ protected:
 
     antlr_int32_t currentPrime; // jump by 4 primes each expand or whatever
     antlr_int32_t initialBucketCapacity;
+
+    /** Where buckets come from; {@code null} for the heap */
+    ANTLR_NULLABLE
+    Arena* arena;
 };
 
 
@@ -254,7 +274,8 @@ Array2DHashSet<T, K, true>::Array2DHashSet()
         n(0),
         threshold((antlr_uint32_t)(INITAL_CAPACITY * LOAD_FACTOR)),
         currentPrime(1),
-        initialBucketCapacity(INITAL_BUCKET_CAPACITY)
+        initialBucketCapacity(INITAL_BUCKET_CAPACITY),
+        arena(NULL)
 {
     initialize(NULL, INITAL_CAPACITY, INITAL_BUCKET_CAPACITY);
 }
@@ -268,7 +289,8 @@ Array2DHashSet<T, K, true>::Array2DHashSet(ANTLR_NULLABLE const AbstractEquality
         n(0),
         threshold((antlr_uint32_t)(INITAL_CAPACITY * LOAD_FACTOR)),
         currentPrime(1),
-        initialBucketCapacity(INITAL_BUCKET_CAPACITY)
+        initialBucketCapacity(INITAL_BUCKET_CAPACITY),
+        arena(NULL)
 {
     initialize(comparator, INITAL_CAPACITY, INITAL_BUCKET_CAPACITY);
 }
@@ -283,7 +305,25 @@ Array2DHashSet<T, K, true>::Array2DHashSet(ANTLR_NULLABLE const AbstractEquality
         n(0),
         threshold((antlr_uint32_t)(INITAL_CAPACITY * LOAD_FACTOR)),
         currentPrime(1),
-        initialBucketCapacity(INITAL_BUCKET_CAPACITY)
+        initialBucketCapacity(INITAL_BUCKET_CAPACITY),
+        arena(NULL)
+{
+    initialize(comparator, initialCapacity, initialBucketCapacity);
+}
+
+template <typename T, typename K>
+Array2DHashSet<T, K, true>::Array2DHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator,
+        antlr_int32_t initialCapacity, antlr_int32_t initialBucketCapacity,
+        ANTLR_NULLABLE Arena* arena)
+    :   comparator(NULL),
+        buckets(NULL),
+        bucketSizes(NULL),
+        numBuckets(0),
+        n(0),
+        threshold((antlr_uint32_t)(INITAL_CAPACITY * LOAD_FACTOR)),
+        currentPrime(1),
+        initialBucketCapacity(INITAL_BUCKET_CAPACITY),
+        arena(arena)
 {
     initialize(comparator, initialCapacity, initialBucketCapacity);
 }
@@ -627,12 +667,10 @@ const T* Array2DHashSet<T, K, true>::getOrAddImpl(const T& o, bool& added)
 
     // FULL BUCKET, expand and add to end
     TVal* oldBucket = bucket;    
-    bucket = new TVal[bucketLength * 2];
+    bucket = createBucket(bucketLength * 2);
     for (antlr_int32_t i = 0; i < bucketLength; i++)
         bucket[i] = oldBucket[i];
-    for (antlr_int32_t i = bucketLength; i < bucketLength * 2; i++)
-        bucket[i].hasValue = false;
-    delete[] oldBucket;
+    destroyBucket(oldBucket, bucketLength);
 
     buckets[b] = bucket;
     bucketSizes[b] = bucketLength * 2;
@@ -664,8 +702,7 @@ void Array2DHashSet<T, K, true>::expand()
     antlr_int32_t newCapacity = numBuckets * 2;
     numBuckets = newCapacity;
     TVal** newTable = createBuckets(newCapacity, bucketSizes);
-    antlr_int32_t* newBucketLengths = new antlr_int32_t[numBuckets];
-    memset(newBucketLengths, 0, sizeof(antlr_int32_t) * numBuckets);
+    std::vector<antlr_int32_t> newBucketLengths(numBuckets, 0);
     buckets = newTable;
     threshold = (antlr_uint32_t)(newCapacity * LOAD_FACTOR);
     // System.out.println("new size="+newCapacity+", thres="+threshold);
@@ -698,12 +735,10 @@ void Array2DHashSet<T, K, true>::expand()
                 if (bucketLength == bucketSizes[b]) {
                     // expand
                     TVal* oldBucket = newBucket;
-                    newBucket = new TVal[bucketLength * 2];
+                    newBucket = createBucket(bucketLength * 2);
                     for (antlr_int32_t k = 0; k < bucketLength; k++)
                         newBucket[k] = oldBucket[k];
-                    for (antlr_int32_t k = bucketLength; k < bucketLength * 2; k++)
-                        newBucket[k].hasValue = false;
-                    delete[] oldBucket;
+                    destroyBucket(oldBucket, bucketLength);
                     
                     newTable[b] = newBucket;
                     bucketSizes[b] = bucketLength * 2;
@@ -715,13 +750,11 @@ void Array2DHashSet<T, K, true>::expand()
         }
         
         // cleanup old bucket
-        delete[] bucket;
+        destroyBucket(const_cast<TVal*>(bucket), oldSizes[i]);
     }
     
     // cleanup old table
-    delete[] old;
-    delete[] oldSizes;
-    delete[] newBucketLengths;
+    destroyBuckets(old, oldSizes);
 
     assert(n == oldSize);
 }
@@ -735,9 +768,16 @@ void Array2DHashSet<T, K, true>::expand()
 template <typename T, typename K>
 typename Array2DHashSet<T, K, true>::TVal** Array2DHashSet<T, K, true>::createBuckets(antlr_int32_t capacity, antlr_int32_t*& sizes) const
 {
-    TVal** table = new TVal*[capacity];
+    TVal** table;
+    if (arena != NULL) {
+        table = static_cast<TVal**>(arena->allocate(sizeof(TVal*) * capacity));
+        sizes = static_cast<antlr_int32_t*>(arena->allocate(sizeof(antlr_int32_t) * capacity));
+    }
+    else {
+        table = new TVal*[capacity];
+        sizes = new antlr_int32_t[capacity];
+    }
     memset(table, 0, sizeof(TVal*) * capacity);
-    sizes = new antlr_int32_t[capacity];
     memset(sizes, 0, sizeof(antlr_int32_t) * capacity);
     return table;
 }
@@ -751,21 +791,44 @@ typename Array2DHashSet<T, K, true>::TVal** Array2DHashSet<T, K, true>::createBu
 template <typename T, typename K>
 typename Array2DHashSet<T, K, true>::TVal* Array2DHashSet<T, K, true>::createBucket(antlr_int32_t capacity) const
 {
-    TVal* bucket = new TVal[capacity];
+    TVal* bucket = arena != NULL ? arena->newArray<TVal>(capacity) : new TVal[capacity];
     for (antlr_int32_t i = 0; i < capacity; i++)
         bucket[i].hasValue = false;
     return bucket;
 }
 
+template <typename T, typename K>
+void Array2DHashSet<T, K, true>::destroyBucket(TVal* bucket, antlr_int32_t capacity) const
+{
+    if (bucket == NULL) {
+        return;
+    }
+    if (arena == NULL) {
+        delete[] bucket;
+        return;
+    }
+    // the arena owns the memory; only the values need to go
+    for (antlr_int32_t i = 0; i < capacity; i++)
+        bucket[i].~TVal();
+}
+
+template <typename T, typename K>
+void Array2DHashSet<T, K, true>::destroyBuckets(TVal** table, antlr_int32_t* sizes) const
+{
+    if (arena == NULL) {
+        delete[] table;
+        delete[] sizes;
+    }
+}
+
 /* De-allocate buckets */
 template <typename T, typename K>
 void Array2DHashSet<T, K, true>::cleanup()
 {
     for (antlr_int32_t i = 0; i < numBuckets; i++) {
-        delete[] buckets[i];
+        destroyBucket(buckets[i], bucketSizes[i]);
     }
-    delete[] buckets;
-    delete[] bucketSizes;
+    destroyBuckets(buckets, bucketSizes);
     buckets = NULL;
     bucketSizes = NULL;
     numBuckets = 0;
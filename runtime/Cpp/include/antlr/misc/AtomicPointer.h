@@ -0,0 +1,132 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef ATOMIC_POINTER_H
+#define ATOMIC_POINTER_H
+
+#include <antlr/Definitions.h>
+#if defined(HAVE_CXX11)
+#   include <atomic>
+#elif defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+
+namespace antlr4 {
+namespace misc {
+
+/** A pointer that can be read by any number of threads while another
+ *  thread replaces it. {@link #store} has release semantics and
+ *  {@link #load} has acquire semantics, so everything written before a
+ *  pointer is stored is visible to a thread that loads it. Neither
+ *  operation ever blocks.
+ * <p/>
+ *  This only orders the pointer itself; concurrent writers must be
+ *  serialized by the caller.
+ */
+template <typename T>
+class ANTLR_API AtomicPointer
+{
+public:
+
+    AtomicPointer();
+
+    explicit AtomicPointer(T* value);
+
+    T* load() const;
+
+    void store(T* value);
+
+private:
+
+    AtomicPointer(const AtomicPointer<T>&);
+
+    AtomicPointer<T>& operator=(const AtomicPointer<T>&);
+
+private:
+
+#if defined(HAVE_CXX11)
+    std::atomic<T*> value;
+#else
+    T* volatile value;
+#endif
+};
+
+
+template<typename T>
+AtomicPointer<T>::AtomicPointer()
+    :   value(NULL)
+{
+}
+
+template<typename T>
+AtomicPointer<T>::AtomicPointer(T* value)
+    :   value(value)
+{
+}
+
+template<typename T>
+T* AtomicPointer<T>::load() const
+{
+#if defined(HAVE_CXX11)
+    return value.load(std::memory_order_acquire);
+#elif defined(__GNUC__)
+    return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#else
+    // volatile reads have acquire semantics with /volatile:ms
+    T* result = value;
+    _ReadWriteBarrier();
+    return result;
+#endif
+}
+
+template<typename T>
+void AtomicPointer<T>::store(T* value)
+{
+#if defined(HAVE_CXX11)
+    this->value.store(value, std::memory_order_release);
+#elif defined(__GNUC__)
+    __atomic_store_n(&this->value, value, __ATOMIC_RELEASE);
+#else
+    // volatile writes have release semantics with /volatile:ms
+    _ReadWriteBarrier();
+    this->value = value;
+#endif
+}
+
+} /* namespace misc */
+} /* namespace antlr4 */
+
+#endif /* ifndef ATOMIC_POINTER_H */
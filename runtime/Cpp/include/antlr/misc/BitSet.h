@@ -0,0 +1,112 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#ifndef BIT_SET_H
+#define BIT_SET_H
+
+#include <antlr/Definitions.h>
+#include <antlr/misc/Key.h>
+#include <string>
+#include <vector>
+
+namespace antlr4 {
+namespace misc {
+
+
+/** A growable set of non-negative integers, one bit per value; the
+ *  counterpart of {@code java.util.BitSet} used for sets of alternatives.
+ */
+class ANTLR_API BitSet : public virtual Key<BitSet>
+{
+public:
+
+    BitSet();
+
+    BitSet(ANTLR_NOTNULL const BitSet& other);
+
+    BitSet& operator=(const BitSet& other);
+
+    void set(antlr_int32_t bitIndex);
+
+    void clear(antlr_int32_t bitIndex);
+
+    void clear();
+
+    bool get(antlr_int32_t bitIndex) const;
+
+    /** Returns the number of bits set to {@code true} */
+    antlr_int32_t cardinality() const;
+
+    /** Returns the index of the first bit set to {@code true} at or after
+     *  {@code fromIndex}, or -1 if there is no such bit.
+     */
+    antlr_int32_t nextSetBit(antlr_int32_t fromIndex) const;
+
+    bool isEmpty() const;
+
+    /** Sets each bit that is set in {@code other} */
+    void or_(const BitSet& other);
+
+    ANTLR_OVERRIDE
+    bool equals(const Key<BitSet>* o) const;
+
+    ANTLR_OVERRIDE
+    BitSet* clone() const;
+
+    ANTLR_OVERRIDE
+    antlr_int32_t hashCode() const;
+
+    /** Returns the set bits as {@code {1, 3}} */
+    ANTLR_OVERRIDE
+    std::string toString() const;
+
+private:
+
+    /** Number of words up to and including the last non-zero word */
+    antlr_uint32_t wordsInUse() const;
+
+private:
+
+    static const antlr_int32_t BITS_PER_WORD;
+
+    std::vector<antlr_uint32_t> words;
+};
+
+
+} /* namespace misc */
+} /* namespace antlr4 */
+
+#endif /* ifndef BIT_SET_H */
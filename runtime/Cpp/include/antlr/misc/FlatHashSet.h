@@ -0,0 +1,765 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef FLAT_HASH_SET_H
+#define FLAT_HASH_SET_H
+
+#include <antlr/Definitions.h>
+#include <antlr/misc/AbstractEqualityComparator.h>
+#include <antlr/misc/Arena.h>
+#include <antlr/misc/Key.h>
+#include <antlr/misc/MurmurHash.h>
+#include <antlr/misc/ObjectEqualityComparator.h>
+#include <antlr/misc/Traits.h>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define ANTLR_FLAT_HASH_SET_SSE2
+#   include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+namespace antlr4 {
+namespace misc {
+
+/**
+ * An open-addressing hash set with the same interface as
+ * {@link Array2DHashSet}.
+ * <p/>
+ * Values live in one flat slot array. A parallel array of control bytes
+ * holds, for each slot, whether it is empty, deleted or full, and for full
+ * slots 7 bits of the value's hash. Lookups scan the control bytes a
+ * group of {@link #GROUP_WIDTH} at a time (with SSE2 when available) and
+ * only call the comparator for slots whose hash bits match. The full hash
+ * of each value is cached in a third array, which filters out most of the
+ * remaining false matches and lets the table grow without hashing the
+ * values again.
+ * <p/>
+ * Pointers returned by {@link #getOrAdd} and {@link #get} are invalidated
+ * when the set grows.
+ */
+template <typename T, typename K = T, bool K_isBaseOf_T = Traits::super<K, T>::value>
+class ANTLR_API FlatHashSet;
+
+template <typename T, typename K>
+class ANTLR_API FlatHashSet<T, K, true> : public virtual Key< FlatHashSet<T, K, true> >
+{
+public:
+
+    ~FlatHashSet();
+
+    FlatHashSet();
+
+    FlatHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator);
+
+    FlatHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator,
+            antlr_uint32_t initialCapacity);
+
+    /** Draws the slot and control arrays from {@code arena}, which must
+     *  outlive this set. Arrays replaced while growing are not reclaimed
+     *  until the arena is reset.
+     */
+    FlatHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator,
+            antlr_uint32_t initialCapacity, ANTLR_NULLABLE Arena* arena);
+
+    /**
+     * Add {@code o} to set if not there; return existing value if already
+     * there. This method performs the same operation as {@link #add} aside from
+     * the return value.
+     */
+    const T* getOrAdd(const T& o);
+
+    const T* getOrAdd(const T& o, bool& added);
+
+    const T* get(const T& o) const;
+
+    /** Independent of the order in which values were added */
+    ANTLR_OVERRIDE
+    antlr_int32_t hashCode() const;
+
+    ANTLR_OVERRIDE
+    bool equals(const Key< FlatHashSet<T, K, true> >* o) const;
+
+    ANTLR_OVERRIDE
+    FlatHashSet<T, K, true>* clone() const;
+
+    ANTLR_OVERRIDE
+    bool add(const T& t);
+
+    ANTLR_OVERRIDE
+    antlr_uint32_t size() const;
+
+    ANTLR_OVERRIDE
+    bool isEmpty() const;
+
+    ANTLR_OVERRIDE
+    bool contains(const T& o) const;
+
+    bool containsFast(ANTLR_NULLABLE const T* obj) const;
+
+    ANTLR_OVERRIDE
+    antlr_auto_ptr< std::vector<const T*> > toPtrArray() const;
+
+    ANTLR_OVERRIDE
+    antlr_auto_ptr< std::vector<T> > toArray() const;
+
+    template <typename U>
+    std::vector<U>& toArray(std::vector<U>& a) const;
+
+    ANTLR_OVERRIDE
+    bool remove(const T& o);
+
+    bool removeFast(ANTLR_NULLABLE const T* obj);
+
+    ANTLR_OVERRIDE
+    bool containsAll(const FlatHashSet<T, K, true>& other) const;
+
+    /** Removes every value but keeps the current capacity */
+    ANTLR_OVERRIDE
+    void clear();
+
+    ANTLR_OVERRIDE
+    std::string toString() const;
+
+    /** Number of slots, full or not */
+    antlr_uint32_t getCapacity() const;
+
+protected:
+
+    /** Returns the slot holding a value equal to {@code o}, or -1 */
+    antlr_int32_t find(const T& o, antlr_uint32_t hash) const;
+
+    /** Returns the first empty or deleted slot on the probe sequence of {@code hash} */
+    antlr_uint32_t findInsertSlot(antlr_uint32_t hash) const;
+
+    /** Moves every value into tables of {@code newCapacity} slots */
+    void rehash(antlr_uint32_t newCapacity);
+
+    void allocate(antlr_uint32_t capacity);
+
+    /** Destroys the values and releases the tables */
+    void cleanup();
+
+    void setCtrl(antlr_uint32_t i, unsigned char c);
+
+    bool isFull(antlr_uint32_t i) const;
+
+    /** Spreads the comparator's hash over all 32 bits */
+    static antlr_uint32_t mix(antlr_int32_t hash);
+
+    /** Hash bits stored in the control byte of a full slot */
+    static unsigned char h2(antlr_uint32_t hash);
+
+    /** Bit {@code i} set if {@code group[i]==c} */
+    static antlr_uint32_t matchByte(const unsigned char* group, unsigned char c);
+
+    /** Bit {@code i} set if {@code group[i]} is {@link #EMPTY} */
+    static antlr_uint32_t matchEmpty(const unsigned char* group);
+
+    /** Bit {@code i} set if {@code group[i]} is {@link #EMPTY} or {@link #DELETED} */
+    static antlr_uint32_t matchEmptyOrDeleted(const unsigned char* group);
+
+    static antlr_uint32_t lowestBit(antlr_uint32_t mask);
+
+public:
+
+    static const antlr_uint32_t GROUP_WIDTH = 16;
+
+    static const antlr_uint32_t INITIAL_CAPACITY = 16; // must be power of 2
+
+protected:
+
+    static const unsigned char EMPTY = 0x80;
+
+    static const unsigned char DELETED = 0xFE;
+
+protected:
+
+    ANTLR_NOTNULL
+    const AbstractEqualityComparator<K>* comparator;
+
+    /** One control byte per slot, followed by a copy of the first
+     *  {@link #GROUP_WIDTH} bytes so groups can be read past the end.
+     */
+    unsigned char* ctrl;
+
+    /** Mixed hash of the value in each full slot */
+    antlr_uint32_t* hashes;
+
+    T* slots;
+
+    antlr_uint32_t capacity;
+
+    /** How many elements in set */
+    antlr_uint32_t n;
+
+    /** Slots that can still be filled before the set must grow; deleted
+     *  slots don't count as free.
+     */
+    antlr_uint32_t growthLeft;
+
+    /** Where the tables come from; {@code null} for the heap */
+    ANTLR_NULLABLE
+    Arena* arena;
+
+private:
+
+    FlatHashSet(const FlatHashSet&);
+
+    FlatHashSet& operator=(const FlatHashSet&);
+};
+
+
+template <typename T, typename K>
+const antlr_uint32_t FlatHashSet<T, K, true>::GROUP_WIDTH;
+
+template <typename T, typename K>
+const antlr_uint32_t FlatHashSet<T, K, true>::INITIAL_CAPACITY;
+
+template <typename T, typename K>
+const unsigned char FlatHashSet<T, K, true>::EMPTY;
+
+template <typename T, typename K>
+const unsigned char FlatHashSet<T, K, true>::DELETED;
+
+template <typename T, typename K>
+FlatHashSet<T, K, true>::~FlatHashSet()
+{
+    cleanup();
+}
+
+template <typename T, typename K>
+FlatHashSet<T, K, true>::FlatHashSet()
+    :   comparator(&ObjectEqualityComparator<T>::INSTANCE),
+        ctrl(NULL),
+        hashes(NULL),
+        slots(NULL),
+        capacity(0),
+        n(0),
+        growthLeft(0),
+        arena(NULL)
+{
+    allocate(INITIAL_CAPACITY);
+}
+
+template <typename T, typename K>
+FlatHashSet<T, K, true>::FlatHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator)
+    :   comparator(comparator != NULL ? comparator : &ObjectEqualityComparator<T>::INSTANCE),
+        ctrl(NULL),
+        hashes(NULL),
+        slots(NULL),
+        capacity(0),
+        n(0),
+        growthLeft(0),
+        arena(NULL)
+{
+    allocate(INITIAL_CAPACITY);
+}
+
+template <typename T, typename K>
+FlatHashSet<T, K, true>::FlatHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator,
+        antlr_uint32_t initialCapacity)
+    :   comparator(comparator != NULL ? comparator : &ObjectEqualityComparator<T>::INSTANCE),
+        ctrl(NULL),
+        hashes(NULL),
+        slots(NULL),
+        capacity(0),
+        n(0),
+        growthLeft(0),
+        arena(NULL)
+{
+    antlr_uint32_t c = INITIAL_CAPACITY;
+    while (c < initialCapacity) c <<= 1;
+    allocate(c);
+}
+
+template <typename T, typename K>
+FlatHashSet<T, K, true>::FlatHashSet(ANTLR_NULLABLE const AbstractEqualityComparator<K>* comparator,
+        antlr_uint32_t initialCapacity, ANTLR_NULLABLE Arena* arena)
+    :   comparator(comparator != NULL ? comparator : &ObjectEqualityComparator<T>::INSTANCE),
+        ctrl(NULL),
+        hashes(NULL),
+        slots(NULL),
+        capacity(0),
+        n(0),
+        growthLeft(0),
+        arena(arena)
+{
+    antlr_uint32_t c = INITIAL_CAPACITY;
+    while (c < initialCapacity) c <<= 1;
+    allocate(c);
+}
+
+template <typename T, typename K>
+const T* FlatHashSet<T, K, true>::getOrAdd(const T& o)
+{
+    bool added = false;
+    return getOrAdd(o, added);
+}
+
+template <typename T, typename K>
+const T* FlatHashSet<T, K, true>::getOrAdd(const T& o, bool& added)
+{
+    antlr_uint32_t hash = mix(comparator->hashCode(o));
+    antlr_int32_t existing = find(o, hash);
+    if ( existing>=0 ) {
+        added = false;
+        return &slots[existing];
+    }
+
+    antlr_uint32_t i = findInsertSlot(hash);
+    if ( growthLeft==0 && ctrl[i]!=DELETED ) {
+        // too many tombstones means the same capacity will do
+        rehash(n * 2 >= capacity - capacity / 8 ? capacity * 2 : capacity);
+        i = findInsertSlot(hash);
+    }
+    if ( ctrl[i]==EMPTY ) {
+        growthLeft--;
+    }
+    new (&slots[i]) T(o);
+    hashes[i] = hash;
+    setCtrl(i, h2(hash));
+    n++;
+    added = true;
+    return &slots[i];
+}
+
+template <typename T, typename K>
+const T* FlatHashSet<T, K, true>::get(const T& o) const
+{
+    antlr_int32_t i = find(o, mix(comparator->hashCode(o)));
+    return i>=0 ? &slots[i] : NULL;
+}
+
+template <typename T, typename K>
+antlr_int32_t FlatHashSet<T, K, true>::hashCode() const
+{
+    antlr_uint32_t sum = 0;
+    for (antlr_uint32_t i = 0; i < capacity; i++) {
+        if ( isFull(i) ) sum += static_cast<antlr_uint32_t>(comparator->hashCode(slots[i]));
+    }
+    antlr_int32_t hash = MurmurHash::initialize();
+    hash = MurmurHash::update(hash, static_cast<antlr_int32_t>(sum));
+    return MurmurHash::finish(hash, size());
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::equals(const Key< FlatHashSet<T, K, true> >* o) const
+{
+    const FlatHashSet<T, K, true>* other = dynamic_cast<const FlatHashSet<T, K, true>*>(o);
+    if (other == NULL) return false;
+    if ( other->size() != size() ) return false;
+    return this->containsAll(*other);
+}
+
+template <typename T, typename K>
+FlatHashSet<T, K, true>* FlatHashSet<T, K, true>::clone() const
+{
+    throw std::logic_error("FlatHashSet::clone not supported");
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::add(const T& t)
+{
+    bool added = false;
+    getOrAdd(t, added);
+    return added;
+}
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::size() const
+{
+    return n;
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::isEmpty() const
+{
+    return n==0;
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::contains(const T& o) const
+{
+    return containsFast(&o);
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::containsFast(ANTLR_NULLABLE const T* obj) const
+{
+    if (obj == NULL) {
+        return false;
+    }
+
+    return get(*obj) != NULL;
+}
+
+template <typename T, typename K>
+antlr_auto_ptr< std::vector<const T*> > FlatHashSet<T, K, true>::toPtrArray() const
+{
+    antlr_auto_ptr< std::vector<const T*> > a(new std::vector<const T*>());
+    a->reserve(size());
+    for (antlr_uint32_t i = 0; i < capacity; i++) {
+        if ( isFull(i) ) a->push_back(&slots[i]);
+    }
+    return a;
+}
+
+template <typename T, typename K>
+antlr_auto_ptr< std::vector<T> > FlatHashSet<T, K, true>::toArray() const
+{
+    antlr_auto_ptr< std::vector<T> > a(new std::vector<T>());
+    a->reserve(size());
+    for (antlr_uint32_t i = 0; i < capacity; i++) {
+        if ( isFull(i) ) a->push_back(slots[i]);
+    }
+    return a;
+}
+
+template <typename T, typename K>
+template <typename U>
+std::vector<U>& FlatHashSet<T, K, true>::toArray(std::vector<U>& a) const
+{
+    a.reserve(size());
+    a.clear();
+    for (antlr_uint32_t i = 0; i < capacity; i++) {
+        if ( isFull(i) ) a.push_back(static_cast<U>(slots[i]));
+    }
+    return a;
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::remove(const T& o)
+{
+    return removeFast(&o);
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::removeFast(ANTLR_NULLABLE const T* obj)
+{
+    if (obj == NULL) {
+        return false;
+    }
+
+    antlr_int32_t i = find(*obj, mix(comparator->hashCode(*obj)));
+    if ( i<0 ) {
+        return false;
+    }
+
+    slots[i].~T();
+    // If every group-sized window holding slot i also holds an empty slot,
+    // no probe ever went past i and it can become empty again rather than
+    // a tombstone.
+    antlr_uint32_t before = (static_cast<antlr_uint32_t>(i) - GROUP_WIDTH) & (capacity - 1);
+    antlr_uint32_t emptyBefore = matchEmpty(&ctrl[before]);
+    antlr_uint32_t emptyAfter = matchEmpty(&ctrl[i]);
+    bool wasNeverFull = false;
+    if ( emptyBefore!=0 && emptyAfter!=0 ) {
+        antlr_uint32_t fullBefore = 0;
+        while ( (emptyBefore & (1U << (GROUP_WIDTH - 1 - fullBefore)))==0 ) fullBefore++;
+        wasNeverFull = lowestBit(emptyAfter) + fullBefore < GROUP_WIDTH;
+    }
+    if ( wasNeverFull ) {
+        setCtrl(static_cast<antlr_uint32_t>(i), EMPTY);
+        growthLeft++;
+    }
+    else {
+        setCtrl(static_cast<antlr_uint32_t>(i), DELETED);
+    }
+    n--;
+    return true;
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::containsAll(const FlatHashSet<T, K, true>& other) const
+{
+    for (antlr_uint32_t i = 0; i < other.capacity; i++) {
+        if ( other.isFull(i) && !this->containsFast(&other.slots[i]) ) return false;
+    }
+    return true;
+}
+
+template <typename T, typename K>
+void FlatHashSet<T, K, true>::clear()
+{
+    for (antlr_uint32_t i = 0; i < capacity; i++) {
+        if ( isFull(i) ) slots[i].~T();
+    }
+    memset(ctrl, EMPTY, capacity + GROUP_WIDTH);
+    n = 0;
+    growthLeft = capacity - capacity / 8;
+}
+
+template <typename T, typename K>
+std::string FlatHashSet<T, K, true>::toString() const
+{
+    if ( size()==0 ) return "{}";
+
+    std::stringstream buf;
+    buf << "{";
+    bool first = true;
+    for (antlr_uint32_t i = 0; i < capacity; i++) {
+        if ( !isFull(i) ) continue;
+        if ( first ) first=false;
+        else buf << ", ";
+        buf << slots[i];
+    }
+    buf << "}";
+    return buf.str();
+}
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::getCapacity() const
+{
+    return capacity;
+}
+
+template <typename T, typename K>
+antlr_int32_t FlatHashSet<T, K, true>::find(const T& o, antlr_uint32_t hash) const
+{
+    const antlr_uint32_t mask = capacity - 1;
+    const unsigned char tag = h2(hash);
+    antlr_uint32_t pos = hash & mask;
+    for (antlr_uint32_t step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+        const unsigned char* group = &ctrl[pos];
+        for (antlr_uint32_t m = matchByte(group, tag); m != 0; m &= m - 1) {
+            antlr_uint32_t i = (pos + lowestBit(m)) & mask;
+            if ( hashes[i]==hash && comparator->equals(slots[i], o) ) {
+                return static_cast<antlr_int32_t>(i);
+            }
+        }
+        if ( matchEmpty(group)!=0 ) {
+            return -1;
+        }
+        pos = (pos + step) & mask;
+    }
+}
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::findInsertSlot(antlr_uint32_t hash) const
+{
+    const antlr_uint32_t mask = capacity - 1;
+    antlr_uint32_t pos = hash & mask;
+    for (antlr_uint32_t step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+        antlr_uint32_t m = matchEmptyOrDeleted(&ctrl[pos]);
+        if ( m!=0 ) {
+            return (pos + lowestBit(m)) & mask;
+        }
+        pos = (pos + step) & mask;
+    }
+}
+
+template <typename T, typename K>
+void FlatHashSet<T, K, true>::rehash(antlr_uint32_t newCapacity)
+{
+    unsigned char* oldCtrl = ctrl;
+    antlr_uint32_t* oldHashes = hashes;
+    T* oldSlots = slots;
+    antlr_uint32_t oldCapacity = capacity;
+
+    allocate(newCapacity);
+    for (antlr_uint32_t i = 0; i < oldCapacity; i++) {
+        if ( (oldCtrl[i] & 0x80)!=0 ) continue;
+        // the cached hash spares us calling the comparator again
+        antlr_uint32_t j = findInsertSlot(oldHashes[i]);
+        new (&slots[j]) T(oldSlots[i]);
+        oldSlots[i].~T();
+        hashes[j] = oldHashes[i];
+        setCtrl(j, oldCtrl[i]);
+        growthLeft--;
+        n++;
+    }
+
+    if (arena == NULL) {
+        delete[] oldCtrl;
+        delete[] oldHashes;
+        ::operator delete(oldSlots);
+    }
+}
+
+template <typename T, typename K>
+void FlatHashSet<T, K, true>::allocate(antlr_uint32_t capacity)
+{
+    if (arena != NULL) {
+        ctrl = static_cast<unsigned char*>(arena->allocate(capacity + GROUP_WIDTH, GROUP_WIDTH));
+        hashes = static_cast<antlr_uint32_t*>(arena->allocate(sizeof(antlr_uint32_t) * capacity));
+        slots = static_cast<T*>(arena->allocate(sizeof(T) * capacity));
+    }
+    else {
+        ctrl = new unsigned char[capacity + GROUP_WIDTH];
+        hashes = new antlr_uint32_t[capacity];
+        slots = static_cast<T*>(::operator new(sizeof(T) * capacity));
+    }
+    memset(ctrl, EMPTY, capacity + GROUP_WIDTH);
+    this->capacity = capacity;
+    n = 0;
+    growthLeft = capacity - capacity / 8;
+}
+
+template <typename T, typename K>
+void FlatHashSet<T, K, true>::cleanup()
+{
+    for (antlr_uint32_t i = 0; i < capacity; i++) {
+        if ( isFull(i) ) slots[i].~T();
+    }
+    if (arena == NULL) {
+        delete[] ctrl;
+        delete[] hashes;
+        ::operator delete(slots);
+    }
+    ctrl = NULL;
+    hashes = NULL;
+    slots = NULL;
+    capacity = 0;
+    n = 0;
+    growthLeft = 0;
+}
+
+template <typename T, typename K>
+void FlatHashSet<T, K, true>::setCtrl(antlr_uint32_t i, unsigned char c)
+{
+    ctrl[i] = c;
+    if (i < GROUP_WIDTH) {
+        ctrl[capacity + i] = c; // keep the mirror in sync
+    }
+}
+
+template <typename T, typename K>
+bool FlatHashSet<T, K, true>::isFull(antlr_uint32_t i) const
+{
+    return (ctrl[i] & 0x80) == 0;
+}
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::mix(antlr_int32_t hash)
+{
+    antlr_uint32_t h = static_cast<antlr_uint32_t>(hash);
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35U;
+    h ^= h >> 16;
+    return h;
+}
+
+template <typename T, typename K>
+unsigned char FlatHashSet<T, K, true>::h2(antlr_uint32_t hash)
+{
+    return static_cast<unsigned char>(hash >> 25);
+}
+
+#ifdef ANTLR_FLAT_HASH_SET_SSE2
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::matchByte(const unsigned char* group, unsigned char c)
+{
+    __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<antlr_uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(static_cast<char>(c)))));
+}
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::matchEmpty(const unsigned char* group)
+{
+    return matchByte(group, EMPTY);
+}
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::matchEmptyOrDeleted(const unsigned char* group)
+{
+    // EMPTY and DELETED are the only control bytes with the top bit set
+    __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<antlr_uint32_t>(_mm_movemask_epi8(g));
+}
+
+#else /* ANTLR_FLAT_HASH_SET_SSE2 */
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::matchByte(const unsigned char* group, unsigned char c)
+{
+    antlr_uint32_t m = 0;
+    for (antlr_uint32_t i = 0; i < GROUP_WIDTH; i++) {
+        if (group[i] == c) m |= 1U << i;
+    }
+    return m;
+}
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::matchEmpty(const unsigned char* group)
+{
+    return matchByte(group, EMPTY);
+}
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::matchEmptyOrDeleted(const unsigned char* group)
+{
+    antlr_uint32_t m = 0;
+    for (antlr_uint32_t i = 0; i < GROUP_WIDTH; i++) {
+        if ((group[i] & 0x80) != 0) m |= 1U << i;
+    }
+    return m;
+}
+
+#endif /* ANTLR_FLAT_HASH_SET_SSE2 */
+
+template <typename T, typename K>
+antlr_uint32_t FlatHashSet<T, K, true>::lowestBit(antlr_uint32_t mask)
+{
+#if defined(__GNUC__)
+    return static_cast<antlr_uint32_t>(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<antlr_uint32_t>(index);
+#else
+    antlr_uint32_t i = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+} /* namespace misc */
+} /* namespace antlr4 */
+
+#endif /* ifndef FLAT_HASH_SET_H */
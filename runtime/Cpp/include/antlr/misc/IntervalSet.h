@@ -103,9 +103,25 @@ public:
     void add(antlr_int32_t a, antlr_int32_t b);
 
 
-    /** combine all sets in the array returned the or'd value */
+    /** combine all sets in the array returned the or'd value.  The sets
+     *  are merged in a single k-way pass over their sorted intervals.
+     */
     static IntervalSet or_(const std::vector<IntervalSet>& sets);
 
+    /** Return the union of this set with other. */
+    IntervalSet or_(const IntervalSet& other) const;
+
+    /** Return the intersection of this set with other. */
+    IntervalSet and_(const IntervalSet& other) const;
+
+    /** Return the elements in this set but not in other. */
+    IntervalSet subtract(const IntervalSet& other) const;
+
+    /** Return the non-negative elements of vocabulary not in this set, or
+     *  an empty set if this set is empty.
+     */
+    IntervalSet complement(const IntervalSet& vocabulary) const;
+
     ANTLR_OVERRIDE
     IntervalSet* addAll(const IntSet* set);
 
@@ -139,7 +155,10 @@ public:
     ANTLR_OVERRIDE
     IntervalSet* and_(const IntSet* other) const;
 
-    /** Is el in any range of this set? */
+    /** Is el in any range of this set?  A readonly set answers from its
+     *  bitmaps for characters they cover, otherwise this is a binary search
+     *  over the intervals.
+     */
     ANTLR_OVERRIDE
     bool contains(antlr_int32_t el) const;
 
@@ -203,8 +222,14 @@ public:
 
     bool isReadonly() const;
 
+    /** Making a set readonly also builds its membership bitmaps; see
+     *  {@link #asciiBits} and {@link #bmpBits}.
+     */
     void setReadonly(bool readonly);
 
+    /** Does this readonly set have a bitmap for the Basic Multilingual Plane? */
+    bool hasBmpBitmap() const;
+
     
 protected:
     
@@ -213,6 +238,45 @@ protected:
 
     std::string elementName(const std::vector<std::string>& tokenNames,
         antlr_uint32_t a) const;
+
+    void buildBitmaps();
+
+    /** The set operations below merge sorted, disjoint interval lists in
+     *  one linear pass, appending to result.
+     */
+    static void orIntervals(const std::vector<Interval>& left,
+                            const std::vector<Interval>& right,
+                            std::vector<Interval>& result);
+
+    static void andIntervals(const std::vector<Interval>& left,
+                             const std::vector<Interval>& right,
+                             std::vector<Interval>& result);
+
+    static void subtractIntervals(const std::vector<Interval>& left,
+                                  const std::vector<Interval>& right,
+                                  std::vector<Interval>& result);
+
+    static void complementIntervals(const std::vector<Interval>& intervals,
+                                    const std::vector<Interval>& vocabulary,
+                                    std::vector<Interval>& result);
+
+    /** Append a..b, merging it into the last interval of result when they
+     *  overlap or are adjacent.  a must not start before the last interval.
+     */
+    static void append(std::vector<Interval>& result, antlr_int32_t a, antlr_int32_t b);
+
+    /** Return the first index at or after i of an interval ending at or
+     *  after el.  Galloping lets a small set skip through a large one in
+     *  logarithmic time.
+     */
+    static antlr_uint32_t skipBefore(const std::vector<Interval>& intervals,
+                                     antlr_uint32_t i,
+                                     antlr_int32_t el);
+
+    /** Find the interval that could hold el, without branching on the
+     *  comparisons so the loop doesn't suffer mispredictions.
+     */
+    bool search(antlr_int32_t el) const;
     
 
 public:
@@ -220,6 +284,18 @@ public:
     static const IntervalSet COMPLETE_CHAR_SET;
     static const IntervalSet EMPTY_SET;
 
+    /** Number of characters covered by {@link #asciiBits}. */
+    static const antlr_int32_t ASCII_BITMAP_SIZE = 0x80;
+
+    /** Number of characters covered by {@link #bmpBits}. */
+    static const antlr_int32_t BMP_BITMAP_SIZE = 0x10000;
+
+    /** A readonly set gets a {@link #bmpBits} bitmap when it has members
+     *  above ASCII in the BMP and at least this many intervals; smaller
+     *  sets are searched quickly enough to not be worth 8K.
+     */
+    static const antlr_uint32_t BMP_BITMAP_MIN_INTERVALS = 4;
+
 protected:
 
     /** The list of sorted, disjoint intervals. */
@@ -227,6 +303,14 @@ protected:
 
     bool readonly;
 
+    /** Membership of 0..{@link #ASCII_BITMAP_SIZE}-1, valid while readonly. */
+    antlr_uint32_t asciiBits[ASCII_BITMAP_SIZE / 32];
+
+    /** Membership of 0..{@link #BMP_BITMAP_SIZE}-1 when readonly, if the set
+     *  qualifies for it; empty otherwise.
+     */
+    std::vector<antlr_uint32_t> bmpBits;
+
 };
 
 } /* namespace misc */
@@ -60,6 +60,9 @@ public:
     ANTLR_OVERRIDE
     antlr_int32_t hashCode() const;
 
+    ANTLR_OVERRIDE
+    bool equals(const Key< KeyPtr<T, true> >* o) const;
+
     KeyPtr();
     
     KeyPtr(T* ptr, bool hasOwnership = true);
@@ -127,6 +130,19 @@ antlr_int32_t KeyPtr<T, true>::hashCode() const
     }
 }
 
+template <typename T>
+bool KeyPtr<T, true>::equals(const Key< KeyPtr<T, true> >* o) const
+{
+    const KeyPtr<T, true>* other = dynamic_cast<const KeyPtr<T, true>*>(o);
+    if (other == NULL || hashCode() != other->hashCode()) {
+        return false;
+    }
+    if (ptr.get() == other->ptr.get()) {
+        return true;
+    }
+    return ptr->equals(other->ptr.get());
+}
+
 template <typename T>
 KeyPtr<T, true>::KeyPtr()
     :   hasOwnership(true)
@@ -107,6 +107,12 @@ public:
     template <typename T>
     static antlr_int32_t hashCode(const std::vector<T>& items, antlr_int32_t seed);
 
+    /** Like {@link #hashCode}, for any container with {@code begin()},
+     *  {@code end()} and {@code size()}.
+     */
+    template <typename List>
+    static antlr_int32_t hashCodeOfList(const List& items, antlr_int32_t seed);
+
 private:
 
     MurmurHash();
@@ -124,9 +130,15 @@ antlr_int32_t MurmurHash::update(antlr_int32_t hash, const Key<T>* value)
 
 template<typename T>
 antlr_int32_t MurmurHash::hashCode(const std::vector<T>& items, antlr_int32_t seed)
+{
+    return hashCodeOfList(items, seed);
+}
+
+template<typename List>
+antlr_int32_t MurmurHash::hashCodeOfList(const List& items, antlr_int32_t seed)
 {
     antlr_int32_t hash = initialize(seed);
-    for (typename std::vector<T>::const_iterator it = items.begin(); it != items.end(); it++) {
+    for (typename List::const_iterator it = items.begin(); it != items.end(); it++) {
         hash = update(hash, *it);
     }
     hash = finish(hash, static_cast<antlr_int32_t>(items.size()));
@@ -118,7 +118,7 @@ public:
     bool isHeld() const;
 };
 
-class ANTLR_API Mutex
+class ANTLR_API Mutex : public MutexBase
 {
 public:
     Mutex();
@@ -0,0 +1,255 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <antlr/Definitions.h>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+
+namespace antlr4 {
+namespace misc {
+
+
+/** A vector that keeps its first {@code N} elements inside the object and
+ *  only goes to the heap once it grows past them. Iterators are plain
+ *  pointers and, as with {@code std::vector}, are invalidated by growth.
+ */
+template <typename T, antlr_uint32_t N>
+class ANTLR_API SmallVector
+{
+public:
+
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef size_t size_type;
+
+    ~SmallVector();
+
+    SmallVector();
+
+    SmallVector(const SmallVector& other);
+
+    SmallVector& operator=(const SmallVector& other);
+
+    iterator begin() { return items; }
+
+    iterator end() { return items + numItems; }
+
+    const_iterator begin() const { return items; }
+
+    const_iterator end() const { return items + numItems; }
+
+    size_type size() const { return numItems; }
+
+    bool empty() const { return numItems == 0; }
+
+    size_type capacity() const { return maxItems; }
+
+    /** Returns {@code true} while the elements are stored inside the object */
+    bool isInline() const { return items == inlineItems(); }
+
+    T& operator[](size_type i) { return items[i]; }
+
+    const T& operator[](size_type i) const { return items[i]; }
+
+    const T& at(size_type i) const;
+
+    T& back() { return items[numItems - 1]; }
+
+    const T& back() const { return items[numItems - 1]; }
+
+    void push_back(const T& value);
+
+    void pop_back();
+
+    void clear();
+
+    void reserve(size_type capacity);
+
+    bool operator==(const SmallVector& other) const;
+
+    bool operator!=(const SmallVector& other) const { return !(*this == other); }
+
+private:
+
+    T* inlineItems() const { return reinterpret_cast<T*>(const_cast<char*>(storage.bytes)); }
+
+    void destroyAll();
+
+private:
+
+    T* items;
+
+    size_type numItems;
+
+    size_type maxItems;
+
+    union
+    {
+        char bytes[N * sizeof(T)];
+        double alignDouble;
+        void* alignPointer;
+    } storage;
+};
+
+
+template <typename T, antlr_uint32_t N>
+SmallVector<T, N>::~SmallVector()
+{
+    destroyAll();
+}
+
+template <typename T, antlr_uint32_t N>
+SmallVector<T, N>::SmallVector()
+    :   items(inlineItems()),
+        numItems(0),
+        maxItems(N)
+{
+}
+
+template <typename T, antlr_uint32_t N>
+SmallVector<T, N>::SmallVector(const SmallVector& other)
+    :   items(inlineItems()),
+        numItems(0),
+        maxItems(N)
+{
+    reserve(other.numItems);
+    for (const_iterator it = other.begin(); it != other.end(); it++)
+        push_back(*it);
+}
+
+template <typename T, antlr_uint32_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& other)
+{
+    if (this != &other) {
+        clear();
+        reserve(other.numItems);
+        for (const_iterator it = other.begin(); it != other.end(); it++)
+            push_back(*it);
+    }
+    return *this;
+}
+
+template <typename T, antlr_uint32_t N>
+const T& SmallVector<T, N>::at(size_type i) const
+{
+    if (i >= numItems) {
+        throw std::out_of_range("SmallVector::at index out of range");
+    }
+    return items[i];
+}
+
+template <typename T, antlr_uint32_t N>
+void SmallVector<T, N>::push_back(const T& value)
+{
+    if (numItems == maxItems) {
+        // value may live in the storage we're about to release
+        T copy(value);
+        reserve(maxItems * 2);
+        new (&items[numItems]) T(copy);
+    }
+    else {
+        new (&items[numItems]) T(value);
+    }
+    numItems++;
+}
+
+template <typename T, antlr_uint32_t N>
+void SmallVector<T, N>::pop_back()
+{
+    numItems--;
+    items[numItems].~T();
+}
+
+template <typename T, antlr_uint32_t N>
+void SmallVector<T, N>::clear()
+{
+    while (numItems > 0)
+        pop_back();
+}
+
+template <typename T, antlr_uint32_t N>
+void SmallVector<T, N>::reserve(size_type capacity)
+{
+    if (capacity <= maxItems) {
+        return;
+    }
+
+    T* grown = static_cast<T*>(::operator new(capacity * sizeof(T)));
+    for (size_type i = 0; i < numItems; i++) {
+        new (&grown[i]) T(items[i]);
+        items[i].~T();
+    }
+    if (!isInline()) {
+        ::operator delete(items);
+    }
+    items = grown;
+    maxItems = capacity;
+}
+
+template <typename T, antlr_uint32_t N>
+bool SmallVector<T, N>::operator==(const SmallVector& other) const
+{
+    if (numItems != other.numItems) {
+        return false;
+    }
+    for (size_type i = 0; i < numItems; i++) {
+        if (!(items[i] == other.items[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, antlr_uint32_t N>
+void SmallVector<T, N>::destroyAll()
+{
+    clear();
+    if (!isInline()) {
+        ::operator delete(items);
+    }
+    items = inlineItems();
+    maxItems = N;
+}
+
+
+} /* namespace misc */
+} /* namespace antlr4 */
+
+#endif /* ifndef SMALL_VECTOR_H */
@@ -0,0 +1,95 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#ifndef TEXT_VIEW_H
+#define TEXT_VIEW_H
+
+#include <antlr/Definitions.h>
+#include <cstddef>
+#include <string>
+
+
+namespace antlr4 {
+namespace misc {
+
+/** A read-only view of UTF-8 text owned by someone else, typically the
+ *  buffer of a {@link CharStream}. Copying a view never copies the text,
+ *  so a view is only valid as long as the buffer it points into.
+ * <p/>
+ *  A default-constructed view has {@code NULL} data; streams and tokens
+ *  return one when they cannot point at their text without copying it.
+ */
+class ANTLR_API TextView
+{
+public:
+
+    TextView();
+
+    TextView(ANTLR_NULLABLE const char* data, size_t length);
+
+    /** The first byte of the text, or {@code NULL} if there is no text */
+    const char* data() const { return text; }
+
+    /** The number of bytes in the text */
+    size_t size() const { return length; }
+
+    bool empty() const { return length == 0; }
+
+    const char* begin() const { return text; }
+
+    const char* end() const { return text + length; }
+
+    /** Copies the text into a new string */
+    std::string str() const;
+
+    bool operator==(const TextView& other) const;
+
+    bool operator!=(const TextView& other) const;
+
+    bool operator==(const std::string& other) const;
+
+    bool operator!=(const std::string& other) const;
+
+private:
+
+    const char* text;
+    size_t length;
+};
+
+} /* namespace misc */
+} /* namespace antlr4 */
+
+#endif /* ifndef TEXT_VIEW_H */
@@ -34,8 +34,149 @@
  */
 
 #include <antlr/ANTLRFileStream.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#   define ANTLR_MMAP_POSIX
+#elif defined(_WIN32)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#   define ANTLR_MMAP_WIN32
+#endif
 
 namespace antlr4 {
 
 
+ANTLRFileStream::ANTLRFileStream(const std::string& fileName)
+    :   fileName(fileName),
+        mapping(NULL),
+        mappingSize(0)
+{
+    load(fileName);
+}
+
+ANTLRFileStream::~ANTLRFileStream()
+{
+    unload();
+}
+
+#if defined(ANTLR_MMAP_POSIX)
+
+void ANTLRFileStream::load(const std::string& fileName)
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open file " + fileName);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("cannot stat file " + fileName);
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+        void* view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("cannot map file " + fileName);
+        }
+        // the lexer reads front to back
+        madvise(view, size, MADV_SEQUENTIAL);
+        mapping = view;
+        mappingSize = size;
+    }
+    close(fd);
+
+    ANTLRInputStream::load(static_cast<const char*>(mapping), mappingSize);
+}
+
+void ANTLRFileStream::unload()
+{
+    if (mapping != NULL) {
+        munmap(mapping, mappingSize);
+        mapping = NULL;
+        mappingSize = 0;
+    }
+}
+
+#elif defined(ANTLR_MMAP_WIN32)
+
+void ANTLRFileStream::load(const std::string& fileName)
+{
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("cannot open file " + fileName);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("cannot stat file " + fileName);
+    }
+
+    if (size.QuadPart > 0) {
+        HANDLE section = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        void* view = section != NULL ? MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (section != NULL) {
+            // the view keeps the section alive
+            CloseHandle(section);
+        }
+        if (view == NULL) {
+            CloseHandle(file);
+            throw std::runtime_error("cannot map file " + fileName);
+        }
+        mapping = view;
+        mappingSize = static_cast<size_t>(size.QuadPart);
+    }
+    CloseHandle(file);
+
+    ANTLRInputStream::load(static_cast<const char*>(mapping), mappingSize);
+}
+
+void ANTLRFileStream::unload()
+{
+    if (mapping != NULL) {
+        UnmapViewOfFile(mapping);
+        mapping = NULL;
+        mappingSize = 0;
+    }
+}
+
+#else
+
+void ANTLRFileStream::load(const std::string& fileName)
+{
+    std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open file " + fileName);
+    }
+
+    std::stringstream contents;
+    contents << in.rdbuf();
+    buffer = contents.str();
+    ANTLRInputStream::load(buffer.data(), buffer.size());
+}
+
+void ANTLRFileStream::unload()
+{
+}
+
+#endif
+
+std::string ANTLRFileStream::getSourceName()
+{
+    return fileName;
+}
+
+
 } /* namespace antlr4 */
@@ -34,8 +34,297 @@
  */
 
 #include <antlr/ANTLRInputStream.h>
+#include <antlr/IntStream.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
 
 namespace antlr4 {
 
 
+const antlr_int32_t ANTLRInputStream::INDEX_INTERVAL = 1024;
+
+namespace {
+
+/** Code point returned for malformed UTF-8 */
+const antlr_int32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+inline bool isContinuation(unsigned char c)
+{
+    return (c & 0xC0) == 0x80;
+}
+
+} /* anonymous namespace */
+
+ANTLRInputStream::ANTLRInputStream()
+    :   data(NULL),
+        numBytes(0),
+        p(0),
+        offset(0),
+        n(0)
+{
+    checkpoints.push_back(0);
+}
+
+ANTLRInputStream::ANTLRInputStream(const std::string& input)
+    :   data(NULL),
+        numBytes(0),
+        p(0),
+        offset(0),
+        n(-1),
+        buffer(input)
+{
+    load(buffer.data(), buffer.size());
+}
+
+ANTLRInputStream::ANTLRInputStream(ANTLR_NULLABLE const char* data, size_t numberOfBytes)
+    :   data(NULL),
+        numBytes(0),
+        p(0),
+        offset(0),
+        n(-1)
+{
+    load(data, numberOfBytes);
+}
+
+ANTLRInputStream::~ANTLRInputStream()
+{
+}
+
+void ANTLRInputStream::load(ANTLR_NULLABLE const char* data, size_t numberOfBytes)
+{
+    this->data = data;
+    this->numBytes = data!=NULL ? numberOfBytes : 0;
+    this->n = this->numBytes==0 ? 0 : -1;
+    checkpoints.clear();
+    checkpoints.push_back(0);
+    reset();
+}
+
+void ANTLRInputStream::reset()
+{
+    p = 0;
+    offset = 0;
+}
+
+void ANTLRInputStream::consume()
+{
+    if (offset >= numBytes) {
+        throw std::logic_error("cannot consume EOF");
+    }
+
+    size_t length;
+    decode(offset, length);
+    offset += length;
+    p++;
+    // record checkpoints for free while reading sequentially
+    if (p % INDEX_INTERVAL == 0 && checkpoints.size() == static_cast<size_t>(p / INDEX_INTERVAL)) {
+        checkpoints.push_back(offset);
+    }
+    if (offset >= numBytes) {
+        n = p;
+    }
+}
+
+antlr_int32_t ANTLRInputStream::LA(antlr_int32_t i)
+{
+    if (i == 0) {
+        return 0; // undefined
+    }
+
+    size_t length;
+    if (i == 1) {
+        if (offset >= numBytes) {
+            return IntStream::EOF_;
+        }
+        return decode(offset, length);
+    }
+
+    if (i < 0) {
+        i++; // e.g., translate LA(-1) to use offset i=0; then data[p+0-1]
+        if (p + i - 1 < 0) {
+            return IntStream::EOF_; // invalid; no char before first char
+        }
+        size_t o = offsetOf(p + i - 1);
+        return decode(o, length);
+    }
+
+    size_t o = offset;
+    for (antlr_int32_t k = 1; k < i; k++) {
+        if (o >= numBytes) {
+            return IntStream::EOF_;
+        }
+        decode(o, length);
+        o += length;
+    }
+
+    if (o >= numBytes) {
+        return IntStream::EOF_;
+    }
+    return decode(o, length);
+}
+
+antlr_int32_t ANTLRInputStream::LT(antlr_int32_t i)
+{
+    return LA(i);
+}
+
+antlr_int32_t ANTLRInputStream::index()
+{
+    return p;
+}
+
+antlr_int32_t ANTLRInputStream::size()
+{
+    if (n < 0) {
+        // decode up to the end; the offset index ends up complete
+        offsetOf(ANTLR_INT32_MAX);
+    }
+
+    return n;
+}
+
+antlr_int32_t ANTLRInputStream::mark()
+{
+    return -1;
+}
+
+void ANTLRInputStream::release(antlr_int32_t)
+{
+}
+
+void ANTLRInputStream::seek(antlr_int32_t index)
+{
+    if (index < 0) {
+        throw std::invalid_argument("cannot seek to negative index");
+    }
+
+    if (index > p && index - p < INDEX_INTERVAL) {
+        // short seek forward, consume until p hits index or n (can't go past EOF)
+        while (p < index && offset < numBytes) {
+            consume();
+        }
+        return;
+    }
+
+    offset = offsetOf(index);
+    p = (n >= 0 && index > n) ? n : index;
+}
+
+size_t ANTLRInputStream::offsetOf(antlr_int32_t index)
+{
+    size_t k = static_cast<size_t>(index / INDEX_INTERVAL);
+    size_t length;
+    // extend the offset index up to the checkpoint preceding index
+    while (checkpoints.size() <= k) {
+        antlr_int32_t base = static_cast<antlr_int32_t>(checkpoints.size() - 1) * INDEX_INTERVAL;
+        size_t o = checkpoints.back();
+        antlr_int32_t j = 0;
+        for (; j < INDEX_INTERVAL && o < numBytes; j++) {
+            decode(o, length);
+            o += length;
+        }
+        if (o >= numBytes) {
+            n = base + j;
+            if (j < INDEX_INTERVAL) {
+                return numBytes; // index lies past the end
+            }
+        }
+        checkpoints.push_back(o);
+    }
+
+    antlr_int32_t base = static_cast<antlr_int32_t>(k) * INDEX_INTERVAL;
+    size_t o = checkpoints[k];
+    antlr_int32_t j = base;
+    for (; j < index && o < numBytes; j++) {
+        decode(o, length);
+        o += length;
+    }
+    if (o >= numBytes) {
+        n = j;
+    }
+    return o;
+}
+
+antlr_int32_t ANTLRInputStream::decode(size_t offset, size_t& length) const
+{
+    return decode(data + offset, numBytes - offset, length);
+}
+
+antlr_int32_t ANTLRInputStream::decode(const char* bytes, size_t available, size_t& length)
+{
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(bytes);
+    unsigned char c = s[0];
+    length = 1;
+    if (c < 0x80) {
+        return c;
+    }
+
+    if (c >= 0xC2 && c <= 0xDF) {
+        if (available >= 2 && isContinuation(s[1])) {
+            length = 2;
+            return ((c & 0x1F) << 6) | (s[1] & 0x3F);
+        }
+    }
+    else if (c >= 0xE0 && c <= 0xEF) {
+        if (available >= 3 && isContinuation(s[1]) && isContinuation(s[2])
+            && (c != 0xE0 || s[1] >= 0xA0)      // overlong
+            && (c != 0xED || s[1] < 0xA0))      // surrogate
+        {
+            length = 3;
+            return ((c & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+        }
+    }
+    else if (c >= 0xF0 && c <= 0xF4) {
+        if (available >= 4 && isContinuation(s[1]) && isContinuation(s[2]) && isContinuation(s[3])
+            && (c != 0xF0 || s[1] >= 0x90)      // overlong
+            && (c != 0xF4 || s[1] < 0x90))      // past U+10FFFF
+        {
+            length = 4;
+            return ((c & 0x07) << 18) | ((s[1] & 0x3F) << 12) | ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+        }
+    }
+
+    return REPLACEMENT_CHARACTER;
+}
+
+std::string ANTLRInputStream::getText(const Interval& interval)
+{
+    TextView view = getTextView(interval);
+    return view.str();
+}
+
+TextView ANTLRInputStream::getTextView(const Interval& interval)
+{
+    antlr_int32_t start = interval.a;
+    antlr_int32_t stop = interval.b;
+    if (start < 0 || stop < start - 1) {
+        throw std::invalid_argument("invalid interval");
+    }
+
+    if (stop < start || data == NULL) {
+        return TextView(data != NULL ? data : "", 0);
+    }
+
+    // offsetOf only decodes up to the requested index and stops at the end
+    // of the input, so both offsets are already clamped to numBytes
+    size_t startOffset = std::min(offsetOf(start), numBytes);
+    size_t stopOffset = stop == ANTLR_INT32_MAX ? numBytes : std::min(offsetOf(stop + 1), numBytes);
+    return TextView(data + startOffset, stopOffset - startOffset);
+}
+
+std::string ANTLRInputStream::getSourceName()
+{
+    if (name.empty()) {
+        return IntStream::UNKNOWN_SOURCE_NAME;
+    }
+    return name;
+}
+
+std::string ANTLRInputStream::toString() const
+{
+    return std::string(data != NULL ? data : "", numBytes);
+}
+
+
 } /* namespace antlr4 */
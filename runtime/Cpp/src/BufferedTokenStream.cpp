@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,9 +33,429 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/BufferedTokenStream.h>
+#include <antlr/CharStream.h>
+#include <antlr/CommonToken.h>
+#include <antlr/Token.h>
+#include <antlr/TokenSource.h>
+#include <antlr/WritableToken.h>
+#include <antlr/misc/Interval.h>
+#include <antlr/misc/TextView.h>
+#include <algorithm>
+#include <stdexcept>
+#include <typeinfo>
 
 namespace antlr4 {
 
 
+const antlr_int32_t BufferedTokenStream::CHUNK_BITS;
+
+const antlr_int32_t BufferedTokenStream::CHUNK_SIZE;
+
+const antlr_int32_t BufferedTokenStream::BATCH_SIZE = 64;
+
+BufferedTokenStream::BufferedTokenStream(TokenSource* tokenSource)
+    :   tokenSource(tokenSource),
+        types(),
+        chunks(),
+        source(NULL),
+        p(-1),
+        fetchedEOF(false),
+        batch(),
+        batching(true)
+{
+}
+
+BufferedTokenStream::~BufferedTokenStream()
+{
+    clear();
+}
+
+TokenSource* BufferedTokenStream::getTokenSource()
+{
+    return tokenSource;
+}
+
+void BufferedTokenStream::setTokenSource(TokenSource* tokenSource)
+{
+    clear();
+    this->tokenSource = tokenSource;
+}
+
+void BufferedTokenStream::clear()
+{
+    for (size_t i = 0; i < chunks.size(); i++) {
+        TokenChunk* chunk = chunks[i];
+        for (antlr_int32_t j = 0; j < CHUNK_SIZE; j++) {
+            delete chunk->tokens[j];
+        }
+        delete chunk;
+    }
+    chunks.clear();
+    types.clear();
+    source = NULL;
+    p = -1;
+    fetchedEOF = false;
+    batch.clear();
+    batching = true;
+}
+
+antlr_int32_t BufferedTokenStream::index()
+{
+    return p;
+}
+
+antlr_int32_t BufferedTokenStream::mark()
+{
+    return 0;
+}
+
+void BufferedTokenStream::release(antlr_int32_t)
+{
+    // no resources to release
+}
+
+void BufferedTokenStream::reset()
+{
+    seek(0);
+}
+
+void BufferedTokenStream::seek(antlr_int32_t index)
+{
+    if (index < 0) {
+        throw std::invalid_argument("cannot seek to negative index");
+    }
+
+    lazyInit();
+    if (!sync(index)) {
+        index = size() - 1;
+    }
+    p = adjustSeekIndex(index);
+}
+
+antlr_int32_t BufferedTokenStream::size()
+{
+    return static_cast<antlr_int32_t>(types.size());
+}
+
+void BufferedTokenStream::consume()
+{
+    if (LA(1) == Token::EOF_) {
+        throw std::logic_error("cannot consume EOF");
+    }
+
+    if (sync(p + 1)) {
+        p = adjustSeekIndex(p + 1);
+    }
+}
+
+bool BufferedTokenStream::sync(antlr_int32_t i)
+{
+    antlr_int32_t n = i - size() + 1; // how many more elements we need?
+    if (n > 0) {
+        antlr_int32_t fetched = fetch(n);
+        return fetched >= n;
+    }
+
+    return true;
+}
+
+antlr_int32_t BufferedTokenStream::fetch(antlr_int32_t n)
+{
+    if (fetchedEOF) {
+        return 0;
+    }
+
+    antlr_int32_t i = 0;
+    while (batching && i < n) {
+        if (batch.empty()) {
+            batch.assign(BATCH_SIZE, CommonToken(Token::INVALID_TYPE));
+        }
+        antlr_int32_t count = tokenSource->nextTokens(&batch[0], std::min(n - i, BATCH_SIZE));
+        if (count <= 0) {
+            // the source produces tokens one at a time
+            batching = false;
+            batch.clear();
+            break;
+        }
+
+        for (antlr_int32_t j = 0; j < count; j++) {
+            add(batch[j]);
+            i++;
+            if (batch[j].getType() == Token::EOF_) {
+                fetchedEOF = true;
+                return i;
+            }
+        }
+    }
+
+    for (; i < n; i++) {
+        antlr_auto_ptr<Token> t = tokenSource->nextToken();
+        bool eof = t->getType() == Token::EOF_;
+        add(t);
+        if (eof) {
+            fetchedEOF = true;
+            return i + 1;
+        }
+    }
+
+    return n;
+}
+
+void BufferedTokenStream::add(antlr_auto_ptr<Token>& token)
+{
+    WritableToken* writable = dynamic_cast<WritableToken*>(token.get());
+    if (writable != NULL) {
+        writable->setTokenIndex(size());
+    }
+
+    bool rebuildable = isRebuildable(*token);
+    addFields(*token);
+    if (rebuildable) {
+        token.reset();
+    } else {
+        chunks.back()->tokens[(size() - 1) & (CHUNK_SIZE - 1)] = token.release();
+    }
+}
+
+void BufferedTokenStream::add(const CommonToken& token)
+{
+    antlr_auto_ptr<CommonToken> copy;
+    if (!isRebuildable(token)) {
+        copy.reset(new CommonToken(token));
+        copy->setTokenIndex(size());
+    }
+
+    addFields(token);
+    chunks.back()->tokens[(size() - 1) & (CHUNK_SIZE - 1)] = copy.release();
+}
+
+void BufferedTokenStream::addFields(const Token& token)
+{
+    antlr_int32_t j = size() & (CHUNK_SIZE - 1);
+    if (j == 0) {
+        // value-initialized, so every token slot starts out NULL
+        antlr_auto_ptr<TokenChunk> chunk(new TokenChunk());
+        chunks.push_back(chunk.get());
+        chunk.release();
+    }
+    types.push_back(token.getType());
+
+    TokenChunk* chunk = chunks.back();
+    chunk->channels[j] = token.getChannel();
+    chunk->startIndexes[j] = token.getStartIndex();
+    chunk->stopIndexes[j] = token.getStopIndex();
+    chunk->lines[j] = token.getLine();
+    chunk->charPositions[j] = token.getCharPositionInLine();
+}
+
+bool BufferedTokenStream::isRebuildable(const Token& token)
+{
+    // a plain CommonToken is rebuilt from the arrays on demand
+    if (typeid(token) != typeid(CommonToken)) {
+        return false;
+    }
+
+    const CommonToken& common = static_cast<const CommonToken&>(token);
+    if (common.hasText() || (source != NULL && source != common.getSource())) {
+        return false;
+    }
+    source = common.getSource();
+    return true;
+}
+
+antlr_int32_t BufferedTokenStream::LA(antlr_int32_t i)
+{
+    if (i == 1 && p >= 0) {
+        // p always refers to a buffered token
+        return types[p];
+    }
+
+    antlr_int32_t index = lookaheadIndex(i);
+    if (index < 0) {
+        return Token::INVALID_TYPE;
+    }
+    return types[index];
+}
+
+const Token* BufferedTokenStream::LT(antlr_int32_t k)
+{
+    antlr_int32_t index = lookaheadIndex(k);
+    if (index < 0) {
+        return NULL;
+    }
+    return get(index);
+}
+
+antlr_int32_t BufferedTokenStream::lookaheadIndex(antlr_int32_t k)
+{
+    lazyInit();
+    if (k == 0) {
+        return -1;
+    }
+    if (k < 0) {
+        return lookbackIndex(-k);
+    }
+
+    antlr_int32_t i = p + k - 1;
+    sync(i);
+    if (i >= size()) { // return EOF token
+        // EOF must be last token
+        return size() - 1;
+    }
+    return i;
+}
+
+antlr_int32_t BufferedTokenStream::lookbackIndex(antlr_int32_t k)
+{
+    if ((p - k) < 0) {
+        return -1;
+    }
+    return p - k;
+}
+
+const Token* BufferedTokenStream::get(antlr_int32_t index)
+{
+    if (index < 0 || index >= size()) {
+        throw std::out_of_range("token index out of range");
+    }
+
+    TokenChunk* chunk = chunks[index >> CHUNK_BITS];
+    antlr_int32_t j = index & (CHUNK_SIZE - 1);
+    if (chunk->tokens[j] == NULL) {
+        antlr_auto_ptr<CommonToken> t(new CommonToken(source, types[index], chunk->channels[j],
+                                                      chunk->startIndexes[j], chunk->stopIndexes[j]));
+        t->setLine(chunk->lines[j]);
+        t->setCharPositionInLine(chunk->charPositions[j]);
+        t->setTokenIndex(index);
+        chunk->tokens[j] = t.release();
+    }
+    return chunk->tokens[j];
+}
+
+antlr_int32_t BufferedTokenStream::getChannel(antlr_int32_t index) const
+{
+    return chunks[index >> CHUNK_BITS]->channels[index & (CHUNK_SIZE - 1)];
+}
+
+antlr_int32_t BufferedTokenStream::adjustSeekIndex(antlr_int32_t i)
+{
+    return i;
+}
+
+void BufferedTokenStream::lazyInit()
+{
+    if (p == -1) {
+        setup();
+    }
+}
+
+void BufferedTokenStream::setup()
+{
+    sync(0);
+    p = adjustSeekIndex(0);
+}
+
+antlr_int32_t BufferedTokenStream::nextTokenOnChannel(antlr_int32_t i, antlr_int32_t channel)
+{
+    sync(i);
+    if (i >= size()) {
+        return size() - 1;
+    }
+
+    while (getChannel(i) != channel) {
+        if (types[i] == Token::EOF_) {
+            return i;
+        }
+
+        i++;
+        sync(i);
+    }
+
+    return i;
+}
+
+antlr_int32_t BufferedTokenStream::previousTokenOnChannel(antlr_int32_t i, antlr_int32_t channel)
+{
+    while (i >= 0 && getChannel(i) != channel) {
+        i--;
+    }
+
+    return i;
+}
+
+std::string BufferedTokenStream::getSourceName()
+{
+    return tokenSource->getSourceName();
+}
+
+std::string BufferedTokenStream::getText(const misc::Interval& interval)
+{
+    antlr_int32_t start = interval.a;
+    antlr_int32_t stop = interval.b;
+    if (start < 0 || stop < 0) {
+        return "";
+    }
+
+    lazyInit();
+    if (stop >= size()) {
+        stop = size() - 1;
+    }
+
+    CharStream* input = source != NULL ? source->b : NULL;
+    std::string buf;
+    for (antlr_int32_t i = start; i <= stop; i++) {
+        if (types[i] == Token::EOF_) {
+            break;
+        }
+
+        TokenChunk* chunk = chunks[i >> CHUNK_BITS];
+        antlr_int32_t j = i & (CHUNK_SIZE - 1);
+        if (chunk->tokens[j] == NULL && input != NULL) {
+            // read the text straight from the input instead of materializing the token
+            misc::Interval range(chunk->startIndexes[j], chunk->stopIndexes[j]);
+            misc::TextView view = input->getTextView(range);
+            if (view.data() != NULL) {
+                buf.append(view.data(), view.size());
+            } else {
+                buf += input->getText(range);
+            }
+        } else {
+            buf += get(i)->getText();
+        }
+    }
+
+    return buf;
+}
+
+std::string BufferedTokenStream::getText()
+{
+    lazyInit();
+    fill();
+    return getText(misc::Interval::of(0, size() - 1));
+}
+
+std::string BufferedTokenStream::getText(const Token* start, const Token* stop)
+{
+    if (start != NULL && stop != NULL) {
+        return getText(misc::Interval::of(start->getTokenIndex(), stop->getTokenIndex()));
+    }
+
+    return "";
+}
+
+void BufferedTokenStream::fill()
+{
+    lazyInit();
+    const antlr_int32_t blockSize = 1000;
+    while (true) {
+        antlr_int32_t fetched = fetch(blockSize);
+        if (fetched < blockSize) {
+            return;
+        }
+    }
+}
+
+
 } /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,9 +33,286 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/CommonToken.h>
+#include <antlr/CharStream.h>
+#include <antlr/Token.h>
+#include <antlr/misc/Interval.h>
+#include <sstream>
+#include <stdexcept>
 
 namespace antlr4 {
 
 
+const CommonToken::Source CommonToken::EMPTY_SOURCE(NULL, NULL);
+
+const antlr_int32_t CommonToken::MAX_TOKEN_TYPE = 0xFFFE;
+
+const antlr_int32_t CommonToken::MIN_CHANNEL = -0x8000;
+
+const antlr_int32_t CommonToken::MAX_CHANNEL = 0x7FFF;
+
+namespace {
+
+const antlr_uint16_t EOF_TYPE = 0xFFFF;
+
+const char EOF_TEXT[] = "<EOF>";
+
+antlr_uint16_t packType(antlr_int32_t ttype)
+{
+    if (ttype == Token::EOF_) {
+        return EOF_TYPE;
+    }
+    if (ttype < 0 || ttype > CommonToken::MAX_TOKEN_TYPE) {
+        throw std::invalid_argument("token type out of range");
+    }
+    return static_cast<antlr_uint16_t>(ttype);
+}
+
+antlr_int16_t packChannel(antlr_int32_t channel)
+{
+    if (channel < CommonToken::MIN_CHANNEL || channel > CommonToken::MAX_CHANNEL) {
+        throw std::invalid_argument("token channel out of range");
+    }
+    return static_cast<antlr_int16_t>(channel);
+}
+
+}
+
+CommonToken::CommonToken(antlr_int32_t type)
+    :   source(&EMPTY_SOURCE),
+        text(NULL),
+        start(0),
+        stop(0),
+        line(0),
+        charPositionInLine(-1),
+        index(-1),
+        type(packType(type)),
+        channel(packChannel(Token::DEFAULT_CHANNEL))
+{
+}
+
+CommonToken::CommonToken(const Source* source, antlr_int32_t type, antlr_int32_t channel,
+                         antlr_int32_t start, antlr_int32_t stop)
+    :   source(source != NULL ? source : &EMPTY_SOURCE),
+        text(NULL),
+        start(start),
+        stop(stop),
+        line(0),
+        charPositionInLine(-1),
+        index(-1),
+        type(packType(type)),
+        channel(packChannel(channel))
+{
+}
+
+CommonToken::CommonToken(antlr_int32_t type, const std::string& text)
+    :   source(&EMPTY_SOURCE),
+        text(new std::string(text)),
+        start(0),
+        stop(0),
+        line(0),
+        charPositionInLine(-1),
+        index(-1),
+        type(packType(type)),
+        channel(packChannel(Token::DEFAULT_CHANNEL))
+{
+}
+
+CommonToken::CommonToken(const CommonToken& other)
+    :   source(other.source),
+        text(other.text != NULL ? new std::string(*other.text) : NULL),
+        start(other.start),
+        stop(other.stop),
+        line(other.line),
+        charPositionInLine(other.charPositionInLine),
+        index(other.index),
+        type(other.type),
+        channel(other.channel)
+{
+}
+
+CommonToken::~CommonToken()
+{
+    delete text;
+}
+
+CommonToken& CommonToken::operator=(const CommonToken& other)
+{
+    if (this != &other) {
+        std::string* copy = other.text != NULL ? new std::string(*other.text) : NULL;
+        delete text;
+        text = copy;
+        source = other.source;
+        start = other.start;
+        stop = other.stop;
+        line = other.line;
+        charPositionInLine = other.charPositionInLine;
+        index = other.index;
+        type = other.type;
+        channel = other.channel;
+    }
+    return *this;
+}
+
+std::string CommonToken::getText() const
+{
+    if (text != NULL) {
+        return *text;
+    }
+
+    CharStream* input = getInputStream();
+    if (input == NULL) {
+        return std::string();
+    }
+    antlr_int32_t n = input->size();
+    if (start < n && stop < n) {
+        return input->getText(Interval::of(start, stop));
+    }
+    return EOF_TEXT;
+}
+
+TextView CommonToken::getTextView() const
+{
+    if (text != NULL) {
+        return TextView(text->data(), text->size());
+    }
+
+    CharStream* input = getInputStream();
+    if (input == NULL) {
+        return TextView();
+    }
+    antlr_int32_t n = input->size();
+    if (start < n && stop < n) {
+        return input->getTextView(Interval::of(start, stop));
+    }
+    return TextView(EOF_TEXT, sizeof(EOF_TEXT) - 1);
+}
+
+void CommonToken::setText(const std::string& text)
+{
+    if (this->text != NULL) {
+        *this->text = text;
+    } else {
+        this->text = new std::string(text);
+    }
+}
+
+bool CommonToken::hasText() const
+{
+    return text != NULL;
+}
+
+antlr_int32_t CommonToken::getType() const
+{
+    return type == EOF_TYPE ? Token::EOF_ : type;
+}
+
+void CommonToken::setType(antlr_int32_t ttype)
+{
+    type = packType(ttype);
+}
+
+antlr_int32_t CommonToken::getLine() const
+{
+    return line;
+}
+
+void CommonToken::setLine(antlr_int32_t line)
+{
+    this->line = line;
+}
+
+antlr_int32_t CommonToken::getCharPositionInLine() const
+{
+    return charPositionInLine;
+}
+
+void CommonToken::setCharPositionInLine(antlr_int32_t pos)
+{
+    charPositionInLine = pos;
+}
+
+antlr_int32_t CommonToken::getChannel() const
+{
+    return channel;
+}
+
+void CommonToken::setChannel(antlr_int32_t channel)
+{
+    this->channel = packChannel(channel);
+}
+
+antlr_int32_t CommonToken::getTokenIndex() const
+{
+    return index;
+}
+
+void CommonToken::setTokenIndex(antlr_int32_t index)
+{
+    this->index = index;
+}
+
+antlr_int32_t CommonToken::getStartIndex() const
+{
+    return start;
+}
+
+void CommonToken::setStartIndex(antlr_int32_t start)
+{
+    this->start = start;
+}
+
+antlr_int32_t CommonToken::getStopIndex() const
+{
+    return stop;
+}
+
+void CommonToken::setStopIndex(antlr_int32_t stop)
+{
+    this->stop = stop;
+}
+
+TokenSource* CommonToken::getTokenSource() const
+{
+    return source->a;
+}
+
+CharStream* CommonToken::getInputStream() const
+{
+    return source->b;
+}
+
+const CommonToken::Source* CommonToken::getSource() const
+{
+    return source;
+}
+
+std::string CommonToken::toString() const
+{
+    std::string txt;
+    if (text != NULL || getInputStream() != NULL) {
+        std::string raw = getText();
+        for (std::string::const_iterator it = raw.begin(); it != raw.end(); ++it) {
+            switch (*it) {
+            case '\n': txt += "\\n"; break;
+            case '\r': txt += "\\r"; break;
+            case '\t': txt += "\\t"; break;
+            default: txt += *it; break;
+            }
+        }
+    } else {
+        txt = "<no text>";
+    }
+
+    std::stringstream buf;
+    buf << "[@" << index << "," << start << ":" << stop << "='" << txt << "',<" << getType() << ">";
+    if (channel > 0) {
+        buf << ",channel=" << channel;
+    }
+    buf << "," << line << ":" << charPositionInLine << "]";
+    return buf.str();
+}
+
+
 } /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,9 +33,134 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/CommonTokenStream.h>
+#include <antlr/Token.h>
+#include <algorithm>
 
 namespace antlr4 {
 
 
+CommonTokenStream::CommonTokenStream(TokenSource* tokenSource)
+    :   BufferedTokenStream(tokenSource),
+        channel(Token::DEFAULT_CHANNEL),
+        onChannel(),
+        indexed(0),
+        q(-1)
+{
+}
+
+CommonTokenStream::CommonTokenStream(TokenSource* tokenSource, antlr_int32_t channel)
+    :   BufferedTokenStream(tokenSource),
+        channel(channel),
+        onChannel(),
+        indexed(0),
+        q(-1)
+{
+}
+
+CommonTokenStream::~CommonTokenStream()
+{
+}
+
+void CommonTokenStream::setTokenSource(TokenSource* tokenSource)
+{
+    BufferedTokenStream::setTokenSource(tokenSource);
+    onChannel.clear();
+    indexed = 0;
+    q = -1;
+}
+
+bool CommonTokenStream::indexNext()
+{
+    if (indexed >= size() && !sync(indexed)) {
+        return false;
+    }
+
+    antlr_int32_t i = indexed++;
+    if (getChannel(i) == channel || types[i] == Token::EOF_) {
+        onChannel.push_back(i);
+    }
+    return true;
+}
+
+antlr_int32_t CommonTokenStream::onChannelPosition(antlr_int32_t i)
+{
+    while (onChannel.empty() || onChannel.back() < i) {
+        if (!indexNext()) {
+            // i lies past EOF
+            return static_cast<antlr_int32_t>(onChannel.size()) - 1;
+        }
+    }
+
+    // consume() asks for the token right after the current one
+    antlr_int32_t n = static_cast<antlr_int32_t>(onChannel.size());
+    if (q >= 0 && q + 1 < n && onChannel[q] < i && onChannel[q + 1] >= i) {
+        return q + 1;
+    }
+    return static_cast<antlr_int32_t>(std::lower_bound(onChannel.begin(), onChannel.end(), i) - onChannel.begin());
+}
+
+antlr_int32_t CommonTokenStream::currentPosition()
+{
+    if (q < 0 || q >= static_cast<antlr_int32_t>(onChannel.size()) || onChannel[q] != p) {
+        q = onChannelPosition(p);
+    }
+    return q;
+}
+
+antlr_int32_t CommonTokenStream::adjustSeekIndex(antlr_int32_t i)
+{
+    antlr_int32_t position = onChannelPosition(i);
+    q = position;
+    return onChannel[position];
+}
+
+antlr_int32_t CommonTokenStream::lookbackIndex(antlr_int32_t k)
+{
+    if (k == 0 || (p - k) < 0) {
+        return -1;
+    }
+
+    antlr_int32_t position = currentPosition() - k;
+    if (position < 0) {
+        return -1;
+    }
+    return onChannel[position];
+}
+
+antlr_int32_t CommonTokenStream::lookaheadIndex(antlr_int32_t k)
+{
+    lazyInit();
+    if (k == 0) {
+        return -1;
+    }
+    if (k < 0) {
+        return lookbackIndex(-k);
+    }
+
+    antlr_int32_t position = currentPosition() + k - 1;
+    while (static_cast<antlr_int32_t>(onChannel.size()) <= position) {
+        if (!indexNext()) {
+            // return EOF token
+            return onChannel.back();
+        }
+    }
+    return onChannel[position];
+}
+
+antlr_int32_t CommonTokenStream::getNumberOfOnChannelTokens()
+{
+    fill();
+    while (indexNext()) {
+    }
+
+    // EOF is indexed whatever its channel
+    antlr_int32_t n = static_cast<antlr_int32_t>(onChannel.size());
+    if (getChannel(onChannel.back()) != channel) {
+        n--;
+    }
+    return n;
+}
+
 } /* namespace antlr4 */
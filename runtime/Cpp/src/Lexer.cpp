@@ -47,5 +47,18 @@ const antlr_int32_t Lexer::HIDDEN = Token::HIDDEN_CHANNEL;
 const antlr_int32_t Lexer::MIN_CHAR_VALUE = 0x0000;
 const antlr_int32_t Lexer::MAX_CHAR_VALUE = 0xFFFE;
 
+Lexer::~Lexer()
+{
+}
+
+bool Lexer::sempred(ANTLR_NULLABLE RuleContext*, antlr_int32_t, antlr_int32_t)
+{
+    return true;
+}
+
+void Lexer::action(ANTLR_NULLABLE RuleContext*, antlr_int32_t, antlr_int32_t)
+{
+}
+
 
 } /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,9 +33,52 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/LexerNoViableAltException.h>
+#include <antlr/CharStream.h>
 
 namespace antlr4 {
 
 
+LexerNoViableAltException::LexerNoViableAltException(ANTLR_NULLABLE Lexer*,
+                                                     ANTLR_NOTNULL CharStream* input,
+                                                     antlr_int32_t startIndex,
+                                                     ANTLR_NULLABLE const atn::ATNConfigSet* deadEndConfigs)
+    :   RecognitionException(getMessage(input, startIndex), input),
+        startIndex(startIndex),
+        deadEndConfigs(deadEndConfigs)
+{
+}
+
+LexerNoViableAltException::~LexerNoViableAltException() throw()
+{
+}
+
+antlr_int32_t LexerNoViableAltException::getStartIndex() const
+{
+    return startIndex;
+}
+
+ANTLR_NULLABLE
+const atn::ATNConfigSet* LexerNoViableAltException::getDeadEndConfigs() const
+{
+    return deadEndConfigs;
+}
+
+std::string LexerNoViableAltException::toString() const
+{
+    return what();
+}
+
+std::string LexerNoViableAltException::getMessage(CharStream* input, antlr_int32_t startIndex)
+{
+    std::string symbol;
+    if (startIndex >= 0 && startIndex < input->size()) {
+        symbol = input->getText(Interval::of(startIndex, startIndex));
+    }
+
+    return "LexerNoViableAltException('" + symbol + "')";
+}
+
+
 } /* namespace antlr4 */
@@ -34,8 +34,47 @@
  */
 
 #include <antlr/NoViableAltException.h>
+#include <antlr/ParserRuleContext.h>
+#include <antlr/Token.h>
+#include <antlr/TokenStream.h>
 
 namespace antlr4 {
 
 
+NoViableAltException::NoViableAltException(ANTLR_NULLABLE Parser*,
+                                           ANTLR_NOTNULL TokenStream* input,
+                                           ANTLR_NOTNULL const Token* startToken,
+                                           ANTLR_NOTNULL const Token* offendingToken,
+                                           ANTLR_NULLABLE const atn::ATNConfigSet* deadEndConfigs,
+                                           ANTLR_NULLABLE ParserRuleContext* ctx)
+    :   RecognitionException("no viable alternative at input '" + offendingToken->getText() + "'", input, ctx),
+        startToken(startToken),
+        offendingToken(offendingToken),
+        deadEndConfigs(deadEndConfigs)
+{
+}
+
+NoViableAltException::~NoViableAltException() throw()
+{
+}
+
+ANTLR_NOTNULL
+const Token* NoViableAltException::getStartToken() const
+{
+    return startToken;
+}
+
+ANTLR_NOTNULL
+const Token* NoViableAltException::getOffendingToken() const
+{
+    return offendingToken;
+}
+
+ANTLR_NULLABLE
+const atn::ATNConfigSet* NoViableAltException::getDeadEndConfigs() const
+{
+    return deadEndConfigs;
+}
+
+
 } /* namespace antlr4 */
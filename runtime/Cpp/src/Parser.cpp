@@ -38,4 +38,14 @@
 namespace antlr4 {
 
 
+Parser::~Parser()
+{
+}
+
+bool Parser::sempred(ANTLR_NULLABLE RuleContext*, antlr_int32_t, antlr_int32_t)
+{
+    return true;
+}
+
+
 } /* namespace antlr4 */
@@ -38,4 +38,14 @@
 namespace antlr4 {
 
 
+ParserRuleContext::ParserRuleContext()
+{
+}
+
+ParserRuleContext::ParserRuleContext(ANTLR_NULLABLE ParserRuleContext* parent, antlr_int32_t invokingStateNumber)
+    :   RuleContext(parent, invokingStateNumber)
+{
+}
+
+
 } /* namespace antlr4 */
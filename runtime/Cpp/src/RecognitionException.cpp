@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,9 +33,54 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/RecognitionException.h>
 
 namespace antlr4 {
 
 
+RecognitionException::RecognitionException(const std::string& message, ANTLR_NULLABLE IntStream* input)
+    :   std::runtime_error(message),
+        input(input),
+        ctx(NULL),
+        offendingState(-1)
+{
+}
+
+RecognitionException::RecognitionException(const std::string& message, ANTLR_NULLABLE IntStream* input,
+                                           ANTLR_NULLABLE RuleContext* ctx)
+    :   std::runtime_error(message),
+        input(input),
+        ctx(ctx),
+        offendingState(-1)
+{
+}
+
+RecognitionException::~RecognitionException() throw()
+{
+}
+
+antlr_int32_t RecognitionException::getOffendingState() const
+{
+    return offendingState;
+}
+
+ANTLR_NULLABLE
+IntStream* RecognitionException::getInputStream() const
+{
+    return input;
+}
+
+ANTLR_NULLABLE
+RuleContext* RecognitionException::getCtx() const
+{
+    return ctx;
+}
+
+void RecognitionException::setOffendingState(antlr_int32_t offendingState)
+{
+    this->offendingState = offendingState;
+}
+
+
 } /* namespace antlr4 */
@@ -38,4 +38,48 @@
 namespace antlr4 {
 
 
+RuleContext::RuleContext()
+    :   parent(NULL),
+        invokingState(-1)
+{
+}
+
+RuleContext::RuleContext(ANTLR_NULLABLE RuleContext* parent, antlr_int32_t invokingState)
+    :   parent(parent),
+        invokingState(invokingState)
+{
+}
+
+RuleContext::~RuleContext()
+{
+}
+
+antlr_int32_t RuleContext::depth() const
+{
+    antlr_int32_t n = 0;
+    const RuleContext* p = this;
+    while ( p!=NULL ) {
+        p = p->parent;
+        n++;
+    }
+    return n;
+}
+
+bool RuleContext::isEmpty() const
+{
+    return invokingState == -1;
+}
+
+ANTLR_NULLABLE
+RuleContext* RuleContext::getParent() const
+{
+    return parent;
+}
+
+antlr_int32_t RuleContext::getRuleIndex() const
+{
+    return -1;
+}
+
+
 } /* namespace antlr4 */
@@ -38,4 +38,14 @@
 namespace antlr4 {
 
 
+TokenSource::~TokenSource()
+{
+}
+
+antlr_int32_t TokenSource::nextTokens(CommonToken*, antlr_int32_t)
+{
+    return 0;
+}
+
+
 } /* namespace antlr4 */
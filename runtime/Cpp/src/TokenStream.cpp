@@ -38,4 +38,9 @@
 namespace antlr4 {
 
 
+TokenStream::~TokenStream()
+{
+}
+
+
 } /* namespace antlr4 */
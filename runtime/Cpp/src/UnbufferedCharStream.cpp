@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,9 +33,330 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/UnbufferedCharStream.h>
+#include <antlr/ANTLRInputStream.h>
+#include <antlr/IntStream.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace antlr4 {
 
 
+const size_t UnbufferedCharStream::DEFAULT_BUFFER_SIZE = 4096;
+
+namespace {
+
+/** Longest UTF-8 sequence; fewer undecoded bytes than this may be a
+ *  sequence cut by the end of a block.
+ */
+const size_t MAX_SEQUENCE_LENGTH = 4;
+
+/** Returns {@code true} unless the {@code available} bytes at {@code bytes}
+ *  are the start of a well-formed sequence that needs more bytes. A
+ *  malformed sequence decodes to U+FFFD right away.
+ */
+bool isCompleteSequence(const char* bytes, size_t available)
+{
+    unsigned char lead = static_cast<unsigned char>(bytes[0]);
+    size_t length = lead < 0xC0 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : lead < 0xF8 ? 4 : 1;
+    if (available >= length) {
+        return true;
+    }
+    for (size_t i = 1; i < available; i++) {
+        if ((static_cast<unsigned char>(bytes[i]) & 0xC0) != 0x80) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ringSize(size_t bufferSize)
+{
+    size_t size = 16;
+    while (size < bufferSize) {
+        size <<= 1;
+    }
+    return size;
+}
+
+void appendUtf8(std::string& s, antlr_int32_t c)
+{
+    if (c < 0x80) {
+        s += static_cast<char>(c);
+    } else if (c < 0x800) {
+        s += static_cast<char>(0xC0 | (c >> 6));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        s += static_cast<char>(0xE0 | (c >> 12));
+        s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    } else {
+        s += static_cast<char>(0xF0 | (c >> 18));
+        s += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    }
+}
+
+} /* anonymous namespace */
+
+UnbufferedCharStream::UnbufferedCharStream(std::istream& input)
+    :   input(&input),
+        bufferSize(DEFAULT_BUFFER_SIZE),
+        bytes(DEFAULT_BUFFER_SIZE + MAX_SEQUENCE_LENGTH - 1),
+        bytesStart(0),
+        bytesEnd(0),
+        inputExhausted(false),
+        data(ringSize(DEFAULT_BUFFER_SIZE)),
+        bufferStart(0),
+        n(0),
+        reachedEOF(false),
+        currentCharIndex(0),
+        numMarkers(0),
+        lastChar(-1),
+        lastCharBufferStart(-1)
+{
+}
+
+UnbufferedCharStream::UnbufferedCharStream(std::istream& input, size_t bufferSize)
+    :   input(&input),
+        bufferSize(bufferSize),
+        bytes(bufferSize + MAX_SEQUENCE_LENGTH - 1),
+        bytesStart(0),
+        bytesEnd(0),
+        inputExhausted(false),
+        data(ringSize(bufferSize)),
+        bufferStart(0),
+        n(0),
+        reachedEOF(false),
+        currentCharIndex(0),
+        numMarkers(0),
+        lastChar(-1),
+        lastCharBufferStart(-1)
+{
+    if (bufferSize == 0) {
+        throw std::invalid_argument("buffer size must be positive");
+    }
+}
+
+UnbufferedCharStream::~UnbufferedCharStream()
+{
+}
+
+void UnbufferedCharStream::consume()
+{
+    if (LA(1) == IntStream::EOF_) {
+        throw std::logic_error("cannot consume EOF");
+    }
+
+    // buffer the next character only when it is asked for, so that
+    // interactive input is not read ahead of the lexer
+    lastChar = at(currentCharIndex);
+    currentCharIndex++;
+    if (numMarkers == 0) {
+        dropConsumed();
+    }
+}
+
+void UnbufferedCharStream::sync(antlr_int32_t want)
+{
+    antlr_int32_t need = (currentCharIndex - bufferStart + want - 1) - n + 1; // how many more elements we need?
+    if (need > 0) {
+        fill(need);
+    }
+}
+
+void UnbufferedCharStream::fill(antlr_int32_t count)
+{
+    antlr_int32_t target = n + count;
+    while (n < target && !reachedEOF) {
+        if (!inputExhausted && !hasCompleteSequence()) {
+            readBlock();
+            continue;
+        }
+
+        if (bytesStart == bytesEnd) {
+            add(IntStream::EOF_);
+            reachedEOF = true;
+            break;
+        }
+
+        // decode the whole block; a sequence cut by its end waits for the next one
+        while (bytesStart < bytesEnd && (inputExhausted || hasCompleteSequence())) {
+            size_t length;
+            add(ANTLRInputStream::decode(&bytes[bytesStart], bytesEnd - bytesStart, length));
+            bytesStart += length;
+        }
+    }
+}
+
+bool UnbufferedCharStream::hasCompleteSequence() const
+{
+    return bytesStart < bytesEnd && isCompleteSequence(&bytes[bytesStart], bytesEnd - bytesStart);
+}
+
+void UnbufferedCharStream::readBlock()
+{
+    size_t left = bytesEnd - bytesStart;
+    std::copy(bytes.begin() + bytesStart, bytes.begin() + bytesEnd, bytes.begin());
+    bytesStart = 0;
+    bytesEnd = left;
+
+    // take what the input has buffered without waiting for a whole block
+    char* block = &bytes[left];
+    std::streamsize count = input->readsome(block, static_cast<std::streamsize>(bufferSize));
+    if (count == 0) {
+        // nothing buffered: wait for one byte, then take whatever came with it
+        input->read(block, 1);
+        count = input->gcount();
+        if (count == 0) {
+            inputExhausted = true;
+            return;
+        }
+        if (bufferSize > 1) {
+            count += input->readsome(block + 1, static_cast<std::streamsize>(bufferSize - 1));
+        }
+    }
+    bytesEnd += static_cast<size_t>(count);
+}
+
+void UnbufferedCharStream::add(antlr_int32_t c)
+{
+    if (static_cast<size_t>(n) == data.size()) {
+        std::vector<antlr_int32_t> grown(2 * data.size());
+        size_t mask = grown.size() - 1;
+        for (antlr_int32_t k = 0; k < n; k++) {
+            grown[static_cast<size_t>(bufferStart + k) & mask] = at(bufferStart + k);
+        }
+        data.swap(grown);
+    }
+
+    data[static_cast<size_t>(bufferStart + n) & (data.size() - 1)] = c;
+    n++;
+}
+
+void UnbufferedCharStream::dropConsumed()
+{
+    n -= currentCharIndex - bufferStart;
+    bufferStart = currentCharIndex;
+    lastCharBufferStart = lastChar;
+}
+
+antlr_int32_t UnbufferedCharStream::at(antlr_int32_t index) const
+{
+    return data[static_cast<size_t>(index) & (data.size() - 1)];
+}
+
+antlr_int32_t UnbufferedCharStream::LA(antlr_int32_t i)
+{
+    if (i == -1) {
+        return lastChar; // special case
+    }
+
+    sync(i);
+    antlr_int32_t index = currentCharIndex - bufferStart + i - 1;
+    if (index < 0) {
+        throw std::out_of_range("LA index out of range");
+    }
+    if (index >= n) {
+        return IntStream::EOF_;
+    }
+    return at(bufferStart + index);
+}
+
+antlr_int32_t UnbufferedCharStream::mark()
+{
+    if (numMarkers == 0) {
+        lastCharBufferStart = lastChar;
+    }
+
+    antlr_int32_t mark = -numMarkers - 1;
+    numMarkers++;
+    return mark;
+}
+
+void UnbufferedCharStream::release(antlr_int32_t marker)
+{
+    antlr_int32_t expectedMark = -numMarkers;
+    if (marker != expectedMark) {
+        throw std::logic_error("release() called with an invalid marker.");
+    }
+
+    numMarkers--;
+    if (numMarkers == 0) {
+        // only moves the start of the ring; nothing is copied
+        dropConsumed();
+    }
+}
+
+antlr_int32_t UnbufferedCharStream::index()
+{
+    return currentCharIndex;
+}
+
+void UnbufferedCharStream::seek(antlr_int32_t index)
+{
+    if (index == currentCharIndex) {
+        return;
+    }
+    if (index < 0) {
+        throw std::invalid_argument("cannot seek to negative index");
+    }
+
+    if (index > currentCharIndex) {
+        sync(index - currentCharIndex + 1);
+        // seeking past EOF stops at EOF
+        index = std::min(index, bufferStart + n - 1);
+    }
+
+    // index == to bufferStartIndex should set p to 0
+    antlr_int32_t i = index - bufferStart;
+    if (i < 0 || i >= n) {
+        throw std::logic_error("seek to index outside buffer");
+    }
+
+    currentCharIndex = index;
+    lastChar = i == 0 ? lastCharBufferStart : at(index - 1);
+    if (numMarkers == 0) {
+        dropConsumed();
+    }
+}
+
+antlr_int32_t UnbufferedCharStream::size()
+{
+    throw std::logic_error("Unbuffered stream cannot know its size");
+}
+
+std::string UnbufferedCharStream::getSourceName()
+{
+    if (name.empty()) {
+        return IntStream::UNKNOWN_SOURCE_NAME;
+    }
+    return name;
+}
+
+std::string UnbufferedCharStream::getText(const Interval& interval)
+{
+    if (interval.a < 0 || interval.b < interval.a - 1) {
+        throw std::invalid_argument("invalid interval");
+    }
+
+    // one past the last buffered character, not counting EOF
+    antlr_int32_t end = bufferStart + n - (reachedEOF ? 1 : 0);
+    if (reachedEOF && interval.b >= end) {
+        throw std::invalid_argument("the interval extends past the end of the stream");
+    }
+    if (interval.a < bufferStart || interval.b >= end) {
+        throw std::logic_error("interval outside buffer");
+    }
+
+    std::string text;
+    for (antlr_int32_t i = interval.a; i <= interval.b; i++) {
+        appendUtf8(text, at(i));
+    }
+    return text;
+}
+
+
 } /* namespace antlr4 */
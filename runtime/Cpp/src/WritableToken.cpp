@@ -38,4 +38,9 @@
 namespace antlr4 {
 
 
+WritableToken::~WritableToken()
+{
+}
+
+
 } /* namespace antlr4 */
@@ -33,12 +33,138 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/ATN.h>
+#include <antlr/atn/ATNConfig.h>
+#include <antlr/atn/ATNState.h>
+#include <antlr/atn/ActionTransition.h>
+#include <antlr/atn/AtomTransition.h>
+#include <antlr/atn/DecisionState.h>
+#include <antlr/atn/PredicateTransition.h>
+#include <antlr/atn/RangeTransition.h>
+#include <antlr/atn/RuleTransition.h>
+#include <antlr/atn/SetTransition.h>
+#include <stdexcept>
 
 namespace antlr4 {
 namespace atn {
 
-const antlr_int32_t ATN::INVALID_ALT_NUMBER = 0;    
+
+const antlr_int32_t ATN::INVALID_ALT_NUMBER = 0;
+
+ATN::ATN()
+    :   grammarType(PARSER),
+        maxTokenType(0)
+{
+}
+
+ATN::~ATN()
+{
+    for (std::vector<ATNState*>::iterator it = states.begin();
+            it != states.end(); it++) {
+        delete *it;
+    }
+}
+
+void ATN::addState(ANTLR_NULLABLE ATNState* state)
+{
+    if (states.size() > static_cast<size_t>(ATNConfig::MAX_STATE_NUMBER)) {
+        delete state;
+        throw std::length_error("too many ATN states");
+    }
+
+    if (state != NULL) {
+        state->atn = this;
+        state->stateNumber = static_cast<antlr_int32_t>(states.size());
+    }
+
+    states.push_back(state);
+}
+
+void ATN::removeState(ANTLR_NOTNULL ATNState* state)
+{
+    states[state->stateNumber] = NULL; // just free mem, don't shift states in list
+    delete state;
+}
+
+antlr_int32_t ATN::defineDecisionState(ANTLR_NOTNULL DecisionState* s)
+{
+    decisionToState.push_back(s);
+    s->decision = static_cast<antlr_int32_t>(decisionToState.size())-1;
+    return s->decision;
+}
+
+ANTLR_NULLABLE
+DecisionState* ATN::getDecisionState(antlr_int32_t decision) const
+{
+    if ( !decisionToState.empty() ) {
+        return decisionToState[decision];
+    }
+    return NULL;
+}
+
+antlr_int32_t ATN::getNumberOfDecisions() const
+{
+    return static_cast<antlr_int32_t>(decisionToState.size());
+}
+
+void ATN::buildLayout()
+{
+    stateType.assign(states.size(), ATNState::INVALID_TYPE);
+    stateRuleIndex.assign(states.size(), -1);
+    transitionOffsets.assign(states.size() + 1, 0);
+    packedTransitions.clear();
+    transitionSets.clear();
+
+    for (size_t s = 0; s < states.size(); s++) {
+        transitionOffsets[s] = static_cast<antlr_int32_t>(packedTransitions.size());
+        const ATNState* state = states[s];
+        if (state == NULL) {
+            continue;
+        }
+        stateType[s] = state->getStateType();
+        stateRuleIndex[s] = state->ruleIndex;
+        for (antlr_int32_t i = 0; i < state->getNumberOfTransitions(); i++) {
+            const Transition* t = state->transition(i);
+            PackedTransition packed = { t->getSerializationType(), t->target->stateNumber, 0, 0 };
+            if (packed.type == Transition::RANGE) {
+                const RangeTransition* range = static_cast<const RangeTransition*>(t);
+                packed.arg1 = range->from;
+                packed.arg2 = range->to;
+            }
+            else if (packed.type == Transition::RULE) {
+                const RuleTransition* rule = static_cast<const RuleTransition*>(t);
+                packed.arg1 = rule->followState->stateNumber;
+                packed.arg2 = rule->ruleIndex;
+            }
+            else if (packed.type == Transition::PREDICATE) {
+                const PredicateTransition* pred = static_cast<const PredicateTransition*>(t);
+                packed.arg1 = pred->ruleIndex;
+                packed.arg2 = pred->predIndex;
+            }
+            else if (packed.type == Transition::ATOM) {
+                packed.arg1 = static_cast<const AtomTransition*>(t)->label_;
+            }
+            else if (packed.type == Transition::ACTION) {
+                const ActionTransition* action = static_cast<const ActionTransition*>(t);
+                packed.arg1 = action->ruleIndex;
+                packed.arg2 = action->actionIndex;
+            }
+            else if (packed.type == Transition::SET || packed.type == Transition::NOT_SET) {
+                packed.arg1 = static_cast<antlr_int32_t>(transitionSets.size());
+                transitionSets.push_back(&static_cast<const SetTransition*>(t)->set);
+            }
+            packedTransitions.push_back(packed);
+        }
+    }
+    transitionOffsets[states.size()] = static_cast<antlr_int32_t>(packedTransitions.size());
+}
+
+antlr_int32_t ATN::getNumberOfPackedTransitions(antlr_int32_t s) const
+{
+    return transitionOffsets[s + 1] - transitionOffsets[s];
+}
+
 
 } /* namespace atn */
 } /* namespace antlr4 */
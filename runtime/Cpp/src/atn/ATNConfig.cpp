@@ -37,135 +37,159 @@
 #include <antlr/atn/ATNState.h>
 #include <antlr/atn/ATNSimulator.h>
 #include <antlr/atn/PredictionContext.h>
-#include <antlr/atn/SemanticContext.h>
-#include <antlr/misc/MurmurHash.h>
+#include <antlr/atn/SemanticContextCache.h>
 #include <sstream>
+#include <stdexcept>
 
 
 namespace antlr4 {
 namespace atn {
 
-ATNConfig::ATNConfig()
-   :    state(NULL),
-        alt(0),
-        context(NULL),
-        reachesIntoOuterContext(0),
-        semanticContext(NULL)
+const antlr_int32_t ATNConfig::MAX_STATE_NUMBER;
+
+const antlr_int32_t ATNConfig::MAX_ALT;
+
+const antlr_int32_t ATNConfig::MAX_LEXER_ACTION_INDEX;
+
+namespace {
+
+antlr_uint32_t checkedAlt(antlr_int32_t alt)
 {
+    if ( alt<0 || alt>ATNConfig::MAX_ALT ) {
+        throw std::out_of_range("alternative doesn't fit in an ATN configuration");
+    }
+    return static_cast<antlr_uint32_t>(alt);
 }
 
-ATNConfig::ATNConfig(const ATNConfig& old)
-    :   Key<ATNConfig>(),
-        state(old.state),
-        alt(old.alt),
-        context(old.context),
-        reachesIntoOuterContext(old.reachesIntoOuterContext),
-        semanticContext(old.semanticContext)
+} /* anonymous namespace */
+
+ATNConfig::ATNConfig()
+   :    context(NULL),
+        stateNumber(ATNState::INVALID_STATE_NUMBER),
+        alt(0),
+        semanticContextIndex(SemanticContextCache::NONE_INDEX),
+        reachesIntoOuterContext(false)
 {
 }
 
 ATNConfig::ATNConfig(ANTLR_NOTNULL const ATNState* state,antlr_int32_t alt,
                      ANTLR_NULLABLE const PredictionContext* context)
-    :   state(state),
-        alt(alt),
-        context(context),
-        reachesIntoOuterContext(0),
-        semanticContext(NULL)
+    :   context(context),
+        stateNumber(state->stateNumber),
+        alt(checkedAlt(alt)),
+        semanticContextIndex(SemanticContextCache::NONE_INDEX),
+        reachesIntoOuterContext(false)
 {
 }
 
 ATNConfig::ATNConfig(ANTLR_NOTNULL const ATNState* state,
                      antlr_int32_t alt,
                      ANTLR_NULLABLE const PredictionContext* context,
-                     ANTLR_NOTNULL const SemanticContext* semanticContext)
-    :   state(state),
-        alt(alt),
-        context(context),
-        reachesIntoOuterContext(0),
-        semanticContext(semanticContext)
+                     antlr_uint32_t semanticContextIndex)
+    :   context(context),
+        stateNumber(state->stateNumber),
+        alt(checkedAlt(alt)),
+        semanticContextIndex(semanticContextIndex),
+        reachesIntoOuterContext(false)
 {
 }
 
 ATNConfig::ATNConfig(ANTLR_NOTNULL const ATNConfig* c, ANTLR_NOTNULL const ATNState* state)
-    :   state(state),
+    :   context(c->context),
+        stateNumber(state->stateNumber),
         alt(c->alt),
-        context(c->context),
-        reachesIntoOuterContext(c->reachesIntoOuterContext),
-        semanticContext(c->semanticContext)
+        semanticContextIndex(c->semanticContextIndex),
+        reachesIntoOuterContext(c->reachesIntoOuterContext)
 {
 }
 
 ATNConfig::ATNConfig(ANTLR_NOTNULL const ATNConfig* c, ANTLR_NOTNULL const ATNState* state,
-                     ANTLR_NOTNULL const SemanticContext* semanticContext)
-    :   state(state),
+                     antlr_uint32_t semanticContextIndex)
+    :   context(c->context),
+        stateNumber(state->stateNumber),
         alt(c->alt),
-        context(c->context),
-        reachesIntoOuterContext(c->reachesIntoOuterContext),
-        semanticContext(semanticContext)
+        semanticContextIndex(semanticContextIndex),
+        reachesIntoOuterContext(c->reachesIntoOuterContext)
 {
 }
 
 ATNConfig::ATNConfig(ANTLR_NOTNULL const ATNConfig* c,
-                     ANTLR_NOTNULL const SemanticContext* semanticContext)
-    :   state(c->state),
+                     antlr_uint32_t semanticContextIndex)
+    :   context(c->context),
+        stateNumber(c->stateNumber),
         alt(c->alt),
-        context(c->context),
-        reachesIntoOuterContext(c->reachesIntoOuterContext),
-        semanticContext(semanticContext)
+        semanticContextIndex(semanticContextIndex),
+        reachesIntoOuterContext(c->reachesIntoOuterContext)
 {
 }
 
 ATNConfig::ATNConfig(ANTLR_NOTNULL const ATNConfig* c, ANTLR_NOTNULL const ATNState* state,
                      ANTLR_NULLABLE const PredictionContext* context)
-    :   state(state),
+    :   context(context),
+        stateNumber(state->stateNumber),
         alt(c->alt),
-        context(context),
-        reachesIntoOuterContext(c->reachesIntoOuterContext),
-        semanticContext(c->semanticContext)
+        semanticContextIndex(c->semanticContextIndex),
+        reachesIntoOuterContext(c->reachesIntoOuterContext)
 {
 }
 
 ATNConfig::ATNConfig(ANTLR_NOTNULL const ATNConfig* c, ANTLR_NOTNULL const ATNState* state,
                      ANTLR_NULLABLE const PredictionContext* context,
-                     ANTLR_NOTNULL const SemanticContext* semanticContext)
-    :   state(state),
+                     antlr_uint32_t semanticContextIndex)
+    :   context(context),
+        stateNumber(state->stateNumber),
         alt(c->alt),
-        context(context),
-        reachesIntoOuterContext(c->reachesIntoOuterContext),
-        semanticContext(semanticContext)
+        semanticContextIndex(semanticContextIndex),
+        reachesIntoOuterContext(c->reachesIntoOuterContext)
 {
 }
 
 /** An ATN configuration is equal to another if both have
  *  the same state, they predict the same alternative, and
- *  syntactic/semantic contexts are the same.
+ *  syntactic/semantic contexts are the same. Contexts interned in the same
+ *  cache are equal only if they are the same object, so the deep comparison
+ *  only runs for contexts from different caches.
  */
-bool ATNConfig::equals(const Key<ATNConfig>* o) const
+bool ATNConfig::equals(const ATNConfig& other) const
 {
-    const ATNConfig* other = dynamic_cast<const ATNConfig*>(o);
-    if (other == NULL) {
-        return false;
-    }
-    return this->state->stateNumber==other->state->stateNumber
-        && this->alt==other->alt
-        && (this->context==other->context || (this->context != NULL && this->context->equals(other->context)))
-        && this->semanticContext->equals(other->semanticContext);
+    return this->stateNumber==other.stateNumber
+        && this->alt==other.alt
+        && this->semanticContextIndex==other.semanticContextIndex
+        && (this->context==other.context || (this->context != NULL && this->context->equals(other.context)));
+}
+
+bool ATNConfig::operator==(const ATNConfig& other) const
+{
+    return equals(other);
+}
+
+bool ATNConfig::operator!=(const ATNConfig& other) const
+{
+    return !equals(other);
 }
 
 antlr_int32_t ATNConfig::hashCode() const
 {
-    antlr_int32_t hashCode = MurmurHash::initialize(7);
-    hashCode = MurmurHash::update(hashCode, state->stateNumber);
-    hashCode = MurmurHash::update(hashCode, alt);
-    hashCode = MurmurHash::update(hashCode, context);
-    hashCode = MurmurHash::update(hashCode, semanticContext);
-    hashCode = MurmurHash::finish(hashCode, 4);
-    return hashCode;
+    // the context's hash code is computed when it's created; hash tables
+    // mix the result, so a multiplicative combination is enough here
+    antlr_uint32_t hashCode = static_cast<antlr_uint32_t>(stateNumber);
+    hashCode = 31 * hashCode + alt;
+    hashCode = 31 * hashCode + semanticContextIndex;
+    hashCode = 31 * hashCode + (context != NULL ? static_cast<antlr_uint32_t>(context->hashCode()) : 0);
+    return static_cast<antlr_int32_t>(hashCode);
 }
 
-ATNConfig* ATNConfig::clone() const
+antlr_int32_t ATNConfig::getLexerActionIndex() const
 {
-    return new ATNConfig(*this);
+    return static_cast<antlr_int32_t>(semanticContextIndex) - 1;
+}
+
+void ATNConfig::setLexerActionIndex(antlr_int32_t actionIndex)
+{
+    if ( actionIndex<-1 || actionIndex>MAX_LEXER_ACTION_INDEX ) {
+        throw std::out_of_range("lexer action index doesn't fit in an ATN configuration");
+    }
+    semanticContextIndex = static_cast<antlr_uint32_t>(actionIndex + 1);
 }
 
 std::string ATNConfig::toString() const
@@ -182,7 +206,7 @@ std::string ATNConfig::toString(ANTLR_NULLABLE const Recognizer<Symbol, ATNInter
     //    else buf << state->ruleIndex << ":";
     //}
     buf << "(";
-    buf << state;
+    buf << stateNumber;
     if (showAlt) {
         buf << ",";
         buf << alt;
@@ -192,12 +216,11 @@ std::string ATNConfig::toString(ANTLR_NULLABLE const Recognizer<Symbol, ATNInter
         buf << context->toString();
         buf << "]";
     }
-    if (semanticContext != NULL && *semanticContext != SemanticContext::NONE) {
-        buf << ",";
-        buf << semanticContext->toString();
+    if (semanticContextIndex != SemanticContextCache::NONE_INDEX) {
+        buf << ",pred=" << semanticContextIndex;
     }
-    if (reachesIntoOuterContext > 0) {
-        buf << ",up=" << reachesIntoOuterContext;
+    if (reachesIntoOuterContext) {
+        buf << ",up";
     }
     buf << ")";
     return buf.str();
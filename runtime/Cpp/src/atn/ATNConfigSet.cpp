@@ -36,7 +36,7 @@
 #include <antlr/atn/ATN.h>
 #include <antlr/atn/ATNConfigSet.h>
 #include <antlr/atn/ATNSimulator.h>
-#include <antlr/atn/SemanticContext.h>
+#include <antlr/atn/SemanticContextCache.h>
 #include <antlr/misc/MurmurHash.h>
 #include <antlr/misc/Utils.h>
 #include <algorithm>
@@ -48,68 +48,442 @@ namespace antlr4 {
 namespace atn {
 
 
+const antlr_uint32_t ATNConfigSet::SMALL_SET_SIZE;
+const antlr_int32_t ATNConfigSet::AltMask::WORD_COUNT;
+const antlr_int32_t ATNConfigSet::AltMask::INLINE_ALTS;
+
 const ATNConfigSet::ConfigEqualityComparator ATNConfigSet::ConfigEqualityComparator::INSTANCE = ATNConfigSet::ConfigEqualityComparator();
 
-ATNConfigSet::AbstractConfigHashSet::AbstractConfigHashSet(const AbstractEqualityComparator<ATNConfig>* comparator)
-    :   Array2DHashSet<ATNConfig>(comparator, 16, 2)
+ATNConfigSet::ConfigEqualityComparator::ConfigEqualityComparator()
 {
 }
 
-ATNConfigSet::AbstractConfigHashSet::AbstractConfigHashSet(const AbstractEqualityComparator<ATNConfig>* comparator,
-                                                           antlr_int32_t initialCapacity, antlr_int32_t initialBucketCapacity)
-    :   Array2DHashSet<ATNConfig>(comparator, initialCapacity, initialBucketCapacity)
+antlr_int32_t ATNConfigSet::ConfigEqualityComparator::hashCode(const ATNConfig& o) const
 {
+    antlr_int32_t hashCode = 7;
+    hashCode = 31 * hashCode + o.stateNumber;
+    hashCode = 31 * hashCode + o.alt;
+    hashCode = 31 * hashCode + o.semanticContextIndex;
+    return hashCode;
 }
 
-ATNConfigSet::ConfigHashSet::ConfigHashSet()
-    :   AbstractConfigHashSet(&ConfigEqualityComparator::INSTANCE)
+bool ATNConfigSet::ConfigEqualityComparator::equals(const ATNConfig& a, const ATNConfig& b) const
 {
+    if ( a==b ) return true;
+    //if ( a.get()==NULL || b.get()==NULL ) return false;
+    return a.stateNumber==b.stateNumber
+        && a.alt==b.alt
+        && a.semanticContextIndex==b.semanticContextIndex;
 }
 
-ATNConfigSet::ConfigEqualityComparator::ConfigEqualityComparator()
+ATNConfigSet::ConfigIndexComparator::ConfigIndexComparator(const ATNConfigSet& set,
+                                                           ANTLR_NOTNULL const AbstractEqualityComparator<ATNConfig>* comparator)
+    :   set(set),
+        comparator(comparator)
 {
 }
 
-antlr_int32_t ATNConfigSet::ConfigEqualityComparator::hashCode(const ATNConfig& o) const
+antlr_int32_t ATNConfigSet::ConfigIndexComparator::hashCode(const antlr_int32_t& o) const
 {
-    antlr_int32_t hashCode = 7;
-    hashCode = 31 * hashCode + o.state->stateNumber;
-    hashCode = 31 * hashCode + o.alt;
-    hashCode = 31 * hashCode + o.semanticContext->hashCode();
-    return hashCode;
+    return comparator->hashCode(set.lookupConfig(o));
 }
 
-bool ATNConfigSet::ConfigEqualityComparator::equals(const ATNConfig& a, const ATNConfig& b) const
+bool ATNConfigSet::ConfigIndexComparator::equals(const antlr_int32_t& a, const antlr_int32_t& b) const
 {
     if ( a==b ) return true;
-    //if ( a.get()==NULL || b.get()==NULL ) return false;
-    return a.state->stateNumber==b.state->stateNumber
-        && a.alt==b.alt
-        && a.semanticContext->equals(b.semanticContext);
+    return comparator->equals(set.lookupConfig(a), set.lookupConfig(b));
+}
+
+void ATNConfigSet::AltMask::reset()
+{
+    for (antlr_int32_t i = 0; i < WORD_COUNT; i++) {
+        words[i] = 0;
+    }
+    high = NULL;
+}
+
+void ATNConfigSet::AltMask::release()
+{
+    delete high;
+    reset();
+}
+
+bool ATNConfigSet::AltMask::get(antlr_int32_t alt) const
+{
+    if ( alt>=INLINE_ALTS ) return high!=NULL && high->get(alt);
+    return (words[alt / 32] & (1u << (alt % 32))) != 0;
+}
+
+void ATNConfigSet::AltMask::set(antlr_int32_t alt)
+{
+    if ( alt>=INLINE_ALTS ) {
+        if ( high==NULL ) high = new BitSet();
+        high->set(alt);
+        return;
+    }
+    words[alt / 32] |= 1u << (alt % 32);
+}
+
+void ATNConfigSet::AltMask::clear(antlr_int32_t alt)
+{
+    if ( alt>=INLINE_ALTS ) {
+        if ( high!=NULL ) high->clear(alt);
+        return;
+    }
+    words[alt / 32] &= ~(1u << (alt % 32));
+}
+
+antlr_int32_t ATNConfigSet::AltMask::first() const
+{
+    for (antlr_int32_t i = 0; i < WORD_COUNT; i++) {
+        if ( words[i]==0 ) continue;
+        antlr_int32_t bit = 0;
+        while ( (words[i] & (1u << bit))==0 ) bit++;
+        return i * 32 + bit;
+    }
+    if ( high!=NULL ) {
+        antlr_int32_t alt = high->nextSetBit(0);
+        if ( alt>=0 ) return alt;
+    }
+    return ATN::INVALID_ALT_NUMBER;
+}
+
+void ATNConfigSet::AltMask::toBitSet(BitSet& bits) const
+{
+    for (antlr_int32_t i = 0; i < WORD_COUNT; i++) {
+        for (antlr_int32_t bit = 0; bit < 32; bit++) {
+            if ( (words[i] & (1u << bit))!=0 ) bits.set(i * 32 + bit);
+        }
+    }
+    if ( high!=NULL ) bits.or_(*high);
+}
+
+ATNConfigSet::AltSubsetTable::IndexComparator::IndexComparator(const AltSubsetTable& table)
+    :   table(table)
+{
+}
+
+antlr_int32_t ATNConfigSet::AltSubsetTable::IndexComparator::hashCode(const antlr_int32_t& o) const
+{
+    return table.hashSubset(table.lookupSubset(o));
+}
+
+bool ATNConfigSet::AltSubsetTable::IndexComparator::equals(const antlr_int32_t& a, const antlr_int32_t& b) const
+{
+    if ( a==b ) return true;
+    return table.equalSubsets(table.lookupSubset(a), table.lookupSubset(b));
+}
+
+ATNConfigSet::AltSubsetTable::AltSubsetTable(bool byContext, ANTLR_NULLABLE Arena* arena)
+    :   subsets(arena),
+        singleAltCount(0),
+        multiAltCount(0),
+        byContext(byContext),
+        arena(arena),
+        lookup(NULL),
+        highAlts(false),
+        indexComparator(*this)
+{
+    probe.stateNumber = ATNState::INVALID_STATE_NUMBER;
+    probe.context = NULL;
+    probe.alts.reset();
+    probe.cardinality = 0;
+}
+
+ATNConfigSet::AltSubsetTable::~AltSubsetTable()
+{
+    destroyLookup();
+    releaseHighAlts();
+}
+
+antlr_int32_t ATNConfigSet::AltSubsetTable::getOrAdd(antlr_int32_t s, const PredictionContext* x)
+{
+    probe.stateNumber = s;
+    probe.context = byContext ? x : NULL;
+    if ( lookup==NULL ) {
+        for (antlr_uint32_t i = 0; i < subsets.size(); i++) {
+            if ( equalSubsets(subsets[i], probe) ) return static_cast<antlr_int32_t>(i);
+        }
+    }
+    else {
+        const antlr_int32_t* found = lookup->get(-1);
+        if ( found!=NULL ) return *found;
+    }
+
+    subsets.push_back(probe);
+    antlr_int32_t index = static_cast<antlr_int32_t>(subsets.size() - 1);
+    if ( lookup!=NULL ) {
+        lookup->add(index);
+    }
+    else if ( subsets.size()>SMALL_SET_SIZE ) {
+        createLookup();
+    }
+    return index;
+}
+
+bool ATNConfigSet::AltSubsetTable::addAlt(antlr_int32_t i, antlr_int32_t alt)
+{
+    AltSubset& subset = subsets[i];
+    if ( subset.alts.get(alt) ) return false;
+    subset.alts.set(alt);
+    if ( alt>=AltMask::INLINE_ALTS ) highAlts = true;
+    updateCounts(subset.cardinality, subset.cardinality + 1);
+    subset.cardinality++;
+    return true;
+}
+
+void ATNConfigSet::AltSubsetTable::removeAlt(antlr_int32_t i, antlr_int32_t alt)
+{
+    AltSubset& subset = subsets[i];
+    if ( !subset.alts.get(alt) ) return;
+    subset.alts.clear(alt);
+    updateCounts(subset.cardinality, subset.cardinality - 1);
+    subset.cardinality--;
+}
+
+void ATNConfigSet::AltSubsetTable::clear()
+{
+    destroyLookup();
+    releaseHighAlts();
+    subsets.clear();
+    singleAltCount = 0;
+    multiAltCount = 0;
+}
+
+void ATNConfigSet::AltSubsetTable::release()
+{
+    clear();
+    subsets.release();
+}
+
+const ATNConfigSet::AltSubset& ATNConfigSet::AltSubsetTable::lookupSubset(antlr_int32_t index) const
+{
+    return index < 0 ? probe : subsets[index];
+}
+
+antlr_int32_t ATNConfigSet::AltSubsetTable::hashSubset(const AltSubset& o) const
+{
+    antlr_int32_t hashCode = MurmurHash::initialize(7);
+    hashCode = MurmurHash::update(hashCode, o.stateNumber);
+    hashCode = MurmurHash::update(hashCode, o.context);
+    return MurmurHash::finish(hashCode, 2);
+}
+
+bool ATNConfigSet::AltSubsetTable::equalSubsets(const AltSubset& a, const AltSubset& b) const
+{
+    return a.stateNumber==b.stateNumber
+        && (a.context==b.context || (a.context!=NULL && a.context->equals(b.context)));
+}
+
+void ATNConfigSet::AltSubsetTable::createLookup()
+{
+    if (arena != NULL) {
+        void* storage = arena->allocate(sizeof(ConfigIndexHashSet));
+        lookup = new (storage) ConfigIndexHashSet(&indexComparator, 16, arena);
+    }
+    else {
+        lookup = new ConfigIndexHashSet(&indexComparator, 16);
+    }
+    for (antlr_uint32_t i = 0; i < subsets.size(); i++) {
+        lookup->add(static_cast<antlr_int32_t>(i));
+    }
+}
+
+void ATNConfigSet::AltSubsetTable::destroyLookup()
+{
+    if (lookup == NULL) {
+        return;
+    }
+    if (arena != NULL) {
+        lookup->~ConfigIndexHashSet();
+    }
+    else {
+        delete lookup;
+    }
+    lookup = NULL;
+}
+
+void ATNConfigSet::AltSubsetTable::updateCounts(antlr_int32_t before, antlr_int32_t after)
+{
+    if ( before==1 ) singleAltCount--;
+    else if ( before>1 ) multiAltCount--;
+    if ( after==1 ) singleAltCount++;
+    else if ( after>1 ) multiAltCount++;
+}
+
+void ATNConfigSet::AltSubsetTable::releaseHighAlts()
+{
+    if ( !highAlts ) return;
+    for (ArenaVector<AltSubset>::iterator it = subsets.begin(); it != subsets.end(); it++) {
+        delete it->alts.high;
+        it->alts.high = NULL;
+    }
+    highAlts = false;
+}
+
+ATNConfigSet::~ATNConfigSet()
+{
+    destroyLookup();
+    alts.release();
 }
 
 ATNConfigSet::ATNConfigSet()
-    :   configLookup(new ConfigHashSet()),
+    :   configLookup(NULL),
         uniqueAlt(0),
         hasSemanticContext(false),
         dipsIntoOuterContext(false),
         fullCtx(true),
         readonly(false),
-        cachedHashCode(-1)
+        lexerConfigs(false),
+        contextCache(NULL),
+        arena(NULL),
+        comparator(&ConfigEqualityComparator::INSTANCE),
+        configIndexComparator(*this, comparator),
+        cachedHashCode(-1),
+        probe(NULL),
+        trackAlts(true),
+        altCount(0),
+        contextAltSubsets(true, arena),
+        stateAltSubsets(false, arena),
+        configSubsets(arena)
 {
-    configs.reserve(7);
+    alts.reset();
 }
 
 ATNConfigSet::ATNConfigSet(bool fullCtx)
-    :   configLookup(new ConfigHashSet()),
+    :   configLookup(NULL),
+        uniqueAlt(0),
+        hasSemanticContext(false),
+        dipsIntoOuterContext(false),
+        fullCtx(fullCtx),
+        readonly(false),
+        lexerConfigs(false),
+        contextCache(NULL),
+        arena(NULL),
+        comparator(&ConfigEqualityComparator::INSTANCE),
+        configIndexComparator(*this, comparator),
+        cachedHashCode(-1),
+        probe(NULL),
+        trackAlts(true),
+        altCount(0),
+        contextAltSubsets(true, arena),
+        stateAltSubsets(false, arena),
+        configSubsets(arena)
+{
+    alts.reset();
+}
+
+ATNConfigSet::ATNConfigSet(bool fullCtx, ANTLR_NULLABLE PredictionContextCache* contextCache)
+    :   configLookup(NULL),
+        uniqueAlt(0),
+        hasSemanticContext(false),
+        dipsIntoOuterContext(false),
+        fullCtx(fullCtx),
+        readonly(false),
+        lexerConfigs(false),
+        contextCache(contextCache),
+        arena(NULL),
+        comparator(&ConfigEqualityComparator::INSTANCE),
+        configIndexComparator(*this, comparator),
+        cachedHashCode(-1),
+        probe(NULL),
+        trackAlts(true),
+        altCount(0),
+        contextAltSubsets(true, arena),
+        stateAltSubsets(false, arena),
+        configSubsets(arena)
+{
+    alts.reset();
+}
+
+ATNConfigSet::ATNConfigSet(bool fullCtx, ANTLR_NULLABLE PredictionContextCache* contextCache,
+                           ANTLR_NULLABLE Arena* arena)
+    :   configLookup(NULL),
+        uniqueAlt(0),
+        hasSemanticContext(false),
+        dipsIntoOuterContext(false),
+        fullCtx(fullCtx),
+        readonly(false),
+        lexerConfigs(false),
+        contextCache(contextCache),
+        arena(arena),
+        comparator(&ConfigEqualityComparator::INSTANCE),
+        configIndexComparator(*this, comparator),
+        cachedHashCode(-1),
+        probe(NULL),
+        trackAlts(true),
+        altCount(0),
+        contextAltSubsets(true, arena),
+        stateAltSubsets(false, arena),
+        configSubsets(arena)
+{
+    alts.reset();
+}
+
+ATNConfigSet::ATNConfigSet(bool fullCtx, ANTLR_NULLABLE PredictionContextCache* contextCache,
+                           ANTLR_NOTNULL const AbstractEqualityComparator<ATNConfig>* comparator,
+                           ANTLR_NULLABLE Arena* arena)
+    :   configLookup(NULL),
         uniqueAlt(0),
         hasSemanticContext(false),
         dipsIntoOuterContext(false),
         fullCtx(fullCtx),
         readonly(false),
-        cachedHashCode(-1)
+        lexerConfigs(false),
+        contextCache(contextCache),
+        arena(arena),
+        comparator(comparator),
+        configIndexComparator(*this, comparator),
+        cachedHashCode(-1),
+        probe(NULL),
+        trackAlts(false),
+        altCount(0),
+        contextAltSubsets(true, arena),
+        stateAltSubsets(false, arena),
+        configSubsets(arena)
+{
+    alts.reset();
+}
+
+const ATNConfig& ATNConfigSet::lookupConfig(antlr_int32_t index) const
 {
-    configs.reserve(7);
+    return index < 0 ? *probe : configs[index];
+}
+
+antlr_int32_t ATNConfigSet::findSmall(const ATNConfig& config) const
+{
+    for (antlr_uint32_t i = 0; i < configs.size(); i++) {
+        if ( comparator->equals(configs[i], config) ) return static_cast<antlr_int32_t>(i);
+    }
+    return -1;
+}
+
+void ATNConfigSet::createLookup()
+{
+    if (arena != NULL) {
+        void* storage = arena->allocate(sizeof(ConfigIndexHashSet));
+        configLookup = new (storage) ConfigIndexHashSet(&configIndexComparator, 16, arena);
+    }
+    else {
+        configLookup = new ConfigIndexHashSet(&configIndexComparator, 16);
+    }
+    for (antlr_uint32_t i = 0; i < configs.size(); i++) {
+        configLookup->add(static_cast<antlr_int32_t>(i));
+    }
+}
+
+void ATNConfigSet::destroyLookup()
+{
+    if (configLookup == NULL) {
+        return;
+    }
+    if (arena != NULL) {
+        configLookup->~ConfigIndexHashSet();
+    }
+    else {
+        delete configLookup;
+    }
+    configLookup = NULL;
 }
 
 bool ATNConfigSet::add(const ATNConfig& config)
@@ -120,66 +494,124 @@ bool ATNConfigSet::add(const ATNConfig& config)
 /**
  * Adding a new config means merging contexts with existing configs for
  * {@code (s, i, pi, _)}, where {@code s} is the
- * {@link ATNConfig#state}, {@code i} is the {@link ATNConfig#alt}, and
- * {@code pi} is the {@link ATNConfig#semanticContext}. We use
+ * {@link ATNConfig#stateNumber}, {@code i} is the {@link ATNConfig#alt}, and
+ * {@code pi} is the {@link ATNConfig#semanticContextIndex}. We use
  * {@code (s,i,pi)} as key.
  * <p/>
  * This method updates {@link #dipsIntoOuterContext} and
  * {@link #hasSemanticContext} when necessary.
  */
 bool ATNConfigSet::add(const ATNConfig& config,
-        ANTLR_NULLABLE DoubleKeyMap< KeyPtr<PredictionContext>,KeyPtr<PredictionContext>,KeyPtr<PredictionContext> >* mergeCache)
+        ANTLR_NULLABLE MergeCache* mergeCache)
 {
     if ( readonly ) throw std::logic_error("This set is readonly");
-    if ( config.semanticContext->operator !=(SemanticContext::NONE) ) {
+    if ( !lexerConfigs && config.semanticContextIndex!=SemanticContextCache::NONE_INDEX ) {
         hasSemanticContext = true;
     }
-    if (config.reachesIntoOuterContext > 0) {
+    if (config.reachesIntoOuterContext) {
         dipsIntoOuterContext = true;
     }
-    bool added = false;
-    const ATNConfig* existing = configLookup->getOrAdd(config, added);
-    if ( added ) { // we added this new one
-        cachedHashCode = -1;
-        configs.push_back(config);  // track order here
-        return true;
+    antlr_int32_t existingIndex;
+    if ( configLookup==NULL ) {
+        // small set: look for (s,i,pi,_) by linear search
+        existingIndex = findSmall(config);
+        if ( existingIndex<0 ) {
+            configs.push_back(config);
+            if ( configs.size()>SMALL_SET_SIZE ) createLookup();
+            trackNewConfig();
+            cachedHashCode = -1;
+            return true;
+        }
+    }
+    else {
+        // tentatively track the new config so the lookup can hash it by index
+        configs.push_back(config);
+        bool added = false;
+        const antlr_int32_t* found =
+            configLookup->getOrAdd(static_cast<antlr_int32_t>(configs.size() - 1), added);
+        if ( added ) { // we added this new one
+            trackNewConfig();
+            cachedHashCode = -1;
+            return true;
+        }
+        configs.pop_back();
+        existingIndex = *found;
     }
     // a previous (s,i,pi,_), merge with it and save result
+    ATNConfig& existing = configs[existingIndex];
     bool rootIsWildcard = !fullCtx;
-    PredictionContext* merged =
-        PredictionContext::merge(existing->context, config.context, rootIsWildcard, mergeCache);
+    const PredictionContext* merged =
+        PredictionContext::merge(existing.context, config.context, rootIsWildcard, mergeCache, contextCache);
     // no need to check for existing.context, config.context in cache
     // since only way to create new graphs is "call rule" and here. We
     // cache at both places.
-    const_cast<ATNConfig*>(existing)->reachesIntoOuterContext =
-        std::max(existing->reachesIntoOuterContext, config.reachesIntoOuterContext);
-    const_cast<ATNConfig*>(existing)->context = merged; // replace context; no need to alt mapping
+    existing.reachesIntoOuterContext |= config.reachesIntoOuterContext;
+    if ( trackAlts && merged!=existing.context ) {
+        trackMergedConfig(existingIndex, merged);
+    }
+    existing.context = merged; // replace context; no need to alt mapping
+    cachedHashCode = -1;
     return true;
 }
 
+void ATNConfigSet::trackNewConfig()
+{
+    if ( !trackAlts ) return;
+    const ATNConfig& config = configs.back();
+    if ( !alts.get(config.alt) ) {
+        alts.set(config.alt);
+        altCount++;
+    }
+    antlr_int32_t subset = contextAltSubsets.getOrAdd(config.stateNumber, config.context);
+    contextAltSubsets.addAlt(subset, config.alt);
+    configSubsets.push_back(subset);
+    stateAltSubsets.addAlt(stateAltSubsets.getOrAdd(config.stateNumber, NULL), config.alt);
+}
+
+void ATNConfigSet::trackMergedConfig(antlr_int32_t i, const PredictionContext* context)
+{
+    const ATNConfig& config = configs[i];
+    antlr_int32_t oldSubset = configSubsets[i];
+    // Without predicates no other config has this state and alt. With
+    // them, another config may still hold the alt for the old context.
+    bool shared = false;
+    if ( hasSemanticContext ) {
+        for (antlr_uint32_t j = 0; j < configs.size() && !shared; j++) {
+            shared = static_cast<antlr_int32_t>(j)!=i && configSubsets[j]==oldSubset
+                  && configs[j].alt==config.alt;
+        }
+    }
+    if ( !shared ) {
+        contextAltSubsets.removeAlt(oldSubset, config.alt);
+    }
+    antlr_int32_t newSubset = contextAltSubsets.getOrAdd(config.stateNumber, context);
+    contextAltSubsets.addAlt(newSubset, config.alt);
+    configSubsets[i] = newSubset;
+}
+
 /** Return a List holding list of configs */
-const std::vector<ATNConfig>& ATNConfigSet::elements() const
+const ATNConfigSet::ConfigList& ATNConfigSet::elements() const
 {
     return configs;
 }
 
-antlr_auto_ptr< HashSet<ATNState> > ATNConfigSet::getStates() const
+antlr_auto_ptr< HashSet<const ATNState*> > ATNConfigSet::getStates(const ATN& atn) const
 {
-    antlr_auto_ptr< HashSet<ATNState> > states(new HashSet<ATNState>());
-    for (std::vector<ATNConfig>::const_iterator it = configs.begin();
+    antlr_auto_ptr< HashSet<const ATNState*> > states(new HashSet<const ATNState*>());
+    for (ConfigList::const_iterator it = configs.begin();
             it != configs.end(); it++) {
-        states->add(*it->state);
+        states->add(atn.states[it->stateNumber]);
     }
     return states;
 }
 
-antlr_auto_ptr< std::vector<const SemanticContext*> > ATNConfigSet::getPredicates() const
+antlr_auto_ptr< std::vector<const SemanticContext*> > ATNConfigSet::getPredicates(const SemanticContextCache& semanticContexts) const
 {
     antlr_auto_ptr< std::vector<const SemanticContext*> > preds(new std::vector<const SemanticContext*>());
-    for (std::vector<ATNConfig>::const_iterator it = configs.begin();
+    for (ConfigList::const_iterator it = configs.begin();
             it != configs.end(); it++) {
-        if (it->semanticContext->operator !=(SemanticContext::NONE)) {
-            preds->push_back(it->semanticContext);
+        if (!lexerConfigs && it->semanticContextIndex!=SemanticContextCache::NONE_INDEX) {
+            preds->push_back(semanticContexts.get(it->semanticContextIndex));
         }
     }
     return preds;
@@ -187,15 +619,83 @@ antlr_auto_ptr< std::vector<const SemanticContext*> > ATNConfigSet::getPredicate
 
 const ATNConfig& ATNConfigSet::get(antlr_int32_t i) const
 {
-    return configs.at(i);
+    return configs.at(static_cast<antlr_uint32_t>(i));
+}
+
+BitSet ATNConfigSet::getAlts() const
+{
+    if ( trackAlts ) {
+        BitSet tracked;
+        alts.toBitSet(tracked);
+        return tracked;
+    }
+    BitSet alts;
+    for (ConfigList::const_iterator it = configs.begin();
+            it != configs.end(); it++) {
+        alts.set(it->alt);
+    }
+    return alts;
+}
+
+antlr_int32_t ATNConfigSet::getUniqueAlt() const
+{
+    if ( trackAlts ) {
+        return altCount==1 ? alts.first() : ATN::INVALID_ALT_NUMBER;
+    }
+    antlr_int32_t alt = ATN::INVALID_ALT_NUMBER;
+    for (ConfigList::const_iterator it = configs.begin(); it != configs.end(); it++) {
+        if ( alt == ATN::INVALID_ALT_NUMBER ) {
+            alt = it->alt; // found first alt
+        }
+        else if ( it->alt!=alt ) {
+            return ATN::INVALID_ALT_NUMBER;
+        }
+    }
+    return alt;
+}
+
+bool ATNConfigSet::tracksAltSubsets() const
+{
+    return trackAlts;
+}
+
+void ATNConfigSet::getAltSubsets(std::vector<BitSet>& altsets) const
+{
+    if ( !trackAlts ) throw std::logic_error("This set doesn't track alt subsets");
+    const ArenaVector<AltSubset>& subsets = contextAltSubsets.subsets;
+    altsets.reserve(altsets.size() + subsets.size());
+    for (ArenaVector<AltSubset>::const_iterator it = subsets.begin(); it != subsets.end(); it++) {
+        if ( it->cardinality>0 ) {
+            altsets.push_back(BitSet());
+            it->alts.toBitSet(altsets.back());
+        }
+    }
+}
+
+bool ATNConfigSet::hasConflictingAltSubset() const
+{
+    if ( !trackAlts ) throw std::logic_error("This set doesn't track alt subsets");
+    return contextAltSubsets.multiAltCount>0;
+}
+
+bool ATNConfigSet::hasNonConflictingAltSubset() const
+{
+    if ( !trackAlts ) throw std::logic_error("This set doesn't track alt subsets");
+    return contextAltSubsets.singleAltCount>0;
+}
+
+bool ATNConfigSet::hasStateAssociatedWithOneAlt() const
+{
+    if ( !trackAlts ) throw std::logic_error("This set doesn't track alt subsets");
+    return stateAltSubsets.singleAltCount>0;
 }
 
 void ATNConfigSet::optimizeConfigs(const ATNSimulator& interpreter)
 {
     if ( readonly ) throw std::logic_error("This set is readonly");
-    if ( configLookup->isEmpty() ) return;
+    if ( configs.empty() ) return;
 
-    for (std::vector<ATNConfig>::iterator it = configs.begin();
+    for (ConfigList::iterator it = configs.begin();
             it != configs.end(); it++) {
         // int before = PredictionContext.getAllContextNodes(config.context).size();
             it->context = interpreter.getCachedContext(it->context);
@@ -233,13 +733,22 @@ antlr_int32_t ATNConfigSet::hashCode() const
 {
     if (isReadonly()) {
         if (cachedHashCode == -1) {
-            const_cast<ATNConfigSet*>(this)->cachedHashCode = MurmurHash::hashCode(configs, 7);
+            const_cast<ATNConfigSet*>(this)->cachedHashCode = hashConfigs();
         }
 
         return cachedHashCode;
     }
 
-    return MurmurHash::hashCode(configs, 7);
+    return hashConfigs();
+}
+
+antlr_int32_t ATNConfigSet::hashConfigs() const
+{
+    antlr_int32_t hash = MurmurHash::initialize(7);
+    for (ConfigList::const_iterator it = configs.begin(); it != configs.end(); it++) {
+        hash = MurmurHash::update(hash, it->hashCode());
+    }
+    return MurmurHash::finish(hash, static_cast<antlr_int32_t>(configs.size()));
 }
 
 antlr_uint32_t ATNConfigSet::size() const
@@ -254,20 +763,27 @@ bool ATNConfigSet::isEmpty() const
 
 bool ATNConfigSet::contains(const ATNConfig& o) const
 {
-    if (configLookup.get() == NULL) {
+    if (readonly) {
         throw std::logic_error("This method is not implemented for readonly sets.");
     }
 
-    return configLookup->contains(o);
+    return containsFast(o);
 }
 
 bool ATNConfigSet::containsFast(const ATNConfig& obj) const
 {
-    if (configLookup.get() == NULL) {
+    if (readonly) {
         throw std::logic_error("This method is not implemented for readonly sets.");
     }
 
-    return configLookup->containsFast(&obj);
+    if (configLookup == NULL) {
+        return findSmall(obj) >= 0;
+    }
+
+    probe = &obj;
+    bool found = configLookup->get(-1) != NULL;
+    probe = NULL;
+    return found;
 }
 
 void ATNConfigSet::clear()
@@ -275,7 +791,12 @@ void ATNConfigSet::clear()
     if ( readonly ) throw std::logic_error("This set is readonly");
     configs.clear();
     cachedHashCode = -1;
-    configLookup->clear();
+    destroyLookup();
+    alts.release();
+    altCount = 0;
+    contextAltSubsets.clear();
+    stateAltSubsets.clear();
+    configSubsets.clear();
 }
 
 bool ATNConfigSet::isReadonly() const
@@ -286,28 +807,58 @@ bool ATNConfigSet::isReadonly() const
 void ATNConfigSet::setReadonly(bool readonly)
 {
     this->readonly = readonly;
-    configLookup.reset();   // can't mod, no need for lookup cache
+    destroyLookup();   // can't mod, no need for lookup cache
+    if ( readonly && trackAlts ) {
+        // DFA states don't ask about alternatives once added to the DFA;
+        // if anything does, the queries fall back to scanning the configs
+        trackAlts = false;
+        alts.release();
+        altCount = 0;
+        contextAltSubsets.release();
+        stateAltSubsets.release();
+        configSubsets.release();
+    }
+}
+
+size_t ATNConfigSet::getBytesUsed() const
+{
+    size_t bytes = sizeof(*this);
+    if ( !configs.isInline() ) bytes += configs.capacity() * sizeof(ATNConfig);
+    if ( configLookup!=NULL && arena==NULL ) {
+        bytes += sizeof(ConfigIndexHashSet) + configLookup->getCapacity() * sizeof(antlr_int32_t);
+    }
+    if ( conflictingAlts.get()!=NULL ) bytes += sizeof(BitSet);
+    bytes += configSubsets.getHeapBytes();
+    bytes += contextAltSubsets.subsets.getHeapBytes();
+    bytes += stateAltSubsets.subsets.getHeapBytes();
+    return bytes;
 }
 
 std::string ATNConfigSet::toString() const
 {
     std::stringstream buf;
-    buf << Utils::stringValueOf(elements());
+    buf << Utils::stringValueOfList(elements());
     if ( hasSemanticContext ) buf << std::boolalpha << ",hasSemanticContext=" << hasSemanticContext;
     if ( uniqueAlt!=ATN::INVALID_ALT_NUMBER ) buf << ",uniqueAlt=" << uniqueAlt;
-    if ( conflictingAlts.get()!=NULL ) buf << ",conflictingAlts=" << Utils::stringValueOf(*conflictingAlts);
+    if ( conflictingAlts.get()!=NULL ) buf << ",conflictingAlts=" << conflictingAlts->toString();
     if ( dipsIntoOuterContext ) buf << ",dipsIntoOuterContext";
     return buf.str();
 }
 
 antlr_auto_ptr< std::vector<const ATNConfig*> > ATNConfigSet::toPtrArray() const
 {
-    return configLookup->toPtrArray();
+    antlr_auto_ptr< std::vector<const ATNConfig*> > a(new std::vector<const ATNConfig*>());
+    a->reserve(configs.size());
+    for (ConfigList::const_iterator it = configs.begin();
+            it != configs.end(); it++) {
+        a->push_back(&*it);
+    }
+    return a;
 }
 
 antlr_auto_ptr< std::vector<ATNConfig> > ATNConfigSet::toArray() const
 {
-    return configLookup->toArray();
+    return antlr_auto_ptr< std::vector<ATNConfig> >(new std::vector<ATNConfig>(configs.begin(), configs.end()));
 }
 
 
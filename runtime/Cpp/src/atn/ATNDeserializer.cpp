@@ -0,0 +1,482 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <antlr/atn/ATNDeserializer.h>
+#include <antlr/Token.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ActionTransition.h>
+#include <antlr/atn/AtomTransition.h>
+#include <antlr/atn/BasicBlockStartState.h>
+#include <antlr/atn/BasicState.h>
+#include <antlr/atn/BlockEndState.h>
+#include <antlr/atn/EpsilonTransition.h>
+#include <antlr/atn/LoopEndState.h>
+#include <antlr/atn/NotSetTransition.h>
+#include <antlr/atn/PlusBlockStartState.h>
+#include <antlr/atn/PlusLoopbackState.h>
+#include <antlr/atn/PredicateTransition.h>
+#include <antlr/atn/RangeTransition.h>
+#include <antlr/atn/RuleStartState.h>
+#include <antlr/atn/RuleStopState.h>
+#include <antlr/atn/RuleTransition.h>
+#include <antlr/atn/SetTransition.h>
+#include <antlr/atn/StarBlockStartState.h>
+#include <antlr/atn/StarLoopEntryState.h>
+#include <antlr/atn/StarLoopbackState.h>
+#include <antlr/atn/TokensStartState.h>
+#include <antlr/atn/WildcardTransition.h>
+#include <antlr/misc/Utils.h>
+#include <stdexcept>
+
+namespace antlr4 {
+namespace atn {
+
+
+const antlr_int32_t ATNDeserializer::SERIALIZED_VERSION = 3;
+
+const antlr_uint32_t ATNDeserializer::SERIALIZED_UUID[8] = {
+    0xACF3, 0xEE8A, 0x4F5B, 0x8B0B, 0x4A43, 0x78BB, 0x1B2D, 0x3376
+};
+
+ATNDeserializer::ATNDeserializer(const antlr_uint32_t* data, size_t length)
+    :   data(data),
+        length(length),
+        p(0)
+{
+}
+
+antlr_auto_ptr<ATN> ATNDeserializer::deserialize(const antlr_uint32_t* data, size_t length)
+{
+    ATNDeserializer deserializer(data, length);
+    return deserializer.deserialize();
+}
+
+antlr_auto_ptr<ATN> ATNDeserializer::deserialize(const std::vector<antlr_uint32_t>& data)
+{
+    return deserialize(data.empty() ? NULL : &data[0], data.size());
+}
+
+antlr_int32_t ATNDeserializer::next()
+{
+    if (p >= length) {
+        throw std::invalid_argument("serialized ATN is truncated");
+    }
+    return static_cast<antlr_int32_t>((data[p++] - 2) & 0xFFFF);
+}
+
+antlr_auto_ptr<ATN> ATNDeserializer::deserialize()
+{
+    if (length == 0) {
+        throw std::invalid_argument("serialized ATN is truncated");
+    }
+    // the version isn't shifted
+    antlr_int32_t version = static_cast<antlr_int32_t>(data[p++]);
+    if (version != SERIALIZED_VERSION) {
+        throw std::invalid_argument("Could not deserialize ATN with version " + Utils::stringValueOf(version) +
+                                    " (expected " + Utils::stringValueOf(SERIALIZED_VERSION) + ").");
+    }
+    for (size_t i = 0; i < 8; i++) {
+        if (static_cast<antlr_uint32_t>(next()) != SERIALIZED_UUID[i]) {
+            throw std::invalid_argument("Could not deserialize ATN with an unknown UUID.");
+        }
+    }
+
+    antlr_auto_ptr<ATN> atn(new ATN());
+    atn->grammarType = next() == LEXER ? LEXER : PARSER;
+    atn->maxTokenType = next();
+
+    std::vector<IntervalSet> sets;
+    readStates(atn.get());
+    readRules(atn.get());
+    readModes(atn.get());
+    readSets(sets);
+    readEdges(atn.get(), sets);
+    deriveEdges(atn.get());
+    readDecisions(atn.get());
+
+    verifyATN(atn.get());
+    atn->buildLayout();
+    return atn;
+}
+
+void ATNDeserializer::readStates(ATN* atn)
+{
+    std::vector< std::pair<LoopEndState*, antlr_int32_t> > loopBackStateNumbers;
+    std::vector< std::pair<BlockStartState*, antlr_int32_t> > endStateNumbers;
+    antlr_int32_t nstates = next();
+    atn->states.reserve(nstates);
+    for (antlr_int32_t i = 0; i < nstates; i++) {
+        antlr_int32_t stype = next();
+        // ignore bad type of states
+        if (stype == ATNState::INVALID_TYPE) {
+            atn->addState(NULL);
+            continue;
+        }
+
+        antlr_int32_t ruleIndex = next();
+        ATNState* s = stateFactory(stype, ruleIndex);
+        atn->addState(s);
+        if (stype == ATNState::LOOP_END) { // special case
+            antlr_int32_t loopBackStateNumber = next();
+            loopBackStateNumbers.push_back(std::make_pair(static_cast<LoopEndState*>(s), loopBackStateNumber));
+        }
+        else if (stype == ATNState::BLOCK_START || stype == ATNState::PLUS_BLOCK_START ||
+                 stype == ATNState::STAR_BLOCK_START) {
+            antlr_int32_t endStateNumber = next();
+            endStateNumbers.push_back(std::make_pair(static_cast<BlockStartState*>(s), endStateNumber));
+        }
+    }
+
+    // delay the assignment of loop back and end states until we know all the state instances have been initialized
+    for (size_t i = 0; i < loopBackStateNumbers.size(); i++) {
+        loopBackStateNumbers[i].first->loopBackState = stateAt(atn, loopBackStateNumbers[i].second);
+    }
+    for (size_t i = 0; i < endStateNumbers.size(); i++) {
+        ATNState* endState = stateAt(atn, endStateNumbers[i].second);
+        checkCondition(endState->getStateType() == ATNState::BLOCK_END, "block end state expected");
+        endStateNumbers[i].first->endState = static_cast<BlockEndState*>(endState);
+    }
+
+    antlr_int32_t numNonGreedyStates = next();
+    for (antlr_int32_t i = 0; i < numNonGreedyStates; i++) {
+        DecisionState* s = dynamic_cast<DecisionState*>(stateAt(atn, next()));
+        checkCondition(s != NULL, "non-greedy state must be a decision state");
+        s->nonGreedy = true;
+    }
+}
+
+void ATNDeserializer::readRules(ATN* atn)
+{
+    antlr_int32_t nrules = next();
+    atn->ruleToStartState.resize(nrules);
+    if (atn->grammarType == LEXER) {
+        atn->ruleToTokenType.resize(nrules);
+        atn->ruleToActionIndex.resize(nrules);
+    }
+    for (antlr_int32_t i = 0; i < nrules; i++) {
+        ATNState* s = stateAt(atn, next());
+        checkCondition(s->getStateType() == ATNState::RULE_START, "rule start state expected");
+        atn->ruleToStartState[i] = static_cast<RuleStartState*>(s);
+        if (atn->grammarType == LEXER) {
+            antlr_int32_t tokenType = next();
+            if (tokenType == 0xFFFF) {
+                tokenType = Token::EOF_;
+            }
+            atn->ruleToTokenType[i] = tokenType;
+            antlr_int32_t actionIndex = next();
+            if (actionIndex == 0xFFFF) {
+                actionIndex = -1;
+            }
+            atn->ruleToActionIndex[i] = actionIndex;
+        }
+    }
+
+    atn->ruleToStopState.resize(nrules);
+    for (std::vector<ATNState*>::iterator it = atn->states.begin(); it != atn->states.end(); it++) {
+        ATNState* state = *it;
+        if (state == NULL || state->getStateType() != ATNState::RULE_STOP) {
+            continue;
+        }
+        checkCondition(state->ruleIndex >= 0 && state->ruleIndex < nrules, "rule index out of range");
+        atn->ruleToStopState[state->ruleIndex] = static_cast<RuleStopState*>(state);
+        atn->ruleToStartState[state->ruleIndex]->stopState = static_cast<RuleStopState*>(state);
+    }
+}
+
+void ATNDeserializer::readModes(ATN* atn)
+{
+    antlr_int32_t nmodes = next();
+    for (antlr_int32_t i = 0; i < nmodes; i++) {
+        ATNState* s = stateAt(atn, next());
+        checkCondition(s->getStateType() == ATNState::TOKEN_START, "tokens start state expected");
+        atn->modeToStartState.push_back(static_cast<TokensStartState*>(s));
+    }
+}
+
+void ATNDeserializer::readSets(std::vector<IntervalSet>& sets)
+{
+    antlr_int32_t nsets = next();
+    sets.resize(nsets);
+    for (antlr_int32_t i = 0; i < nsets; i++) {
+        IntervalSet& set = sets[i];
+        antlr_int32_t nintervals = next();
+        bool containsEof = next() != 0;
+        if (containsEof) {
+            set.add(-1);
+        }
+        for (antlr_int32_t j = 0; j < nintervals; j++) {
+            antlr_int32_t a = next();
+            antlr_int32_t b = next();
+            set.add(a, b);
+        }
+    }
+}
+
+void ATNDeserializer::readEdges(ATN* atn, const std::vector<IntervalSet>& sets)
+{
+    antlr_int32_t nedges = next();
+    for (antlr_int32_t i = 0; i < nedges; i++) {
+        antlr_int32_t src = next();
+        antlr_int32_t trg = next();
+        antlr_int32_t ttype = next();
+        antlr_int32_t arg1 = next();
+        antlr_int32_t arg2 = next();
+        antlr_int32_t arg3 = next();
+        ATNState* srcState = stateAt(atn, src);
+        srcState->addTransition(edgeFactory(atn, ttype, src, trg, arg1, arg2, arg3, sets));
+    }
+}
+
+void ATNDeserializer::deriveEdges(ATN* atn)
+{
+    // edges for rule stop states can be derived, so they aren't serialized
+    for (std::vector<ATNState*>::iterator it = atn->states.begin(); it != atn->states.end(); it++) {
+        const ATNState* state = *it;
+        if (state == NULL) {
+            continue;
+        }
+        for (antlr_int32_t i = 0; i < state->getNumberOfTransitions(); i++) {
+            const Transition* t = state->transition(i);
+            if (t->getSerializationType() != Transition::RULE) {
+                continue;
+            }
+            const RuleTransition* ruleTransition = static_cast<const RuleTransition*>(t);
+            atn->ruleToStopState[ruleTransition->target->ruleIndex]->addTransition(
+                new EpsilonTransition(ruleTransition->followState));
+        }
+    }
+
+    for (std::vector<ATNState*>::iterator it = atn->states.begin(); it != atn->states.end(); it++) {
+        ATNState* state = *it;
+        if (state == NULL) {
+            continue;
+        }
+        BlockStartState* blockStart = dynamic_cast<BlockStartState*>(state);
+        if (blockStart != NULL) {
+            // we need to know the end state to set its start state
+            checkCondition(blockStart->endState != NULL, "block start state without end state");
+            // block end states can only be associated to a single block start state
+            BlockEndState* endState = const_cast<BlockEndState*>(blockStart->endState);
+            checkCondition(endState->startState == NULL, "block end state shared by block start states");
+            endState->startState = blockStart;
+        }
+
+        if (state->getStateType() == ATNState::PLUS_LOOP_BACK) {
+            const PlusLoopbackState* loopbackState = static_cast<const PlusLoopbackState*>(state);
+            for (antlr_int32_t i = 0; i < loopbackState->getNumberOfTransitions(); i++) {
+                const ATNState* target = loopbackState->transition(i)->target;
+                if (target->getStateType() == ATNState::PLUS_BLOCK_START) {
+                    const_cast<PlusBlockStartState*>(static_cast<const PlusBlockStartState*>(target))->loopBackState =
+                        loopbackState;
+                }
+            }
+        }
+        else if (state->getStateType() == ATNState::STAR_LOOP_BACK) {
+            const StarLoopbackState* loopbackState = static_cast<const StarLoopbackState*>(state);
+            for (antlr_int32_t i = 0; i < loopbackState->getNumberOfTransitions(); i++) {
+                const ATNState* target = loopbackState->transition(i)->target;
+                if (target->getStateType() == ATNState::STAR_LOOP_ENTRY) {
+                    const_cast<StarLoopEntryState*>(static_cast<const StarLoopEntryState*>(target))->loopBackState =
+                        loopbackState;
+                }
+            }
+        }
+    }
+}
+
+void ATNDeserializer::readDecisions(ATN* atn)
+{
+    antlr_int32_t ndecisions = next();
+    for (antlr_int32_t i = 0; i < ndecisions; i++) {
+        DecisionState* decState = dynamic_cast<DecisionState*>(stateAt(atn, next()));
+        checkCondition(decState != NULL, "decision state expected");
+        atn->defineDecisionState(decState);
+    }
+}
+
+void ATNDeserializer::verifyATN(const ATN* atn)
+{
+    // verify assumptions
+    for (std::vector<ATNState*>::const_iterator it = atn->states.begin(); it != atn->states.end(); it++) {
+        const ATNState* state = *it;
+        if (state == NULL) {
+            continue;
+        }
+
+        antlr_int32_t type = state->getStateType();
+        antlr_int32_t n = state->getNumberOfTransitions();
+        checkCondition(state->onlyHasEpsilonTransitions() || n <= 1,
+                       "state with a non-epsilon transition must have only one transition");
+
+        if (type == ATNState::PLUS_BLOCK_START) {
+            checkCondition(static_cast<const PlusBlockStartState*>(state)->loopBackState != NULL,
+                           "plus block start state without loopback state");
+        }
+
+        if (type == ATNState::STAR_LOOP_ENTRY) {
+            const StarLoopEntryState* starLoopEntryState = static_cast<const StarLoopEntryState*>(state);
+            checkCondition(starLoopEntryState->loopBackState != NULL, "star loop entry state without loopback state");
+            checkCondition(n == 2, "star loop entry state must have two transitions");
+            antlr_int32_t first = state->transition(0)->target->getStateType();
+            antlr_int32_t second = state->transition(1)->target->getStateType();
+            if (first == ATNState::STAR_BLOCK_START) {
+                checkCondition(second == ATNState::LOOP_END, "star loop must exit to a loop end state");
+                checkCondition(!starLoopEntryState->nonGreedy, "greedy star loop must enter the block first");
+            }
+            else if (first == ATNState::LOOP_END) {
+                checkCondition(second == ATNState::STAR_BLOCK_START, "star loop must enter a star block start state");
+                checkCondition(starLoopEntryState->nonGreedy, "non-greedy star loop must exit first");
+            }
+            else {
+                checkCondition(false, "star loop entry state has unexpected targets");
+            }
+        }
+
+        if (type == ATNState::STAR_LOOP_BACK) {
+            checkCondition(n == 1, "star loopback state must have one transition");
+            checkCondition(state->transition(0)->target->getStateType() == ATNState::STAR_LOOP_ENTRY,
+                           "star loopback state must return to a star loop entry state");
+        }
+
+        if (type == ATNState::LOOP_END) {
+            checkCondition(static_cast<const LoopEndState*>(state)->loopBackState != NULL,
+                           "loop end state without loopback state");
+        }
+
+        if (type == ATNState::RULE_START) {
+            checkCondition(static_cast<const RuleStartState*>(state)->stopState != NULL,
+                           "rule start state without stop state");
+        }
+
+        const BlockStartState* blockStart = dynamic_cast<const BlockStartState*>(state);
+        if (blockStart != NULL) {
+            checkCondition(blockStart->endState != NULL, "block start state without end state");
+        }
+
+        if (type == ATNState::BLOCK_END) {
+            checkCondition(static_cast<const BlockEndState*>(state)->startState != NULL,
+                           "block end state without start state");
+        }
+
+        const DecisionState* decisionState = dynamic_cast<const DecisionState*>(state);
+        if (decisionState != NULL) {
+            checkCondition(n <= 1 || decisionState->decision >= 0, "decision state with several transitions must be a decision");
+        }
+        else {
+            checkCondition(n <= 1 || type == ATNState::RULE_STOP, "only decision and rule stop states may branch");
+        }
+    }
+}
+
+void ATNDeserializer::checkCondition(bool condition, const char* message)
+{
+    if (!condition) {
+        throw std::logic_error(message);
+    }
+}
+
+ATNState* ATNDeserializer::stateAt(const ATN* atn, antlr_int32_t stateNumber)
+{
+    if (stateNumber < 0 || stateNumber >= static_cast<antlr_int32_t>(atn->states.size()) ||
+        atn->states[stateNumber] == NULL) {
+        throw std::logic_error("invalid state number " + Utils::stringValueOf(stateNumber));
+    }
+    return atn->states[stateNumber];
+}
+
+ATNState* ATNDeserializer::stateFactory(antlr_int32_t type, antlr_int32_t ruleIndex)
+{
+    ATNState* s;
+    if (type == ATNState::BASIC) s = new BasicState();
+    else if (type == ATNState::RULE_START) s = new RuleStartState();
+    else if (type == ATNState::BLOCK_START) s = new BasicBlockStartState();
+    else if (type == ATNState::PLUS_BLOCK_START) s = new PlusBlockStartState();
+    else if (type == ATNState::STAR_BLOCK_START) s = new StarBlockStartState();
+    else if (type == ATNState::TOKEN_START) s = new TokensStartState();
+    else if (type == ATNState::RULE_STOP) s = new RuleStopState();
+    else if (type == ATNState::BLOCK_END) s = new BlockEndState();
+    else if (type == ATNState::STAR_LOOP_BACK) s = new StarLoopbackState();
+    else if (type == ATNState::STAR_LOOP_ENTRY) s = new StarLoopEntryState();
+    else if (type == ATNState::PLUS_LOOP_BACK) s = new PlusLoopbackState();
+    else if (type == ATNState::LOOP_END) s = new LoopEndState();
+    else {
+        throw std::logic_error("The specified state type " + Utils::stringValueOf(type) + " is not valid.");
+    }
+
+    s->setRuleIndex(ruleIndex);
+    return s;
+}
+
+Transition* ATNDeserializer::edgeFactory(const ATN* atn, antlr_int32_t type, antlr_int32_t, antlr_int32_t trg,
+                                         antlr_int32_t arg1, antlr_int32_t arg2, antlr_int32_t arg3,
+                                         const std::vector<IntervalSet>& sets)
+{
+    const ATNState* target = stateAt(atn, trg);
+    if (type == Transition::EPSILON) {
+        return new EpsilonTransition(target);
+    }
+    if (type == Transition::RANGE) {
+        return arg3 != 0 ? new RangeTransition(target, Token::EOF_, arg2) : new RangeTransition(target, arg1, arg2);
+    }
+    if (type == Transition::RULE) {
+        const ATNState* ruleStart = stateAt(atn, arg1);
+        checkCondition(ruleStart->getStateType() == ATNState::RULE_START, "rule transition must enter a rule start state");
+        return new RuleTransition(static_cast<const RuleStartState*>(ruleStart), arg2, target);
+    }
+    if (type == Transition::PREDICATE) {
+        return new PredicateTransition(target, arg1, arg2, arg3 != 0);
+    }
+    if (type == Transition::ATOM) {
+        return arg3 != 0 ? new AtomTransition(target, Token::EOF_) : new AtomTransition(target, arg1);
+    }
+    if (type == Transition::ACTION) {
+        return new ActionTransition(target, arg1, arg2, arg3 != 0);
+    }
+    if (type == Transition::SET || type == Transition::NOT_SET) {
+        checkCondition(arg1 >= 0 && arg1 < static_cast<antlr_int32_t>(sets.size()), "set index out of range");
+        if (type == Transition::SET) {
+            return new SetTransition(target, &sets[arg1]);
+        }
+        return new NotSetTransition(target, &sets[arg1]);
+    }
+    if (type == Transition::WILDCARD) {
+        return new WildcardTransition(target);
+    }
+    throw std::logic_error("The specified transition type " + Utils::stringValueOf(type) + " is not valid.");
+}
+
+
+} /* namespace atn */
+} /* namespace antlr4 */
@@ -33,14 +33,44 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/ATNSimulator.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/dfa/DFAState.h>
+
+using namespace antlr4::dfa;
 
 namespace antlr4 {
 namespace atn {
 
-const PredictionContext* ATNSimulator::getCachedContext(const PredictionContext* context) const
+
+DFAState* const ATNSimulator::ERROR = new DFAState(ANTLR_INT32_MAX);
+
+ATNSimulator::ATNSimulator(ANTLR_NOTNULL const ATN* atn,
+                           ANTLR_NULLABLE PredictionContextCache* sharedContextCache)
+    :   atn(atn),
+        sharedContextCache(sharedContextCache)
+{
+    if (sharedContextCache == NULL) {
+        ownedContextCache.reset(new PredictionContextCache());
+        this->sharedContextCache = ownedContextCache.get();
+    }
+}
+
+ATNSimulator::~ATNSimulator()
+{
+}
+
+const PredictionContext* ATNSimulator::getCachedContext(ANTLR_NOTNULL const PredictionContext* context) const
+{
+    HashMap<const PredictionContext*, const PredictionContext*> visited;
+    return PredictionContext::getCachedContext(context, sharedContextCache, visited);
+}
+
+ANTLR_NOTNULL
+PredictionContextCache* ATNSimulator::getSharedContextCache() const
 {
-    return 0;
+    return sharedContextCache;
 }
 
 
@@ -33,11 +33,163 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/ATNState.h>
+#include <antlr/atn/Transition.h>
+#include <antlr/misc/Utils.h>
+#include <stdexcept>
 
 namespace antlr4 {
 namespace atn {
 
 
+const antlr_int32_t ATNState::INITIAL_NUM_TRANSITIONS = 4;
+
+// constants for serialization
+const antlr_int32_t ATNState::INVALID_TYPE     = 0;
+const antlr_int32_t ATNState::BASIC            = 1;
+const antlr_int32_t ATNState::RULE_START       = 2;
+const antlr_int32_t ATNState::BLOCK_START      = 3;
+const antlr_int32_t ATNState::PLUS_BLOCK_START = 4;
+const antlr_int32_t ATNState::STAR_BLOCK_START = 5;
+const antlr_int32_t ATNState::TOKEN_START      = 6;
+const antlr_int32_t ATNState::RULE_STOP        = 7;
+const antlr_int32_t ATNState::BLOCK_END        = 8;
+const antlr_int32_t ATNState::STAR_LOOP_BACK   = 9;
+const antlr_int32_t ATNState::STAR_LOOP_ENTRY  = 10;
+const antlr_int32_t ATNState::PLUS_LOOP_BACK   = 11;
+const antlr_int32_t ATNState::LOOP_END         = 12;
+
+const std::vector<std::string> ATNState::serializationNames =
+    ATNState::getSerializationNames();
+
+const antlr_int32_t ATNState::INVALID_STATE_NUMBER = -1;
+
+ATNState::ATNState()
+    :   atn(NULL),
+        stateNumber(INVALID_STATE_NUMBER),
+        ruleIndex(0),
+        epsilonOnlyTransitions(false)
+{
+    transitions.reserve(INITIAL_NUM_TRANSITIONS);
+}
+
+ATNState::~ATNState()
+{
+    for (std::vector<Transition*>::iterator it = transitions.begin();
+            it != transitions.end(); it++) {
+        delete *it;
+    }
+}
+
+std::vector<std::string> ATNState::getSerializationNames()
+{
+    const char* names[] = {
+        "INVALID",
+        "BASIC",
+        "RULE_START",
+        "BLOCK_START",
+        "PLUS_BLOCK_START",
+        "STAR_BLOCK_START",
+        "TOKEN_START",
+        "RULE_STOP",
+        "BLOCK_END",
+        "STAR_LOOP_BACK",
+        "STAR_LOOP_ENTRY",
+        "PLUS_LOOP_BACK",
+        "LOOP_END"
+    };
+    return std::vector<std::string>(names, names + sizeof(names)/sizeof(names[0]));
+}
+
+antlr_int32_t ATNState::hashCode() const
+{
+    return stateNumber;
+}
+
+bool ATNState::equals(const Key<ATNState>* o) const
+{
+    // are these states same object?
+    const ATNState* other = dynamic_cast<const ATNState*>(o);
+    if (other == NULL) {
+        return false;
+    }
+    return stateNumber==other->stateNumber;
+}
+
+ATNState* ATNState::clone() const
+{
+    throw std::logic_error("ATNState::clone not supported");
+}
+
+bool ATNState::isNonGreedyExitState() const
+{
+    return false;
+}
+
+std::string ATNState::toString() const
+{
+    return Utils::stringValueOf(stateNumber);
+}
+
+const std::vector<Transition*>& ATNState::getTransitions() const
+{
+    return transitions;
+}
+
+antlr_int32_t ATNState::getNumberOfTransitions() const
+{
+    return static_cast<antlr_int32_t>(transitions.size());
+}
+
+void ATNState::addTransition(ANTLR_NOTNULL Transition* e)
+{
+    addTransition(getNumberOfTransitions(), e);
+}
+
+void ATNState::addTransition(antlr_int32_t index, ANTLR_NOTNULL Transition* e)
+{
+    if (transitions.empty()) {
+        epsilonOnlyTransitions = e->isEpsilon();
+    }
+    else if (epsilonOnlyTransitions != e->isEpsilon()) {
+        // ATN state has both epsilon and non-epsilon transitions
+        epsilonOnlyTransitions = false;
+    }
+
+    transitions.insert(transitions.begin() + index, e);
+}
+
+const Transition* ATNState::transition(antlr_int32_t i) const
+{
+    return transitions[i];
+}
+
+void ATNState::setTransition(antlr_int32_t i, ANTLR_NOTNULL Transition* e)
+{
+    if (transitions[i] != e) {
+        delete transitions[i];
+        transitions[i] = e;
+    }
+}
+
+Transition* ATNState::removeTransition(antlr_int32_t index)
+{
+    Transition* t = transitions[index];
+    transitions.erase(transitions.begin() + index);
+    return t;
+}
+
+bool ATNState::onlyHasEpsilonTransitions() const
+{
+    return epsilonOnlyTransitions;
+}
+
+void ATNState::setRuleIndex(antlr_int32_t ruleIndex)
+{
+    this->ruleIndex = ruleIndex;
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
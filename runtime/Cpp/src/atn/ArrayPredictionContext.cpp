@@ -34,10 +34,106 @@
  */
 
 #include <antlr/atn/ArrayPredictionContext.h>
+#include <antlr/atn/SingletonPredictionContext.h>
+#include <antlr/misc/Utils.h>
+#include <sstream>
 
 namespace antlr4 {
 namespace atn {
 
 
+ArrayPredictionContext::ArrayPredictionContext(ANTLR_NOTNULL const SingletonPredictionContext* a)
+    :   PredictionContext(calculateHashCode(std::vector<const PredictionContext*>(1, a->parent),
+                                            std::vector<antlr_int32_t>(1, a->returnState))),
+        parents(1, a->parent),
+        returnStates(1, a->returnState)
+{
+}
+
+ArrayPredictionContext::ArrayPredictionContext(const std::vector<const PredictionContext*>& parents,
+                                               const std::vector<antlr_int32_t>& returnStates)
+    :   PredictionContext(calculateHashCode(parents, returnStates)),
+        parents(parents),
+        returnStates(returnStates)
+{
+}
+
+bool ArrayPredictionContext::isEmpty() const
+{
+    // since EMPTY_RETURN_STATE can only appear in the last position, we
+    // don't need to verify that size==1
+    return returnStates[0]==EMPTY_RETURN_STATE;
+}
+
+antlr_int32_t ArrayPredictionContext::size() const
+{
+    return static_cast<antlr_int32_t>(returnStates.size());
+}
+
+const PredictionContext* ArrayPredictionContext::getParent(antlr_int32_t index) const
+{
+    return parents[index];
+}
+
+antlr_int32_t ArrayPredictionContext::getReturnState(antlr_int32_t index) const
+{
+    return returnStates[index];
+}
+
+bool ArrayPredictionContext::equals(const Key<PredictionContext>* o) const
+{
+    if (this == o) {
+        return true;
+    }
+    const ArrayPredictionContext* a = dynamic_cast<const ArrayPredictionContext*>(o);
+    if (a == NULL) {
+        return false;
+    }
+
+    if ( isInternedWith(a) ) {
+        return false; // hash-consed, so equal only if same object
+    }
+
+    if ( this->hashCode() != a->hashCode() ) {
+        return false; // can't be same if hash is different
+    }
+
+    if ( returnStates != a->returnStates ) {
+        return false;
+    }
+    for (size_t i = 0; i < parents.size(); i++) {
+        const PredictionContext* p = parents[i];
+        const PredictionContext* q = a->parents[i];
+        if ( p != q && (p == NULL || q == NULL || !p->equals(q)) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string ArrayPredictionContext::toString() const
+{
+    if ( isEmpty() ) return "[]";
+    std::stringstream buf;
+    buf << "[";
+    for (size_t i=0; i<returnStates.size(); i++) {
+        if ( i>0 ) buf << ", ";
+        if ( returnStates[i]==EMPTY_RETURN_STATE ) {
+            buf << "$";
+            continue;
+        }
+        buf << returnStates[i];
+        if ( parents[i]!=NULL ) {
+            buf << ' ' << parents[i]->toString();
+        }
+        else {
+            buf << "null";
+        }
+    }
+    buf << "]";
+    return buf.str();
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
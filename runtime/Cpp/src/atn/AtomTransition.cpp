@@ -42,16 +42,11 @@ namespace antlr4 {
 namespace atn {
 
 AtomTransition::AtomTransition(ANTLR_NOTNULL const ATNState* target, antlr_int32_t label)
-    :   Transition(target),
+    :   Transition(target, ATOM, label),
         label_(label)
 {
 }
 
-antlr_int32_t AtomTransition::getSerializationType() const
-{
-    return ATOM;
-}
-
 antlr_auto_ptr<IntervalSet> AtomTransition::label() const
 {
     antlr_auto_ptr<IntervalSet> s(new IntervalSet());
@@ -59,11 +54,6 @@ antlr_auto_ptr<IntervalSet> AtomTransition::label() const
     return s;
 }
 
-bool AtomTransition::matches(antlr_int32_t symbol, antlr_int32_t, antlr_int32_t) const
-{
-    return label_ == symbol;
-}
-
 std::string AtomTransition::toString() const
 {
     return Utils::stringValueOf(label_);
@@ -33,12 +33,22 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/BasicBlockStartState.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+BasicBlockStartState::BasicBlockStartState()
+{
+}
+
+antlr_int32_t BasicBlockStartState::getStateType() const
+{
+    return BLOCK_START;
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
-
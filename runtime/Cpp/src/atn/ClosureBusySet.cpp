@@ -0,0 +1,141 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <antlr/atn/ClosureBusySet.h>
+#include <antlr/atn/ATNState.h>
+
+namespace antlr4 {
+namespace atn {
+
+
+ClosureBusySet::ClosureBusySet()
+    :   epoch(1),
+        n(0)
+{
+}
+
+ClosureBusySet::ClosureBusySet(antlr_uint32_t stateCount)
+    :   epoch(1),
+        n(0)
+{
+    Bucket stale = { 0, -1 };
+    buckets.assign(stateCount, stale);
+}
+
+void ClosureBusySet::reset()
+{
+    chain.clear();
+    n = 0;
+    epoch++;
+    if ( epoch==0 ) {
+        // wrapped around; old stamps could look current again
+        Bucket stale = { 0, -1 };
+        buckets.assign(buckets.size(), stale);
+        epoch = 1;
+    }
+}
+
+bool ClosureBusySet::add(const ATNConfig& config)
+{
+    Bucket& bucket = bucketFor(config.stateNumber);
+    for (antlr_int32_t i = bucket.head; i >= 0; i = chain[i].next) {
+        if ( chain[i].config==config ) return false;
+    }
+    Link link = { config, bucket.head };
+    chain.push_back(link);
+    bucket.head = static_cast<antlr_int32_t>(chain.size() - 1);
+    n++;
+    return true;
+}
+
+bool ClosureBusySet::add(ANTLR_NOTNULL const ATNState* state)
+{
+    if ( contains(state) ) return false;
+    bucketFor(state->stateNumber);
+    n++;
+    return true;
+}
+
+bool ClosureBusySet::contains(const ATNConfig& config) const
+{
+    const Bucket* bucket = currentBucket(config.stateNumber);
+    if ( bucket==NULL ) return false;
+    for (antlr_int32_t i = bucket->head; i >= 0; i = chain[i].next) {
+        if ( chain[i].config==config ) return true;
+    }
+    return false;
+}
+
+bool ClosureBusySet::contains(ANTLR_NOTNULL const ATNState* state) const
+{
+    return currentBucket(state->stateNumber) != NULL;
+}
+
+antlr_uint32_t ClosureBusySet::size() const
+{
+    return n;
+}
+
+antlr_uint32_t ClosureBusySet::getEpoch() const
+{
+    return epoch;
+}
+
+ClosureBusySet::Bucket& ClosureBusySet::bucketFor(antlr_int32_t stateNumber)
+{
+    antlr_uint32_t i = static_cast<antlr_uint32_t>(stateNumber);
+    if ( i>=buckets.size() ) {
+        Bucket stale = { 0, -1 };
+        buckets.resize(i + 1, stale);
+    }
+    Bucket& bucket = buckets[i];
+    if ( bucket.epoch!=epoch ) {
+        bucket.epoch = epoch;
+        bucket.head = -1;
+    }
+    return bucket;
+}
+
+ANTLR_NULLABLE
+const ClosureBusySet::Bucket* ClosureBusySet::currentBucket(antlr_int32_t stateNumber) const
+{
+    antlr_uint32_t i = static_cast<antlr_uint32_t>(stateNumber);
+    if ( i>=buckets.size() || buckets[i].epoch!=epoch ) return NULL;
+    return &buckets[i];
+}
+
+
+} /* namespace atn */
+} /* namespace antlr4 */
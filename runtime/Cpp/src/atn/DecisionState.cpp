@@ -33,11 +33,19 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/DecisionState.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+DecisionState::DecisionState()
+    :   decision(-1),
+        nonGreedy(false)
+{
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
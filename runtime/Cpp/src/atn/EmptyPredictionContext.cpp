@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,11 +33,52 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/EmptyPredictionContext.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+static const EmptyPredictionContext emptyPredictionContext;
+
+const PredictionContext* const PredictionContext::EMPTY = &emptyPredictionContext;
+
+EmptyPredictionContext::EmptyPredictionContext()
+    :   SingletonPredictionContext(NULL, EMPTY_RETURN_STATE)
+{
+}
+
+bool EmptyPredictionContext::isEmpty() const
+{
+    return true;
+}
+
+antlr_int32_t EmptyPredictionContext::size() const
+{
+    return 1;
+}
+
+const PredictionContext* EmptyPredictionContext::getParent(antlr_int32_t) const
+{
+    return NULL;
+}
+
+antlr_int32_t EmptyPredictionContext::getReturnState(antlr_int32_t) const
+{
+    return returnState;
+}
+
+bool EmptyPredictionContext::equals(const Key<PredictionContext>* o) const
+{
+    return this == o;
+}
+
+std::string EmptyPredictionContext::toString() const
+{
+    return "$";
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
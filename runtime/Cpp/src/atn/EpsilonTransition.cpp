@@ -39,25 +39,10 @@ namespace antlr4 {
 namespace atn {
 
 EpsilonTransition::EpsilonTransition(ANTLR_NOTNULL const ATNState* target)
-    :   Transition(target)
+    :   Transition(target, EPSILON)
 {
 }
 
-antlr_int32_t EpsilonTransition::getSerializationType() const
-{
-    return EPSILON;
-}
-
-bool EpsilonTransition::isEpsilon() const
-{
-    return true;
-}
-
-bool EpsilonTransition::matches(antlr_int32_t, antlr_int32_t, antlr_int32_t) const
-{
-    return false;
-}
-
 std::string EpsilonTransition::toString() const
 {
     return "epsilon";
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,11 +33,47 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/LexerATNConfig.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+LexerATNConfig::LexerATNConfig(ANTLR_NOTNULL const ATNState* state,
+                               antlr_int32_t alt,
+                               ANTLR_NULLABLE const PredictionContext* context)
+    :   ATNConfig(state, alt, context)
+{
+}
+
+LexerATNConfig::LexerATNConfig(ANTLR_NOTNULL const ATNState* state,
+                               antlr_int32_t alt,
+                               ANTLR_NULLABLE const PredictionContext* context,
+                               antlr_int32_t actionIndex)
+    :   ATNConfig(state, alt, context)
+{
+    setLexerActionIndex(actionIndex);
+}
+
+LexerATNConfig::LexerATNConfig(ANTLR_NOTNULL const ATNConfig& c, ANTLR_NOTNULL const ATNState* state)
+    :   ATNConfig(&c, state)
+{
+}
+
+LexerATNConfig::LexerATNConfig(ANTLR_NOTNULL const ATNConfig& c, ANTLR_NOTNULL const ATNState* state,
+                               antlr_int32_t actionIndex)
+    :   ATNConfig(&c, state)
+{
+    setLexerActionIndex(actionIndex);
+}
+
+LexerATNConfig::LexerATNConfig(ANTLR_NOTNULL const ATNConfig& c, ANTLR_NOTNULL const ATNState* state,
+                               ANTLR_NULLABLE const PredictionContext* context)
+    :   ATNConfig(&c, state, context)
+{
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,11 +33,730 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/LexerATNSimulator.h>
+#include <antlr/CharStream.h>
+#include <antlr/IntStream.h>
+#include <antlr/Lexer.h>
+#include <antlr/LexerNoViableAltException.h>
+#include <antlr/Token.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ATNState.h>
+#include <antlr/atn/ActionTransition.h>
+#include <antlr/atn/LexerATNConfig.h>
+#include <antlr/atn/OrderedATNConfigSet.h>
+#include <antlr/atn/PredicateTransition.h>
+#include <antlr/atn/PredictionContext.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/atn/RuleTransition.h>
+#include <antlr/atn/SingletonPredictionContext.h>
+#include <antlr/atn/TokensStartState.h>
+#include <antlr/atn/Transition.h>
+#include <antlr/dfa/DFA.h>
+#include <antlr/dfa/DFAState.h>
+#include <antlr/dfa/FrozenDFA.h>
+#include <antlr/misc/Interval.h>
+#include <antlr/misc/MutexLock.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+const antlr_int32_t LexerATNSimulator::MIN_DFA_EDGE = 0;
+const antlr_int32_t LexerATNSimulator::MAX_DFA_EDGE = 127;
+const antlr_int32_t LexerATNSimulator::MAX_BMP_DFA_EDGE = 0xFFFF;
+
+LexerATNSimulator::SimState::SimState()
+    :   index(-1),
+        line(0),
+        charPos(-1),
+        dfaState(NULL)
+{
+}
+
+void LexerATNSimulator::SimState::reset()
+{
+    index = -1;
+    line = 0;
+    charPos = -1;
+    dfaState = NULL;
+}
+
+LexerATNSimulator::LexerATNSimulator(ANTLR_NOTNULL const ATN* atn,
+                                     std::vector<DFA*>& decisionToDFA,
+                                     ANTLR_NULLABLE PredictionContextCache* sharedContextCache)
+    :   ATNSimulator(atn, sharedContextCache),
+        recog(NULL),
+        startIndex(-1),
+        line(1),
+        charPositionInLine(0),
+        decisionToDFA(decisionToDFA),
+        mode(Lexer::DEFAULT_MODE),
+        bmpEdgeCacheEnabled(true)
+{
+}
+
+LexerATNSimulator::LexerATNSimulator(ANTLR_NULLABLE Lexer* recog,
+                                     ANTLR_NOTNULL const ATN* atn,
+                                     std::vector<DFA*>& decisionToDFA,
+                                     ANTLR_NULLABLE PredictionContextCache* sharedContextCache)
+    :   ATNSimulator(atn, sharedContextCache),
+        recog(recog),
+        startIndex(-1),
+        line(1),
+        charPositionInLine(0),
+        decisionToDFA(decisionToDFA),
+        mode(Lexer::DEFAULT_MODE),
+        bmpEdgeCacheEnabled(true)
+{
+}
+
+void LexerATNSimulator::copyState(ANTLR_NOTNULL const LexerATNSimulator* simulator)
+{
+    this->charPositionInLine = simulator->charPositionInLine;
+    this->line = simulator->line;
+    this->mode = simulator->mode;
+    this->startIndex = simulator->startIndex;
+}
+
+antlr_int32_t LexerATNSimulator::match(ANTLR_NOTNULL CharStream* input, antlr_int32_t mode)
+{
+    this->mode = mode;
+    antlr_int32_t mark = input->mark();
+    antlr_int32_t result;
+    try {
+        this->startIndex = input->index();
+        this->prevAccept.reset();
+        const FrozenDFA* frozen = decisionToDFA[mode]->getFrozen();
+        antlr_int32_t startLine = line;
+        antlr_int32_t startCharPositionInLine = charPositionInLine;
+        if ( frozen==NULL || !execFrozenDFA(input, frozen, result) ) {
+            if ( frozen!=NULL ) {
+                input->seek(startIndex);
+                line = startLine;
+                charPositionInLine = startCharPositionInLine;
+            }
+
+            const DFAState* s0 = decisionToDFA[mode]->s0.load();
+            if ( s0==NULL ) {
+                result = matchATN(input);
+            }
+            else {
+                result = execATN(input, s0);
+            }
+        }
+    }
+    catch (...) {
+        predictionArena.reset();
+        input->release(mark);
+        throw;
+    }
+    predictionArena.reset();
+    input->release(mark);
+    return result;
+}
+
+void LexerATNSimulator::reset()
+{
+    prevAccept.reset();
+    startIndex = -1;
+    line = 1;
+    charPositionInLine = 0;
+    mode = Lexer::DEFAULT_MODE;
+}
+
+antlr_int32_t LexerATNSimulator::matchATN(ANTLR_NOTNULL CharStream* input)
+{
+    const ATNState* startState = atn->modeToStartState[mode];
+
+    antlr_auto_ptr<ATNConfigSet> s0_closure = computeStartState(input, startState);
+    bool suppressEdge = s0_closure->hasSemanticContext;
+    s0_closure->hasSemanticContext = false;
+
+    DFA* dfa = decisionToDFA[mode];
+    const DFAState* next;
+    {
+        MutexLock guard(&dfa->lock);
+        next = addDFAState(s0_closure);
+        if (!suppressEdge) {
+            dfa->s0.store(next);
+        }
+    }
+
+    antlr_int32_t predict = execATN(input, next);
+
+    return predict;
+}
+
+antlr_int32_t LexerATNSimulator::execATN(ANTLR_NOTNULL CharStream* input, ANTLR_NOTNULL const DFAState* ds0)
+{
+    if (ds0->isAcceptState) {
+        // allow zero-length tokens
+        captureSimState(prevAccept, input, ds0);
+    }
+
+    antlr_int32_t t = input->LA(1);
+
+    const DFAState* s = ds0; // s is current/from DFA state
+
+    while ( true ) { // while more work
+        // As we move src->trg, src->trg, we keep track of the previous trg to
+        // avoid looking up the DFA state again, which is expensive.
+        // If the previous target was already part of the DFA, we might
+        // be able to avoid doing a reach operation upon t. If s!=null,
+        // it means that semantic predicates didn't prevent us from
+        // creating a DFA state. Once we know s!=null, we check to see if
+        // the DFA state has an edge already for t. If so, we can just reuse
+        // it's configuration set; there's no point in re-computing it.
+        // This is kind of like doing DFA simulation within the ATN
+        // simulation because DFA simulation is really just a way to avoid
+        // computing reach/closure sets. Technically, once we know that
+        // we have a previously added DFA state, we could jump over to
+        // the DFA simulator. But, that would mean popping back and forth
+        // a lot and making things more complicated algorithmically.
+        // This optimization makes a lot of sense for loops within DFA.
+        // A character will take us back to an existing DFA state
+        // that already has lots of edges out of it. e.g., .* in comments.
+        const DFAState* target = getExistingTargetState(s, t);
+        if (target == NULL) {
+            target = computeTargetState(input, s, t);
+        }
+
+        if (target == ERROR) {
+            break;
+        }
+
+        if (target->isAcceptState) {
+            captureSimState(prevAccept, input, target);
+            if (t == IntStream::EOF_) {
+                break;
+            }
+        }
+
+        if (t != IntStream::EOF_) {
+            consume(input);
+            t = input->LA(1);
+        }
+
+        s = target; // flip; current DFA target becomes new src/from state
+    }
+
+    return failOrAccept(prevAccept, input, s->configs.get(), t);
+}
+
+bool LexerATNSimulator::execFrozenDFA(ANTLR_NOTNULL CharStream* input, ANTLR_NOTNULL const FrozenDFA* frozen,
+                                      antlr_int32_t& result)
+{
+    antlr_int32_t s = frozen->getStartState();
+    antlr_int32_t acceptState = FrozenDFA::NO_EDGE;
+    antlr_int32_t acceptIndex = -1;
+    antlr_int32_t acceptLine = 0;
+    antlr_int32_t acceptCharPos = -1;
+    if (frozen->isAcceptState(s)) {
+        // allow zero-length tokens
+        acceptState = s;
+        acceptIndex = input->index();
+        acceptLine = line;
+        acceptCharPos = charPositionInLine;
+    }
+
+    antlr_int32_t t = input->LA(1);
+
+    while ( true ) { // while more work
+        if (t == IntStream::EOF_) {
+            // the table has no EOF column; EOF ends the match unless the
+            // ATN has somewhere to go on it
+            if (frozen->matchesEOF(s)) {
+                return false;
+            }
+            break;
+        }
+
+        // the edge pages are frozen under their symbol, which is also the
+        // column of t since MIN_DFA_EDGE is 0
+        antlr_int32_t target = frozen->getTarget(s, t - MIN_DFA_EDGE);
+        if (target == FrozenDFA::NO_EDGE) {
+            return false;
+        }
+
+        if (target == FrozenDFA::ERROR_EDGE) {
+            break;
+        }
+
+        if (frozen->isAcceptState(target)) {
+            acceptState = target;
+            acceptIndex = input->index();
+            acceptLine = line;
+            acceptCharPos = charPositionInLine;
+        }
+
+        consume(input);
+        t = input->LA(1);
+        s = target;
+    }
+
+    if (acceptState == FrozenDFA::NO_EDGE) {
+        // if no accept and EOF is first char, return EOF
+        if ( t==IntStream::EOF_ && input->index()==startIndex ) {
+            result = Token::EOF_;
+            return true;
+        }
+
+        throw LexerNoViableAltException(recog, input, startIndex, NULL);
+    }
+
+    accept(input, frozen->getLexerRuleIndex(acceptState), frozen->getLexerActionIndex(acceptState),
+        acceptIndex, acceptLine, acceptCharPos);
+    result = frozen->getPrediction(acceptState);
+    return true;
+}
+
+ANTLR_NULLABLE
+const DFAState* LexerATNSimulator::getExistingTargetState(ANTLR_NOTNULL const DFAState* s, antlr_int32_t t) const
+{
+    // a single unsigned compare rejects EOF (-1) along with symbols past the table
+    if (static_cast<antlr_uint32_t>(t - MIN_DFA_EDGE) <= static_cast<antlr_uint32_t>(MAX_DFA_EDGE - MIN_DFA_EDGE)) {
+        return s->getEdge(t - MIN_DFA_EDGE);
+    }
+
+    if (t > MAX_DFA_EDGE && t <= MAX_BMP_DFA_EDGE) {
+        return s->getPagedEdge(t);
+    }
+
+    return NULL;
+}
+
+ANTLR_NOTNULL
+const DFAState* LexerATNSimulator::computeTargetState(ANTLR_NOTNULL CharStream* input, ANTLR_NOTNULL const DFAState* s, antlr_int32_t t)
+{
+    antlr_auto_ptr<ATNConfigSet> reach(new OrderedATNConfigSet(&predictionArena));
+
+    // if we don't find an existing DFA state
+    // Fill reach starting from closure, following t transitions
+    getReachableConfigSet(input, s->configs.get(), reach.get(), t);
+
+    if ( reach->isEmpty() ) { // we got nowhere on t from s
+        if (!reach->hasSemanticContext) {
+            // we got nowhere on t, don't throw out this knowledge; it'd
+            // cause a failover from DFA later.
+            MutexLock guard(&decisionToDFA[mode]->lock);
+            addDFAEdge(s, t, ERROR);
+        }
+
+        // stop when we can't match any more char
+        return ERROR;
+    }
+
+    // Add an edge from s to target DFA found/created for reach
+    return addDFAEdge(s, t, reach);
+}
+
+antlr_int32_t LexerATNSimulator::failOrAccept(SimState& prevAccept, ANTLR_NOTNULL CharStream* input,
+                                              ANTLR_NOTNULL const ATNConfigSet* reach, antlr_int32_t t)
+{
+    if (prevAccept.dfaState != NULL) {
+        antlr_int32_t ruleIndex = prevAccept.dfaState->lexerRuleIndex;
+        antlr_int32_t actionIndex = prevAccept.dfaState->lexerActionIndex;
+        accept(input, ruleIndex, actionIndex,
+            prevAccept.index, prevAccept.line, prevAccept.charPos);
+        return prevAccept.dfaState->prediction;
+    }
+    else {
+        // if no accept and EOF is first char, return EOF
+        if ( t==IntStream::EOF_ && input->index()==startIndex ) {
+            return Token::EOF_;
+        }
+
+        throw LexerNoViableAltException(recog, input, startIndex, reach);
+    }
+}
+
+void LexerATNSimulator::getReachableConfigSet(ANTLR_NOTNULL CharStream* input,
+                                              ANTLR_NOTNULL const ATNConfigSet* closureConfigs,
+                                              ANTLR_NOTNULL ATNConfigSet* reach,
+                                              antlr_int32_t t)
+{
+    // this is used to skip processing for configs which have a lower priority
+    // than a config that already reached an accept state for the same rule
+    antlr_int32_t skipAlt = ATN::INVALID_ALT_NUMBER;
+    const ATNConfigSet::ConfigList& configs = closureConfigs->elements();
+    for (ATNConfigSet::ConfigList::const_iterator it = configs.begin(); it != configs.end(); it++) {
+        const ATNConfig& c = *it;
+        if (c.alt == skipAlt) {
+            continue;
+        }
+
+        const ATNState* state = atn->states[c.stateNumber];
+        antlr_int32_t n = state->getNumberOfTransitions();
+        for (antlr_int32_t ti=0; ti<n; ti++) {               // for each transition
+            const Transition* trans = state->transition(ti);
+            const ATNState* target = getReachableTarget(trans, t);
+            if ( target!=NULL ) {
+                if (closure(input, LexerATNConfig(c, target), reach, false, true)) {
+                    // any remaining configs for this alt have a lower priority than
+                    // the one that just reached an accept state.
+                    skipAlt = c.alt;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void LexerATNSimulator::accept(ANTLR_NOTNULL CharStream* input, antlr_int32_t ruleIndex, antlr_int32_t actionIndex,
+                               antlr_int32_t index, antlr_int32_t line, antlr_int32_t charPos)
+{
+    if (actionIndex >= 0 && recog != NULL) {
+        recog->action(NULL, ruleIndex, actionIndex);
+    }
+
+    // seek to after last char in token
+    input->seek(index);
+    this->line = line;
+    this->charPositionInLine = charPos;
+    if (input->LA(1) != IntStream::EOF_) {
+        consume(input);
+    }
+}
+
+ANTLR_NULLABLE
+const ATNState* LexerATNSimulator::getReachableTarget(const Transition* trans, antlr_int32_t t) const
+{
+    if (trans->matches(t, Lexer::MIN_CHAR_VALUE, Lexer::MAX_CHAR_VALUE)) {
+        return trans->target;
+    }
+
+    return NULL;
+}
+
+ANTLR_NOTNULL
+antlr_auto_ptr<ATNConfigSet> LexerATNSimulator::computeStartState(ANTLR_NOTNULL CharStream* input,
+                                                                  ANTLR_NOTNULL const ATNState* p)
+{
+    const PredictionContext* initialContext = PredictionContext::EMPTY;
+    antlr_auto_ptr<ATNConfigSet> configs(new OrderedATNConfigSet(&predictionArena));
+    for (antlr_int32_t i=0; i<p->getNumberOfTransitions(); i++) {
+        const ATNState* target = p->transition(i)->target;
+        LexerATNConfig c(target, i+1, initialContext);
+        closure(input, c, configs.get(), false, false);
+    }
+    return configs;
+}
+
+bool LexerATNSimulator::closure(ANTLR_NOTNULL CharStream* input, const ATNConfig& config, ANTLR_NOTNULL ATNConfigSet* configs,
+                                bool currentAltReachedAcceptState, bool speculative)
+{
+    const size_t base = closureStack.size();
+    closureEnter(config, configs, currentAltReachedAcceptState);
+
+    // depth first, in the order of the alternatives' preference
+    ATNConfig c;
+    while (closureStack.size() > base) {
+        ClosureFrame& frame = closureStack.back();
+        const ATNConfig top = frame.config;
+        const antlr_int32_t i = frame.next++;
+
+        if ( frame.returns ) {
+            if ( i>=top.context->size() ) {
+                closureStack.pop_back();
+                continue;
+            }
+            if ( top.context->getReturnState(i)!=PredictionContext::EMPTY_RETURN_STATE ) {
+                const PredictionContext* newContext = top.context->getParent(i); // "pop" return state
+                const ATNState* returnState = atn->states[top.context->getReturnState(i)];
+                closureEnter(LexerATNConfig(top, returnState, newContext), configs, currentAltReachedAcceptState);
+            }
+            continue;
+        }
+
+        const ATNState* p = atn->states[top.stateNumber];
+        if ( i>=p->getNumberOfTransitions() ) {
+            closureStack.pop_back();
+            continue;
+        }
+        if ( getEpsilonTarget(input, top, p->transition(i), configs, speculative, c) ) {
+            closureEnter(c, configs, currentAltReachedAcceptState);
+        }
+    }
+
+    return currentAltReachedAcceptState;
+}
+
+void LexerATNSimulator::closureEnter(const ATNConfig& config, ANTLR_NOTNULL ATNConfigSet* configs,
+                                     bool& currentAltReachedAcceptState)
+{
+    const ATNState* state = atn->states[config.stateNumber];
+    if ( state->getStateType() == ATNState::RULE_STOP ) {
+        if ( config.context == NULL || config.context->hasEmptyPath() ) {
+            if (config.context == NULL || config.context->isEmpty()) {
+                configs->add(config);
+                currentAltReachedAcceptState = true;
+                return;
+            }
+            else {
+                configs->add(LexerATNConfig(config, state, PredictionContext::EMPTY));
+                currentAltReachedAcceptState = true;
+            }
+        }
+
+        if ( config.context!=NULL && !config.context->isEmpty() ) {
+            ClosureFrame frame = { config, 0, 0, false, true };
+            closureStack.push_back(frame);
+        }
+        return;
+    }
+
+    // optimization
+    if ( !state->onlyHasEpsilonTransitions() ) {
+        configs->add(config);
+    }
+
+    if ( state->getNumberOfTransitions()>0 ) {
+        ClosureFrame frame = { config, 0, 0, false, false };
+        closureStack.push_back(frame);
+    }
+}
+
+bool LexerATNSimulator::getEpsilonTarget(ANTLR_NOTNULL CharStream* input,
+                                         const ATNConfig& config,
+                                         ANTLR_NOTNULL const Transition* t,
+                                         ANTLR_NOTNULL ATNConfigSet* configs,
+                                         bool speculative,
+                                         ATNConfig& c)
+{
+    switch (t->getSerializationType()) {
+    case Transition::RULE: {
+        const RuleTransition* ruleTransition = static_cast<const RuleTransition*>(t);
+        const PredictionContext* newContext = sharedContextCache->add(
+            SingletonPredictionContext::create(config.context, ruleTransition->followState->stateNumber));
+        c = LexerATNConfig(config, t->target, newContext);
+        return true;
+    }
+
+    case Transition::PREDICATE: {
+        /*  Track traversing semantic predicates. If we traverse,
+         we cannot add a DFA state for this "reach" computation
+         because the DFA would not test the predicate again in the
+         future. Rather than creating collections of semantic predicates
+         like v3 and testing them on prediction, v4 will test them on the
+         fly all the time using the ATN not the DFA. This is slower but
+         semantically it's not used that often. One of the key elements to
+         this predicate mechanism is not adding DFA states that see
+         predicates immediately afterwards in the ATN. For example,
+
+         a : ID {p1}? | ID {p2}? ;
+
+         should create the start state for rule 'a' (to save start state
+         competition), but should not create target of ID state. The
+         collection of ATN states the following ID references includes
+         states reached by traversing predicates. Since this is when we
+         test them, we cannot cash the DFA state target of ID.
+         */
+        const PredicateTransition* pt = static_cast<const PredicateTransition*>(t);
+        configs->hasSemanticContext = true;
+        if (evaluatePredicate(input, pt->ruleIndex, pt->predIndex, speculative)) {
+            c = LexerATNConfig(config, t->target);
+            return true;
+        }
+        return false;
+    }
+
+    case Transition::ACTION:
+        // ignore actions; just exec one per rule upon accept
+        c = LexerATNConfig(config, t->target, static_cast<const ActionTransition*>(t)->actionIndex);
+        return true;
+
+    case Transition::EPSILON:
+        c = LexerATNConfig(config, t->target);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool LexerATNSimulator::evaluatePredicate(ANTLR_NOTNULL CharStream* input, antlr_int32_t ruleIndex, antlr_int32_t predIndex,
+                                          bool speculative)
+{
+    // assume true if no recognizer was provided
+    if (recog == NULL) {
+        return true;
+    }
+
+    if (!speculative) {
+        return recog->sempred(NULL, ruleIndex, predIndex);
+    }
+
+    antlr_int32_t savedCharPositionInLine = charPositionInLine;
+    antlr_int32_t savedLine = line;
+    antlr_int32_t index = input->index();
+    antlr_int32_t marker = input->mark();
+    bool result;
+    try {
+        consume(input);
+        result = recog->sempred(NULL, ruleIndex, predIndex);
+    }
+    catch (...) {
+        charPositionInLine = savedCharPositionInLine;
+        line = savedLine;
+        input->seek(index);
+        input->release(marker);
+        throw;
+    }
+
+    charPositionInLine = savedCharPositionInLine;
+    line = savedLine;
+    input->seek(index);
+    input->release(marker);
+    return result;
+}
+
+void LexerATNSimulator::captureSimState(SimState& settings, ANTLR_NOTNULL CharStream* input,
+                                        ANTLR_NOTNULL const DFAState* dfaState) const
+{
+    settings.index = input->index();
+    settings.line = line;
+    settings.charPos = charPositionInLine;
+    settings.dfaState = dfaState;
+}
+
+ANTLR_NOTNULL
+const DFAState* LexerATNSimulator::addDFAEdge(ANTLR_NOTNULL const DFAState* from, antlr_int32_t t,
+                                              ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& q)
+{
+    /* leading to this call, ATNConfigSet.hasSemanticContext is used as a
+     * marker indicating dynamic predicate evaluation makes this edge
+     * dependent on the specific input sequence, so the static edge in the
+     * DFA should be omitted. The target DFAState is still created since
+     * execATN has the ability to resynchronize with the DFA state cache
+     * following the predicate evaluation step.
+     *
+     * TJP notes: next time through the DFA, we see a pred again and eval.
+     * If that gets us to a previously created (but dangling) DFA
+     * state, we can continue in pure DFA mode from there.
+     */
+    bool suppressEdge = q->hasSemanticContext;
+    q->hasSemanticContext = false;
+
+    MutexLock guard(&decisionToDFA[mode]->lock);
+    const DFAState* to = addDFAState(q);
+
+    if (suppressEdge) {
+        return to;
+    }
+
+    addDFAEdge(from, t, to);
+    return to;
+}
+
+void LexerATNSimulator::addDFAEdge(ANTLR_NOTNULL const DFAState* p, antlr_int32_t t, ANTLR_NOTNULL const DFAState* q)
+{
+    // the edge tables are the only part of a DFA state that changes once
+    // the state has been added to the DFA
+    DFAState* from = const_cast<DFAState*>(p);
+
+    if (static_cast<antlr_uint32_t>(t - MIN_DFA_EDGE) <= static_cast<antlr_uint32_t>(MAX_DFA_EDGE - MIN_DFA_EDGE)) {
+        from->setEdge(t - MIN_DFA_EDGE, MAX_DFA_EDGE-MIN_DFA_EDGE+1, q); // connect
+        return;
+    }
+
+    if (!bmpEdgeCacheEnabled || t < MIN_DFA_EDGE || t > MAX_BMP_DFA_EDGE) {
+        // Only track edges within the DFA bounds
+        return;
+    }
+
+    from->setPagedEdge(t, q); // connect
+}
+
+ANTLR_NOTNULL
+const DFAState* LexerATNSimulator::addDFAState(ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& configs)
+{
+    /* the lexer evaluates predicates on-the-fly; by this point configs
+     * should not contain any configurations with unevaluated predicates.
+     */
+    DFAState proposed(configs);
+    const ATNConfig* firstConfigWithRuleStopState = NULL;
+    const ATNConfigSet::ConfigList& elements = proposed.configs->elements();
+    for (ATNConfigSet::ConfigList::const_iterator it = elements.begin(); it != elements.end(); it++) {
+        if ( atn->states[it->stateNumber]->getStateType() == ATNState::RULE_STOP ) {
+            firstConfigWithRuleStopState = &*it;
+            break;
+        }
+    }
+
+    if ( firstConfigWithRuleStopState!=NULL ) {
+        proposed.isAcceptState = true;
+        proposed.lexerRuleIndex = atn->states[firstConfigWithRuleStopState->stateNumber]->ruleIndex;
+        proposed.lexerActionIndex = firstConfigWithRuleStopState->getLexerActionIndex();
+        proposed.prediction = atn->ruleToTokenType[proposed.lexerRuleIndex];
+    }
+
+    DFA* dfa = decisionToDFA[mode];
+    DFAState* const* existing = dfa->states->get(KeyPtr<DFAState>(&proposed, false));
+    if ( existing!=NULL ) {
+        return *existing;
+    }
+
+    proposed.configs->setReadonly(true);
+    return dfa->addState(proposed);
+}
+
+ANTLR_NOTNULL
+DFA* LexerATNSimulator::getDFA(antlr_int32_t mode) const
+{
+    return decisionToDFA[mode];
+}
+
+/** Get the text matched so far for the current token.
+ */
+std::string LexerATNSimulator::getText(ANTLR_NOTNULL CharStream* input) const
+{
+    // index is first lookahead char, don't include.
+    return input->getText(Interval::of(startIndex, input->index()-1));
+}
+
+antlr_int32_t LexerATNSimulator::getLine() const
+{
+    return line;
+}
+
+void LexerATNSimulator::setLine(antlr_int32_t line)
+{
+    this->line = line;
+}
+
+antlr_int32_t LexerATNSimulator::getCharPositionInLine() const
+{
+    return charPositionInLine;
+}
+
+void LexerATNSimulator::setCharPositionInLine(antlr_int32_t charPositionInLine)
+{
+    this->charPositionInLine = charPositionInLine;
+}
+
+void LexerATNSimulator::consume(ANTLR_NOTNULL CharStream* input)
+{
+    antlr_int32_t curChar = input->LA(1);
+    if ( curChar=='\n' ) {
+        line++;
+        charPositionInLine=0;
+    } else {
+        charPositionInLine++;
+    }
+    input->consume();
+}
+
+void LexerATNSimulator::setBmpEdgeCacheEnabled(bool enabled)
+{
+    bmpEdgeCacheEnabled = enabled;
+}
+
+bool LexerATNSimulator::isBmpEdgeCacheEnabled() const
+{
+    return bmpEdgeCacheEnabled;
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
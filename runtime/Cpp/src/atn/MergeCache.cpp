@@ -0,0 +1,245 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <antlr/atn/MergeCache.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/misc/MurmurHash.h>
+#include <algorithm>
+#include <functional>
+
+using namespace antlr4::misc;
+
+namespace antlr4 {
+namespace atn {
+
+
+const antlr_uint32_t MergeCache::DEFAULT_CAPACITY;
+
+const antlr_uint32_t MergeCache::WAYS;
+
+MergeCache::MergeCache()
+{
+    init(DEFAULT_CAPACITY);
+}
+
+MergeCache::MergeCache(antlr_uint32_t capacity)
+{
+    init(capacity);
+}
+
+void MergeCache::init(antlr_uint32_t capacity)
+{
+    antlr_uint32_t c = WAYS;
+    while ( c<capacity ) c <<= 1;
+    Entry free = { NULL, NULL, NULL, false, false, false };
+    entries.assign(c, free);
+    hands.assign(c / WAYS, 0);
+    setMask = c / WAYS - 1;
+    n = 0;
+    transientCache = NULL;
+    numTransient = 0;
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
+antlr_int32_t MergeCache::pointerBits(const void* p)
+{
+    size_t bits = reinterpret_cast<size_t>(p);
+    return static_cast<antlr_int32_t>(bits ^ (bits >> (sizeof(size_t) * 4)));
+}
+
+antlr_uint32_t MergeCache::setFor(const PredictionContext* a, const PredictionContext* b, bool rootIsWildcard) const
+{
+    antlr_int32_t hash = MurmurHash::initialize();
+    hash = MurmurHash::update(hash, pointerBits(a));
+    hash = MurmurHash::update(hash, pointerBits(b));
+    hash = MurmurHash::update(hash, rootIsWildcard ? 1 : 0);
+    hash = MurmurHash::finish(hash, 3);
+    return (static_cast<antlr_uint32_t>(hash) & setMask) * WAYS;
+}
+
+const PredictionContext* MergeCache::get(ANTLR_NOTNULL const PredictionContext* a,
+                                         ANTLR_NOTNULL const PredictionContext* b,
+                                         bool rootIsWildcard)
+{
+    if ( std::less<const PredictionContext*>()(b, a) ) std::swap(a, b);
+    antlr_uint32_t set = setFor(a, b, rootIsWildcard);
+    for (antlr_uint32_t i = set; i < set + WAYS; i++) {
+        Entry& e = entries[i];
+        if ( e.a==a && e.b==b && e.rootIsWildcard==rootIsWildcard ) {
+            e.referenced = true;
+            hits++;
+            return e.result;
+        }
+    }
+    misses++;
+    return NULL;
+}
+
+void MergeCache::put(ANTLR_NOTNULL const PredictionContext* a,
+                     ANTLR_NOTNULL const PredictionContext* b,
+                     bool rootIsWildcard,
+                     ANTLR_NOTNULL const PredictionContext* result)
+{
+    if ( std::less<const PredictionContext*>()(b, a) ) std::swap(a, b);
+    antlr_uint32_t set = setFor(a, b, rootIsWildcard);
+    Entry* victim = NULL;
+    for (antlr_uint32_t i = set; i < set + WAYS; i++) {
+        Entry& e = entries[i];
+        if ( e.a==a && e.b==b && e.rootIsWildcard==rootIsWildcard ) {
+            if ( e.transient ) numTransient--;
+            e.result = result;
+            e.transient = isTransient(a, b, result);
+            if ( e.transient ) numTransient++;
+            return;
+        }
+        if ( e.a==NULL && victim==NULL ) victim = &e;
+    }
+    if ( victim==NULL ) {
+        // set is full: advance the clock hand past referenced entries,
+        // giving each a second chance
+        antlr_uint32_t& hand = hands[set / WAYS];
+        while ( entries[set + hand].referenced ) {
+            entries[set + hand].referenced = false;
+            hand = (hand + 1) % WAYS;
+        }
+        victim = &entries[set + hand];
+        hand = (hand + 1) % WAYS;
+        evictions++;
+        if ( victim->transient ) numTransient--;
+    }
+    else {
+        n++;
+    }
+    victim->a = a;
+    victim->b = b;
+    victim->result = result;
+    victim->rootIsWildcard = rootIsWildcard;
+    victim->referenced = false;
+    victim->transient = isTransient(a, b, result);
+    if ( victim->transient ) numTransient++;
+}
+
+bool MergeCache::isTransient(const PredictionContext* a, const PredictionContext* b,
+                             const PredictionContext* result) const
+{
+    return transientCache!=NULL
+        && (transientCache->owns(a) || transientCache->owns(b) || transientCache->owns(result));
+}
+
+void MergeCache::clear()
+{
+    if ( n==0 ) return;
+    for (std::vector<Entry>::iterator it = entries.begin(); it != entries.end(); it++) {
+        it->a = NULL;
+        it->transient = false;
+    }
+    n = 0;
+    numTransient = 0;
+}
+
+void MergeCache::setTransientCache(ANTLR_NULLABLE const PredictionContextCache* cache)
+{
+    clear();
+    transientCache = cache;
+}
+
+void MergeCache::removeContextsOf(ANTLR_NOTNULL const PredictionContextCache* cache)
+{
+    if ( cache==transientCache ) {
+        // only the counted entries refer to its contexts
+        for (std::vector<Entry>::iterator it = entries.begin(); numTransient>0 && it != entries.end(); it++) {
+            if ( it->transient ) {
+                it->a = NULL;
+                it->transient = false;
+                n--;
+                numTransient--;
+            }
+        }
+        return;
+    }
+
+    if ( n==0 ) return;
+    for (std::vector<Entry>::iterator it = entries.begin(); it != entries.end(); it++) {
+        if ( it->a!=NULL && (cache->owns(it->a) || cache->owns(it->b) || cache->owns(it->result)) ) {
+            it->a = NULL;
+            if ( it->transient ) numTransient--;
+            it->transient = false;
+            n--;
+        }
+    }
+}
+
+antlr_uint32_t MergeCache::size() const
+{
+    return n;
+}
+
+antlr_uint32_t MergeCache::transientSize() const
+{
+    return numTransient;
+}
+
+antlr_uint32_t MergeCache::getCapacity() const
+{
+    return static_cast<antlr_uint32_t>(entries.size());
+}
+
+antlr_uint32_t MergeCache::getHits() const
+{
+    return hits;
+}
+
+antlr_uint32_t MergeCache::getMisses() const
+{
+    return misses;
+}
+
+antlr_uint32_t MergeCache::getEvictions() const
+{
+    return evictions;
+}
+
+void MergeCache::resetStatistics()
+{
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
+
+} /* namespace atn */
+} /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,11 +33,26 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/OrderedATNConfigSet.h>
+#include <antlr/misc/ObjectEqualityComparator.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+OrderedATNConfigSet::OrderedATNConfigSet()
+    :   ATNConfigSet(true, NULL, &ObjectEqualityComparator<ATNConfig>::INSTANCE, NULL)
+{
+    lexerConfigs = true;
+}
+
+OrderedATNConfigSet::OrderedATNConfigSet(ANTLR_NULLABLE Arena* arena)
+    :   ATNConfigSet(true, NULL, &ObjectEqualityComparator<ATNConfig>::INSTANCE, arena)
+{
+    lexerConfigs = true;
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
@@ -34,10 +34,1046 @@
  */
 
 #include <antlr/atn/ParserATNSimulator.h>
+#include <antlr/IntStream.h>
+#include <antlr/NoViableAltException.h>
+#include <antlr/Parser.h>
+#include <antlr/ParserRuleContext.h>
+#include <antlr/Token.h>
+#include <antlr/TokenStream.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ATNConfigSet.h>
+#include <antlr/atn/ATNState.h>
+#include <antlr/atn/ActionTransition.h>
+#include <antlr/atn/DecisionState.h>
+#include <antlr/atn/PredicateTransition.h>
+#include <antlr/atn/RuleTransition.h>
+#include <antlr/atn/SemanticContext.h>
+#include <antlr/atn/SingletonPredictionContext.h>
+#include <antlr/atn/Transition.h>
+#include <antlr/dfa/DFA.h>
+#include <antlr/dfa/DFAState.h>
+#include <antlr/dfa/FrozenDFA.h>
+#include <antlr/misc/MutexLock.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+ParserATNSimulator::ParserATNSimulator(ANTLR_NOTNULL const ATN* atn,
+                                       std::vector<DFA*>& decisionToDFA,
+                                       ANTLR_NULLABLE PredictionContextCache* sharedContextCache)
+    :   ATNSimulator(atn, sharedContextCache),
+        parser(NULL),
+        decisionToDFA(decisionToDFA),
+        mode(PredictionMode::LL),
+        transientContexts(getSharedContextCache()),
+        closureBusy(static_cast<antlr_uint32_t>(atn->states.size())),
+        _input(NULL),
+        _startIndex(0),
+        _outerContext(NULL),
+        _dfa(NULL),
+        sllPredictions(0),
+        llFallbacks(0)
+{
+    mergeCache.setTransientCache(&transientContexts);
+}
+
+ParserATNSimulator::ParserATNSimulator(ANTLR_NULLABLE Parser* parser,
+                                       ANTLR_NOTNULL const ATN* atn,
+                                       std::vector<DFA*>& decisionToDFA,
+                                       ANTLR_NULLABLE PredictionContextCache* sharedContextCache)
+    :   ATNSimulator(atn, sharedContextCache),
+        parser(parser),
+        decisionToDFA(decisionToDFA),
+        mode(PredictionMode::LL),
+        transientContexts(getSharedContextCache()),
+        closureBusy(static_cast<antlr_uint32_t>(atn->states.size())),
+        _input(NULL),
+        _startIndex(0),
+        _outerContext(NULL),
+        _dfa(NULL),
+        sllPredictions(0),
+        llFallbacks(0)
+{
+    mergeCache.setTransientCache(&transientContexts);
+}
+
+void ParserATNSimulator::reset()
+{
+    mergeCache.clear();
+}
+
+antlr_int32_t ParserATNSimulator::adaptivePredict(ANTLR_NOTNULL TokenStream* input, antlr_int32_t decision,
+                                                  ANTLR_NULLABLE ParserRuleContext* outerContext)
+{
+    _input = input;
+    _startIndex = input->index();
+    _outerContext = outerContext;
+    DFA* dfa = decisionToDFA[decision];
+    _dfa = dfa;
+    sllPredictions++;
+
+    antlr_int32_t m = input->mark();
+    antlr_int32_t index = input->index();
+
+    antlr_int32_t alt = ATN::INVALID_ALT_NUMBER;
+    try {
+        const FrozenDFA* frozen = dfa->getFrozen();
+        if ( frozen!=NULL ) {
+            alt = execFrozenDFA(dfa, frozen, input, index, outerContext);
+        }
+
+        if ( alt==ATN::INVALID_ALT_NUMBER ) {
+            input->seek(index);
+            const DFAState* s0 = dfa->s0.load();
+            if ( s0==NULL ) {
+                bool fullCtx = false;
+                antlr_auto_ptr<ATNConfigSet> s0_closure = computeStartState(dfa->atnStartState, NULL, fullCtx);
+                DFAState proposed(s0_closure);
+                MutexLock guard(&dfa->lock);
+                s0 = addDFAState(dfa, &proposed);
+                dfa->s0.store(s0);
+            }
+
+            alt = execATN(dfa, s0, input, index, outerContext);
+        }
+    }
+    catch (...) {
+        mergeCache.removeContextsOf(&transientContexts); // about to be deleted
+        transientContexts.clear();
+        predictionArena.reset();
+        _dfa = NULL;
+        input->seek(index);
+        input->release(m);
+        throw;
+    }
+    mergeCache.removeContextsOf(&transientContexts); // about to be deleted
+    transientContexts.clear();
+    predictionArena.reset();
+    _dfa = NULL;
+    input->seek(index);
+    input->release(m);
+    return alt;
+}
+
+void ParserATNSimulator::setPredictionMode(PredictionMode::Mode mode)
+{
+    this->mode = mode;
+}
+
+PredictionMode::Mode ParserATNSimulator::getPredictionMode() const
+{
+    return mode;
+}
+
+antlr_uint32_t ParserATNSimulator::getSLLPredictionCount() const
+{
+    return sllPredictions;
+}
+
+antlr_uint32_t ParserATNSimulator::getLLFallbackCount() const
+{
+    return llFallbacks;
+}
+
+const MergeCache& ParserATNSimulator::getMergeCache() const
+{
+    return mergeCache;
+}
+
+void ParserATNSimulator::resetPredictionCounters()
+{
+    sllPredictions = 0;
+    llFallbacks = 0;
+    mergeCache.resetStatistics();
+}
+
+antlr_int32_t ParserATNSimulator::execATN(ANTLR_NOTNULL DFA* dfa, ANTLR_NOTNULL const DFAState* s0,
+                                          ANTLR_NOTNULL TokenStream* input, antlr_int32_t startIndex,
+                                          ANTLR_NULLABLE ParserRuleContext* outerContext)
+{
+    const DFAState* previousD = s0;
+
+    antlr_int32_t t = input->LA(1);
+
+    while (true) { // while more work
+        const DFAState* D = getExistingTargetState(previousD, t);
+        if ( D==NULL ) {
+            D = computeTargetState(dfa, previousD, t);
+        }
+
+        if ( D==ERROR ) {
+            // if any configs in previous dipped into outer context, that
+            // means that input up to t actually finished entry rule
+            // at least for SLL decision. Full LL doesn't dip into outer
+            // so don't need special case.
+            // We will get an error no matter what so delay until after
+            // decision; better error message. Also, no reachable target
+            // ATN states in SLL implies LL will also get nowhere.
+            NoViableAltException e = noViableAlt(input, outerContext, previousD->configs.get(), startIndex);
+            input->seek(startIndex);
+            throw e;
+        }
+
+        if ( D->requiresFullContext && mode != PredictionMode::SLL ) {
+            // IF PREDS, MIGHT RESOLVE TO SINGLE ALT => SLL (or syntax error)
+            if ( D->predicates!=NULL ) {
+                antlr_int32_t conflictIndex = input->index();
+                if (conflictIndex != startIndex) {
+                    input->seek(startIndex);
+                }
+
+                BitSet conflictingAlts = evalSemanticContext(D, outerContext, true);
+                if ( conflictingAlts.cardinality()==1 ) {
+                    return conflictingAlts.nextSetBit(0);
+                }
+
+                if (conflictIndex != startIndex) {
+                    // restore the index so reporting the fallback to full
+                    // context occurs with the index at the correct spot
+                    input->seek(conflictIndex);
+                }
+            }
+
+            llFallbacks++;
+            bool fullCtx = true;
+            antlr_auto_ptr<ATNConfigSet> s0_closure =
+                computeStartState(dfa->atnStartState, outerContext, fullCtx);
+            antlr_int32_t alt = execATNWithFullContext(dfa, D, s0_closure,
+                                                       input, startIndex,
+                                                       outerContext);
+            return alt;
+        }
+
+        if ( D->isAcceptState ) {
+            if (D->predicates == NULL) {
+                return D->prediction;
+            }
+
+            input->seek(startIndex);
+            BitSet alts = evalSemanticContext(D, outerContext, true);
+            if ( alts.isEmpty() ) {
+                throw noViableAlt(input, outerContext, D->configs.get(), startIndex);
+            }
+            // report ambiguity after predicate evaluation to make sure the
+            // correct set of ambig alts is reported.
+            return alts.nextSetBit(0);
+        }
+
+        previousD = D;
+
+        if (t != IntStream::EOF_) {
+            input->consume();
+            t = input->LA(1);
+        }
+    }
+}
+
+antlr_int32_t ParserATNSimulator::execFrozenDFA(ANTLR_NOTNULL DFA* dfa, ANTLR_NOTNULL const FrozenDFA* frozen,
+                                                ANTLR_NOTNULL TokenStream* input, antlr_int32_t startIndex,
+                                                ANTLR_NULLABLE ParserRuleContext* outerContext)
+{
+    antlr_int32_t previousD = frozen->getStartState();
+
+    antlr_int32_t t = input->LA(1);
+
+    while (true) { // while more work
+        antlr_int32_t D = frozen->getTarget(previousD, t + 1);
+        if ( D==FrozenDFA::NO_EDGE ) {
+            return ATN::INVALID_ALT_NUMBER;
+        }
+
+        if ( D==FrozenDFA::ERROR_EDGE ) {
+            NoViableAltException e = noViableAlt(input, outerContext, NULL, startIndex);
+            input->seek(startIndex);
+            throw e;
+        }
+
+        if ( frozen->requiresFullContext(D) && mode != PredictionMode::SLL ) {
+            if ( frozen->getNumPredicates(D)>0 ) {
+                antlr_int32_t conflictIndex = input->index();
+                if (conflictIndex != startIndex) {
+                    input->seek(startIndex);
+                }
+
+                BitSet conflictingAlts = evalSemanticContext(*frozen, D, outerContext, true);
+                if ( conflictingAlts.cardinality()==1 ) {
+                    return conflictingAlts.nextSetBit(0);
+                }
+
+                if (conflictIndex != startIndex) {
+                    input->seek(conflictIndex);
+                }
+            }
+
+            llFallbacks++;
+            bool fullCtx = true;
+            antlr_auto_ptr<ATNConfigSet> s0_closure =
+                computeStartState(dfa->atnStartState, outerContext, fullCtx);
+            return execATNWithFullContext(dfa, NULL, s0_closure,
+                                          input, startIndex,
+                                          outerContext);
+        }
+
+        if ( frozen->isAcceptState(D) ) {
+            if ( frozen->getNumPredicates(D)==0 ) {
+                return frozen->getPrediction(D);
+            }
+
+            input->seek(startIndex);
+            BitSet alts = evalSemanticContext(*frozen, D, outerContext, true);
+            if ( alts.isEmpty() ) {
+                throw noViableAlt(input, outerContext, NULL, startIndex);
+            }
+            return alts.nextSetBit(0);
+        }
+
+        previousD = D;
+
+        if (t != IntStream::EOF_) {
+            input->consume();
+            t = input->LA(1);
+        }
+    }
+}
+
+ANTLR_NULLABLE
+const DFAState* ParserATNSimulator::getExistingTargetState(ANTLR_NOTNULL const DFAState* previousD, antlr_int32_t t) const
+{
+    return previousD->getEdge(t + 1);
+}
+
+ANTLR_NOTNULL
+const DFAState* ParserATNSimulator::computeTargetState(ANTLR_NOTNULL DFA* dfa, ANTLR_NOTNULL const DFAState* previousD, antlr_int32_t t)
+{
+    antlr_auto_ptr<ATNConfigSet> reach = computeReachSet(previousD->configs.get(), t, false);
+    if ( reach.get()==NULL ) {
+        addDFAEdge(dfa, previousD, t, ERROR);
+        return ERROR;
+    }
+
+    // create new target state; we'll add to DFA after it's complete
+    DFAState proposed(reach);
+    DFAState* D = &proposed;
+
+    antlr_int32_t predictedAlt = getUniqueAlt(D->configs.get());
+
+    if ( predictedAlt!=ATN::INVALID_ALT_NUMBER ) {
+        // NO CONFLICT, UNIQUELY PREDICTED ALT
+        D->isAcceptState = true;
+        D->configs->uniqueAlt = predictedAlt;
+        D->prediction = predictedAlt;
+    }
+    else if ( PredictionMode::hasSLLConflictTerminatingPrediction(mode, atn, D->configs.get(), &transientContexts) ) {
+        // MORE THAN ONE VIABLE ALTERNATIVE
+        D->configs->conflictingAlts.reset(new BitSet(getConflictingAlts(D->configs.get())));
+        D->requiresFullContext = true;
+        // in SLL-only mode, we will stop at this state and return the minimum alt
+        D->isAcceptState = true;
+        D->prediction = D->configs->conflictingAlts->nextSetBit(0);
+    }
+
+    if ( D->isAcceptState && D->configs->hasSemanticContext ) {
+        predicateDFAState(D, atn->getDecisionState(dfa->decision));
+        if (D->predicates != NULL) {
+            D->prediction = ATN::INVALID_ALT_NUMBER;
+        }
+    }
+
+    // all adds to dfa are done after we've created full D state
+    return addDFAEdge(dfa, previousD, t, D);
+}
+
+void ParserATNSimulator::predicateDFAState(ANTLR_NOTNULL DFAState* dfaState, ANTLR_NOTNULL const DecisionState* decisionState)
+{
+    // We need to test all predicates, even in DFA states that
+    // uniquely predict alternative.
+    antlr_int32_t nalts = decisionState->getNumberOfTransitions();
+    // Update DFA so reach becomes accept state with (predicate,alt)
+    // pairs if preds found for conflicting alts
+    BitSet altsToCollectPredsFrom = getConflictingAltsOrUniqueAlt(dfaState->configs.get());
+    antlr_auto_ptr< std::vector<const SemanticContext*> > altToPred =
+        getPredsForAmbigAlts(altsToCollectPredsFrom, dfaState->configs.get(), nalts);
+    if ( altToPred.get()!=NULL && getPredicatePredictions(altsToCollectPredsFrom, *altToPred, dfaState) ) {
+        dfaState->prediction = ATN::INVALID_ALT_NUMBER; // make sure we use preds
+    }
+    else {
+        // There are preds in configs but they might go away
+        // when OR'd together like {p}? || NONE == NONE. If neither
+        // alt has preds, resolve to min alt
+        dfaState->prediction = altsToCollectPredsFrom.nextSetBit(0);
+    }
+}
+
+antlr_int32_t ParserATNSimulator::execATNWithFullContext(ANTLR_NOTNULL DFA*,
+                                                         ANTLR_NULLABLE const DFAState*,
+                                                         ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& s0,
+                                                         ANTLR_NOTNULL TokenStream* input, antlr_int32_t startIndex,
+                                                         ANTLR_NULLABLE ParserRuleContext* outerContext)
+{
+    bool fullCtx = true;
+    antlr_auto_ptr<ATNConfigSet> reach;
+    antlr_auto_ptr<ATNConfigSet> previous(s0.release());
+    input->seek(startIndex);
+    antlr_int32_t t = input->LA(1);
+    antlr_int32_t predictedAlt;
+    while (true) { // while more work
+        reach = computeReachSet(previous.get(), t, fullCtx);
+        if ( reach.get()==NULL ) {
+            // if any configs in previous dipped into outer context, that
+            // means that input up to t actually finished entry rule
+            // at least for LL decision. Full LL doesn't dip into outer
+            // so don't need special case.
+            // We will get an error no matter what so delay until after
+            // decision; better error message. Also, no reachable target
+            // ATN states in SLL implies LL will also get nowhere.
+            // The configurations only live as long as this call, so they
+            // aren't attached to the exception.
+            NoViableAltException e = noViableAlt(input, outerContext, NULL, startIndex);
+            input->seek(startIndex);
+            throw e;
+        }
+
+        reach->uniqueAlt = getUniqueAlt(reach.get());
+        // unique prediction?
+        if ( reach->uniqueAlt!=ATN::INVALID_ALT_NUMBER ) {
+            predictedAlt = reach->uniqueAlt;
+            break;
+        }
+        antlr_auto_ptr<PredictionMode::AltSubsets> altSubSets = PredictionMode::getConflictingAltSubsets(reach.get());
+        if ( mode != PredictionMode::LL_EXACT_AMBIG_DETECTION ) {
+            predictedAlt = PredictionMode::resolvesToJustOneViableAlt(*altSubSets);
+            if ( predictedAlt != ATN::INVALID_ALT_NUMBER ) {
+                break;
+            }
+        }
+        else {
+            // In exact ambiguity mode, we never try to terminate early.
+            // Just keeps scarfing until we know what the conflict is
+            if ( !reach->hasNonConflictingAltSubset() &&
+                 PredictionMode::allSubsetsEqual(*altSubSets) )
+            {
+                predictedAlt = PredictionMode::getSingleViableAlt(*altSubSets);
+                break;
+            }
+            // else there are multiple non-conflicting subsets or
+            // we're not sure what the ambiguity is yet.
+            // So, keep going.
+        }
+
+        previous.reset(reach.release());
+        if (t != IntStream::EOF_) {
+            input->consume();
+            t = input->LA(1);
+        }
+    }
+
+    /* We do not check predicates here because we have checked them
+       on-the-fly when doing full context prediction.
+     */
+
+    /*
+    In non-exact ambiguity detection mode, we might actually be able to
+    detect an exact ambiguity, but I'm not going to spend the cycles
+    needed to check. We only emit ambiguity warnings in exact ambiguity
+    mode.
+
+    For example, we might know that we have conflicting configurations.
+    But, that does not mean that there is no way forward without a
+    conflict. It's possible to have nonconflicting alt subsets as in:
+
+       LL altSubSets=[{1, 2}, {1, 2}, {1}, {1, 2}]
+
+    from
+
+       [(17,1,[5 $]), (13,1,[5 10 $]), (21,1,[5 10 $]), (11,1,[$]),
+        (13,2,[5 10 $]), (21,2,[5 10 $]), (11,2,[$])]
+
+    In this case, (17,1,[5 $]) indicates there is some next sequence that
+    would resolve this without conflict to alternative 1. Any other viable
+    next sequence, however, is associated with a conflict.  We stop
+    looking for input because no amount of further lookahead will alter
+    the fact that we should predict alternative 1.  We just can't say for
+    sure that there is an ambiguity without looking further.
+    */
+    return predictedAlt;
+}
+
+ANTLR_NULLABLE
+antlr_auto_ptr<ATNConfigSet> ParserATNSimulator::computeReachSet(ANTLR_NOTNULL const ATNConfigSet* closureConfigs, antlr_int32_t t,
+                                                                 bool fullCtx)
+{
+    antlr_auto_ptr<ATNConfigSet> intermediate(new ATNConfigSet(fullCtx, &transientContexts, &predictionArena));
+
+    /* Configurations already in a rule stop state indicate reaching the end
+     * of the decision rule (local context) or end of the start rule (full
+     * context). Once reached, these configurations are never updated by a
+     * closure operation, so they are handled separately for the performance
+     * advantage of having a smaller intermediate set when calling closure.
+     *
+     * For full-context reach operations, separate handling is required to
+     * ensure that the alternative matching the longest overall sequence is
+     * chosen when multiple such configurations can match the input.
+     */
+    std::vector<const ATNConfig*> skippedStopStates;
+
+    // First figure out where we can reach on input t
+    const ATNConfigSet::ConfigList& elements = closureConfigs->elements();
+    for (ATNConfigSet::ConfigList::const_iterator it = elements.begin(); it != elements.end(); it++) {
+        const ATNConfig& c = *it;
+        const ATNState* state = atn->states[c.stateNumber];
+        if ( state->getStateType()==ATNState::RULE_STOP ) {
+            if (fullCtx || t == IntStream::EOF_) {
+                skippedStopStates.push_back(&c);
+            }
+
+            continue;
+        }
+
+        antlr_int32_t n = state->getNumberOfTransitions();
+        for (antlr_int32_t ti=0; ti<n; ti++) { // for each transition
+            const Transition* trans = state->transition(ti);
+            const ATNState* target = getReachableTarget(trans, t);
+            if ( target!=NULL ) {
+                intermediate->add(ATNConfig(&c, target), &mergeCache);
+            }
+        }
+    }
+
+    // Now figure out where the reach operation can take us...
+
+    antlr_auto_ptr<ATNConfigSet> reach;
+
+    /* This block optimizes the reach operation for intermediate sets which
+     * trivially indicate a termination state for the overall
+     * adaptivePredict operation.
+     *
+     * The conditions assume that intermediate
+     * contains all configurations relevant to the reach set, but this
+     * condition is not true when one or more configurations have been
+     * withheld in skippedStopStates.
+     */
+    if (skippedStopStates.empty()) {
+        if ( intermediate->size()==1 ) {
+            // Don't pursue the closure if there is just one state.
+            // It can only have one alternative; just add to result
+            // Also don't pursue the closure if there is unique alternative
+            // among the configurations.
+            reach.reset(intermediate.release());
+        }
+        else if ( getUniqueAlt(intermediate.get())!=ATN::INVALID_ALT_NUMBER ) {
+            // Also don't pursue the closure if there is unique alternative
+            // among the configurations.
+            reach.reset(intermediate.release());
+        }
+    }
+
+    /* If the reach set could not be trivially determined, perform a closure
+     * operation on the intermediate set to compute its initial value.
+     */
+    if (reach.get() == NULL) {
+        reach.reset(new ATNConfigSet(fullCtx, &transientContexts, &predictionArena));
+        closureBusy.reset();
+        const ATNConfigSet::ConfigList& intermediateElements = intermediate->elements();
+        for (ATNConfigSet::ConfigList::const_iterator it = intermediateElements.begin();
+                it != intermediateElements.end(); it++) {
+            closure(*it, reach.get(), closureBusy, false, fullCtx);
+        }
+    }
+
+    if (t == IntStream::EOF_) {
+        /* After consuming EOF no additional input is possible, so we are
+         * only interested in configurations which reached the end of the
+         * decision rule (local context) or end of the start rule (full
+         * context). Update reach to contain only these configurations. This
+         * handles both explicit EOF transitions in the grammar and implicit
+         * EOF transitions following the end of the decision or start rule.
+         *
+         * This is handled before the configurations in skippedStopStates,
+         * because any configurations potentially added from that list are
+         * already guaranteed to meet this condition whether or not it's
+         * required.
+         */
+        reach.reset(removeAllConfigsNotInRuleStopState(reach).release());
+    }
+
+    /* If skippedStopStates is not null, then it contains at least one
+     * configuration. For full-context reach operations, these
+     * configurations reached the end of the start rule, in which case we
+     * only add them back to reach if no configuration during the current
+     * closure operation reached such a state. This ensures adaptivePredict
+     * chooses an alternative matching the longest overall sequence when
+     * multiple alternatives are viable.
+     */
+    if (!skippedStopStates.empty() && (!fullCtx || !PredictionMode::hasConfigInRuleStopState(atn, reach.get()))) {
+        for (std::vector<const ATNConfig*>::const_iterator it = skippedStopStates.begin();
+                it != skippedStopStates.end(); it++) {
+            reach->add(**it, &mergeCache);
+        }
+    }
+
+    if ( reach->isEmpty() ) {
+        reach.reset();
+    }
+    return reach;
+}
+
+ANTLR_NOTNULL
+antlr_auto_ptr<ATNConfigSet> ParserATNSimulator::removeAllConfigsNotInRuleStopState(ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& configs)
+{
+    if (PredictionMode::allConfigsInRuleStopStates(atn, configs.get())) {
+        return antlr_auto_ptr<ATNConfigSet>(configs.release());
+    }
+
+    antlr_auto_ptr<ATNConfigSet> result(new ATNConfigSet(configs->fullCtx, &transientContexts, &predictionArena));
+    const ATNConfigSet::ConfigList& elements = configs->elements();
+    for (ATNConfigSet::ConfigList::const_iterator it = elements.begin(); it != elements.end(); it++) {
+        if (atn->states[it->stateNumber]->getStateType()==ATNState::RULE_STOP) {
+            result->add(*it, &mergeCache);
+        }
+    }
+
+    return result;
+}
+
+ANTLR_NOTNULL
+antlr_auto_ptr<ATNConfigSet> ParserATNSimulator::computeStartState(ANTLR_NOTNULL const ATNState* p,
+                                                                   ANTLR_NULLABLE RuleContext* ctx,
+                                                                   bool fullCtx)
+{
+    // always at least the implicit call to start rule
+    const PredictionContext* initialContext = PredictionContext::fromRuleContext(atn, ctx, &transientContexts);
+    antlr_auto_ptr<ATNConfigSet> configs(new ATNConfigSet(fullCtx, &transientContexts, &predictionArena));
+
+    for (antlr_int32_t i=0; i<p->getNumberOfTransitions(); i++) {
+        const ATNState* target = p->transition(i)->target;
+        ATNConfig c(target, i+1, initialContext);
+        closureBusy.reset();
+        closure(c, configs.get(), closureBusy, true, fullCtx);
+    }
+
+    return configs;
+}
+
+ANTLR_NULLABLE
+const ATNState* ParserATNSimulator::getReachableTarget(ANTLR_NOTNULL const Transition* trans, antlr_int32_t ttype) const
+{
+    if (trans->matches(ttype, 0, atn->maxTokenType)) {
+        return trans->target;
+    }
+
+    return NULL;
+}
+
+ANTLR_NULLABLE
+antlr_auto_ptr< std::vector<const SemanticContext*> > ParserATNSimulator::getPredsForAmbigAlts(const BitSet& ambigAlts,
+                                                                                               ANTLR_NOTNULL const ATNConfigSet* configs,
+                                                                                               antlr_int32_t nalts)
+{
+    // REACH=[1|1|[]|0:0, 1|2|[]|0:1]
+    /* altToPred starts as an array of all null contexts. The entry at index i
+     * corresponds to alternative i. altToPred[i] may have one of three values:
+     *   1. null: no ATNConfig c is found such that c.alt==i
+     *   2. SemanticContext.NONE: At least one ATNConfig c exists such that
+     *      c.alt==i and c.semanticContext==SemanticContext.NONE. In other words,
+     *      alt i has at least one unpredicated config.
+     *   3. Non-NONE Semantic Context: There exists at least one, and for all
+     *      ATNConfig c such that c.alt==i, c.semanticContext!=SemanticContext.NONE.
+     *
+     * From this, it is clear that NONE||anything==NONE.
+     */
+    antlr_auto_ptr< std::vector<const SemanticContext*> > altToPred(
+        new std::vector<const SemanticContext*>(nalts + 1, static_cast<const SemanticContext*>(NULL)));
+    const ATNConfigSet::ConfigList& elements = configs->elements();
+    for (ATNConfigSet::ConfigList::const_iterator it = elements.begin(); it != elements.end(); it++) {
+        if ( ambigAlts.get(it->alt) ) {
+            (*altToPred)[it->alt] = SemanticContext::or_((*altToPred)[it->alt],
+                                                        _dfa->semanticContexts.get(it->semanticContextIndex),
+                                                        _dfa->semanticContexts);
+        }
+    }
+
+    antlr_int32_t nPredAlts = 0;
+    for (antlr_int32_t i = 1; i <= nalts; i++) {
+        if ((*altToPred)[i] == NULL) {
+            (*altToPred)[i] = &SemanticContext::NONE;
+        }
+        else if ((*altToPred)[i] != &SemanticContext::NONE) {
+            nPredAlts++;
+        }
+    }
+
+    // nonambig alts are null in altToPred
+    if ( nPredAlts==0 ) {
+        altToPred.reset();
+    }
+    return altToPred;
+}
+
+bool ParserATNSimulator::getPredicatePredictions(const BitSet& ambigAlts,
+                                                 const std::vector<const SemanticContext*>& altToPred,
+                                                 ANTLR_NOTNULL DFAState* dfaState) const
+{
+    std::vector<const DFAState::PredPrediction*> pairs;
+    bool containsPredicate = false;
+    for (size_t i = 1; i < altToPred.size(); i++) {
+        const SemanticContext* pred = altToPred[i];
+
+        // unpredicated is indicated by SemanticContext.NONE
+        if ( ambigAlts.get(static_cast<antlr_int32_t>(i)) ) {
+            pairs.push_back(new DFAState::PredPrediction(pred, static_cast<antlr_int32_t>(i)));
+        }
+        if ( pred!=&SemanticContext::NONE ) containsPredicate = true;
+    }
+
+    if ( !containsPredicate ) {
+        for (size_t i = 0; i < pairs.size(); i++) {
+            delete pairs[i];
+        }
+        return false;
+    }
+
+    dfaState->numPredicates = static_cast<antlr_uint32_t>(pairs.size());
+    dfaState->predicates = new const DFAState::PredPrediction*[pairs.size()];
+    std::copy(pairs.begin(), pairs.end(), dfaState->predicates);
+    return true;
+}
+
+BitSet ParserATNSimulator::evalSemanticContext(ANTLR_NOTNULL const DFAState* dfaState,
+                                               ANTLR_NULLABLE ParserRuleContext* outerContext,
+                                               bool complete)
+{
+    BitSet predictions;
+    for (antlr_uint32_t i = 0; i < dfaState->numPredicates; i++) {
+        const DFAState::PredPrediction* pair = dfaState->predicates[i];
+        if ( pair->pred==&SemanticContext::NONE ) {
+            predictions.set(pair->alt);
+            if (!complete) {
+                break;
+            }
+            continue;
+        }
+
+        bool predicateEvaluationResult = pair->pred->eval(parser, outerContext);
+        if ( predicateEvaluationResult ) {
+            predictions.set(pair->alt);
+            if (!complete) {
+                break;
+            }
+        }
+    }
+
+    return predictions;
+}
+
+BitSet ParserATNSimulator::evalSemanticContext(const FrozenDFA& frozen, antlr_int32_t state,
+                                               ANTLR_NULLABLE ParserRuleContext* outerContext,
+                                               bool complete)
+{
+    BitSet predictions;
+    for (antlr_uint32_t i = 0; i < frozen.getNumPredicates(state); i++) {
+        const DFAState::PredPrediction& pair = frozen.getPredicate(state, i);
+        if ( pair.pred==&SemanticContext::NONE || pair.pred->eval(parser, outerContext) ) {
+            predictions.set(pair.alt);
+            if (!complete) {
+                break;
+            }
+        }
+    }
+
+    return predictions;
+}
+
+void ParserATNSimulator::closure(const ATNConfig& config,
+                                 ANTLR_NOTNULL ATNConfigSet* configs,
+                                 ClosureBusySet& closureBusy,
+                                 bool collectPredicates,
+                                 bool fullCtx)
+{
+    const antlr_int32_t initialDepth = 0;
+    const size_t base = closureStack.size();
+    closureCheckingStopState(config, configs, collectPredicates,
+                             fullCtx,
+                             initialDepth);
+
+    // Visit the successors depth first, in the order the recursive
+    // formulation would, so configs are added in the same order.
+    ATNConfig c;
+    while (closureStack.size() > base) {
+        ClosureFrame& frame = closureStack.back();
+        const ATNConfig top = frame.config;
+        const ATNState* p = atn->states[top.stateNumber];
+        const antlr_int32_t i = frame.next++;
+        const antlr_int32_t depth = frame.depth;
+        const bool collecting = frame.collectPredicates;
+
+        if ( frame.returns ) {
+            if ( i>=top.context->size() ) {
+                closureStack.pop_back();
+                continue;
+            }
+            if ( top.context->getReturnState(i)==PredictionContext::EMPTY_RETURN_STATE ) {
+                if (fullCtx) {
+                    configs->add(ATNConfig(&top, p, PredictionContext::EMPTY), &mergeCache);
+                }
+                else {
+                    // we have no context info, just chase follow links (if greedy)
+                    closure_(top, configs, collecting, depth);
+                }
+                continue;
+            }
+            const ATNState* returnState = atn->states[top.context->getReturnState(i)];
+            const PredictionContext* newContext = top.context->getParent(i); // "pop" return state
+            c = ATNConfig(returnState, top.alt, newContext,
+                          top.semanticContextIndex);
+            // While we have context to pop back from, we may have
+            // gotten that context AFTER having falling off a rule.
+            // Make sure we track that we are now out of context.
+            c.reachesIntoOuterContext = top.reachesIntoOuterContext;
+            closureCheckingStopState(c, configs, collecting,
+                                     fullCtx, depth - 1);
+            continue;
+        }
+
+        if ( i>=p->getNumberOfTransitions() ) {
+            closureStack.pop_back();
+            continue;
+        }
+        const Transition* t = p->transition(i);
+        bool continueCollecting =
+            t->getSerializationType()!=Transition::ACTION && collecting;
+        if ( getEpsilonTarget(top, t, continueCollecting, depth == 0, fullCtx, c) ) {
+            antlr_int32_t newDepth = depth;
+            if ( p->getStateType()==ATNState::RULE_STOP ) {
+                // target fell off end of rule; mark resulting c as having dipped into outer context
+                // We can't get here if incoming config was rule stop and we had context
+                // track how far we dip into outer context.  Might
+                // come in handy and we avoid evaluating context dependent
+                // preds if this is > 0.
+                if (!closureBusy.add(c)) {
+                    // avoid infinite recursion for right-recursive rules
+                    continue;
+                }
+
+                c.reachesIntoOuterContext = true;
+                configs->dipsIntoOuterContext = true; // TODO: can remove? only care when we add to set per middle of this method
+                newDepth--;
+            }
+            else if (t->getSerializationType()==Transition::RULE) {
+                // latch when newDepth goes negative - once we step out of the entry context we can't return
+                if (newDepth >= 0) {
+                    newDepth++;
+                }
+            }
+
+            closureCheckingStopState(c, configs, continueCollecting, fullCtx, newDepth);
+        }
+    }
+}
+
+void ParserATNSimulator::closureCheckingStopState(const ATNConfig& config,
+                                                  ANTLR_NOTNULL ATNConfigSet* configs,
+                                                  bool collectPredicates,
+                                                  bool fullCtx,
+                                                  antlr_int32_t depth)
+{
+    if ( atn->states[config.stateNumber]->getStateType()==ATNState::RULE_STOP ) {
+        // We hit rule end. If we have context info, use it
+        // run thru all possible stack tops in ctx
+        if ( !config.context->isEmpty() ) {
+            ClosureFrame frame = { config, 0, depth, collectPredicates, true };
+            closureStack.push_back(frame);
+            return;
+        }
+        else if (fullCtx) {
+            // reached end of start rule
+            configs->add(config, &mergeCache);
+            return;
+        }
+        else {
+            // else if we have no context info, just chase follow links (if greedy)
+        }
+    }
+
+    closure_(config, configs, collectPredicates, depth);
+}
+
+void ParserATNSimulator::closure_(const ATNConfig& config,
+                                  ANTLR_NOTNULL ATNConfigSet* configs,
+                                  bool collectPredicates,
+                                  antlr_int32_t depth)
+{
+    const ATNState* p = atn->states[config.stateNumber];
+    // optimization
+    if ( !p->onlyHasEpsilonTransitions() ) {
+        configs->add(config, &mergeCache);
+        // make sure to not return here, because EOF transitions can act as
+        // both epsilon transitions and non-epsilon transitions.
+    }
+
+    if ( p->getNumberOfTransitions()>0 ) {
+        ClosureFrame frame = { config, 0, depth, collectPredicates, false };
+        closureStack.push_back(frame);
+    }
+}
+
+bool ParserATNSimulator::getEpsilonTarget(const ATNConfig& config,
+                                          ANTLR_NOTNULL const Transition* t,
+                                          bool collectPredicates,
+                                          bool inContext,
+                                          bool fullCtx,
+                                          ATNConfig& c)
+{
+    switch (t->getSerializationType()) {
+    case Transition::RULE:
+        ruleTransition(config, static_cast<const RuleTransition*>(t), c);
+        return true;
+
+    case Transition::PREDICATE:
+        return predTransition(config, static_cast<const PredicateTransition*>(t),
+                              collectPredicates,
+                              inContext,
+                              fullCtx,
+                              c);
+
+    case Transition::ACTION:
+        actionTransition(config, static_cast<const ActionTransition*>(t), c);
+        return true;
+
+    case Transition::EPSILON:
+        c = ATNConfig(&config, t->target);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void ParserATNSimulator::actionTransition(const ATNConfig& config, ANTLR_NOTNULL const ActionTransition* t, ATNConfig& c) const
+{
+    c = ATNConfig(&config, t->target);
+}
+
+bool ParserATNSimulator::predTransition(const ATNConfig& config,
+                                        ANTLR_NOTNULL const PredicateTransition* pt,
+                                        bool collectPredicates,
+                                        bool inContext,
+                                        bool fullCtx,
+                                        ATNConfig& c)
+{
+    if ( collectPredicates &&
+         (!pt->isCtxDependent || (pt->isCtxDependent&&inContext)) )
+    {
+        if ( fullCtx ) {
+            // In full context mode, we can evaluate predicates on-the-fly
+            // during closure, which dramatically reduces the size of
+            // the config sets. It also obviates the need to test predicates
+            // later during conflict resolution.
+            antlr_int32_t currentPosition = _input->index();
+            _input->seek(_startIndex);
+            bool predSucceeds = pt->getPredicate()->eval(parser, _outerContext);
+            _input->seek(currentPosition);
+            if ( predSucceeds ) {
+                c = ATNConfig(&config, pt->target); // no pred context
+                return true;
+            }
+            return false;
+        }
+        else {
+            SemanticContextCache& semanticContexts = _dfa->semanticContexts;
+            const SemanticContext* newSemCtx =
+                SemanticContext::and_(semanticContexts.get(config.semanticContextIndex), pt->getPredicate(),
+                                      semanticContexts);
+            c = ATNConfig(&config, pt->target, semanticContexts.getIndex(newSemCtx));
+            return true;
+        }
+    }
+
+    c = ATNConfig(&config, pt->target);
+    return true;
+}
+
+void ParserATNSimulator::ruleTransition(const ATNConfig& config, ANTLR_NOTNULL const RuleTransition* t, ATNConfig& c)
+{
+    const ATNState* returnState = t->followState;
+    const PredictionContext* newContext = transientContexts.add(
+        SingletonPredictionContext::create(config.context, returnState->stateNumber));
+    c = ATNConfig(&config, t->target, newContext);
+}
+
+BitSet ParserATNSimulator::getConflictingAlts(ANTLR_NOTNULL const ATNConfigSet* configs) const
+{
+    // every config is in some (s, x) subset, so their union is all alts
+    return configs->getAlts();
+}
+
+BitSet ParserATNSimulator::getConflictingAltsOrUniqueAlt(ANTLR_NOTNULL const ATNConfigSet* configs) const
+{
+    BitSet conflictingAlts;
+    if ( configs->uniqueAlt!=ATN::INVALID_ALT_NUMBER ) {
+        conflictingAlts.set(configs->uniqueAlt);
+    }
+    else if ( configs->conflictingAlts.get()!=NULL ) {
+        conflictingAlts = *configs->conflictingAlts;
+    }
+    return conflictingAlts;
+}
+
+NoViableAltException ParserATNSimulator::noViableAlt(ANTLR_NOTNULL TokenStream* input,
+                                                     ANTLR_NULLABLE ParserRuleContext* outerContext,
+                                                     ANTLR_NULLABLE const ATNConfigSet* configs,
+                                                     antlr_int32_t startIndex) const
+{
+    return NoViableAltException(parser, input,
+                                input->get(startIndex),
+                                input->LT(1),
+                                configs, outerContext);
+}
+
+antlr_int32_t ParserATNSimulator::getUniqueAlt(ANTLR_NOTNULL const ATNConfigSet* configs)
+{
+    return configs->getUniqueAlt();
+}
+
+ANTLR_NOTNULL
+const DFAState* ParserATNSimulator::addDFAEdge(ANTLR_NOTNULL DFA* dfa,
+                                               ANTLR_NULLABLE const DFAState* from,
+                                               antlr_int32_t t,
+                                               ANTLR_NOTNULL DFAState* to)
+{
+    MutexLock guard(&dfa->lock);
+    const DFAState* target = addDFAState(dfa, to); // used existing if possible not incoming
+    if (from == NULL || t < -1 || t > atn->maxTokenType) {
+        return target;
+    }
+
+    // the edges are the only part of a DFA state that changes once the
+    // state has been added to the DFA
+    DFAState* source = const_cast<DFAState*>(from);
+    source->setEdge(t+1, static_cast<antlr_uint32_t>(atn->maxTokenType + 1 + 1), target); // connect
+
+    return target;
+}
+
+ANTLR_NOTNULL
+const DFAState* ParserATNSimulator::addDFAState(ANTLR_NOTNULL DFA* dfa, ANTLR_NOTNULL DFAState* D)
+{
+    if (D == ERROR) {
+        return D;
+    }
+
+    DFAState* const* existing = dfa->states->get(KeyPtr<DFAState>(D, false));
+    if ( existing!=NULL ) {
+        return *existing;
+    }
+
+    if (!D->configs->isReadonly()) {
+        D->configs->optimizeConfigs(*this);
+        D->configs->setReadonly(true);
+    }
+    return dfa->addState(*D);
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
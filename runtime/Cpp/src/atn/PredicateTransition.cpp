@@ -45,32 +45,17 @@ PredicateTransition::PredicateTransition(ANTLR_NOTNULL const ATNState* target,
                                          antlr_int32_t ruleIndex,
                                          antlr_int32_t predIndex,
                                          bool isCtxDependent)
-    :   Transition(target),
+    :   Transition(target, PREDICATE),
         ruleIndex(ruleIndex),
         predIndex(predIndex),
-        isCtxDependent(isCtxDependent)
+        isCtxDependent(isCtxDependent),
+        predicate(ruleIndex, predIndex, isCtxDependent)
 {
 }
 
-antlr_int32_t PredicateTransition::getSerializationType() const
+const SemanticContext::Predicate* PredicateTransition::getPredicate() const
 {
-    return PREDICATE;
-}
-
-bool PredicateTransition::isEpsilon() const
-{
-    return true;
-}
-
-bool PredicateTransition::matches(antlr_int32_t, antlr_int32_t, antlr_int32_t) const
-{
-    return false;
-}
-
-antlr_auto_ptr<SemanticContext::Predicate> PredicateTransition::getPredicate() const
-{
-    return antlr_auto_ptr<SemanticContext::Predicate>(
-        new SemanticContext::Predicate(ruleIndex, predIndex, isCtxDependent));
+    return &predicate;
 }
 
 std::string PredicateTransition::toString() const
@@ -33,11 +33,381 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/PredictionContext.h>
+#include <antlr/RuleContext.h>
+#include <antlr/atn/ArrayPredictionContext.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ATNState.h>
+#include <antlr/atn/EmptyPredictionContext.h>
+#include <antlr/atn/MergeCache.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/atn/RuleTransition.h>
+#include <antlr/atn/SingletonPredictionContext.h>
+#include <antlr/misc/MurmurHash.h>
+#include <stdexcept>
 
 namespace antlr4 {
 namespace atn {
 
 
+const antlr_int32_t PredictionContext::EMPTY_RETURN_STATE = ANTLR_INT32_MAX;
+
+const antlr_int32_t PredictionContext::INITIAL_HASH = 1;
+
+PredictionContext::PredictionContext(antlr_int32_t cachedHashCode)
+    :   cachedHashCode(cachedHashCode),
+        owner(NULL)
+{
+}
+
+PredictionContext::~PredictionContext()
+{
+}
+
+/** This means only the {@link #EMPTY} context is in set. */
+bool PredictionContext::isEmpty() const
+{
+    return this == EMPTY;
+}
+
+bool PredictionContext::hasEmptyPath() const
+{
+    return getReturnState(size() - 1) == EMPTY_RETURN_STATE;
+}
+
+bool PredictionContext::isInternedWith(ANTLR_NOTNULL const PredictionContext* other) const
+{
+    return owner!=NULL && owner==other->owner;
+}
+
+antlr_int32_t PredictionContext::hashCode() const
+{
+    return cachedHashCode;
+}
+
+PredictionContext* PredictionContext::clone() const
+{
+    throw std::logic_error("PredictionContext::clone not supported");
+}
+
+antlr_int32_t PredictionContext::calculateEmptyHashCode()
+{
+    antlr_int32_t hash = MurmurHash::initialize(INITIAL_HASH);
+    hash = MurmurHash::finish(hash, 0);
+    return hash;
+}
+
+antlr_int32_t PredictionContext::calculateHashCode(ANTLR_NOTNULL const PredictionContext* parent, antlr_int32_t returnState)
+{
+    antlr_int32_t hash = MurmurHash::initialize(INITIAL_HASH);
+    hash = MurmurHash::update(hash, parent);
+    hash = MurmurHash::update(hash, returnState);
+    hash = MurmurHash::finish(hash, 2);
+    return hash;
+}
+
+antlr_int32_t PredictionContext::calculateHashCode(const std::vector<const PredictionContext*>& parents,
+                                                   const std::vector<antlr_int32_t>& returnStates)
+{
+    antlr_int32_t hash = MurmurHash::initialize(INITIAL_HASH);
+    for (size_t i = 0; i < parents.size(); i++) {
+        hash = MurmurHash::update(hash, parents[i]);
+    }
+    for (size_t i = 0; i < returnStates.size(); i++) {
+        hash = MurmurHash::update(hash, returnStates[i]);
+    }
+    hash = MurmurHash::finish(hash, static_cast<antlr_int32_t>(2 * parents.size()));
+    return hash;
+}
+
+static const PredictionContext* mergeCacheGet(MergeCache* mergeCache,
+                                              const PredictionContext* a, const PredictionContext* b,
+                                              bool rootIsWildcard)
+{
+    return mergeCache!=NULL ? mergeCache->get(a, b, rootIsWildcard) : NULL;
+}
+
+static const PredictionContext* mergeCachePut(MergeCache* mergeCache,
+                                              const PredictionContext* a, const PredictionContext* b,
+                                              bool rootIsWildcard, const PredictionContext* result)
+{
+    if ( mergeCache!=NULL ) mergeCache->put(a, b, rootIsWildcard, result);
+    return result;
+}
+
+/** Hands a context created by a merge over to {@code contextCache}. */
+static const PredictionContext* addToCache(PredictionContextCache* contextCache, const PredictionContext* ctx)
+{
+    if ( contextCache==NULL ) {
+        if ( ctx!=PredictionContext::EMPTY ) delete ctx;
+        throw std::logic_error("PredictionContext::merge requires a context cache to own new contexts");
+    }
+    return contextCache->add(ctx);
+}
+
+const PredictionContext* PredictionContext::fromRuleContext(ANTLR_NOTNULL const ATN* atn,
+                                                            ANTLR_NULLABLE const RuleContext* outerContext,
+                                                            ANTLR_NOTNULL PredictionContextCache* contextCache)
+{
+    // if we are in RuleContext of start rule, s, then PredictionContext
+    // is EMPTY. Nobody called us. (if we are empty, return empty)
+    if ( outerContext==NULL || outerContext->parent==NULL || outerContext->isEmpty() ) {
+        return EMPTY;
+    }
+
+    // If we have a parent, convert it to a PredictionContext graph
+    const PredictionContext* parent = fromRuleContext(atn, outerContext->parent, contextCache);
+
+    const ATNState* state = atn->states[outerContext->invokingState];
+    const RuleTransition* transition = static_cast<const RuleTransition*>(state->transition(0));
+    return contextCache->add(SingletonPredictionContext::create(parent, transition->followState->stateNumber));
+}
+
+const PredictionContext* PredictionContext::merge(
+    ANTLR_NOTNULL const PredictionContext* a, ANTLR_NOTNULL const PredictionContext* b,
+    bool rootIsWildcard,
+    ANTLR_NULLABLE MergeCache* mergeCache,
+    ANTLR_NOTNULL PredictionContextCache* contextCache)
+{
+    // share same graph if both same
+    if ( a==b || a->equals(b) ) return a;
+
+    const SingletonPredictionContext* sa = dynamic_cast<const SingletonPredictionContext*>(a);
+    const SingletonPredictionContext* sb = dynamic_cast<const SingletonPredictionContext*>(b);
+    if ( sa!=NULL && sb!=NULL ) {
+        return mergeSingletons(sa, sb, rootIsWildcard, mergeCache, contextCache);
+    }
+
+    // At least one of a or b is array
+    // If one is $ and rootIsWildcard, return $ as * wildcard
+    if ( rootIsWildcard ) {
+        if ( a==EMPTY ) return a;
+        if ( b==EMPTY ) return b;
+    }
+
+    // convert singleton so both are arrays to normalize
+    const ArrayPredictionContext* aa = sa!=NULL
+        ? static_cast<const ArrayPredictionContext*>(addToCache(contextCache, new ArrayPredictionContext(sa)))
+        : static_cast<const ArrayPredictionContext*>(a);
+    const ArrayPredictionContext* ab = sb!=NULL
+        ? static_cast<const ArrayPredictionContext*>(addToCache(contextCache, new ArrayPredictionContext(sb)))
+        : static_cast<const ArrayPredictionContext*>(b);
+    return mergeArrays(aa, ab, rootIsWildcard, mergeCache, contextCache);
+}
+
+const PredictionContext* PredictionContext::mergeSingletons(
+    ANTLR_NOTNULL const SingletonPredictionContext* a, ANTLR_NOTNULL const SingletonPredictionContext* b,
+    bool rootIsWildcard,
+    ANTLR_NULLABLE MergeCache* mergeCache,
+    ANTLR_NOTNULL PredictionContextCache* contextCache)
+{
+    const PredictionContext* previous = mergeCacheGet(mergeCache, a, b, rootIsWildcard);
+    if ( previous!=NULL ) return previous;
+
+    const PredictionContext* rootMerge = mergeRoot(a, b, rootIsWildcard, contextCache);
+    if ( rootMerge!=NULL ) {
+        return mergeCachePut(mergeCache, a, b, rootIsWildcard, rootMerge);
+    }
+
+    if ( a->returnState==b->returnState ) { // a == b
+        const PredictionContext* parent = merge(a->parent, b->parent, rootIsWildcard, mergeCache, contextCache);
+        // if parent is same as existing a or b parent or reduced to a parent, return it
+        if ( parent==a->parent ) return a; // ax + bx = ax, if a=b
+        if ( parent==b->parent ) return b; // ax + bx = bx, if a=b
+        // else: ax + ay = a'[x,y]
+        // merge parents x and y, giving array node with x,y then remainders
+        // of those graphs.  dup a, a' points at merged array
+        // new joined parent so create new singleton pointing to it, a'
+        const PredictionContext* a_ = addToCache(contextCache, SingletonPredictionContext::create(parent, a->returnState));
+        return mergeCachePut(mergeCache, a, b, rootIsWildcard, a_);
+    }
+
+    // a != b payloads differ
+    // see if we can collapse parents due to $+x parents if local ctx
+    const PredictionContext* singleParent = NULL;
+    if ( a->parent!=NULL && a->parent->equals(b->parent) ) { // ax + bx = [a,b]x
+        singleParent = a->parent;
+    }
+
+    std::vector<const PredictionContext*> parents(2);
+    std::vector<antlr_int32_t> payloads(2);
+    // sort by payload
+    bool swap = a->returnState > b->returnState;
+    payloads[0] = swap ? b->returnState : a->returnState;
+    payloads[1] = swap ? a->returnState : b->returnState;
+    if ( singleParent!=NULL ) { // parents are same
+        parents[0] = singleParent;
+        parents[1] = singleParent;
+    }
+    else {
+        // parents differ and can't merge them. Just pack together
+        // into array; can't merge.
+        // ax + by = [ax,by]
+        parents[0] = swap ? b->parent : a->parent;
+        parents[1] = swap ? a->parent : b->parent;
+    }
+    const PredictionContext* a_ = addToCache(contextCache, new ArrayPredictionContext(parents, payloads));
+    return mergeCachePut(mergeCache, a, b, rootIsWildcard, a_);
+}
+
+const PredictionContext* PredictionContext::mergeRoot(
+    ANTLR_NOTNULL const SingletonPredictionContext* a, ANTLR_NOTNULL const SingletonPredictionContext* b,
+    bool rootIsWildcard,
+    ANTLR_NOTNULL PredictionContextCache* contextCache)
+{
+    if ( rootIsWildcard ) {
+        if ( a==EMPTY ) return EMPTY;  // * + b = *
+        if ( b==EMPTY ) return EMPTY;  // a + * = *
+    }
+    else {
+        if ( a==EMPTY && b==EMPTY ) return EMPTY; // $ + $ = $
+        const SingletonPredictionContext* other = NULL;
+        if ( a==EMPTY ) other = b;      // $ + x = [$,x]
+        else if ( b==EMPTY ) other = a; // x + $ = [$,x] ($ is always first if present)
+        if ( other!=NULL ) {
+            std::vector<const PredictionContext*> parents(2);
+            std::vector<antlr_int32_t> payloads(2);
+            parents[0] = other->parent;
+            parents[1] = NULL;
+            payloads[0] = other->returnState;
+            payloads[1] = EMPTY_RETURN_STATE;
+            return addToCache(contextCache, new ArrayPredictionContext(parents, payloads));
+        }
+    }
+    return NULL;
+}
+
+const PredictionContext* PredictionContext::mergeArrays(
+    ANTLR_NOTNULL const ArrayPredictionContext* a, ANTLR_NOTNULL const ArrayPredictionContext* b,
+    bool rootIsWildcard,
+    ANTLR_NULLABLE MergeCache* mergeCache,
+    ANTLR_NOTNULL PredictionContextCache* contextCache)
+{
+    const PredictionContext* previous = mergeCacheGet(mergeCache, a, b, rootIsWildcard);
+    if ( previous!=NULL ) return previous;
+
+    // merge sorted payloads a + b => M
+    size_t i = 0; // walks a
+    size_t j = 0; // walks b
+
+    std::vector<antlr_int32_t> mergedReturnStates;
+    std::vector<const PredictionContext*> mergedParents;
+    mergedReturnStates.reserve(a->returnStates.size() + b->returnStates.size());
+    mergedParents.reserve(a->returnStates.size() + b->returnStates.size());
+    // walk and merge to yield mergedParents, mergedReturnStates
+    while ( i<a->returnStates.size() && j<b->returnStates.size() ) {
+        const PredictionContext* a_parent = a->parents[i];
+        const PredictionContext* b_parent = b->parents[j];
+        if ( a->returnStates[i]==b->returnStates[j] ) {
+            // same payload (stack tops are equal), must yield merged singleton
+            antlr_int32_t payload = a->returnStates[i];
+            // $+$ = $
+            bool both$ = payload==EMPTY_RETURN_STATE && a_parent==NULL && b_parent==NULL;
+            bool ax_ax = (a_parent!=NULL && b_parent!=NULL) && a_parent->equals(b_parent); // ax+ax -> ax
+            if ( both$ || ax_ax ) {
+                mergedParents.push_back(a_parent); // choose left
+            }
+            else { // ax+ay -> a'[x,y]
+                mergedParents.push_back(merge(a_parent, b_parent, rootIsWildcard, mergeCache, contextCache));
+            }
+            mergedReturnStates.push_back(payload);
+            i++; // hop over left one as usual
+            j++; // but also skip one in right side since we merge
+        }
+        else if ( a->returnStates[i]<b->returnStates[j] ) { // copy a[i] to M
+            mergedParents.push_back(a_parent);
+            mergedReturnStates.push_back(a->returnStates[i]);
+            i++;
+        }
+        else { // b > a, copy b[j] to M
+            mergedParents.push_back(b_parent);
+            mergedReturnStates.push_back(b->returnStates[j]);
+            j++;
+        }
+    }
+
+    // copy over any payloads remaining in either array
+    for (; i<a->returnStates.size(); i++) {
+        mergedParents.push_back(a->parents[i]);
+        mergedReturnStates.push_back(a->returnStates[i]);
+    }
+    for (; j<b->returnStates.size(); j++) {
+        mergedParents.push_back(b->parents[j]);
+        mergedReturnStates.push_back(b->returnStates[j]);
+    }
+
+    // for just one merged element, return singleton top
+    if ( mergedParents.size()==1 ) {
+        const PredictionContext* a_ = addToCache(contextCache,
+            SingletonPredictionContext::create(mergedParents[0], mergedReturnStates[0]));
+        return mergeCachePut(mergeCache, a, b, rootIsWildcard, a_);
+    }
+
+    // make sure we use the same parent object wherever parents are equal
+    for (size_t p = 1; p < mergedParents.size(); p++) {
+        for (size_t q = 0; q < p; q++) {
+            if ( mergedParents[p]!=NULL && mergedParents[p]->equals(mergedParents[q]) ) {
+                mergedParents[p] = mergedParents[q];
+                break;
+            }
+        }
+    }
+
+    antlr_auto_ptr<ArrayPredictionContext> M(new ArrayPredictionContext(mergedParents, mergedReturnStates));
+
+    // if we created same array as a or b, return that instead
+    // TODO: track whether this is possible above during merge sort for speed
+    if ( M->equals(a) ) {
+        return mergeCachePut(mergeCache, a, b, rootIsWildcard, a);
+    }
+    if ( M->equals(b) ) {
+        return mergeCachePut(mergeCache, a, b, rootIsWildcard, b);
+    }
+
+    return mergeCachePut(mergeCache, a, b, rootIsWildcard, addToCache(contextCache, M.release()));
+}
+
+const PredictionContext* PredictionContext::getCachedContext(
+    ANTLR_NOTNULL const PredictionContext* context,
+    ANTLR_NOTNULL PredictionContextCache* contextCache,
+    HashMap<const PredictionContext*, const PredictionContext*>& visited)
+{
+    if ( context->isEmpty() ) {
+        return context;
+    }
+
+    const PredictionContext* const* existing = visited.get(context);
+    if ( existing!=NULL ) {
+        return *existing;
+    }
+
+    const PredictionContext* cached = contextCache->get(context);
+    if ( cached!=NULL ) {
+        visited.put(context, cached);
+        return cached;
+    }
+
+    std::vector<const PredictionContext*> parents(context->size());
+    std::vector<antlr_int32_t> returnStates(context->size());
+    for (antlr_int32_t i = 0; i < context->size(); i++) {
+        const PredictionContext* parent = context->getParent(i);
+        parents[i] = parent!=NULL ? getCachedContext(parent, contextCache, visited) : NULL;
+        returnStates[i] = context->getReturnState(i);
+    }
+
+    const PredictionContext* updated;
+    if ( dynamic_cast<const SingletonPredictionContext*>(context)!=NULL ) {
+        updated = SingletonPredictionContext::create(parents[0], returnStates[0]);
+    }
+    else {
+        updated = new ArrayPredictionContext(parents, returnStates);
+    }
+    updated = contextCache->add(updated);
+    visited.put(context, updated);
+    return updated;
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,11 +33,107 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/PredictionContextCache.h>
+#include <antlr/misc/MutexLock.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+const antlr_uint32_t PredictionContextCache::SHARD_BITS;
+
+const antlr_uint32_t PredictionContextCache::SHARD_COUNT;
+
+PredictionContextCache::PredictionContextCache()
+    :   sharedCache(NULL)
+{
+}
+
+PredictionContextCache::PredictionContextCache(ANTLR_NULLABLE const PredictionContextCache* sharedCache)
+    :   sharedCache(sharedCache)
+{
+}
+
+PredictionContextCache::~PredictionContextCache()
+{
+    clear();
+}
+
+PredictionContextCache::Shard& PredictionContextCache::shardFor(ANTLR_NOTNULL const PredictionContext* ctx) const
+{
+    return shards[static_cast<antlr_uint32_t>(ctx->hashCode()) >> (32 - SHARD_BITS)];
+}
+
+const PredictionContext* PredictionContextCache::add(ANTLR_NOTNULL const PredictionContext* ctx)
+{
+    if ( ctx==PredictionContext::EMPTY ) return PredictionContext::EMPTY;
+    if ( ctx->owner==this ) return ctx;
+    if ( sharedCache!=NULL ) {
+        const PredictionContext* shared = sharedCache->get(ctx);
+        if ( shared!=NULL ) {
+            delete ctx;
+            return shared;
+        }
+    }
+    Shard& shard = shardFor(ctx);
+    MutexLock guard(&shard.mutex);
+    KeyPtr<PredictionContext> key(const_cast<PredictionContext*>(ctx), false);
+    const PredictionContext* const* existing = shard.cache.get(key);
+    if ( existing!=NULL ) {
+        delete ctx;
+        return *existing;
+    }
+    const_cast<PredictionContext*>(ctx)->owner = this;
+    shard.cache.put(key, ctx);
+    return ctx;
+}
+
+ANTLR_NULLABLE
+const PredictionContext* PredictionContextCache::get(ANTLR_NOTNULL const PredictionContext* ctx) const
+{
+    if ( ctx->owner==this ) return ctx;
+    const PredictionContext* existing = getLocal(ctx);
+    if ( existing==NULL && sharedCache!=NULL ) existing = sharedCache->get(ctx);
+    return existing;
+}
+
+ANTLR_NULLABLE
+const PredictionContext* PredictionContextCache::getLocal(ANTLR_NOTNULL const PredictionContext* ctx) const
+{
+    Shard& shard = shardFor(ctx);
+    KeyPtr<PredictionContext> key(const_cast<PredictionContext*>(ctx), false);
+    MutexLock guard(&shard.mutex);
+    const PredictionContext* const* existing = shard.cache.get(key);
+    return existing!=NULL ? *existing : NULL;
+}
+
+bool PredictionContextCache::owns(ANTLR_NOTNULL const PredictionContext* ctx) const
+{
+    return ctx->owner==this;
+}
+
+antlr_int32_t PredictionContextCache::size() const
+{
+    size_t n = 0;
+    for (antlr_uint32_t i = 0; i < SHARD_COUNT; i++) {
+        MutexLock guard(&shards[i].mutex);
+        n += shards[i].cache.size();
+    }
+    return static_cast<antlr_int32_t>(n);
+}
+
+void PredictionContextCache::clear()
+{
+    for (antlr_uint32_t i = 0; i < SHARD_COUNT; i++) {
+        MutexLock guard(&shards[i].mutex);
+        for (ContextHashMap::iterator it = shards[i].cache.begin(); it != shards[i].cache.end(); it++) {
+            delete it->second;
+        }
+        shards[i].cache.clear();
+    }
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
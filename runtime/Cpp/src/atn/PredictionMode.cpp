@@ -34,10 +34,244 @@
  */
 
 #include <antlr/atn/PredictionMode.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ATNConfig.h>
+#include <antlr/atn/ATNConfigSet.h>
+#include <antlr/atn/ATNState.h>
+#include <antlr/atn/PredictionContext.h>
+#include <antlr/atn/SemanticContextCache.h>
+#include <antlr/misc/AbstractEqualityComparator.h>
+#include <antlr/misc/FlexibleHashMap.h>
+#include <antlr/misc/MurmurHash.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+/** Hashes configurations by {@code (s, x)}, ignoring alt and predicate. */
+class AltAndContextConfigEqualityComparator : public AbstractEqualityComparator<ATNConfig>
+{
+public:
+
+    ANTLR_OVERRIDE
+    antlr_int32_t hashCode(const ATNConfig& o) const
+    {
+        antlr_int32_t hashCode = MurmurHash::initialize(7);
+        hashCode = MurmurHash::update(hashCode, o.stateNumber);
+        hashCode = MurmurHash::update(hashCode, o.context);
+        hashCode = MurmurHash::finish(hashCode, 2);
+        return hashCode;
+    }
+
+    ANTLR_OVERRIDE
+    bool equals(const ATNConfig& a, const ATNConfig& b) const
+    {
+        if ( &a==&b ) return true;
+        return a.stateNumber==b.stateNumber
+            && (a.context==b.context || (a.context!=NULL && a.context->equals(b.context)));
+    }
+
+public:
+
+    static const AltAndContextConfigEqualityComparator INSTANCE;
+};
+
+const AltAndContextConfigEqualityComparator AltAndContextConfigEqualityComparator::INSTANCE = AltAndContextConfigEqualityComparator();
+
+
+bool PredictionMode::hasSLLConflictTerminatingPrediction(Mode mode, ANTLR_NOTNULL const ATN* atn,
+                                                         ANTLR_NOTNULL const ATNConfigSet* configs,
+                                                         ANTLR_NOTNULL PredictionContextCache* contextCache)
+{
+    /* Configs in rule stop states indicate reaching the end of the decision
+     * rule (local context) or end of start rule (full context). If all
+     * configs meet this condition, then none of the configurations is able
+     * to match additional input so we terminate prediction.
+     */
+    if ( allConfigsInRuleStopStates(atn, configs) ) {
+        return true;
+    }
+
+    // pure SLL mode parsing
+    antlr_auto_ptr<ATNConfigSet> dup;
+    if ( mode==SLL ) {
+        // Don't bother with combining configs from different semantic
+        // contexts if we can fail over to full LL; costs more time
+        // since we'll often fail over anyway.
+        if ( configs->hasSemanticContext ) {
+            // dup configs, tossing out semantic predicates
+            dup.reset(new ATNConfigSet(true, contextCache));
+            for (ATNConfigSet::ConfigList::const_iterator it = configs->configs.begin();
+                    it != configs->configs.end(); it++) {
+                dup->add(ATNConfig(&*it, SemanticContextCache::NONE_INDEX));
+            }
+            configs = dup.get();
+        }
+        // now we have combined contexts for configs with dissimilar preds
+    }
+
+    // pure SLL or combined SLL+LL mode parsing
+
+    if ( configs->tracksAltSubsets() ) {
+        return configs->hasConflictingAltSubset() && !configs->hasStateAssociatedWithOneAlt();
+    }
+    antlr_auto_ptr<AltSubsets> altsets = getConflictingAltSubsets(configs);
+    bool heuristic = hasConflictingAltSet(*altsets) && !hasStateAssociatedWithOneAlt(configs);
+    return heuristic;
+}
+
+bool PredictionMode::hasConfigInRuleStopState(ANTLR_NOTNULL const ATN* atn, ANTLR_NOTNULL const ATNConfigSet* configs)
+{
+    for (ATNConfigSet::ConfigList::const_iterator it = configs->configs.begin();
+            it != configs->configs.end(); it++) {
+        if ( atn->states[it->stateNumber]->getStateType()==ATNState::RULE_STOP ) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PredictionMode::allConfigsInRuleStopStates(ANTLR_NOTNULL const ATN* atn, ANTLR_NOTNULL const ATNConfigSet* configs)
+{
+    for (ATNConfigSet::ConfigList::const_iterator it = configs->configs.begin();
+            it != configs->configs.end(); it++) {
+        if ( atn->states[it->stateNumber]->getStateType()!=ATNState::RULE_STOP ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+antlr_int32_t PredictionMode::resolvesToJustOneViableAlt(const AltSubsets& altsets)
+{
+    return getSingleViableAlt(altsets);
+}
+
+bool PredictionMode::allSubsetsConflict(const AltSubsets& altsets)
+{
+    return !hasNonConflictingAltSet(altsets);
+}
+
+bool PredictionMode::hasNonConflictingAltSet(const AltSubsets& altsets)
+{
+    for (AltSubsets::const_iterator it = altsets.begin(); it != altsets.end(); it++) {
+        if ( it->cardinality()==1 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PredictionMode::hasConflictingAltSet(const AltSubsets& altsets)
+{
+    for (AltSubsets::const_iterator it = altsets.begin(); it != altsets.end(); it++) {
+        if ( it->cardinality()>1 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PredictionMode::allSubsetsEqual(const AltSubsets& altsets)
+{
+    if ( altsets.empty() ) {
+        return true;
+    }
+    const BitSet& first = altsets.front();
+    for (AltSubsets::const_iterator it = altsets.begin() + 1; it != altsets.end(); it++) {
+        if ( !it->equals(&first) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+antlr_int32_t PredictionMode::getUniqueAlt(const AltSubsets& altsets)
+{
+    BitSet all = getAlts(altsets);
+    if ( all.cardinality()==1 ) return all.nextSetBit(0);
+    return ATN::INVALID_ALT_NUMBER;
+}
+
+BitSet PredictionMode::getAlts(const AltSubsets& altsets)
+{
+    BitSet all;
+    for (AltSubsets::const_iterator it = altsets.begin(); it != altsets.end(); it++) {
+        all.or_(*it);
+    }
+    return all;
+}
+
+antlr_auto_ptr<PredictionMode::AltSubsets> PredictionMode::getConflictingAltSubsets(ANTLR_NOTNULL const ATNConfigSet* configs)
+{
+    if ( configs->tracksAltSubsets() ) {
+        antlr_auto_ptr<AltSubsets> altsets(new AltSubsets());
+        configs->getAltSubsets(*altsets);
+        return altsets;
+    }
+
+    FlexibleHashMap<ATNConfig, BitSet> configToAlts(&AltAndContextConfigEqualityComparator::INSTANCE);
+    for (ATNConfigSet::ConfigList::const_iterator it = configs->configs.begin();
+            it != configs->configs.end(); it++) {
+        const BitSet* existing = configToAlts.get(*it);
+        BitSet alts;
+        if ( existing!=NULL ) {
+            alts = *existing;
+        }
+        alts.set(it->alt);
+        configToAlts.put(*it, alts);
+    }
+
+    antlr_auto_ptr<AltSubsets> altsets(new AltSubsets());
+    std::vector<const BitSet*> values = configToAlts.values();
+    altsets->reserve(values.size());
+    for (std::vector<const BitSet*>::const_iterator it = values.begin(); it != values.end(); it++) {
+        altsets->push_back(**it);
+    }
+    return altsets;
+}
+
+antlr_auto_ptr< HashMap<antlr_int32_t, BitSet> > PredictionMode::getStateToAltMap(ANTLR_NOTNULL const ATNConfigSet* configs)
+{
+    antlr_auto_ptr< HashMap<antlr_int32_t, BitSet> > m(new HashMap<antlr_int32_t, BitSet>());
+    for (ATNConfigSet::ConfigList::const_iterator it = configs->configs.begin();
+            it != configs->configs.end(); it++) {
+        const BitSet* existing = m->get(it->stateNumber);
+        if ( existing==NULL ) {
+            existing = m->put(it->stateNumber, BitSet());
+        }
+        const_cast<BitSet*>(existing)->set(it->alt);
+    }
+    return m;
+}
+
+bool PredictionMode::hasStateAssociatedWithOneAlt(ANTLR_NOTNULL const ATNConfigSet* configs)
+{
+    if ( configs->tracksAltSubsets() ) {
+        return configs->hasStateAssociatedWithOneAlt();
+    }
+    antlr_auto_ptr< HashMap<antlr_int32_t, BitSet> > x = getStateToAltMap(configs);
+    for (HashMap<antlr_int32_t, BitSet>::const_iterator it = x->begin(); it != x->end(); it++) {
+        if ( it->second.cardinality()==1 ) return true;
+    }
+    return false;
+}
+
+antlr_int32_t PredictionMode::getSingleViableAlt(const AltSubsets& altsets)
+{
+    BitSet viableAlts;
+    for (AltSubsets::const_iterator it = altsets.begin(); it != altsets.end(); it++) {
+        antlr_int32_t minAlt = it->nextSetBit(0);
+        viableAlts.set(minAlt);
+        if ( viableAlts.cardinality()>1 ) { // more than 1 viable alt
+            return ATN::INVALID_ALT_NUMBER;
+        }
+    }
+    return viableAlts.nextSetBit(0);
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
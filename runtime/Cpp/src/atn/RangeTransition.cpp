@@ -39,17 +39,12 @@ namespace antlr4 {
 namespace atn {
 
 RangeTransition::RangeTransition(ANTLR_NOTNULL const ATNState* target, antlr_int32_t from, antlr_int32_t to)
-    :   Transition(target),
+    :   Transition(target, RANGE, from, to),
         from(from),
         to(to)
 {
 }
 
-antlr_int32_t RangeTransition::getSerializationType() const
-{
-    return RANGE;
-}
-
 antlr_auto_ptr<IntervalSet> RangeTransition::label() const
 {
     antlr_auto_ptr<IntervalSet> s(new IntervalSet());
@@ -57,11 +52,6 @@ antlr_auto_ptr<IntervalSet> RangeTransition::label() const
     return s;
 }
 
-bool RangeTransition::matches(antlr_int32_t symbol, antlr_int32_t, antlr_int32_t) const
-{
-    return symbol >= from && symbol <= to;
-}
-
 std::string RangeTransition::toString() const
 {
     return std::string("'")+(char)from+"'..'"+(char)to+"'";
@@ -35,6 +35,9 @@
 
 #include <antlr/atn/RuleTransition.h>
 #include <antlr/atn/RuleStartState.h>
+#include <antlr/misc/Utils.h>
+
+using namespace antlr4::misc;
 
 namespace antlr4 {
 namespace atn {
@@ -43,25 +46,15 @@ RuleTransition::RuleTransition(
                ANTLR_NOTNULL const RuleStartState* ruleStart,
                antlr_int32_t ruleIndex,
                ANTLR_NOTNULL const ATNState* followState)
-    :   Transition(ruleStart),
+    :   Transition(ruleStart, RULE),
         ruleIndex(ruleIndex),
         followState(followState)
 {
 }
 
-antlr_int32_t RuleTransition::getSerializationType() const
-{
-    return RULE;
-}
-
-bool RuleTransition::isEpsilon() const
-{
-    return true;
-}
-
-bool RuleTransition::matches(antlr_int32_t, antlr_int32_t, antlr_int32_t) const
+std::string RuleTransition::toString() const
 {
-    return false;
+    return std::string("rule_")+Utils::stringValueOf(ruleIndex);
 }
 
 } /* namespace atn */
@@ -34,11 +34,254 @@
  */
 
 #include <antlr/atn/SemanticContext.h>
+#include <antlr/Parser.h>
+#include <antlr/atn/SemanticContextCache.h>
+#include <antlr/misc/MurmurHash.h>
+#include <antlr/misc/Utils.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace antlr4 {
 namespace atn {
 
-const SemanticContext SemanticContext::NONE = SemanticContext();
+
+namespace {
+
+/** Orders operands by hash code so that equal operand sets compare equal
+ *  regardless of the order they were combined in.
+ */
+bool compareOperands(const SemanticContext* a, const SemanticContext* b)
+{
+    return a->hashCode() < b->hashCode();
+}
+
+void addOperand(std::vector<const SemanticContext*>& operands, const SemanticContext* opnd)
+{
+    for (std::vector<const SemanticContext*>::const_iterator it = operands.begin(); it != operands.end(); it++) {
+        if ((*it)->equals(opnd)) {
+            return;
+        }
+    }
+    operands.push_back(opnd);
+}
+
+antlr_int32_t hashOperands(const std::vector<const SemanticContext*>& operands, antlr_int32_t seed)
+{
+    antlr_int32_t hash = MurmurHash::initialize(seed);
+    for (std::vector<const SemanticContext*>::const_iterator it = operands.begin(); it != operands.end(); it++) {
+        hash = MurmurHash::update(hash, *it);
+    }
+    return MurmurHash::finish(hash, static_cast<antlr_int32_t>(operands.size()));
+}
+
+bool equalOperands(const std::vector<const SemanticContext*>& a, const std::vector<const SemanticContext*>& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!a[i]->equals(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string joinOperands(const std::vector<const SemanticContext*>& operands, const char* separator)
+{
+    std::string buf;
+    for (std::vector<const SemanticContext*>::const_iterator it = operands.begin(); it != operands.end(); it++) {
+        if (it != operands.begin()) {
+            buf += separator;
+        }
+        buf += (*it)->toString();
+    }
+    return buf;
+}
+
+const antlr_int32_t AND_HASH_SEED = 40363613;
+const antlr_int32_t OR_HASH_SEED = 486279973;
+
+} /* anonymous namespace */
+
+
+const SemanticContext::Predicate SemanticContext::NONE;
+
+SemanticContext::SemanticContext()
+{
+}
+
+SemanticContext::~SemanticContext()
+{
+}
+
+SemanticContext* SemanticContext::clone() const
+{
+    throw std::logic_error("SemanticContext::clone not supported");
+}
+
+const SemanticContext* SemanticContext::and_(ANTLR_NULLABLE const SemanticContext* a,
+                                             ANTLR_NULLABLE const SemanticContext* b,
+                                             SemanticContextCache& cache)
+{
+    if ( a == NULL || a == &NONE ) return b;
+    if ( b == NULL || b == &NONE ) return a;
+    antlr_auto_ptr<AND> result(new AND(a, b));
+    if (result->opnds.size() == 1) {
+        return result->opnds[0];
+    }
+
+    return cache.add(result.release());
+}
+
+const SemanticContext* SemanticContext::or_(ANTLR_NULLABLE const SemanticContext* a,
+                                            ANTLR_NULLABLE const SemanticContext* b,
+                                            SemanticContextCache& cache)
+{
+    if ( a == NULL ) return b;
+    if ( b == NULL ) return a;
+    if ( a == &NONE || b == &NONE ) return &NONE;
+    antlr_auto_ptr<OR> result(new OR(a, b));
+    if (result->opnds.size() == 1) {
+        return result->opnds[0];
+    }
+
+    return cache.add(result.release());
+}
+
+SemanticContext::Predicate::Predicate()
+    :   ruleIndex(-1),
+        predIndex(-1),
+        isCtxDependent(false)
+{
+}
+
+SemanticContext::Predicate::Predicate(antlr_int32_t ruleIndex, antlr_int32_t predIndex, bool isCtxDependent)
+    :   ruleIndex(ruleIndex),
+        predIndex(predIndex),
+        isCtxDependent(isCtxDependent)
+{
+}
+
+bool SemanticContext::Predicate::eval(ANTLR_NULLABLE Parser* parser, ANTLR_NULLABLE RuleContext* outerContext) const
+{
+    if (parser == NULL) {
+        return true;
+    }
+
+    RuleContext* localctx = isCtxDependent ? outerContext : NULL;
+    return parser->sempred(localctx, ruleIndex, predIndex);
+}
+
+antlr_int32_t SemanticContext::Predicate::hashCode() const
+{
+    antlr_int32_t hashCode = MurmurHash::initialize();
+    hashCode = MurmurHash::update(hashCode, ruleIndex);
+    hashCode = MurmurHash::update(hashCode, predIndex);
+    hashCode = MurmurHash::update(hashCode, isCtxDependent ? 1 : 0);
+    hashCode = MurmurHash::finish(hashCode, 3);
+    return hashCode;
+}
+
+bool SemanticContext::Predicate::equals(const Key<SemanticContext>* o) const
+{
+    const Predicate* p = dynamic_cast<const Predicate*>(o);
+    if (p == NULL) {
+        return false;
+    }
+    if ( this == p ) return true;
+    return this->ruleIndex == p->ruleIndex &&
+           this->predIndex == p->predIndex &&
+           this->isCtxDependent == p->isCtxDependent;
+}
+
+std::string SemanticContext::Predicate::toString() const
+{
+    return "{"+Utils::stringValueOf(ruleIndex)+":"+Utils::stringValueOf(predIndex)+"}?";
+}
+
+SemanticContext::AND::AND(ANTLR_NOTNULL const SemanticContext* a, ANTLR_NOTNULL const SemanticContext* b)
+{
+    const AND* andA = dynamic_cast<const AND*>(a);
+    if ( andA != NULL ) {
+        for (size_t i = 0; i < andA->opnds.size(); i++) addOperand(opnds, andA->opnds[i]);
+    }
+    else addOperand(opnds, a);
+    const AND* andB = dynamic_cast<const AND*>(b);
+    if ( andB != NULL ) {
+        for (size_t i = 0; i < andB->opnds.size(); i++) addOperand(opnds, andB->opnds[i]);
+    }
+    else addOperand(opnds, b);
+    std::stable_sort(opnds.begin(), opnds.end(), compareOperands);
+}
+
+bool SemanticContext::AND::eval(ANTLR_NULLABLE Parser* parser, ANTLR_NULLABLE RuleContext* outerContext) const
+{
+    for (std::vector<const SemanticContext*>::const_iterator it = opnds.begin(); it != opnds.end(); it++) {
+        if ( !(*it)->eval(parser, outerContext) ) return false;
+    }
+    return true;
+}
+
+antlr_int32_t SemanticContext::AND::hashCode() const
+{
+    return hashOperands(opnds, AND_HASH_SEED);
+}
+
+bool SemanticContext::AND::equals(const Key<SemanticContext>* o) const
+{
+    if ( this == o ) return true;
+    const AND* other = dynamic_cast<const AND*>(o);
+    if ( other == NULL ) return false;
+    return equalOperands(this->opnds, other->opnds);
+}
+
+std::string SemanticContext::AND::toString() const
+{
+    return joinOperands(opnds, "&&");
+}
+
+SemanticContext::OR::OR(ANTLR_NOTNULL const SemanticContext* a, ANTLR_NOTNULL const SemanticContext* b)
+{
+    const OR* orA = dynamic_cast<const OR*>(a);
+    if ( orA != NULL ) {
+        for (size_t i = 0; i < orA->opnds.size(); i++) addOperand(opnds, orA->opnds[i]);
+    }
+    else addOperand(opnds, a);
+    const OR* orB = dynamic_cast<const OR*>(b);
+    if ( orB != NULL ) {
+        for (size_t i = 0; i < orB->opnds.size(); i++) addOperand(opnds, orB->opnds[i]);
+    }
+    else addOperand(opnds, b);
+    std::stable_sort(opnds.begin(), opnds.end(), compareOperands);
+}
+
+bool SemanticContext::OR::eval(ANTLR_NULLABLE Parser* parser, ANTLR_NULLABLE RuleContext* outerContext) const
+{
+    for (std::vector<const SemanticContext*>::const_iterator it = opnds.begin(); it != opnds.end(); it++) {
+        if ( (*it)->eval(parser, outerContext) ) return true;
+    }
+    return false;
+}
+
+antlr_int32_t SemanticContext::OR::hashCode() const
+{
+    return hashOperands(opnds, OR_HASH_SEED);
+}
+
+bool SemanticContext::OR::equals(const Key<SemanticContext>* o) const
+{
+    if ( this == o ) return true;
+    const OR* other = dynamic_cast<const OR*>(o);
+    if ( other == NULL ) return false;
+    return equalOperands(this->opnds, other->opnds);
+}
+
+std::string SemanticContext::OR::toString() const
+{
+    return joinOperands(opnds, "||");
+}
+
 
 } /* namespace atn */
 } /* namespace antlr4 */
@@ -0,0 +1,155 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <antlr/atn/SemanticContextCache.h>
+#include <antlr/misc/MutexLock.h>
+#include <new>
+#include <stdexcept>
+
+namespace antlr4 {
+namespace atn {
+
+
+const antlr_uint32_t SemanticContextCache::NONE_INDEX;
+
+const antlr_uint32_t SemanticContextCache::MAX_INDEX;
+
+const antlr_uint32_t SemanticContextCache::FIRST_CHUNK_SIZE;
+
+const antlr_uint32_t SemanticContextCache::NUM_CHUNKS;
+
+namespace {
+
+/** Finds the chunk holding {@code index} and the offset in it */
+antlr_uint32_t chunkOf(antlr_uint32_t index, antlr_uint32_t firstChunkSize, antlr_uint32_t& offset)
+{
+    antlr_uint32_t k = 0;
+    antlr_uint32_t start = 0;
+    antlr_uint32_t size = firstChunkSize;
+    while ( index>=start+size ) {
+        start += size;
+        size <<= 1;
+        k++;
+    }
+    offset = index - start;
+    return k;
+}
+
+} /* anonymous namespace */
+
+SemanticContextCache::SemanticContextCache()
+{
+}
+
+SemanticContextCache::~SemanticContextCache()
+{
+    clear();
+}
+
+const SemanticContext* SemanticContextCache::add(ANTLR_NOTNULL const SemanticContext* ctx)
+{
+    MutexLock guard(&mutex);
+    KeyPtr<SemanticContext> key(const_cast<SemanticContext*>(ctx), false);
+    const SemanticContext* const* existing = cache.get(key);
+    if ( existing!=NULL ) {
+        if ( *existing!=ctx ) delete ctx;
+        return *existing;
+    }
+    cache.put(key, ctx);
+    return ctx;
+}
+
+antlr_uint32_t SemanticContextCache::getIndex(ANTLR_NOTNULL const SemanticContext* ctx)
+{
+    if ( ctx==&SemanticContext::NONE || *ctx==SemanticContext::NONE ) return NONE_INDEX;
+    MutexLock guard(&mutex);
+    KeyPtr<SemanticContext> key(const_cast<SemanticContext*>(ctx), false);
+    const antlr_uint32_t* existing = indexes.get(key);
+    if ( existing!=NULL ) return *existing;
+
+    antlr_uint32_t index = static_cast<antlr_uint32_t>(indexes.size()) + 1;
+    if ( index>MAX_INDEX ) {
+        // every numbered context takes memory of its own
+        throw std::bad_alloc();
+    }
+    antlr_uint32_t offset;
+    antlr_uint32_t k = chunkOf(index, FIRST_CHUNK_SIZE, offset);
+    Slot* chunk = chunks[k].load();
+    if ( chunk==NULL ) {
+        chunk = new Slot[FIRST_CHUNK_SIZE << k];
+        chunks[k].store(chunk);
+    }
+    chunk[offset].store(ctx);
+    indexes.put(key, index);
+    return index;
+}
+
+const SemanticContext* SemanticContextCache::get(antlr_uint32_t index) const
+{
+    if ( index==NONE_INDEX ) return &SemanticContext::NONE;
+    antlr_uint32_t offset;
+    antlr_uint32_t k = chunkOf(index, FIRST_CHUNK_SIZE, offset);
+    const Slot* chunk = k<NUM_CHUNKS ? chunks[k].load() : NULL;
+    const SemanticContext* ctx = chunk!=NULL ? chunk[offset].load() : NULL;
+    if ( ctx==NULL ) {
+        throw std::out_of_range("no semantic context has this index");
+    }
+    return ctx;
+}
+
+antlr_int32_t SemanticContextCache::size() const
+{
+    MutexLock guard(&mutex);
+    return static_cast<antlr_int32_t>(cache.size());
+}
+
+void SemanticContextCache::clear()
+{
+    MutexLock guard(&mutex);
+    for (ContextHashMap::iterator it = cache.begin(); it != cache.end(); it++) {
+        delete it->second;
+    }
+    cache.clear();
+    indexes.clear();
+    for (antlr_uint32_t k = 0; k < NUM_CHUNKS; k++) {
+        delete[] chunks[k].load();
+        chunks[k].store(NULL);
+    }
+}
+
+
+} /* namespace atn */
+} /* namespace antlr4 */
@@ -44,28 +44,35 @@ namespace atn {
 // TODO (sam): should we really allow null here?
 SetTransition::SetTransition(ANTLR_NOTNULL const ATNState* target,
                              ANTLR_NULLABLE const IntervalSet* set)
-    :   Transition(target)
+    :   Transition(target, SET, 0, 0, &this->set)
 {
-    if (set == NULL) {
-        this->set = IntervalSet::of(Token::INVALID_TYPE);
-    } else {
-        this->set = *set;
-    }
+    init(set);
 }
 
-antlr_int32_t SetTransition::getSerializationType() const
+SetTransition::SetTransition(ANTLR_NOTNULL const ATNState* target,
+                             antlr_int32_t serializationType,
+                             ANTLR_NULLABLE const IntervalSet* set)
+    :   Transition(target, serializationType, 0, 0, &this->set)
 {
-    return SET;
+    init(set);
 }
 
-antlr_auto_ptr<IntervalSet> SetTransition::label() const
+void SetTransition::init(ANTLR_NULLABLE const IntervalSet* set)
 {
-    return antlr_auto_ptr<IntervalSet>(new IntervalSet(set));
+    if (set == NULL) {
+        this->set = IntervalSet::of(Token::INVALID_TYPE);
+    } else {
+        this->set = *set;
+    }
+    // the label is matched against every input symbol; let it build its bitmaps
+    this->set.setReadonly(true);
 }
 
-bool SetTransition::matches(antlr_int32_t symbol, antlr_int32_t, antlr_int32_t) const
+antlr_auto_ptr<IntervalSet> SetTransition::label() const
 {
-    return set.contains(symbol);
+    antlr_auto_ptr<IntervalSet> s(new IntervalSet(set));
+    s->setReadonly(false);
+    return s;
 }
 
 std::string SetTransition::toString() const
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,11 +33,79 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/SingletonPredictionContext.h>
+#include <antlr/misc/Utils.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+SingletonPredictionContext::SingletonPredictionContext(ANTLR_NULLABLE const PredictionContext* parent, antlr_int32_t returnState)
+    :   PredictionContext(parent != NULL ? calculateHashCode(parent, returnState) : calculateEmptyHashCode()),
+        parent(parent),
+        returnState(returnState)
+{
+}
+
+const PredictionContext* SingletonPredictionContext::create(ANTLR_NULLABLE const PredictionContext* parent, antlr_int32_t returnState)
+{
+    if ( returnState == EMPTY_RETURN_STATE && parent == NULL ) {
+        // someone can pass in the bits of an array ctx that mean $
+        return EMPTY;
+    }
+    return new SingletonPredictionContext(parent, returnState);
+}
+
+antlr_int32_t SingletonPredictionContext::size() const
+{
+    return 1;
+}
+
+const PredictionContext* SingletonPredictionContext::getParent(antlr_int32_t) const
+{
+    return parent;
+}
+
+antlr_int32_t SingletonPredictionContext::getReturnState(antlr_int32_t) const
+{
+    return returnState;
+}
+
+bool SingletonPredictionContext::equals(const Key<PredictionContext>* o) const
+{
+    if (this == o) {
+        return true;
+    }
+    const SingletonPredictionContext* s = dynamic_cast<const SingletonPredictionContext*>(o);
+    if (s == NULL) {
+        return false;
+    }
+
+    if ( isInternedWith(s) ) {
+        return false; // hash-consed, so equal only if same object
+    }
+
+    if ( this->hashCode() != s->hashCode() ) {
+        return false; // can't be same if hash is different
+    }
+
+    return returnState == s->returnState &&
+        (parent == s->parent || (parent != NULL && parent->equals(s->parent)));
+}
+
+std::string SingletonPredictionContext::toString() const
+{
+    std::string up = parent!=NULL ? parent->toString() : "";
+    if ( up.empty() ) {
+        if ( returnState == EMPTY_RETURN_STATE ) {
+            return "$";
+        }
+        return Utils::stringValueOf(returnState);
+    }
+    return Utils::stringValueOf(returnState)+" "+up;
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
@@ -16,7 +16,7 @@
  *  3. The name of the author may not be used to endorse or promote products
  *     derived from this software without specific prior written permission.
  *
- *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR AS IS'' AND ANY EXPRESS OR
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
  *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
  *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
  *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
@@ -33,11 +33,22 @@
  * Gael Hatchue
  */
 
+
 #include <antlr/atn/StarBlockStartState.h>
 
 namespace antlr4 {
 namespace atn {
 
 
+StarBlockStartState::StarBlockStartState()
+{
+}
+
+antlr_int32_t StarBlockStartState::getStateType() const
+{
+    return STAR_BLOCK_START;
+}
+
+
 } /* namespace atn */
 } /* namespace antlr4 */
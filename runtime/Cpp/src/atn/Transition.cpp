@@ -34,17 +34,6 @@
  */
 
 #include <antlr/atn/Transition.h>
-#include <antlr/atn/EpsilonTransition.h>
-#include <antlr/atn/RangeTransition.h>
-#include <antlr/atn/RuleTransition.h>
-#include <antlr/atn/PredicateTransition.h>
-#include <antlr/atn/AtomTransition.h>
-#include <antlr/atn/ActionTransition.h>
-#include <antlr/atn/SetTransition.h>
-#include <antlr/atn/NotSetTransition.h>
-#include <antlr/atn/WildcardTransition.h>
-#include <antlr/misc/Utils.h>
-#include <algorithm>
 #include <stdexcept>
 
 
@@ -55,29 +44,29 @@ namespace atn {
 
 
 // constants for serialization
-const antlr_int32_t Transition::EPSILON     = 1;
-const antlr_int32_t Transition::RANGE       = 2;
-const antlr_int32_t Transition::RULE        = 3;
-const antlr_int32_t Transition::PREDICATE   = 4; // e.g., {isType(input.LT(1))}?
-const antlr_int32_t Transition::ATOM        = 5;
-const antlr_int32_t Transition::ACTION      = 6;
-const antlr_int32_t Transition::SET         = 7; // ~(A|B) or ~atom, wildcard, which convert to next 2
-const antlr_int32_t Transition::NOT_SET     = 8;
-const antlr_int32_t Transition::WILDCARD    = 9;
+const antlr_int32_t Transition::EPSILON;
+const antlr_int32_t Transition::RANGE;
+const antlr_int32_t Transition::RULE;
+const antlr_int32_t Transition::PREDICATE;
+const antlr_int32_t Transition::ATOM;
+const antlr_int32_t Transition::ACTION;
+const antlr_int32_t Transition::SET;
+const antlr_int32_t Transition::NOT_SET;
+const antlr_int32_t Transition::WILDCARD;
 
 const std::vector<std::string> Transition::serializationNames =
     Transition::getSerializationNames();
 
-#if defined(HAVE_CX11)
-const HashMap<std::size_t, antlr_int32_t> Transition::serializationTypes =
-    Transition::getSerializationTypes();
-#else
-const std::vector<Transition::TypeInfo> Transition::serializationTypes =
-    Transition::getSerializationTypes();
-#endif
-
-Transition::Transition(ANTLR_NOTNULL const ATNState* target)
-    :   target(target)
+Transition::Transition(ANTLR_NOTNULL const ATNState* target,
+                       antlr_int32_t serializationType,
+                       antlr_int32_t arg1,
+                       antlr_int32_t arg2,
+                       ANTLR_NULLABLE const IntervalSet* matchSet)
+    :   target(target),
+        serializationType(serializationType),
+        arg1(arg1),
+        arg2(arg2),
+        matchSet(matchSet)
 {
     if (target == NULL) {
         throw std::logic_error("target cannot be null.");
@@ -105,69 +94,6 @@ std::vector<std::string> Transition::getSerializationNames()
     return std::vector<std::string>(names, names + sizeof(names)/sizeof(names[0]));
 }
 
-#if defined(HAVE_CX11)
-
-antlr_int32_t Transition::getSerializationType(const std::type_info& type)
-{
-    antlr_int32_t* type = serializationTypes.get(type.hash_code());
-    if (type == NULL) {
-        throw std::logic_error("type not found");
-    }
-    return *type;
-}
-
-HashMap<std::size_t, antlr_int32_t> Transition::getSerializationTypes()
-{
-    HashMap<std::size_t, antlr_int32_t> types;
-    types.put(typeid(EpsilonTransition).hash_code(), EPSILON);
-    types.put(typeid(RangeTransition).hash_code(), RANGE);
-    types.put(typeid(RuleTransition).hash_code(), RULE);
-    types.put(typeid(PredicateTransition).hash_code(), PREDICATE);
-    types.put(typeid(AtomTransition).hash_code(), ATOM);
-    types.put(typeid(ActionTransition).hash_code(), ACTION);
-    types.put(typeid(SetTransition).hash_code(), SET);
-    types.put(typeid(NotSetTransition).hash_code(), NOT_SET);
-    types.put(typeid(WildcardTransition).hash_code(), WILDCARD);
-    return types;
-}
-
-#else /* HAVE_CX11 */
-
-antlr_int32_t Transition::getSerializationType(const std::type_info& type)
-{
-    for (std::vector<TypeInfo>::const_iterator it = serializationTypes.begin();
-            it != serializationTypes.end(); it++)
-    {
-        if (type == *it->first) {
-            return it->second;
-        }
-    }
-    throw std::logic_error("type not found");
-}
-
-std::vector<Transition::TypeInfo> Transition::getSerializationTypes()
-{
-    std::vector<TypeInfo> types;
-    types.push_back(TypeInfo(&typeid(EpsilonTransition), EPSILON));
-    types.push_back(TypeInfo(&typeid(RangeTransition), RANGE));
-    types.push_back(TypeInfo(&typeid(RuleTransition), RULE));
-    types.push_back(TypeInfo(&typeid(PredicateTransition), PREDICATE));
-    types.push_back(TypeInfo(&typeid(AtomTransition), ATOM));
-    types.push_back(TypeInfo(&typeid(ActionTransition), ACTION));
-    types.push_back(TypeInfo(&typeid(SetTransition), SET));
-    types.push_back(TypeInfo(&typeid(NotSetTransition), NOT_SET));
-    types.push_back(TypeInfo(&typeid(WildcardTransition), WILDCARD));
-    return types;
-}
-
-#endif
-
-/** Are we epsilon, action, sempred? */
-bool Transition::isEpsilon() const
-{
-    return false;
-}
-
 antlr_auto_ptr<IntervalSet> Transition::label() const
 {
     return antlr_auto_ptr<IntervalSet>();
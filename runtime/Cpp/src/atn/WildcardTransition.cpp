@@ -39,20 +39,10 @@ namespace antlr4 {
 namespace atn {
 
 WildcardTransition::WildcardTransition(ANTLR_NOTNULL const ATNState* target)
-    :   Transition(target)
+    :   Transition(target, WILDCARD)
 {
 }
 
-antlr_int32_t WildcardTransition::getSerializationType() const
-{
-    return WILDCARD;
-}
-
-bool WildcardTransition::matches(antlr_int32_t symbol, antlr_int32_t minVocabSymbol, antlr_int32_t maxVocabSymbol) const
-{
-    return symbol >= minVocabSymbol && symbol <= maxVocabSymbol;
-}
-
 std::string WildcardTransition::toString() const
 {
     return ".";
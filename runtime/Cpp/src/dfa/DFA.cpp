@@ -34,10 +34,14 @@
  */
 
 #include <antlr/dfa/DFA.h>
+#include <antlr/atn/ATN.h>
 #include <antlr/atn/DecisionState.h>
+#include <antlr/atn/SemanticContext.h>
 #include <antlr/dfa/DFASerializer.h>
 #include <antlr/dfa/LexerDFASerializer.h>
+#include <antlr/misc/MutexLock.h>
 #include <algorithm>
+#include <stdexcept>
 
 namespace antlr4 {
 namespace dfa {
@@ -45,7 +49,6 @@ namespace dfa {
 
 DFA::DFA(ANTLR_NOTNULL const DecisionState* atnStartState)
     :   states(new StateHashMap()),
-        s0(NULL),
         decision(0),
         atnStartState(atnStartState)
 {
@@ -53,12 +56,87 @@ DFA::DFA(ANTLR_NOTNULL const DecisionState* atnStartState)
 
 DFA::DFA(ANTLR_NOTNULL const DecisionState* atnStartState, antlr_int32_t decision)
     :   states(new StateHashMap()),
-        s0(NULL),
         decision(decision),
         atnStartState(atnStartState)
 {
 }
 
+DFA::~DFA()
+{
+    for (StateHashMap::iterator it = states->begin(); it != states->end(); it++) {
+        it->second->~DFAState(); // storage belongs to arena
+    }
+    delete frozen.load();
+}
+
+size_t DFA::freeze()
+{
+    MutexLock guard(&lock);
+    const DFAState* start = s0.load();
+    if ( start==NULL || frozen.load()!=NULL ) {
+        return 0;
+    }
+
+    size_t bytesBefore = arena.getBytesReserved() + sizeof(StateHashMap);
+    for (StateHashMap::const_iterator it = states->begin(); it != states->end(); it++) {
+        const DFAState* state = it->second;
+        // an entry of the map, its node and bucket
+        bytesBefore += sizeof(StateHashMap::value_type) + 2 * sizeof(void*);
+        bytesBefore += state->configs->getBytesUsed();
+        bytesBefore += state->numPredicates * (sizeof(DFAState::PredPrediction) + sizeof(void*));
+    }
+
+    const FrozenDFA* table = createFrozen(start);
+    frozen.store(table);
+    s0.store(NULL);
+    for (StateHashMap::iterator it = states->begin(); it != states->end(); it++) {
+        it->second->~DFAState(); // storage belongs to arena
+    }
+    states.reset(new StateHashMap());
+    arena.reset();
+
+    size_t bytesAfter = arena.getBytesReserved() + sizeof(StateHashMap) + table->getBytesUsed();
+    return bytesBefore > bytesAfter ? bytesBefore - bytesAfter : 0;
+}
+
+FrozenDFA* DFA::createFrozen(ANTLR_NOTNULL const DFAState* start) const
+{
+    std::vector<const DFAState*> sorted;
+    sorted.reserve(states->size());
+    for (StateHashMap::const_iterator it = states->begin(); it != states->end(); it++) {
+        sorted.push_back(it->second);
+    }
+    std::sort(sorted.begin(), sorted.end(), compareStatesForSort);
+    return new FrozenDFA(*atnStartState->atn, sorted, start);
+}
+
+antlr_auto_ptr<FrozenDFA> DFA::toFrozen() const
+{
+    MutexLock guard(&lock);
+    const DFAState* start = s0.load();
+    return antlr_auto_ptr<FrozenDFA>(start!=NULL ? createFrozen(start) : NULL);
+}
+
+void DFA::setFrozen(ANTLR_NOTNULL antlr_auto_ptr<FrozenDFA>& table)
+{
+    MutexLock guard(&lock);
+    if ( frozen.load()!=NULL ) {
+        throw std::logic_error("DFA is already frozen");
+    }
+    frozen.store(table.release());
+}
+
+bool DFA::isFrozen() const
+{
+    return frozen.load()!=NULL;
+}
+
+ANTLR_NULLABLE
+const FrozenDFA* DFA::getFrozen() const
+{
+    return frozen.load();
+}
+
 bool DFA::compareStatesForSort (const DFAState* o1, const DFAState* o2)
 {
     return o1->stateNumber < o2->stateNumber;
@@ -70,12 +148,21 @@ bool DFA::compareStatesForSort (const DFAState* o1, const DFAState* o2)
 antlr_auto_ptr< std::vector<const DFAState*> > DFA::getStates() const
 {
     antlr_auto_ptr< std::vector<const DFAState*> > result(new std::vector<const DFAState*>());
+    MutexLock guard(&lock);
     for (StateHashMap::const_iterator it = states->begin(); it != states->end(); it++)
         result->push_back(it->first.get());
     std::sort(result->begin(), result->end(), compareStatesForSort);
     return result;
 }
 
+DFAState* DFA::addState(ANTLR_NOTNULL DFAState& proposed)
+{
+    DFAState* state = new (arena.allocate(sizeof(DFAState))) DFAState(proposed, &arena);
+    state->stateNumber = static_cast<antlr_int32_t>(states->size());
+    states->put(KeyPtr<DFAState>(state, false), state);
+    return state;
+}
+
 std::string DFA::toString() const
 {
     return toString(NULL);
@@ -83,14 +170,14 @@ std::string DFA::toString() const
 
 std::string DFA::toString(ANTLR_NULLABLE const std::vector<std::string>* tokenNames) const
 {
-    if ( s0==NULL ) return "";
+    if ( s0.load()==NULL ) return "";
     antlr_auto_ptr<DFASerializer> serializer(new DFASerializer(this,tokenNames));
     return serializer->toString();
 }
 
 std::string DFA::toLexerString() const
 {
-    if ( s0==NULL ) return "";
+    if ( s0.load()==NULL ) return "";
     antlr_auto_ptr<DFASerializer> serializer(new LexerDFASerializer(this));
     return serializer->toString();
 }
@@ -49,9 +49,13 @@ DFASerializer::DFASerializer(ANTLR_NOTNULL const DFA* dfa,
 {
 }
 
+DFASerializer::~DFASerializer()
+{
+}
+
 std::string DFASerializer::toString() const
 {
-    if ( dfa->s0==NULL ) return "";
+    if ( dfa->s0.load()==NULL ) return "";
     std::stringstream buf;
     antlr_auto_ptr< std::vector<const DFAState*> > states = dfa->getStates();
     for (std::vector<const DFAState*>::const_iterator it = states->begin();
@@ -59,15 +63,27 @@ std::string DFASerializer::toString() const
     {
         const DFAState& s = **it;
         antlr_uint32_t n = 0;
-        if ( s.edges!=NULL ) n = s.numEdges;
+        if ( s.edges.load()!=NULL ) n = s.numEdges;
         for (antlr_uint32_t i=0; i<n; i++) {
-            const DFAState* t = s.edges[i];
+            const DFAState* t = s.getEdge(i);
             if ( t!=NULL && t->stateNumber != ANTLR_INT32_MAX ) {
                 buf << getStateString(s);
                 std::string label = getEdgeLabel(i);
                 buf << "-" << label << "->" << getStateString(*t) << "\n";
             }
         }
+        if ( s.edgePages.load()!=NULL ) {
+            for (antlr_int32_t page=0; page<DFAState::NUM_EDGE_PAGES; page++) {
+                for (antlr_int32_t j=0; j<DFAState::EDGE_PAGE_SIZE; j++) {
+                    const DFAState* t = s.getPagedEdge((page << DFAState::EDGE_PAGE_SHIFT) + j);
+                    if ( t!=NULL && t->stateNumber != ANTLR_INT32_MAX ) {
+                        buf << getStateString(s);
+                        std::string label = getEdgeLabel((page << DFAState::EDGE_PAGE_SHIFT) + j);
+                        buf << "-" << label << "->" << getStateString(*t) << "\n";
+                    }
+                }
+            }
+        }
     }
 
     //return Utils.sortLinesInString(output);
@@ -92,7 +108,7 @@ std::string DFASerializer::getStateString(const DFAState& s) const
             baseStateStr += "=>" + Utils::stringValueOfPtrArray(s.predicates, s.numPredicates);
         }
         else {
-            baseStateStr += "=>" + s.prediction;
+            baseStateStr += "=>" + Utils::stringValueOf(s.prediction);
         }
     }
     return baseStateStr;
@@ -0,0 +1,454 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <antlr/dfa/DFASnapshot.h>
+#include <antlr/dfa/DFA.h>
+#include <antlr/misc/MurmurHash.h>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#   define ANTLR_MMAP_POSIX
+#elif defined(_WIN32)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#   define ANTLR_MMAP_WIN32
+#endif
+
+namespace antlr4 {
+namespace dfa {
+
+
+const antlr_int32_t DFASnapshot::SNAPSHOT_MAGIC = 0x46443441; // "A4DF"
+const antlr_int32_t DFASnapshot::SNAPSHOT_VERSION = 2;
+
+namespace {
+
+// header words
+const size_t MAGIC_WORD = 0;
+const size_t VERSION_WORD = 1;
+const size_t ATN_CHECKSUM_WORD = 2;
+const size_t NUM_DFAS_WORD = 3;
+const size_t CHECKSUM_WORD = 4;
+const size_t HEADER_SIZE = 5;
+
+// words of a DFA before its arrays
+const size_t DFA_HEADER_SIZE = 5;
+
+antlr_int32_t checksumOf(const antlr_int32_t* words, size_t n)
+{
+    antlr_int32_t hash = MurmurHash::initialize();
+    for (size_t i = 0; i < n; i++) {
+        hash = MurmurHash::update(hash, words[i]);
+    }
+    return MurmurHash::finish(hash, static_cast<antlr_int32_t>(n));
+}
+
+template <typename T>
+void append(std::vector<antlr_int32_t>& out, const T* values, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        out.push_back(static_cast<antlr_int32_t>(values[i]));
+    }
+}
+
+size_t wordsForBytes(size_t n)
+{
+    return (n + sizeof(antlr_int32_t) - 1) / sizeof(antlr_int32_t);
+}
+
+/** Returns {@code true} if {@code target} is {@link FrozenDFA#NO_EDGE},
+ *  {@link FrozenDFA#ERROR_EDGE} or one of the {@code numStates} states.
+ */
+bool isValidTarget(antlr_int32_t target, antlr_uint32_t numStates)
+{
+    return target == FrozenDFA::NO_EDGE || target == FrozenDFA::ERROR_EDGE
+        || (target >= 0 && static_cast<antlr_uint32_t>(target) < numStates);
+}
+
+/** Returns {@code true} if every edge of {@code tables} leads somewhere
+ *  valid and each row of the overflow edges is in range and sorted, so
+ *  {@link FrozenDFA#getTarget} never reads outside the arrays.
+ */
+bool isValidTables(const FrozenDFA::Tables& tables, antlr_uint32_t numOverflow)
+{
+    antlr_uint32_t numStates = tables.numStates;
+    size_t numEdges = static_cast<size_t>(numStates) * tables.numColumns;
+    for (size_t i = 0; i < numEdges; i++) {
+        if ( !isValidTarget(tables.edges[i], numStates) ) return false;
+    }
+
+    if ( tables.overflowStart[numStates] != numOverflow ) {
+        return false;
+    }
+    for (antlr_uint32_t s = 0; s < numStates; s++) {
+        antlr_uint32_t begin = tables.overflowStart[s];
+        antlr_uint32_t end = tables.overflowStart[s + 1];
+        if ( begin > end ) return false;
+        for (antlr_uint32_t i = begin + 1; i < end; i++) {
+            if ( tables.overflowColumns[i - 1] >= tables.overflowColumns[i] ) return false;
+        }
+    }
+
+    for (antlr_uint32_t i = 0; i < numOverflow; i++) {
+        if ( !isValidTarget(tables.overflowTargets[i], numStates) ) return false;
+    }
+    return true;
+}
+
+/** Appends the arrays of {@code table}, dropping states with predicates */
+void writeDFA(std::vector<antlr_int32_t>& out, antlr_int32_t decision, const FrozenDFA& table)
+{
+    const FrozenDFA::Tables& tables = table.getTables();
+    antlr_uint32_t numStates = tables.numStates;
+    std::vector<bool> predicated(numStates);
+    for (antlr_uint32_t s = 0; s < numStates; s++) {
+        predicated[s] = table.getNumPredicates(s) > 0;
+    }
+    if ( predicated[tables.startState] ) {
+        return;
+    }
+
+    antlr_uint32_t numOverflow = tables.overflowStart[numStates];
+    out.push_back(decision);
+    out.push_back(tables.startState);
+    out.push_back(static_cast<antlr_int32_t>(numStates));
+    out.push_back(static_cast<antlr_int32_t>(tables.numColumns));
+    out.push_back(static_cast<antlr_int32_t>(numOverflow));
+
+    size_t numEdges = static_cast<size_t>(numStates) * tables.numColumns;
+    for (size_t i = 0; i < numEdges; i++) {
+        antlr_int32_t target = tables.edges[i];
+        out.push_back(target >= 0 && predicated[target] ? FrozenDFA::NO_EDGE : target);
+    }
+    append(out, tables.overflowStart, numStates + 1);
+    append(out, tables.overflowColumns, numOverflow);
+    for (antlr_uint32_t i = 0; i < numOverflow; i++) {
+        antlr_int32_t target = tables.overflowTargets[i];
+        out.push_back(target >= 0 && predicated[target] ? FrozenDFA::NO_EDGE : target);
+    }
+    append(out, tables.predictions, numStates);
+    append(out, tables.lexerRuleIndexes, numStates);
+    append(out, tables.lexerActionIndexes, numStates);
+
+    size_t flagsStart = out.size();
+    out.resize(flagsStart + wordsForBytes(numStates), 0);
+    std::copy(tables.flags, tables.flags + numStates, reinterpret_cast<unsigned char*>(&out[flagsStart]));
+}
+
+}
+
+DFASnapshot::DFASnapshot(const std::string& fileName)
+    :   fileName(fileName),
+        mapping(NULL),
+        mappingSize(0),
+        words(NULL),
+        numWords(0)
+{
+    load();
+    try {
+        parse();
+    }
+    catch (...) {
+        unload();
+        throw;
+    }
+}
+
+DFASnapshot::DFASnapshot(ANTLR_NOTNULL const antlr_int32_t* data, size_t length)
+    :   fileName("<memory>"),
+        mapping(NULL),
+        mappingSize(0),
+        words(data),
+        numWords(length)
+{
+    parse();
+}
+
+DFASnapshot::~DFASnapshot()
+{
+    unload();
+}
+
+void DFASnapshot::write(std::ostream& out, const std::vector<DFA*>& decisionToDFA,
+                        const antlr_uint32_t* serializedATN, size_t length)
+{
+    std::vector<antlr_int32_t> data(HEADER_SIZE);
+    antlr_int32_t numDFAs = 0;
+    for (std::vector<DFA*>::const_iterator it = decisionToDFA.begin(); it != decisionToDFA.end(); it++) {
+        const DFA* dfa = *it;
+        size_t before = data.size();
+        const FrozenDFA* frozen = dfa->getFrozen();
+        if ( frozen!=NULL ) {
+            writeDFA(data, dfa->decision, *frozen);
+        }
+        else {
+            antlr_auto_ptr<FrozenDFA> copy = dfa->toFrozen();
+            if ( copy.get()!=NULL ) {
+                writeDFA(data, dfa->decision, *copy);
+            }
+        }
+        if ( data.size()!=before ) {
+            numDFAs++;
+        }
+    }
+
+    data[MAGIC_WORD] = SNAPSHOT_MAGIC;
+    data[VERSION_WORD] = SNAPSHOT_VERSION;
+    data[ATN_CHECKSUM_WORD] = checksum(serializedATN, length);
+    data[NUM_DFAS_WORD] = numDFAs;
+    data[CHECKSUM_WORD] = checksumOf(&data[0] + HEADER_SIZE, data.size() - HEADER_SIZE);
+    out.write(reinterpret_cast<const char*>(&data[0]), data.size() * sizeof(antlr_int32_t));
+}
+
+antlr_int32_t DFASnapshot::checksum(const antlr_uint32_t* serializedATN, size_t length)
+{
+    return checksumOf(reinterpret_cast<const antlr_int32_t*>(serializedATN), length);
+}
+
+bool DFASnapshot::matches(const antlr_uint32_t* serializedATN, size_t length) const
+{
+    return words[ATN_CHECKSUM_WORD] == checksum(serializedATN, length);
+}
+
+antlr_uint32_t DFASnapshot::apply(std::vector<DFA*>& decisionToDFA,
+                                  const antlr_uint32_t* serializedATN, size_t length) const
+{
+    if ( !matches(serializedATN, length) ) {
+        return 0;
+    }
+
+    antlr_uint32_t applied = 0;
+    for (std::vector<Section>::const_iterator it = sections.begin(); it != sections.end(); it++) {
+        if ( static_cast<size_t>(it->decision) >= decisionToDFA.size() ) {
+            continue;
+        }
+
+        DFA* dfa = decisionToDFA[it->decision];
+        if ( dfa->isFrozen() ) {
+            continue;
+        }
+
+        antlr_auto_ptr<FrozenDFA> table(new FrozenDFA(it->tables));
+        dfa->setFrozen(table);
+        applied++;
+    }
+    return applied;
+}
+
+antlr_uint32_t DFASnapshot::size() const
+{
+    return static_cast<antlr_uint32_t>(sections.size());
+}
+
+const antlr_int32_t* DFASnapshot::take(size_t& offset, size_t n) const
+{
+    if ( n > numWords - offset ) {
+        throw std::runtime_error("truncated DFA snapshot " + fileName);
+    }
+    const antlr_int32_t* result = words + offset;
+    offset += n;
+    return result;
+}
+
+void DFASnapshot::parse()
+{
+    if ( numWords < HEADER_SIZE || words[MAGIC_WORD] != SNAPSHOT_MAGIC ) {
+        throw std::runtime_error("not a DFA snapshot: " + fileName);
+    }
+    if ( words[VERSION_WORD] != SNAPSHOT_VERSION ) {
+        throw std::runtime_error("unsupported DFA snapshot version in " + fileName);
+    }
+    if ( words[CHECKSUM_WORD] != checksumOf(words + HEADER_SIZE, numWords - HEADER_SIZE) ) {
+        throw std::runtime_error("corrupted DFA snapshot " + fileName);
+    }
+
+    size_t offset = HEADER_SIZE;
+    for (antlr_int32_t i = 0; i < words[NUM_DFAS_WORD]; i++) {
+        const antlr_int32_t* header = take(offset, DFA_HEADER_SIZE);
+        Section section;
+        section.decision = header[0];
+        FrozenDFA::Tables& tables = section.tables;
+        tables.startState = header[1];
+        tables.numStates = static_cast<antlr_uint32_t>(header[2]);
+        tables.numColumns = static_cast<antlr_uint32_t>(header[3]);
+        antlr_uint32_t numOverflow = static_cast<antlr_uint32_t>(header[4]);
+        if ( section.decision < 0 || tables.startState < 0
+                || static_cast<antlr_uint32_t>(tables.startState) >= tables.numStates ) {
+            throw std::runtime_error("corrupted DFA snapshot " + fileName);
+        }
+        if ( tables.numStates >= numWords
+                || (tables.numColumns != 0 && tables.numStates > numWords / tables.numColumns) ) {
+            throw std::runtime_error("truncated DFA snapshot " + fileName);
+        }
+
+        tables.edges = take(offset, static_cast<size_t>(tables.numStates) * tables.numColumns);
+        tables.overflowStart = reinterpret_cast<const antlr_uint32_t*>(take(offset, tables.numStates + 1));
+        tables.overflowColumns = take(offset, numOverflow);
+        tables.overflowTargets = take(offset, numOverflow);
+        tables.predictions = take(offset, tables.numStates);
+        tables.lexerRuleIndexes = take(offset, tables.numStates);
+        tables.lexerActionIndexes = take(offset, tables.numStates);
+        tables.flags = reinterpret_cast<const unsigned char*>(take(offset, wordsForBytes(tables.numStates)));
+        tables.predicateStart = NULL;
+        tables.predicates = NULL;
+        if ( !isValidTables(tables, numOverflow) ) {
+            throw std::runtime_error("corrupted DFA snapshot " + fileName);
+        }
+        sections.push_back(section);
+    }
+}
+
+#if defined(ANTLR_MMAP_POSIX)
+
+void DFASnapshot::load()
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open file " + fileName);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("cannot stat file " + fileName);
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+        void* view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("cannot map file " + fileName);
+        }
+        mapping = view;
+        mappingSize = size;
+    }
+    close(fd);
+
+    words = static_cast<const antlr_int32_t*>(mapping);
+    numWords = mappingSize / sizeof(antlr_int32_t);
+}
+
+void DFASnapshot::unload()
+{
+    if (mapping != NULL) {
+        munmap(mapping, mappingSize);
+        mapping = NULL;
+        mappingSize = 0;
+    }
+}
+
+#elif defined(ANTLR_MMAP_WIN32)
+
+void DFASnapshot::load()
+{
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("cannot open file " + fileName);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("cannot stat file " + fileName);
+    }
+
+    if (size.QuadPart > 0) {
+        HANDLE section = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        void* view = section != NULL ? MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (section != NULL) {
+            // the view keeps the section alive
+            CloseHandle(section);
+        }
+        if (view == NULL) {
+            CloseHandle(file);
+            throw std::runtime_error("cannot map file " + fileName);
+        }
+        mapping = view;
+        mappingSize = static_cast<size_t>(size.QuadPart);
+    }
+    CloseHandle(file);
+
+    words = static_cast<const antlr_int32_t*>(mapping);
+    numWords = mappingSize / sizeof(antlr_int32_t);
+}
+
+void DFASnapshot::unload()
+{
+    if (mapping != NULL) {
+        UnmapViewOfFile(mapping);
+        mapping = NULL;
+        mappingSize = 0;
+    }
+}
+
+#else
+
+void DFASnapshot::load()
+{
+    std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open file " + fileName);
+    }
+
+    in.seekg(0, std::ios::end);
+    size_t size = static_cast<size_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+    buffer.resize(size / sizeof(antlr_int32_t));
+    if (!buffer.empty()) {
+        in.read(reinterpret_cast<char*>(&buffer[0]), buffer.size() * sizeof(antlr_int32_t));
+    }
+
+    words = buffer.empty() ? NULL : &buffer[0];
+    numWords = buffer.size();
+}
+
+void DFASnapshot::unload()
+{
+}
+
+#endif
+
+
+} /* namespace dfa */
+} /* namespace antlr4 */
@@ -37,6 +37,7 @@
 #include <antlr/atn/SemanticContext.h>
 #include <antlr/misc/MurmurHash.h>
 #include <antlr/misc/Utils.h>
+#include <cassert>
 #include <sstream>
 
 namespace antlr4 {
@@ -49,19 +50,54 @@ DFAState::PredPrediction::PredPrediction(const SemanticContext* pred, antlr_int3
 {
 }
 
+DFAState::PredPrediction::~PredPrediction()
+{
+}
+
 std::string DFAState::PredPrediction::toString() const
 {
     return std::string("(")+Utils::stringValueOf(*pred)+", "+Utils::stringValueOf(alt)+ ")";
 }
 
+const antlr_int32_t DFAState::EDGE_PAGE_SHIFT = 8;
+const antlr_int32_t DFAState::EDGE_PAGE_SIZE = 1 << DFAState::EDGE_PAGE_SHIFT;
+const antlr_int32_t DFAState::NUM_EDGE_PAGES = 0x10000 >> DFAState::EDGE_PAGE_SHIFT;
+
+namespace {
+
+/** Allocates {@code n} null entries in {@code arena}, or on the heap */
+template <typename T>
+T* newTable(Arena* arena, size_t n)
+{
+    return arena!=NULL ? arena->newArray<T>(n) : new T[n];
+}
+
+}
+
 DFAState::~DFAState()
 {
+    // tables in the arena go away with it
+    if ( arena==NULL ) {
+        delete[] edges.load();
+        AtomicPointer<Edge>* pages = edgePages.load();
+        if ( pages!=NULL ) {
+            for (antlr_int32_t i = 0; i < NUM_EDGE_PAGES; i++) {
+                delete[] pages[i].load();
+            }
+            delete[] pages;
+        }
+    }
+    if ( predicates!=NULL ) {
+        for (antlr_uint32_t i = 0; i < numPredicates; i++) {
+            delete predicates[i];
+        }
+        delete[] predicates;
+    }
 }
 
 DFAState::DFAState()
     :   stateNumber(-1),
         configs(new ATNConfigSet()),
-        edges(NULL),
         numEdges(0),
         isAcceptState(false),
         prediction(0),
@@ -69,14 +105,14 @@ DFAState::DFAState()
         lexerActionIndex(-1),
         requiresFullContext(false),
         predicates(NULL),
-        numPredicates(0)
+        numPredicates(0),
+        arena(NULL)
 {
 }
 
 DFAState::DFAState(antlr_int32_t stateNumber)
     :   stateNumber(stateNumber),
         configs(new ATNConfigSet()),
-        edges(NULL),
         numEdges(0),
         isAcceptState(false),
         prediction(0),
@@ -84,13 +120,13 @@ DFAState::DFAState(antlr_int32_t stateNumber)
         lexerActionIndex(-1),
         requiresFullContext(false),
         predicates(NULL),
-        numPredicates(0)
+        numPredicates(0),
+        arena(NULL)
 {
 }
 
 DFAState::DFAState(ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& configs)
     :   stateNumber(-1),
-        edges(NULL),
         numEdges(0),
         isAcceptState(false),
         prediction(0),
@@ -98,11 +134,30 @@ DFAState::DFAState(ANTLR_NOTNULL antlr_auto_ptr<ATNConfigSet>& configs)
         lexerActionIndex(-1),
         requiresFullContext(false),
         predicates(NULL),
-        numPredicates(0)
+        numPredicates(0),
+        arena(NULL)
 {
     this->configs.reset(configs.release());
 }
 
+DFAState::DFAState(ANTLR_NOTNULL DFAState& proposed, ANTLR_NULLABLE Arena* arena)
+    :   stateNumber(proposed.stateNumber),
+        numEdges(0),
+        isAcceptState(proposed.isAcceptState),
+        prediction(proposed.prediction),
+        lexerRuleIndex(proposed.lexerRuleIndex),
+        lexerActionIndex(proposed.lexerActionIndex),
+        requiresFullContext(proposed.requiresFullContext),
+        predicates(proposed.predicates),
+        numPredicates(proposed.numPredicates),
+        arena(arena)
+{
+    assert(proposed.edges.load()==NULL && proposed.edgePages.load()==NULL);
+    this->configs.reset(proposed.configs.release());
+    proposed.predicates = NULL;
+    proposed.numPredicates = 0;
+}
+
 /** Get the set of all alts mentioned by all ATN configurations in this
  *  DFA state.
  */
@@ -110,8 +165,8 @@ antlr_auto_ptr< HashSet<antlr_int32_t> > DFAState::getAltSet() const
 {
     antlr_auto_ptr< HashSet<antlr_int32_t> > alts(new HashSet<antlr_int32_t>());
     if ( configs.get()!=NULL ) {
-        const std::vector<ATNConfig>& items = configs->elements();
-        for (std::vector<ATNConfig>::const_iterator it = items.begin(); it != items.end(); it++) {
+        const ATNConfigSet::ConfigList& items = configs->elements();
+        for (ATNConfigSet::ConfigList::const_iterator it = items.begin(); it != items.end(); it++) {
             alts->add(it->alt);
         }
     }
@@ -119,6 +174,54 @@ antlr_auto_ptr< HashSet<antlr_int32_t> > DFAState::getAltSet() const
     return alts;
 }
 
+ANTLR_NULLABLE
+const DFAState* DFAState::getEdge(antlr_int32_t i) const
+{
+    const Edge* table = edges.load();
+    if ( table==NULL || static_cast<antlr_uint32_t>(i) >= numEdges ) {
+        return NULL;
+    }
+    return table[i].load();
+}
+
+void DFAState::setEdge(antlr_int32_t i, antlr_uint32_t numEdges, ANTLR_NOTNULL const DFAState* target)
+{
+    Edge* table = edges.load();
+    if ( table==NULL ) {
+        table = newTable<Edge>(arena, numEdges);
+        this->numEdges = numEdges;
+        edges.store(table);
+    }
+    table[i].store(target);
+}
+
+ANTLR_NULLABLE
+const DFAState* DFAState::getPagedEdge(antlr_int32_t symbol) const
+{
+    const AtomicPointer<Edge>* pages = edgePages.load();
+    if ( pages==NULL ) {
+        return NULL;
+    }
+    const Edge* page = pages[symbol >> EDGE_PAGE_SHIFT].load();
+    return page!=NULL ? page[symbol & (EDGE_PAGE_SIZE - 1)].load() : NULL;
+}
+
+void DFAState::setPagedEdge(antlr_int32_t symbol, ANTLR_NOTNULL const DFAState* target)
+{
+    AtomicPointer<Edge>* pages = edgePages.load();
+    if ( pages==NULL ) {
+        pages = newTable< AtomicPointer<Edge> >(arena, NUM_EDGE_PAGES);
+        edgePages.store(pages);
+    }
+    AtomicPointer<Edge>& slot = pages[symbol >> EDGE_PAGE_SHIFT];
+    Edge* page = slot.load();
+    if ( page==NULL ) {
+        page = newTable<Edge>(arena, EDGE_PAGE_SIZE);
+        slot.store(page);
+    }
+    page[symbol & (EDGE_PAGE_SIZE - 1)].store(target);
+}
+
 antlr_int32_t DFAState::hashCode() const
 {
     antlr_int32_t hash = MurmurHash::initialize(7);
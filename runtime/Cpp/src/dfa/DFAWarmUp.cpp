@@ -0,0 +1,100 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <antlr/dfa/DFAWarmUp.h>
+#include <antlr/ANTLRFileStream.h>
+#include <antlr/dfa/DFASnapshot.h>
+#include <fstream>
+#include <stdexcept>
+
+namespace antlr4 {
+namespace dfa {
+
+
+DFAWarmUp::DFAWarmUp()
+{
+}
+
+DFAWarmUp::~DFAWarmUp()
+{
+}
+
+void DFAWarmUp::addRecognizer(const std::string& recognizerName, std::vector<DFA*>& decisionToDFA,
+                              const antlr_uint32_t* serializedATN, size_t length)
+{
+    Recognizer recognizer;
+    recognizer.name = recognizerName;
+    recognizer.decisionToDFA = &decisionToDFA;
+    recognizer.serializedATN = serializedATN;
+    recognizer.length = length;
+    recognizers.push_back(recognizer);
+}
+
+void DFAWarmUp::run(const std::vector<std::string>& corpus)
+{
+    for (std::vector<std::string>::const_iterator it = corpus.begin(); it != corpus.end(); it++) {
+        ANTLRFileStream input(*it);
+        recognize(&input);
+    }
+}
+
+std::vector<std::string> DFAWarmUp::write(const std::string& directory) const
+{
+    std::vector<std::string> fileNames;
+    for (std::vector<Recognizer>::const_iterator it = recognizers.begin(); it != recognizers.end(); it++) {
+        std::string fileName = it->name + ".dfa";
+        if ( !directory.empty() ) {
+            fileName = directory + "/" + fileName;
+        }
+
+        std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if ( !out ) {
+            throw std::runtime_error("cannot open file " + fileName);
+        }
+
+        DFASnapshot::write(out, *it->decisionToDFA, it->serializedATN, it->length);
+        out.close();
+        if ( !out ) {
+            throw std::runtime_error("cannot write file " + fileName);
+        }
+
+        fileNames.push_back(fileName);
+    }
+    return fileNames;
+}
+
+
+} /* namespace dfa */
+} /* namespace antlr4 */
@@ -0,0 +1,273 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <antlr/dfa/FrozenDFA.h>
+#include <antlr/IntStream.h>
+#include <antlr/Lexer.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ATNConfigSet.h>
+#include <antlr/atn/ATNSimulator.h>
+#include <antlr/atn/ATNState.h>
+#include <antlr/atn/Transition.h>
+#include <algorithm>
+#include <cassert>
+
+namespace antlr4 {
+namespace dfa {
+
+
+const antlr_int32_t FrozenDFA::NO_EDGE;
+const antlr_int32_t FrozenDFA::ERROR_EDGE;
+
+namespace {
+
+template <typename T>
+const T* dataOf(const std::vector<T>& v)
+{
+    return v.empty() ? NULL : &v[0];
+}
+
+template <typename T>
+size_t bytesOf(const std::vector<T>& v)
+{
+    return v.capacity() * sizeof(T);
+}
+
+}
+
+FrozenDFA::FrozenDFA(const ATN& atn, const std::vector<const DFAState*>& states, ANTLR_NOTNULL const DFAState* s0)
+{
+    antlr_uint32_t numStates = static_cast<antlr_uint32_t>(states.size());
+    antlr_uint32_t numColumns = 0;
+    for (std::vector<const DFAState*>::const_iterator it = states.begin(); it != states.end(); it++) {
+        if ( (*it)->edges.load()!=NULL ) {
+            numColumns = std::max(numColumns, (*it)->numEdges);
+        }
+    }
+
+    edges.assign(static_cast<size_t>(numStates) * numColumns, NO_EDGE);
+    overflowStart.reserve(numStates + 1);
+    predicateStart.reserve(numStates + 1);
+    flags.reserve(numStates);
+    predictions.reserve(numStates);
+    lexerRuleIndexes.reserve(numStates);
+    lexerActionIndexes.reserve(numStates);
+    for (antlr_uint32_t s = 0; s < numStates; s++) {
+        const DFAState* state = states[s];
+        assert(state->stateNumber == static_cast<antlr_int32_t>(s));
+
+        const DFAState::Edge* table = state->edges.load();
+        if ( table!=NULL ) {
+            antlr_int32_t* row = &edges[static_cast<size_t>(s) * numColumns];
+            for (antlr_uint32_t i = 0; i < state->numEdges; i++) {
+                row[i] = targetOf(table[i].load());
+            }
+        }
+
+        overflowStart.push_back(static_cast<antlr_uint32_t>(overflowColumns.size()));
+        const AtomicPointer<DFAState::Edge>* pages = state->edgePages.load();
+        if ( pages!=NULL ) {
+            for (antlr_int32_t p = 0; p < DFAState::NUM_EDGE_PAGES; p++) {
+                const DFAState::Edge* page = pages[p].load();
+                if ( page==NULL ) continue;
+                for (antlr_int32_t i = 0; i < DFAState::EDGE_PAGE_SIZE; i++) {
+                    const DFAState* target = page[i].load();
+                    if ( target!=NULL ) {
+                        overflowColumns.push_back((p << DFAState::EDGE_PAGE_SHIFT) + i);
+                        overflowTargets.push_back(targetOf(target));
+                    }
+                }
+            }
+        }
+
+        unsigned char f = 0;
+        if ( state->isAcceptState ) f |= ACCEPT;
+        if ( state->requiresFullContext ) f |= REQUIRES_FULL_CONTEXT;
+        if ( hasEOFTransition(atn, state) ) f |= MATCHES_EOF;
+        flags.push_back(f);
+        predictions.push_back(state->prediction);
+        lexerRuleIndexes.push_back(state->lexerRuleIndex);
+        lexerActionIndexes.push_back(state->lexerActionIndex);
+
+        predicateStart.push_back(static_cast<antlr_uint32_t>(predicates.size()));
+        if ( state->predicates!=NULL ) {
+            for (antlr_uint32_t i = 0; i < state->numPredicates; i++) {
+                predicates.push_back(*state->predicates[i]);
+            }
+        }
+    }
+    overflowStart.push_back(static_cast<antlr_uint32_t>(overflowColumns.size()));
+    predicateStart.push_back(static_cast<antlr_uint32_t>(predicates.size()));
+
+    tables.startState = s0->stateNumber;
+    tables.numStates = numStates;
+    tables.numColumns = numColumns;
+    tables.edges = dataOf(edges);
+    tables.overflowStart = dataOf(overflowStart);
+    tables.overflowColumns = dataOf(overflowColumns);
+    tables.overflowTargets = dataOf(overflowTargets);
+    tables.flags = dataOf(flags);
+    tables.predictions = dataOf(predictions);
+    tables.lexerRuleIndexes = dataOf(lexerRuleIndexes);
+    tables.lexerActionIndexes = dataOf(lexerActionIndexes);
+    if ( predicates.empty() ) {
+        std::vector<antlr_uint32_t>().swap(predicateStart);
+    }
+    tables.predicateStart = dataOf(predicateStart);
+    tables.predicates = dataOf(predicates);
+}
+
+FrozenDFA::FrozenDFA(const Tables& tables)
+    :   tables(tables)
+{
+}
+
+antlr_int32_t FrozenDFA::targetOf(ANTLR_NULLABLE const DFAState* target)
+{
+    if ( target==NULL ) return NO_EDGE;
+    if ( target==ATNSimulator::ERROR ) return ERROR_EDGE;
+    return target->stateNumber;
+}
+
+bool FrozenDFA::hasEOFTransition(const ATN& atn, ANTLR_NOTNULL const DFAState* state)
+{
+    if ( state->configs.get()==NULL ) return false;
+    const ATNConfigSet::ConfigList& configs = state->configs->elements();
+    for (ATNConfigSet::ConfigList::const_iterator it = configs.begin(); it != configs.end(); it++) {
+        const ATNState* p = atn.states[it->stateNumber];
+        for (antlr_int32_t i = 0; i < p->getNumberOfTransitions(); i++) {
+            if ( p->transition(i)->matches(IntStream::EOF_, Lexer::MIN_CHAR_VALUE, Lexer::MAX_CHAR_VALUE) ) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+const FrozenDFA::Tables& FrozenDFA::getTables() const
+{
+    return tables;
+}
+
+antlr_int32_t FrozenDFA::getStartState() const
+{
+    return tables.startState;
+}
+
+antlr_int32_t FrozenDFA::getTarget(antlr_int32_t state, antlr_int32_t column) const
+{
+    if ( static_cast<antlr_uint32_t>(column) < tables.numColumns ) {
+        return tables.edges[static_cast<size_t>(state) * tables.numColumns + column];
+    }
+
+    const antlr_int32_t* begin = tables.overflowColumns + tables.overflowStart[state];
+    const antlr_int32_t* end = tables.overflowColumns + tables.overflowStart[state + 1];
+    const antlr_int32_t* it = std::lower_bound(begin, end, column);
+    if ( it==end || *it!=column ) {
+        return NO_EDGE;
+    }
+
+    return tables.overflowTargets[it - tables.overflowColumns];
+}
+
+bool FrozenDFA::isAcceptState(antlr_int32_t state) const
+{
+    return (tables.flags[state] & ACCEPT) != 0;
+}
+
+bool FrozenDFA::requiresFullContext(antlr_int32_t state) const
+{
+    return (tables.flags[state] & REQUIRES_FULL_CONTEXT) != 0;
+}
+
+bool FrozenDFA::matchesEOF(antlr_int32_t state) const
+{
+    return (tables.flags[state] & MATCHES_EOF) != 0;
+}
+
+antlr_int32_t FrozenDFA::getPrediction(antlr_int32_t state) const
+{
+    return tables.predictions[state];
+}
+
+antlr_int32_t FrozenDFA::getLexerRuleIndex(antlr_int32_t state) const
+{
+    return tables.lexerRuleIndexes[state];
+}
+
+antlr_int32_t FrozenDFA::getLexerActionIndex(antlr_int32_t state) const
+{
+    return tables.lexerActionIndexes[state];
+}
+
+antlr_uint32_t FrozenDFA::getNumPredicates(antlr_int32_t state) const
+{
+    if ( tables.predicateStart==NULL ) return 0;
+    return tables.predicateStart[state + 1] - tables.predicateStart[state];
+}
+
+const DFAState::PredPrediction& FrozenDFA::getPredicate(antlr_int32_t state, antlr_uint32_t i) const
+{
+    return tables.predicates[tables.predicateStart[state] + i];
+}
+
+antlr_uint32_t FrozenDFA::getNumStates() const
+{
+    return tables.numStates;
+}
+
+antlr_uint32_t FrozenDFA::getNumColumns() const
+{
+    return tables.numColumns;
+}
+
+size_t FrozenDFA::getBytesUsed() const
+{
+    return sizeof(*this)
+        + bytesOf(edges)
+        + bytesOf(overflowStart)
+        + bytesOf(overflowColumns)
+        + bytesOf(overflowTargets)
+        + bytesOf(flags)
+        + bytesOf(predictions)
+        + bytesOf(lexerRuleIndexes)
+        + bytesOf(lexerActionIndexes)
+        + bytesOf(predicateStart)
+        + bytesOf(predicates);
+}
+
+
+} /* namespace dfa */
+} /* namespace antlr4 */
@@ -34,6 +34,7 @@
  */
 
 #include <antlr/dfa/LexerDFASerializer.h>
+#include <iomanip>
 #include <sstream>
 
 namespace antlr4 {
@@ -45,10 +46,14 @@ LexerDFASerializer::LexerDFASerializer(ANTLR_NOTNULL const DFA* dfa)
 {
 }
 
-std::string LexerDFASerializer::getEdgeLabel(antlr_uint32_t i)
+std::string LexerDFASerializer::getEdgeLabel(antlr_uint32_t i) const
 {
     std::stringstream buf;
-    buf << "'" << static_cast<char>(i) << "'";
+    if (i < 0x80) {
+        buf << "'" << static_cast<char>(i) << "'";
+    } else {
+        buf << "'\\u" << std::hex << std::setw(4) << std::setfill('0') << i << "'";
+    }
     return buf.str();
 }
 
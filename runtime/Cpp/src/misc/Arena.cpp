@@ -0,0 +1,162 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <antlr/misc/Arena.h>
+#include <cassert>
+#include <cstdlib>
+
+namespace antlr4 {
+namespace misc {
+
+
+const size_t Arena::DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+const size_t Arena::DEFAULT_ALIGNMENT = 2 * sizeof(void*);
+
+Arena::~Arena()
+{
+    freeBlocks(blocks);
+    freeBlocks(largeBlocks);
+}
+
+Arena::Arena()
+    :   blockSize(DEFAULT_BLOCK_SIZE),
+        blocks(NULL),
+        largeBlocks(NULL),
+        cursor(NULL),
+        limit(NULL),
+        bytesAllocated(0),
+        bytesReserved(0)
+{
+}
+
+Arena::Arena(size_t blockSize)
+    :   blockSize(blockSize),
+        blocks(NULL),
+        largeBlocks(NULL),
+        cursor(NULL),
+        limit(NULL),
+        bytesAllocated(0),
+        bytesReserved(0)
+{
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    if (size == 0) {
+        size = 1;
+    }
+    bytesAllocated += size;
+
+    if (size > blockSize / 4) {
+        size_t header = (sizeof(Block) + alignment - 1) & ~(alignment - 1);
+        Block* block = static_cast<Block*>(malloc(header + size));
+        if (block == NULL) {
+            throw std::bad_alloc();
+        }
+        block->size = header + size;
+        block->next = largeBlocks;
+        largeBlocks = block;
+        bytesReserved += block->size;
+        return reinterpret_cast<char*>(block) + header;
+    }
+
+    size_t misalignment = reinterpret_cast<size_t>(cursor) & (alignment - 1);
+    char* p = cursor + (misalignment == 0 ? 0 : alignment - misalignment);
+    if (cursor == NULL || p + size > limit) {
+        newBlock(blockSize);
+        misalignment = reinterpret_cast<size_t>(cursor) & (alignment - 1);
+        p = cursor + (misalignment == 0 ? 0 : alignment - misalignment);
+    }
+    cursor = p + size;
+    return p;
+}
+
+void Arena::reset()
+{
+    freeBlocks(largeBlocks);
+    largeBlocks = NULL;
+    bytesReserved = 0;
+    bytesAllocated = 0;
+    cursor = NULL;
+    limit = NULL;
+    if (blocks == NULL) {
+        return;
+    }
+
+    freeBlocks(blocks->next);
+    blocks->next = NULL;
+    bytesReserved = blocks->size;
+    cursor = reinterpret_cast<char*>(blocks + 1);
+    limit = reinterpret_cast<char*>(blocks) + blocks->size;
+}
+
+size_t Arena::getBytesAllocated() const
+{
+    return bytesAllocated;
+}
+
+size_t Arena::getBytesReserved() const
+{
+    return bytesReserved;
+}
+
+void Arena::newBlock(size_t size)
+{
+    Block* block = static_cast<Block*>(malloc(sizeof(Block) + size));
+    if (block == NULL) {
+        throw std::bad_alloc();
+    }
+    block->size = sizeof(Block) + size;
+    block->next = blocks;
+    blocks = block;
+    bytesReserved += block->size;
+    cursor = reinterpret_cast<char*>(block + 1);
+    limit = reinterpret_cast<char*>(block) + block->size;
+}
+
+void Arena::freeBlocks(Block* block)
+{
+    while (block != NULL) {
+        Block* next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+
+} /* namespace misc */
+} /* namespace antlr4 */
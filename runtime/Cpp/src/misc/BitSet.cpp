@@ -0,0 +1,213 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <antlr/misc/BitSet.h>
+#include <antlr/misc/MurmurHash.h>
+#include <sstream>
+#include <stdexcept>
+
+namespace antlr4 {
+namespace misc {
+
+
+const antlr_int32_t BitSet::BITS_PER_WORD = 32;
+
+BitSet::BitSet()
+{
+}
+
+BitSet::BitSet(ANTLR_NOTNULL const BitSet& other)
+    :   Key<BitSet>(),
+        words(other.words)
+{
+}
+
+BitSet& BitSet::operator=(const BitSet& other)
+{
+    words = other.words;
+    return *this;
+}
+
+void BitSet::set(antlr_int32_t bitIndex)
+{
+    if (bitIndex < 0) {
+        throw std::out_of_range("BitSet::set negative index");
+    }
+    antlr_uint32_t word = static_cast<antlr_uint32_t>(bitIndex / BITS_PER_WORD);
+    if (word >= words.size()) {
+        words.resize(word + 1, 0);
+    }
+    words[word] |= 1u << (bitIndex % BITS_PER_WORD);
+}
+
+void BitSet::clear(antlr_int32_t bitIndex)
+{
+    if (bitIndex < 0) {
+        throw std::out_of_range("BitSet::clear negative index");
+    }
+    antlr_uint32_t word = static_cast<antlr_uint32_t>(bitIndex / BITS_PER_WORD);
+    if (word < words.size()) {
+        words[word] &= ~(1u << (bitIndex % BITS_PER_WORD));
+    }
+}
+
+void BitSet::clear()
+{
+    words.clear();
+}
+
+bool BitSet::get(antlr_int32_t bitIndex) const
+{
+    if (bitIndex < 0) {
+        throw std::out_of_range("BitSet::get negative index");
+    }
+    antlr_uint32_t word = static_cast<antlr_uint32_t>(bitIndex / BITS_PER_WORD);
+    return word < words.size() && (words[word] & (1u << (bitIndex % BITS_PER_WORD))) != 0;
+}
+
+antlr_int32_t BitSet::cardinality() const
+{
+    antlr_int32_t count = 0;
+    for (std::vector<antlr_uint32_t>::const_iterator it = words.begin(); it != words.end(); it++) {
+        for (antlr_uint32_t w = *it; w != 0; w &= w - 1) {
+            count++;
+        }
+    }
+    return count;
+}
+
+antlr_int32_t BitSet::nextSetBit(antlr_int32_t fromIndex) const
+{
+    if (fromIndex < 0) {
+        throw std::out_of_range("BitSet::nextSetBit negative index");
+    }
+    antlr_uint32_t word = static_cast<antlr_uint32_t>(fromIndex / BITS_PER_WORD);
+    if (word >= words.size()) {
+        return -1;
+    }
+    antlr_uint32_t w = words[word] & (~0u << (fromIndex % BITS_PER_WORD));
+    while (true) {
+        if (w != 0) {
+            antlr_int32_t bit = 0;
+            while ((w & 1u) == 0) {
+                w >>= 1;
+                bit++;
+            }
+            return static_cast<antlr_int32_t>(word) * BITS_PER_WORD + bit;
+        }
+        if (++word == words.size()) {
+            return -1;
+        }
+        w = words[word];
+    }
+}
+
+bool BitSet::isEmpty() const
+{
+    return wordsInUse() == 0;
+}
+
+void BitSet::or_(const BitSet& other)
+{
+    if (words.size() < other.words.size()) {
+        words.resize(other.words.size(), 0);
+    }
+    for (antlr_uint32_t i = 0; i < other.words.size(); i++) {
+        words[i] |= other.words[i];
+    }
+}
+
+bool BitSet::equals(const Key<BitSet>* o) const
+{
+    const BitSet* other = dynamic_cast<const BitSet*>(o);
+    if (other == NULL) {
+        return false;
+    }
+    antlr_uint32_t n = wordsInUse();
+    if (n != other->wordsInUse()) {
+        return false;
+    }
+    for (antlr_uint32_t i = 0; i < n; i++) {
+        if (words[i] != other->words[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+BitSet* BitSet::clone() const
+{
+    return new BitSet(*this);
+}
+
+antlr_int32_t BitSet::hashCode() const
+{
+    antlr_uint32_t n = wordsInUse();
+    antlr_int32_t hash = MurmurHash::initialize();
+    for (antlr_uint32_t i = 0; i < n; i++) {
+        hash = MurmurHash::update(hash, static_cast<antlr_int32_t>(words[i]));
+    }
+    return MurmurHash::finish(hash, static_cast<antlr_int32_t>(n));
+}
+
+std::string BitSet::toString() const
+{
+    std::stringstream buf;
+    buf << "{";
+    bool first = true;
+    for (antlr_int32_t i = nextSetBit(0); i >= 0; i = nextSetBit(i + 1)) {
+        if (!first) {
+            buf << ", ";
+        }
+        first = false;
+        buf << i;
+    }
+    buf << "}";
+    return buf.str();
+}
+
+antlr_uint32_t BitSet::wordsInUse() const
+{
+    antlr_uint32_t n = static_cast<antlr_uint32_t>(words.size());
+    while (n > 0 && words[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
+
+} /* namespace misc */
+} /* namespace antlr4 */
@@ -37,6 +37,8 @@
 #include <antlr/misc/MurmurHash.h>
 #include <antlr/Lexer.h>
 #include <antlr/Token.h>
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
@@ -48,6 +50,10 @@ namespace misc {
 const IntervalSet IntervalSet::COMPLETE_CHAR_SET = IntervalSet::of(0, Lexer::MAX_CHAR_VALUE);
 const IntervalSet IntervalSet::EMPTY_SET = IntervalSet();
 
+const antlr_int32_t IntervalSet::ASCII_BITMAP_SIZE;
+const antlr_int32_t IntervalSet::BMP_BITMAP_SIZE;
+const antlr_uint32_t IntervalSet::BMP_BITMAP_MIN_INTERVALS;
+
 IntervalSet::IntervalSet(const std::list<Interval>& intervals)
     :   intervals(intervals.begin(), intervals.end()),
         readonly(false)
@@ -58,8 +64,10 @@ IntervalSet::IntervalSet(const IntervalSet& set)
     :   Key<IntSet>(),
         IntSet(),
         intervals(set.intervals),
-        readonly(set.readonly)
+        readonly(set.readonly),
+        bmpBits(set.bmpBits)
 {
+    std::copy(set.asciiBits, set.asciiBits + ASCII_BITMAP_SIZE / 32, asciiBits);
 }
 
 IntervalSet::IntervalSet(const IntervalSet* set)
@@ -181,10 +189,64 @@ void IntervalSet::add(const Interval& addition)
 
 /** combine all sets in the array returned the or'd value */
 IntervalSet IntervalSet::or_(const std::vector<IntervalSet>& sets)
+{
+    // min-heap of the next unmerged interval start of each set
+    typedef std::pair<antlr_int32_t, antlr_uint32_t> Head;
+    std::vector<Head> heads;
+    std::vector<antlr_uint32_t> next(sets.size(), 0);
+    size_t total = 0;
+    for (antlr_uint32_t i = 0; i < sets.size(); i++) {
+        if ( !sets[i].intervals.empty() ) {
+            heads.push_back(Head(sets[i].intervals[0].a, i));
+            total += sets[i].intervals.size();
+        }
+    }
+    std::make_heap(heads.begin(), heads.end(), std::greater<Head>());
+
+    IntervalSet r;
+    r.intervals.reserve(total);
+    while ( !heads.empty() ) {
+        std::pop_heap(heads.begin(), heads.end(), std::greater<Head>());
+        antlr_uint32_t i = heads.back().second;
+        const std::vector<Interval>& intervals = sets[i].intervals;
+        const Interval& I = intervals[next[i]++];
+        append(r.intervals, I.a, I.b);
+        if ( next[i] < intervals.size() ) {
+            heads.back().first = intervals[next[i]].a;
+            std::push_heap(heads.begin(), heads.end(), std::greater<Head>());
+        }
+        else {
+            heads.pop_back();
+        }
+    }
+    return r;
+}
+
+IntervalSet IntervalSet::or_(const IntervalSet& other) const
+{
+    IntervalSet r;
+    orIntervals(intervals, other.intervals, r.intervals);
+    return r;
+}
+
+IntervalSet IntervalSet::and_(const IntervalSet& other) const
+{
+    IntervalSet r;
+    andIntervals(intervals, other.intervals, r.intervals);
+    return r;
+}
+
+IntervalSet IntervalSet::subtract(const IntervalSet& other) const
 {
     IntervalSet r;
-    for (std::vector<IntervalSet>::const_iterator it; it != sets.end(); it++)
-        r.addAll(&(*it));
+    subtractIntervals(intervals, other.intervals, r.intervals);
+    return r;
+}
+
+IntervalSet IntervalSet::complement(const IntervalSet& vocabulary) const
+{
+    IntervalSet r;
+    complementIntervals(intervals, vocabulary.intervals, r.intervals);
     return r;
 }
 
@@ -200,12 +262,14 @@ IntervalSet* IntervalSet::addAll(const IntSet* set)
                 typeid(*set).name()+
                 ") to IntervalSet");
     }
-    // walk set and add each interval
-    antlr_uint32_t n = other->intervals.size();
-    for (antlr_uint32_t i = 0; i < n; i++) {
-        const Interval& I = other->intervals[i];
-        this->add(I.a,I.b);
+    if ( other->intervals.empty() ) {
+        return this;
     }
+    if ( readonly ) throw std::logic_error("can't alter readonly IntervalSet");
+    // merge both lists rather than adding each interval in turn
+    std::vector<Interval> merged;
+    orIntervals(intervals, other->intervals, merged);
+    intervals.swap(merged);
     return this;
 }
 
@@ -232,53 +296,30 @@ IntervalSet* IntervalSet::complement(const IntSet* vocabulary) const
             "can't complement with non IntervalSet (")+
             typeid(*vocabulary).name()+")");
     }
-    antlr_int32_t maxElement = vocabularyIS->getMaxElement();
-
     antlr_auto_ptr<IntervalSet> comp(new IntervalSet());
-    antlr_uint32_t n = intervals.size();
-    if ( n ==0 ) {
-        return comp.release();
-    }
-    const Interval& first = intervals[0];
-    // add a range from 0 to first.a constrained to vocab
-    if ( first.a > 0 ) {
-        IntervalSet s = IntervalSet::of(0, first.a-1);
-        antlr_auto_ptr<IntervalSet> a(s.and_(vocabularyIS));
-        comp->addAll(a.get());
-    }
-    for (antlr_uint32_t i=1; i<n; i++) { // from 2nd interval .. nth
-        const Interval& previous = intervals[i-1];
-        const Interval& current = intervals[i];
-        IntervalSet s = IntervalSet::of(previous.b+1, current.a-1);
-        antlr_auto_ptr<IntervalSet> a(s.and_(vocabularyIS));
-        comp->addAll(a.get());
-    }
-    const Interval& last = intervals[n -1];
-    // add a range from last.b to maxElement constrained to vocab
-    if ( last.b < maxElement ) {
-        IntervalSet s = IntervalSet::of(last.b+1, maxElement);
-        antlr_auto_ptr<IntervalSet> a(s.and_(vocabularyIS));
-        comp->addAll(a.get());
-    }
+    complementIntervals(intervals, vocabularyIS->intervals, comp->intervals);
     return comp.release();
 }
 
-/** Compute this-other via this&~other.
+/** Compute this-other.
  *  Return a new set containing all elements in this but not in other.
- *  other is assumed to be a subset of this;
- *  anything that is in other but not in this will be ignored.
+ *  Anything that is in other but not in this will be ignored.
  */
 IntervalSet* IntervalSet::subtract(const IntSet* other) const
 {
-    // assume the whole unicode range here for the complement
-    // because it doesn't matter.  Anything beyond the max of this' set
-    // will be ignored since we are doing this & ~other.  The intersection
-    // will be empty.  The only problem would be when this' set max value
-    // goes beyond MAX_CHAR_VALUE, but hopefully the constant MAX_CHAR_VALUE
-    // will prevent this.
-    antlr_auto_ptr<IntervalSet> comp(
-        dynamic_cast<const IntervalSet*>(other)->complement(&COMPLETE_CHAR_SET));
-    return this->and_(comp.get());
+    antlr_auto_ptr<IntervalSet> r(new IntervalSet());
+    if ( other==NULL ) {
+        r->intervals = intervals;
+        return r.release();
+    }
+    const IntervalSet* otherIS = dynamic_cast<const IntervalSet*>(other);
+    if ( !otherIS ) {
+        throw std::invalid_argument(std::string(
+            "can't subtract non IntervalSet (")+
+            typeid(*other).name()+")");
+    }
+    subtractIntervals(intervals, otherIS->intervals, r->intervals);
+    return r.release();
 }
 
 IntervalSet* IntervalSet::or_(const IntSet* a) const
@@ -300,85 +341,156 @@ IntervalSet* IntervalSet::and_(const IntSet* other) const
         return NULL; // nothing in common with null set
     }
 
-    const std::vector<Interval>& myIntervals = this->intervals;
-    const std::vector<Interval>& theirIntervals = dynamic_cast<const IntervalSet*>(other)->intervals;
-    antlr_auto_ptr<IntervalSet> intersection;
-    antlr_uint32_t mySize = myIntervals.size();
-    antlr_uint32_t theirSize = theirIntervals.size();
+    antlr_auto_ptr<IntervalSet> intersection(new IntervalSet());
+    andIntervals(intervals, dynamic_cast<const IntervalSet*>(other)->intervals, intersection->intervals);
+    return intersection.release();
+}
+
+void IntervalSet::orIntervals(const std::vector<Interval>& left,
+                              const std::vector<Interval>& right,
+                              std::vector<Interval>& result)
+{
+    result.reserve(result.size() + left.size() + right.size());
+    antlr_uint32_t n = left.size();
+    antlr_uint32_t m = right.size();
     antlr_uint32_t i = 0;
     antlr_uint32_t j = 0;
-    // iterate down both interval lists looking for nondisjoint intervals
-    while ( i<mySize && j<theirSize ) {
-        const Interval& mine = myIntervals[i];
-        const Interval& theirs = theirIntervals[j];
-        //System.out.println("mine="+mine+" and theirs="+theirs);
-        if ( mine.startsBeforeDisjoint(theirs) ) {
-            // move this iterator looking for interval that might overlap
-            i++;
-        }
-        else if ( theirs.startsBeforeDisjoint(mine) ) {
-            // move other iterator looking for interval that might overlap
-            j++;
-        }
-        else if ( mine.properlyContains(theirs) ) {
-            // overlap, add intersection, get next theirs
-            if ( intersection.get()==NULL ) {
-                intersection.reset(new IntervalSet());
-            }
-            intersection->add(mine.intersection(theirs));
-            j++;
+    while ( i<n || j<m ) {
+        const Interval& I = (j>=m || (i<n && left[i].a <= right[j].a)) ? left[i++] : right[j++];
+        append(result, I.a, I.b);
+    }
+}
+
+void IntervalSet::andIntervals(const std::vector<Interval>& left,
+                               const std::vector<Interval>& right,
+                               std::vector<Interval>& result)
+{
+    antlr_uint32_t n = left.size();
+    antlr_uint32_t m = right.size();
+    antlr_uint32_t i = 0;
+    antlr_uint32_t j = 0;
+    while ( i<n && j<m ) {
+        const Interval& mine = left[i];
+        const Interval& theirs = right[j];
+        if ( mine.b < theirs.a ) {
+            i = skipBefore(left, i+1, theirs.a);
         }
-        else if ( theirs.properlyContains(mine) ) {
-            // overlap, add intersection, get next mine
-            if ( intersection.get()==NULL) {
-                intersection.reset(new IntervalSet());
-            }
-            intersection->add(mine.intersection(theirs));
-            i++;
+        else if ( theirs.b < mine.a ) {
+            j = skipBefore(right, j+1, mine.a);
         }
-        else if ( !mine.disjoint(theirs) ) {
-            // overlap, add intersection
-            if ( intersection.get()==NULL ) {
-                intersection.reset(new IntervalSet());
+        else {
+            // both lists are disjoint and non-adjacent, so are the
+            // intersections of their intervals
+            result.push_back(Interval(std::max(mine.a, theirs.a), std::min(mine.b, theirs.b)));
+            if ( mine.b < theirs.b ) {
+                i++;
             }
-            intersection->add(mine.intersection(theirs));
-            // Move the iterator of lower range [a..b], but not
-            // the upper range as it may contain elements that will collide
-            // with the next iterator. So, if mine=[0..115] and
-            // theirs=[115..200], then intersection is 115 and move mine
-            // but not theirs as theirs may collide with the next range
-            // in thisIter.
-            // move both iterators to next ranges
-            if ( mine.startsAfterNonDisjoint(theirs) ) {
+            else {
                 j++;
             }
-            else if ( theirs.startsAfterNonDisjoint(mine) ) {
-                i++;
+        }
+    }
+}
+
+void IntervalSet::subtractIntervals(const std::vector<Interval>& left,
+                                    const std::vector<Interval>& right,
+                                    std::vector<Interval>& result)
+{
+    antlr_uint32_t m = right.size();
+    antlr_uint32_t j = 0;
+    for (std::vector<Interval>::const_iterator mine = left.begin(); mine != left.end(); mine++) {
+        antlr_int32_t a = mine->a;
+        bool covered = false;
+        // punch out every interval of right overlapping a..mine.b
+        for (j = skipBefore(right, j, a); j<m && right[j].a <= mine->b; j++) {
+            const Interval& theirs = right[j];
+            if ( theirs.a > a ) {
+                result.push_back(Interval(a, theirs.a - 1));
+            }
+            if ( theirs.b >= mine->b ) {
+                covered = true; // theirs may overlap the next of mine too
+                break;
             }
+            a = theirs.b + 1;
+        }
+        if ( !covered ) {
+            result.push_back(Interval(a, mine->b));
         }
     }
-    if ( intersection.get()==NULL) {
-        return new IntervalSet();
+}
+
+void IntervalSet::complementIntervals(const std::vector<Interval>& intervals,
+                                      const std::vector<Interval>& vocabulary,
+                                      std::vector<Interval>& result)
+{
+    if ( intervals.empty() ) {
+        return;
     }
-    return intersection.release();
+    subtractIntervals(vocabulary, intervals, result);
+    // only the elements from 0 up are candidates
+    std::vector<Interval>::iterator first = result.begin();
+    while ( first != result.end() && first->b < 0 ) {
+        first++;
+    }
+    result.erase(result.begin(), first);
+    if ( !result.empty() && result.front().a < 0 ) {
+        result.front().a = 0;
+    }
+}
+
+void IntervalSet::append(std::vector<Interval>& result, antlr_int32_t a, antlr_int32_t b)
+{
+    if ( !result.empty() ) {
+        Interval& last = result.back();
+        if ( a <= last.b || a - 1 == last.b ) {
+            last.b = std::max(last.b, b);
+            return;
+        }
+    }
+    result.push_back(Interval(a, b));
+}
+
+antlr_uint32_t IntervalSet::skipBefore(const std::vector<Interval>& intervals,
+                                       antlr_uint32_t i,
+                                       antlr_int32_t el)
+{
+    antlr_uint32_t n = intervals.size();
+    if ( i>=n || intervals[i].b >= el ) {
+        return i;
+    }
+    // gallop until overshooting, then binary search the last step
+    antlr_uint32_t lo = i;
+    antlr_uint32_t step = 1;
+    while ( lo+step < n && intervals[lo+step].b < el ) {
+        lo += step;
+        step <<= 1;
+    }
+    antlr_uint32_t hi = std::min(lo+step, n);
+    while ( hi-lo > 1 ) {
+        antlr_uint32_t mid = lo + (hi-lo)/2;
+        if ( intervals[mid].b < el ) {
+            lo = mid;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return hi;
 }
 
 /** Is el in any range of this set? */
 bool IntervalSet::contains(antlr_int32_t el) const
 {
-    antlr_uint32_t n = intervals.size();
-    for (antlr_uint32_t i = 0; i < n; i++) {
-        const Interval& I = intervals[i];
-        antlr_int32_t a = I.a;
-        antlr_int32_t b = I.b;
-        if ( el<a ) {
-            break; // list is sorted and el is before this interval; not here
+    antlr_uint32_t c = static_cast<antlr_uint32_t>(el);
+    if ( readonly ) {
+        if ( c < static_cast<antlr_uint32_t>(ASCII_BITMAP_SIZE) ) {
+            return (asciiBits[c >> 5] >> (c & 31)) & 1;
         }
-        if ( el>=a && el<=b ) {
-            return true; // found in this interval
+        if ( c < static_cast<antlr_uint32_t>(BMP_BITMAP_SIZE) && !bmpBits.empty() ) {
+            return (bmpBits[c >> 5] >> (c & 31)) & 1;
         }
     }
-    return false;
+    return search(el);
     /*
     for (ListIterator iter = intervals.listIterator(); iter.hasNext();) {
         Interval I = (Interval) iter.next();
@@ -684,8 +796,67 @@ bool IntervalSet::isReadonly() const
 
 void IntervalSet::setReadonly(bool readonly)
 {
+    if ( readonly && !this->readonly ) {
+        buildBitmaps();
+    }
+    else if ( !readonly ) {
+        std::vector<antlr_uint32_t>().swap(bmpBits);
+    }
     this->readonly = readonly;
 }
 
+bool IntervalSet::hasBmpBitmap() const
+{
+    return !bmpBits.empty();
+}
+
+static void setBits(antlr_uint32_t* bits, antlr_int32_t a, antlr_int32_t b)
+{
+    for (antlr_int32_t c = a; c <= b; c++) {
+        bits[c >> 5] |= 1u << (c & 31);
+    }
+}
+
+void IntervalSet::buildBitmaps()
+{
+    std::fill(asciiBits, asciiBits + ASCII_BITMAP_SIZE / 32, 0);
+    bool aboveAscii = false;
+    for (std::vector<Interval>::const_iterator it = intervals.begin(); it != intervals.end(); it++) {
+        if ( it->a < ASCII_BITMAP_SIZE && it->b >= 0 ) {
+            setBits(asciiBits, std::max(it->a, 0), std::min(it->b, ASCII_BITMAP_SIZE - 1));
+        }
+        if ( it->b >= ASCII_BITMAP_SIZE && it->a < BMP_BITMAP_SIZE ) {
+            aboveAscii = true;
+        }
+    }
+
+    bmpBits.clear();
+    if ( !aboveAscii || intervals.size() < BMP_BITMAP_MIN_INTERVALS ) {
+        return;
+    }
+    bmpBits.assign(BMP_BITMAP_SIZE / 32, 0);
+    for (std::vector<Interval>::const_iterator it = intervals.begin(); it != intervals.end(); it++) {
+        if ( it->a < BMP_BITMAP_SIZE && it->b >= 0 ) {
+            setBits(&bmpBits[0], std::max(it->a, 0), std::min(it->b, BMP_BITMAP_SIZE - 1));
+        }
+    }
+}
+
+bool IntervalSet::search(antlr_int32_t el) const
+{
+    antlr_uint32_t n = intervals.size();
+    if ( n==0 ) {
+        return false;
+    }
+    // narrow down to the last interval starting at or before el
+    const Interval* base = &intervals[0];
+    while ( n > 1 ) {
+        antlr_uint32_t half = n / 2;
+        base = base[half].a <= el ? base + half : base;
+        n -= half;
+    }
+    return el >= base->a && el <= base->b;
+}
+
 } /* namespace misc */
 } /* namespace antlr4 */
@@ -0,0 +1,86 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <antlr/misc/TextView.h>
+#include <cstring>
+
+namespace antlr4 {
+namespace misc {
+
+
+TextView::TextView()
+    :   text(NULL), length(0)
+{
+}
+
+TextView::TextView(const char* data, size_t length)
+    :   text(data), length(data != NULL ? length : 0)
+{
+}
+
+std::string TextView::str() const
+{
+    if (text == NULL) {
+        return std::string();
+    }
+    return std::string(text, length);
+}
+
+bool TextView::operator==(const TextView& other) const
+{
+    return length == other.length
+        && (length == 0 || std::memcmp(text, other.text, length) == 0);
+}
+
+bool TextView::operator!=(const TextView& other) const
+{
+    return !(*this == other);
+}
+
+bool TextView::operator==(const std::string& other) const
+{
+    return length == other.size()
+        && (length == 0 || std::memcmp(text, other.data(), length) == 0);
+}
+
+bool TextView::operator!=(const std::string& other) const
+{
+    return !(*this == other);
+}
+
+
+} /* namespace misc */
+} /* namespace antlr4 */
@@ -0,0 +1,293 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <BaseTest.h>
+#include <antlr/ANTLRFileStream.h>
+#include <antlr/ANTLRInputStream.h>
+#include <antlr/IntStream.h>
+#include <antlr/misc/Interval.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace antlr4;
+using namespace antlr4::misc;
+
+namespace {
+
+/** Appends the UTF-8 encoding of {@code c} to {@code s} */
+void appendUtf8(std::string& s, antlr_int32_t c)
+{
+    if (c < 0x80) {
+        s += static_cast<char>(c);
+    } else if (c < 0x800) {
+        s += static_cast<char>(0xC0 | (c >> 6));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        s += static_cast<char>(0xE0 | (c >> 12));
+        s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    } else {
+        s += static_cast<char>(0xF0 | (c >> 18));
+        s += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    }
+}
+
+/** Code points spanning several offset index intervals with encodings of
+ *  every length
+ */
+std::vector<antlr_int32_t> mixedCodePoints()
+{
+    static const antlr_int32_t samples[] = { 'a', 0x00E9, 0x4E00, 0x1F600, '\n', 0x07FF, 0xFFFD };
+    std::vector<antlr_int32_t> codePoints;
+    for (antlr_int32_t i = 0; i < 5 * ANTLRInputStream::INDEX_INTERVAL + 17; i++) {
+        codePoints.push_back(samples[i % 7] + (i % 7 == 0 ? i % 26 : 0));
+    }
+    return codePoints;
+}
+
+std::string encode(const std::vector<antlr_int32_t>& codePoints)
+{
+    std::string s;
+    for (size_t i = 0; i < codePoints.size(); i++) {
+        appendUtf8(s, codePoints[i]);
+    }
+    return s;
+}
+
+/** Exposes how far the offset index has been built */
+class TestStream : public ANTLRInputStream
+{
+public:
+
+    TestStream(const std::string& input)
+        :   ANTLRInputStream(input)
+    {
+    }
+
+    size_t checkpointCount() const
+    {
+        return checkpoints.size();
+    }
+};
+
+} /* anonymous namespace */
+
+class TestANTLRInputStream : public BaseTest {};
+
+TEST_F(TestANTLRInputStream, testConsumeAscii)
+{
+    ANTLRInputStream input("ab");
+    EXPECT_EQ(0, input.index());
+    EXPECT_EQ('a', input.LA(1));
+    EXPECT_EQ('b', input.LA(2));
+    EXPECT_EQ(IntStream::EOF_, input.LA(3));
+    EXPECT_EQ(IntStream::EOF_, input.LA(-1));
+    input.consume();
+    EXPECT_EQ(1, input.index());
+    EXPECT_EQ('b', input.LA(1));
+    EXPECT_EQ('a', input.LA(-1));
+    input.consume();
+    EXPECT_EQ(IntStream::EOF_, input.LA(1));
+    EXPECT_THROW(input.consume(), std::logic_error);
+    EXPECT_EQ(2, input.size());
+    EXPECT_EQ(IntStream::UNKNOWN_SOURCE_NAME, input.getSourceName());
+}
+
+TEST_F(TestANTLRInputStream, testDecodeMultiByte)
+{
+    std::vector<antlr_int32_t> codePoints;
+    codePoints.push_back('x');
+    codePoints.push_back(0x00E9);
+    codePoints.push_back(0x4E00);
+    codePoints.push_back(0x1F600);
+    std::string text = encode(codePoints);
+    ANTLRInputStream input(text.data(), text.size());
+
+    EXPECT_EQ(4, input.size());
+    for (size_t i = 0; i < codePoints.size(); i++) {
+        EXPECT_EQ(codePoints[i], input.LA(static_cast<antlr_int32_t>(i) + 1));
+    }
+    input.consume();
+    input.consume();
+    input.consume();
+    EXPECT_EQ(0x1F600, input.LA(1));
+    EXPECT_EQ(0x4E00, input.LA(-1));
+    EXPECT_EQ(0x00E9, input.LA(-2));
+    EXPECT_EQ("\xC3\xA9\xE4\xB8\x80", input.getText(Interval(1, 2)));
+    EXPECT_EQ(text, input.getText(Interval(0, 3)));
+    EXPECT_EQ("", input.getText(Interval(2, 1)));
+}
+
+TEST_F(TestANTLRInputStream, testMalformedInput)
+{
+    // truncated sequence, stray continuation byte, surrogate, overlong encoding
+    std::string text("\xE4\xB8" "a" "\x80" "\xED\xA0\x80" "\xC0\xAF", 9);
+    ANTLRInputStream input(text);
+
+    std::vector<antlr_int32_t> decoded;
+    while (input.LA(1) != IntStream::EOF_) {
+        decoded.push_back(input.LA(1));
+        input.consume();
+    }
+
+    ASSERT_EQ(9u, decoded.size());
+    EXPECT_EQ(0xFFFD, decoded[0]);
+    EXPECT_EQ(0xFFFD, decoded[1]);
+    EXPECT_EQ('a', decoded[2]);
+    for (size_t i = 3; i < decoded.size(); i++) {
+        EXPECT_EQ(0xFFFD, decoded[i]);
+    }
+}
+
+TEST_F(TestANTLRInputStream, testSeek)
+{
+    std::vector<antlr_int32_t> codePoints = mixedCodePoints();
+    std::string text = encode(codePoints);
+    ANTLRInputStream input(text);
+    antlr_int32_t n = static_cast<antlr_int32_t>(codePoints.size());
+
+    // far jumps in both directions before the end of the input is known
+    static const antlr_int32_t targets[] = { 3000, 5, 4100, 1023, 1024, 2049, 0, 5000 };
+    for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+        input.seek(targets[i]);
+        EXPECT_EQ(targets[i], input.index());
+        EXPECT_EQ(codePoints[targets[i]], input.LA(1));
+        if (targets[i] > 0) {
+            EXPECT_EQ(codePoints[targets[i] - 1], input.LA(-1));
+        }
+    }
+
+    // short moves
+    input.seek(10);
+    input.seek(30);
+    EXPECT_EQ(codePoints[30], input.LA(1));
+    input.seek(29);
+    EXPECT_EQ(codePoints[29], input.LA(1));
+
+    // past the end
+    input.seek(n + 5000);
+    EXPECT_EQ(n, input.index());
+    EXPECT_EQ(IntStream::EOF_, input.LA(1));
+    EXPECT_EQ(n, input.size());
+    EXPECT_EQ(codePoints[n - 1], input.LA(-1));
+
+    // reading sequentially after seeking back agrees with the input
+    input.seek(2040);
+    for (antlr_int32_t i = 2040; i < n; i++) {
+        ASSERT_EQ(codePoints[i], input.LA(1));
+        input.consume();
+    }
+    EXPECT_EQ(IntStream::EOF_, input.LA(1));
+
+    std::string expected;
+    for (antlr_int32_t i = 1020; i <= 1030; i++) {
+        appendUtf8(expected, codePoints[i]);
+    }
+    EXPECT_EQ(expected, input.getText(Interval(1020, 1030)));
+}
+
+TEST_F(TestANTLRInputStream, testGetTextView)
+{
+    std::vector<antlr_int32_t> codePoints = mixedCodePoints();
+    std::string text = encode(codePoints);
+    TestStream input(text);
+    antlr_int32_t n = static_cast<antlr_int32_t>(codePoints.size());
+
+    // text near the start does not decode the rest of the input
+    std::string expected;
+    for (antlr_int32_t i = 5; i <= 9; i++) {
+        appendUtf8(expected, codePoints[i]);
+    }
+    EXPECT_EQ(expected, input.getTextView(Interval(5, 9)).str());
+    EXPECT_EQ(1U, input.checkpointCount());
+
+    // intervals running past the end are clipped to the input
+    expected.clear();
+    appendUtf8(expected, codePoints[n - 2]);
+    appendUtf8(expected, codePoints[n - 1]);
+    EXPECT_EQ(expected, input.getText(Interval(n - 2, n + 10)));
+    EXPECT_EQ(expected, input.getText(Interval(n - 2, ANTLR_INT32_MAX)));
+    EXPECT_EQ("", input.getText(Interval(n + 3, n + 5)));
+    EXPECT_EQ("", input.getText(Interval(4, 3)));
+}
+
+TEST_F(TestANTLRInputStream, testEmptyInput)
+{
+    ANTLRInputStream input("");
+    EXPECT_EQ(0, input.size());
+    EXPECT_EQ(IntStream::EOF_, input.LA(1));
+    input.seek(3);
+    EXPECT_EQ(0, input.index());
+}
+
+TEST_F(TestANTLRInputStream, testFileStream)
+{
+    std::vector<antlr_int32_t> codePoints = mixedCodePoints();
+    std::string text = encode(codePoints);
+    const std::string fileName = "TestANTLRFileStream.txt";
+    {
+        std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary);
+        out << text;
+    }
+
+    {
+        ANTLRFileStream input(fileName);
+        EXPECT_EQ(fileName, input.getSourceName());
+        EXPECT_EQ(static_cast<antlr_int32_t>(codePoints.size()), input.size());
+        input.seek(4097);
+        EXPECT_EQ(codePoints[4097], input.LA(1));
+        input.consume();
+        EXPECT_EQ(codePoints[4098], input.LA(1));
+    }
+
+    {
+        std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+
+    {
+        ANTLRFileStream input(fileName);
+        EXPECT_EQ(0, input.size());
+        EXPECT_EQ(IntStream::EOF_, input.LA(1));
+    }
+
+    std::remove(fileName.c_str());
+    EXPECT_THROW(ANTLRFileStream input(fileName), std::runtime_error);
+}
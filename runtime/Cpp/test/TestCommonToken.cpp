@@ -0,0 +1,132 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <BaseTest.h>
+#include <antlr/ANTLRInputStream.h>
+#include <antlr/CommonToken.h>
+#include <antlr/Token.h>
+#include <antlr/misc/Interval.h>
+#include <antlr/misc/TextView.h>
+#include <stdexcept>
+#include <string>
+
+using namespace antlr4;
+using namespace antlr4::misc;
+
+class TestCommonToken : public BaseTest {};
+
+TEST_F(TestCommonToken, testLayout)
+{
+    // vtable, source, text override and 24 bytes of packed fields
+    EXPECT_LE(sizeof(CommonToken), 3 * sizeof(void*) + 24);
+}
+
+TEST_F(TestCommonToken, testTextFromInput)
+{
+    ANTLRInputStream input("x = \xC3\xA9t\xC3\xA9;");
+    CommonToken::Source source(NULL, &input);
+    CommonToken token(&source, 5, Token::DEFAULT_CHANNEL, 4, 6);
+    EXPECT_EQ(&input, token.getInputStream());
+    EXPECT_EQ(NULL, token.getTokenSource());
+    EXPECT_EQ("\xC3\xA9t\xC3\xA9", token.getText());
+
+    TextView view = token.getTextView();
+    EXPECT_TRUE(view == "\xC3\xA9t\xC3\xA9");
+    EXPECT_EQ(input.getTextView(Interval::of(4, 6)).data(), view.data());
+    EXPECT_EQ(input.getTextView(Interval::of(0, 0)).data() + 4, view.data());
+
+    CommonToken eof(&source, Token::EOF_, Token::DEFAULT_CHANNEL, 8, 7);
+    EXPECT_EQ(Token::EOF_, eof.getType());
+    EXPECT_EQ("<EOF>", eof.getText());
+    EXPECT_TRUE(eof.getTextView() == "<EOF>");
+}
+
+TEST_F(TestCommonToken, testExplicitText)
+{
+    ANTLRInputStream input("abc");
+    CommonToken::Source source(NULL, &input);
+    CommonToken token(&source, 1, Token::DEFAULT_CHANNEL, 0, 2);
+    token.setText("xyz");
+    EXPECT_EQ("xyz", token.getText());
+    EXPECT_TRUE(token.getTextView() == "xyz");
+
+    CommonToken conjured(3, "<missing>");
+    EXPECT_EQ(&CommonToken::EMPTY_SOURCE, conjured.getSource());
+    EXPECT_EQ(NULL, conjured.getInputStream());
+    EXPECT_EQ("<missing>", conjured.getText());
+
+    CommonToken empty(3);
+    EXPECT_EQ("", empty.getText());
+    EXPECT_EQ(NULL, empty.getTextView().data());
+}
+
+TEST_F(TestCommonToken, testCopy)
+{
+    ANTLRInputStream input("abc def");
+    CommonToken::Source source(NULL, &input);
+    CommonToken token(&source, 2, Token::HIDDEN_CHANNEL, 4, 6);
+    token.setLine(1);
+    token.setCharPositionInLine(4);
+    token.setTokenIndex(2);
+
+    CommonToken copy(token);
+    EXPECT_EQ(&source, copy.getSource());
+    EXPECT_EQ("def", copy.getText());
+    EXPECT_EQ(token.toString(), copy.toString());
+    EXPECT_EQ("[@2,4:6='def',<2>,channel=1,1:4]", copy.toString());
+
+    copy.setText("a\tb");
+    EXPECT_EQ("def", token.getText());
+    token = copy;
+    EXPECT_EQ("a\tb", token.getText());
+    EXPECT_EQ("[@2,4:6='a\\tb',<2>,channel=1,1:4]", token.toString());
+}
+
+TEST_F(TestCommonToken, testPackedRanges)
+{
+    CommonToken token(CommonToken::MAX_TOKEN_TYPE);
+    EXPECT_EQ(CommonToken::MAX_TOKEN_TYPE, token.getType());
+    token.setType(Token::EOF_);
+    EXPECT_EQ(Token::EOF_, token.getType());
+    EXPECT_THROW(token.setType(CommonToken::MAX_TOKEN_TYPE + 1), std::invalid_argument);
+    EXPECT_THROW(token.setType(Token::EPSILON), std::invalid_argument);
+
+    token.setChannel(CommonToken::MAX_CHANNEL);
+    EXPECT_EQ(CommonToken::MAX_CHANNEL, token.getChannel());
+    token.setChannel(CommonToken::MIN_CHANNEL);
+    EXPECT_EQ(CommonToken::MIN_CHANNEL, token.getChannel());
+    EXPECT_THROW(token.setChannel(CommonToken::MAX_CHANNEL + 1), std::invalid_argument);
+}
@@ -0,0 +1,326 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <BaseTest.h>
+#include <antlr/ANTLRInputStream.h>
+#include <antlr/BufferedTokenStream.h>
+#include <antlr/CommonToken.h>
+#include <antlr/CommonTokenStream.h>
+#include <antlr/Token.h>
+#include <antlr/TokenSource.h>
+#include <antlr/misc/Interval.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace antlr4;
+using namespace antlr4::misc;
+
+namespace {
+
+const antlr_int32_t WORD = 1;
+const antlr_int32_t WS = 2;
+
+/** Splits its input into words and hidden runs of spaces. Words spelled
+ *  "ID" get their text replaced with "id". When {@code batched}, tokens
+ *  are also produced in batches.
+ */
+class WordSource : public TokenSource
+{
+public:
+
+    explicit WordSource(const std::string& text, bool batched = false)
+        :   input(text), source(this, &input), fetched(0), calls(0), batched(batched)
+    {
+    }
+
+    antlr_auto_ptr<Token> nextToken()
+    {
+        calls++;
+        antlr_auto_ptr<Token> token(new CommonToken(lex()));
+        return token;
+    }
+
+    antlr_int32_t nextTokens(CommonToken* buffer, antlr_int32_t maxCount)
+    {
+        if (!batched) {
+            return TokenSource::nextTokens(buffer, maxCount);
+        }
+
+        calls++;
+        antlr_int32_t count = 0;
+        while (count < maxCount) {
+            buffer[count] = lex();
+            if (buffer[count++].getType() == Token::EOF_) {
+                break;
+            }
+        }
+        return count;
+    }
+
+    CommonToken lex()
+    {
+        fetched++;
+        antlr_int32_t start = input.index();
+        antlr_int32_t c = input.LA(1);
+        if (c == IntStream::EOF_) {
+            return CommonToken(&source, Token::EOF_, Token::DEFAULT_CHANNEL, start, start - 1);
+        }
+
+        bool space = c == ' ';
+        while (c != IntStream::EOF_ && (c == ' ') == space) {
+            input.consume();
+            c = input.LA(1);
+        }
+
+        CommonToken t(&source, space ? WS : WORD, space ? Token::HIDDEN_CHANNEL : Token::DEFAULT_CHANNEL,
+                      start, input.index() - 1);
+        t.setLine(1);
+        t.setCharPositionInLine(start);
+        if (t.getText() == "ID") {
+            t.setText("id");
+        }
+        return t;
+    }
+
+    antlr_int32_t getLine() const
+    {
+        return 1;
+    }
+
+    antlr_int32_t getCharPositionInLine() const
+    {
+        return 0;
+    }
+
+    CharStream* getInputStream()
+    {
+        return &input;
+    }
+
+    std::string getSourceName()
+    {
+        return "words";
+    }
+
+public:
+
+    ANTLRInputStream input;
+    CommonToken::Source source;
+    antlr_int32_t fetched;
+    antlr_int32_t calls;
+    bool batched;
+};
+
+} /* anonymous namespace */
+
+class TestCommonTokenStream : public BaseTest {};
+
+TEST_F(TestCommonTokenStream, testBufferedLookahead)
+{
+    WordSource source("a bc  d");
+    BufferedTokenStream tokens(&source);
+    EXPECT_EQ(0, source.fetched);
+    EXPECT_EQ(WORD, tokens.LA(1));
+    EXPECT_EQ(WS, tokens.LA(2));
+    EXPECT_EQ(WORD, tokens.LA(3));
+    EXPECT_EQ(Token::EOF_, tokens.LA(6));
+    EXPECT_EQ(Token::EOF_, tokens.LA(10));
+
+    const Token* t = tokens.LT(3);
+    EXPECT_EQ("bc", t->getText());
+    EXPECT_EQ(2, t->getTokenIndex());
+    EXPECT_EQ(2, t->getStartIndex());
+    EXPECT_EQ(3, t->getStopIndex());
+    EXPECT_EQ(2, t->getCharPositionInLine());
+    EXPECT_EQ(&source, t->getTokenSource());
+    EXPECT_EQ(t, tokens.get(2));
+
+    tokens.consume();
+    tokens.consume();
+    EXPECT_EQ(2, tokens.index());
+    EXPECT_EQ(WS, tokens.LA(-1));
+    EXPECT_EQ("bc", tokens.LT(1)->getText());
+    EXPECT_EQ("a bc  d", tokens.getText());
+    EXPECT_EQ("bc  d", tokens.getText(Interval::of(2, 10)));
+    EXPECT_EQ(6, tokens.size());
+    EXPECT_THROW(tokens.get(6), std::out_of_range);
+    EXPECT_EQ("words", tokens.getSourceName());
+}
+
+TEST_F(TestCommonTokenStream, testSkipsOffChannelTokens)
+{
+    WordSource source(" a bc  d ");
+    CommonTokenStream tokens(&source);
+    EXPECT_EQ(WORD, tokens.LA(1));
+    EXPECT_EQ(1, tokens.index());
+    EXPECT_EQ("a", tokens.LT(1)->getText());
+    EXPECT_EQ("bc", tokens.LT(2)->getText());
+    EXPECT_EQ("d", tokens.LT(3)->getText());
+    EXPECT_EQ(Token::EOF_, tokens.LA(4));
+    EXPECT_EQ(NULL, tokens.LT(-1));
+
+    tokens.consume();
+    EXPECT_EQ(3, tokens.index());
+    EXPECT_EQ("a", tokens.LT(-1)->getText());
+    tokens.consume();
+    tokens.consume();
+    EXPECT_EQ(Token::EOF_, tokens.LA(1));
+    EXPECT_EQ("d", tokens.LT(-1)->getText());
+    EXPECT_THROW(tokens.consume(), std::logic_error);
+
+    tokens.seek(0);
+    EXPECT_EQ(1, tokens.index());
+    tokens.seek(100);
+    EXPECT_EQ(Token::EOF_, tokens.LA(1));
+    EXPECT_EQ(4, tokens.getNumberOfOnChannelTokens());
+}
+
+TEST_F(TestCommonTokenStream, testKeepsTokensWithText)
+{
+    WordSource source("x ID y");
+    CommonTokenStream tokens(&source);
+    tokens.fill();
+    EXPECT_EQ("id", tokens.LT(2)->getText());
+    EXPECT_EQ(2, tokens.LT(2)->getTokenIndex());
+    EXPECT_EQ("x id y", tokens.getText());
+    EXPECT_EQ("ID", source.input.getText(Interval::of(2, 3)));
+}
+
+TEST_F(TestCommonTokenStream, testManyChunks)
+{
+    std::string text;
+    for (antlr_int32_t i = 0; i < 3000; i++) {
+        text += i % 2 == 0 ? "w " : "ww ";
+    }
+    WordSource source(text);
+    CommonTokenStream tokens(&source);
+    antlr_int32_t words = 0;
+    while (tokens.LA(1) != Token::EOF_) {
+        EXPECT_EQ(WORD, tokens.LA(1));
+        if (words % 997 == 0) {
+            const Token* t = tokens.LT(1);
+            EXPECT_EQ(words % 2 == 0 ? "w" : "ww", t->getText());
+            EXPECT_EQ(2 * words, t->getTokenIndex());
+        }
+        tokens.consume();
+        words++;
+    }
+    EXPECT_EQ(3000, words);
+    EXPECT_EQ(6001, tokens.size());
+    EXPECT_EQ(text, tokens.getText());
+}
+
+TEST_F(TestCommonTokenStream, testOnChannelIndex)
+{
+    std::string text;
+    antlr_uint32_t seed = 7;
+    for (antlr_int32_t i = 0; i < 400; i++) {
+        seed = seed * 1103515245 + 12345;
+        text += (seed >> 16) % 3 == 0 ? "w" : "w ";
+        if ((seed >> 20) % 5 == 0) {
+            text += " w";
+        }
+    }
+
+    for (antlr_int32_t channel = Token::DEFAULT_CHANNEL; channel <= Token::HIDDEN_CHANNEL; channel++) {
+        WordSource all(text);
+        BufferedTokenStream reference(&all);
+        reference.fill();
+        std::vector<antlr_int32_t> expected;
+        for (antlr_int32_t i = 0; i < reference.size(); i++) {
+            if (reference.get(i)->getChannel() == channel || reference.LA(i + 1) == Token::EOF_) {
+                expected.push_back(i);
+            }
+        }
+
+        WordSource source(text);
+        CommonTokenStream tokens(&source, channel);
+        tokens.LA(1);
+        for (size_t j = 0; j < expected.size(); j++) {
+            EXPECT_EQ(expected[j], tokens.index());
+            for (antlr_int32_t k = 1; k <= 3; k++) {
+                size_t ahead = j + k - 1 < expected.size() ? j + k - 1 : expected.size() - 1;
+                EXPECT_EQ(expected[ahead], tokens.LT(k)->getTokenIndex());
+                EXPECT_EQ(reference.get(expected[ahead])->getType(), tokens.LA(k));
+                if (j >= static_cast<size_t>(k)) {
+                    EXPECT_EQ(expected[j - k], tokens.LT(-k)->getTokenIndex());
+                } else {
+                    EXPECT_EQ(NULL, tokens.LT(-k));
+                }
+            }
+            if (tokens.LA(1) != Token::EOF_) {
+                tokens.consume();
+            }
+        }
+
+        for (antlr_int32_t i = 0; i < reference.size(); i += 7) {
+            tokens.seek(i);
+            std::vector<antlr_int32_t>::const_iterator it = std::lower_bound(expected.begin(), expected.end(), i);
+            EXPECT_EQ(*it, tokens.index());
+        }
+        EXPECT_EQ(static_cast<antlr_int32_t>(expected.size()) - (channel == Token::DEFAULT_CHANNEL ? 0 : 1),
+                  tokens.getNumberOfOnChannelTokens());
+    }
+}
+
+TEST_F(TestCommonTokenStream, testBatchedSource)
+{
+    std::string text;
+    for (antlr_int32_t i = 0; i < 100; i++) {
+        text += i % 10 == 0 ? "ID " : "w ";
+    }
+
+    WordSource source(text, true);
+    CommonTokenStream tokens(&source);
+    EXPECT_EQ(WORD, tokens.LA(1));
+    EXPECT_EQ(WORD, tokens.LA(2));
+    EXPECT_EQ(3, source.fetched); // fetching stays on demand
+    tokens.fill();
+    EXPECT_EQ(201, tokens.size());
+    EXPECT_LT(source.calls, 10);
+    EXPECT_EQ("id", tokens.LT(1)->getText());
+    EXPECT_EQ(0, tokens.LT(1)->getTokenIndex());
+    EXPECT_EQ("w", tokens.LT(2)->getText());
+    EXPECT_EQ(2, tokens.LT(2)->getTokenIndex());
+    EXPECT_EQ(100, tokens.getNumberOfOnChannelTokens() - 1);
+
+    WordSource single(text);
+    CommonTokenStream reference(&single);
+    EXPECT_EQ(reference.getText(), tokens.getText());
+    EXPECT_EQ(201, single.calls);
+}
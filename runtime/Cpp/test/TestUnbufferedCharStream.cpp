@@ -0,0 +1,236 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <BaseTest.h>
+#include <antlr/ANTLRInputStream.h>
+#include <antlr/IntStream.h>
+#include <antlr/UnbufferedCharStream.h>
+#include <antlr/misc/Interval.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace antlr4;
+using namespace antlr4::misc;
+
+namespace {
+
+/** Exposes the ring buffer size */
+class TestStream : public UnbufferedCharStream
+{
+public:
+
+    TestStream(std::istream& input, size_t bufferSize)
+        :   UnbufferedCharStream(input, bufferSize)
+    {
+    }
+
+    size_t getRingSize() const
+    {
+        return data.size();
+    }
+};
+
+/** Hands out its chunks one per {@code underflow()}, like a pipe or
+ *  terminal delivering input as it arrives; only the current chunk is
+ *  available without waiting.
+ */
+class ChunkedBuffer : public std::streambuf
+{
+public:
+
+    ChunkedBuffer(const std::vector<std::string>& chunks)
+        :   chunks(chunks),
+            reads(0)
+    {
+    }
+
+    /** Number of times the reader had to wait for a chunk */
+    size_t getReads() const
+    {
+        return reads;
+    }
+
+protected:
+
+    int_type underflow()
+    {
+        if (reads >= chunks.size()) {
+            reads++;
+            return traits_type::eof();
+        }
+        std::string& chunk = chunks[reads++];
+        setg(&chunk[0], &chunk[0], &chunk[0] + chunk.size());
+        return traits_type::to_int_type(chunk[0]);
+    }
+
+private:
+
+    std::vector<std::string> chunks;
+    size_t reads;
+};
+
+/** Two-, three- and four-byte sequences between ASCII letters */
+const char MIXED[] = "a\xC3\xA9" "b\xE4\xB8\x80" "c\xF0\x9F\x98\x80" "d";
+
+} /* anonymous namespace */
+
+class TestUnbufferedCharStream : public BaseTest {};
+
+TEST_F(TestUnbufferedCharStream, testMatchesInputStream)
+{
+    std::string text;
+    for (antlr_int32_t i = 0; i < 50; i++) {
+        text += MIXED;
+    }
+    text += "\xFF\xC3"; // malformed, then truncated at the end
+
+    // small blocks cut multi-byte sequences at every possible offset
+    for (size_t bufferSize = 1; bufferSize <= 7; bufferSize++) {
+        ANTLRInputStream expected(text);
+        std::istringstream in(text);
+        UnbufferedCharStream input(in, bufferSize);
+        EXPECT_EQ(-1, input.LA(-1));
+        while (expected.LA(1) != IntStream::EOF_) {
+            EXPECT_EQ(expected.index(), input.index());
+            EXPECT_EQ(expected.LA(1), input.LA(1));
+            EXPECT_EQ(expected.LA(2), input.LA(2));
+            expected.consume();
+            input.consume();
+            EXPECT_EQ(expected.LA(-1), input.LA(-1));
+        }
+        EXPECT_EQ(IntStream::EOF_, input.LA(1));
+        EXPECT_EQ(0xFFFD, input.LA(-1));
+        EXPECT_THROW(input.consume(), std::logic_error);
+    }
+}
+
+TEST_F(TestUnbufferedCharStream, testMarkSeekRelease)
+{
+    std::istringstream in(MIXED);
+    UnbufferedCharStream input(in, 2);
+    input.consume();
+    antlr_int32_t m1 = input.mark();
+    input.consume();
+    input.consume();
+    antlr_int32_t m2 = input.mark();
+    input.consume();
+    EXPECT_EQ(4, input.index());
+    EXPECT_EQ("\xC3\xA9" "b\xE4\xB8\x80", input.getText(Interval::of(1, 3)));
+
+    input.seek(1);
+    EXPECT_EQ(0xE9, input.LA(1));
+    EXPECT_EQ('a', input.LA(-1));
+    input.seek(5);
+    EXPECT_EQ(0x1F600, input.LA(1));
+    input.seek(100); // past EOF
+    EXPECT_EQ(7, input.index());
+    EXPECT_EQ(IntStream::EOF_, input.LA(1));
+    EXPECT_THROW(input.seek(0), std::logic_error);
+    EXPECT_THROW(input.getText(Interval::of(0, 2)), std::logic_error);
+    EXPECT_THROW(input.getText(Interval::of(1, 7)), std::invalid_argument);
+    EXPECT_EQ("d", input.getText(Interval::of(6, 6)));
+
+    EXPECT_THROW(input.release(m1), std::logic_error);
+    input.release(m2);
+    input.seek(2);
+    EXPECT_EQ('b', input.LA(1));
+    input.release(m1);
+    EXPECT_THROW(input.seek(1), std::logic_error);
+    EXPECT_EQ("b", input.getText(Interval::of(2, 2)));
+    EXPECT_THROW(input.size(), std::logic_error);
+    EXPECT_EQ(IntStream::UNKNOWN_SOURCE_NAME, input.getSourceName());
+}
+
+TEST_F(TestUnbufferedCharStream, testBoundedBuffer)
+{
+    std::string text(100000, 'x');
+    std::istringstream in(text);
+    TestStream input(in, 64);
+    size_t ringSize = input.getRingSize();
+    antlr_int32_t count = 0;
+    while (input.LA(1) != IntStream::EOF_) {
+        input.consume();
+        count++;
+    }
+    EXPECT_EQ(100000, count);
+    EXPECT_EQ(ringSize, input.getRingSize());
+
+    // a mark keeps everything after it
+    std::istringstream marked(text);
+    TestStream window(marked, 64);
+    window.LA(1);
+    antlr_int32_t m = window.mark();
+    for (antlr_int32_t i = 0; i < 1000; i++) {
+        window.consume();
+    }
+    EXPECT_LE(1000u, window.getRingSize());
+    window.seek(0);
+    EXPECT_EQ('x', window.LA(1));
+    window.release(m);
+    std::string expected(100, 'x');
+    window.seek(100);
+    EXPECT_EQ(expected, window.getText(Interval::of(100, 199)));
+}
+
+TEST_F(TestUnbufferedCharStream, testPartialReads)
+{
+    // the second character is cut between two chunks
+    std::vector<std::string> chunks;
+    chunks.push_back("a\xC3");
+    chunks.push_back("\xA9" "b");
+    chunks.push_back("\xE4\xB8\x80");
+    ChunkedBuffer buffer(chunks);
+    std::istream in(&buffer);
+    UnbufferedCharStream input(in);
+
+    // nothing waits for a whole block or for input past what is needed
+    EXPECT_EQ('a', input.LA(1));
+    EXPECT_EQ(1u, buffer.getReads());
+    input.consume();
+    EXPECT_EQ(0x00E9, input.LA(1));
+    EXPECT_EQ(2u, buffer.getReads());
+    EXPECT_EQ('b', input.LA(2));
+    EXPECT_EQ(2u, buffer.getReads());
+    input.consume();
+    input.consume();
+    EXPECT_EQ(0x4E00, input.LA(1));
+    EXPECT_EQ(3u, buffer.getReads());
+    input.consume();
+    EXPECT_EQ(IntStream::EOF_, input.LA(1));
+    EXPECT_EQ(4, input.index());
+}
@@ -0,0 +1,445 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ATNConfig.h>
+#include <antlr/atn/ATNConfigSet.h>
+#include <antlr/atn/BasicState.h>
+#include <antlr/atn/PredictionContext.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/atn/SemanticContextCache.h>
+#include <antlr/atn/SingletonPredictionContext.h>
+#include <antlr/misc/Arena.h>
+#include <antlr/misc/HashSet.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+using namespace antlr4::atn;
+using namespace antlr4::misc;
+
+#if __cplusplus >= 201103L
+#define TEST_NOEXCEPT noexcept
+#else
+#define TEST_NOEXCEPT throw()
+#endif
+
+namespace {
+
+/** Set while a test counts the calls to the replacement operator new */
+bool countingAllocations = false;
+
+antlr_int32_t allocationCount = 0;
+
+void* countedAllocate(std::size_t size)
+{
+    if (countingAllocations)
+        allocationCount++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAllocateOrThrow(std::size_t size)
+{
+    void* p = countedAllocate(size);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+/** Owns {@code n} numbered states for configs to point at */
+class States
+{
+public:
+
+    States(antlr_int32_t n)
+    {
+        for (antlr_int32_t i = 0; i < n; i++) {
+            BasicState* s = new BasicState();
+            s->stateNumber = i;
+            states.push_back(s);
+        }
+    }
+
+    ~States()
+    {
+        for (size_t i = 0; i < states.size(); i++)
+            delete states[i];
+    }
+
+    const ATNState* operator[](antlr_int32_t i) const { return states[i]; }
+
+private:
+
+    std::vector<BasicState*> states;
+};
+
+}
+
+// Replaced for the whole test program; they only count while
+// countingAllocations is set.
+
+void* operator new(std::size_t size)
+{
+    return countedAllocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return countedAllocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) TEST_NOEXCEPT
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) TEST_NOEXCEPT
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void* p) TEST_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) TEST_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) TEST_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) TEST_NOEXCEPT
+{
+    std::free(p);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* p, std::size_t) TEST_NOEXCEPT
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) TEST_NOEXCEPT
+{
+    std::free(p);
+}
+#endif
+
+class TestATNConfigSet : public BaseTest
+{
+};
+
+
+TEST_F(TestATNConfigSet, testSmallSetStaysInline)
+{
+    States states(ATNConfigSet::SMALL_SET_SIZE);
+    ATNConfigSet set(true);
+    for (antlr_uint32_t i = 0; i < ATNConfigSet::SMALL_SET_SIZE; i++)
+        set.add(ATNConfig(states[i], 1, PredictionContext::EMPTY));
+    EXPECT_EQ(ATNConfigSet::SMALL_SET_SIZE, set.size());
+    EXPECT_TRUE(set.configs.isInline());
+    EXPECT_TRUE(set.configLookup == NULL);
+
+    // duplicates are found without the lookup table
+    set.add(ATNConfig(states[2], 1, PredictionContext::EMPTY));
+    EXPECT_EQ(ATNConfigSet::SMALL_SET_SIZE, set.size());
+    EXPECT_TRUE(set.contains(ATNConfig(states[3], 1, PredictionContext::EMPTY)));
+    EXPECT_FALSE(set.contains(ATNConfig(states[3], 2, PredictionContext::EMPTY)));
+}
+
+TEST_F(TestATNConfigSet, testPromotion)
+{
+    States states(20);
+    Arena arena;
+    ATNConfigSet set(true, NULL, &arena);
+    for (antlr_int32_t i = 0; i < 20; i++)
+        set.add(ATNConfig(states[i], 1, PredictionContext::EMPTY));
+    EXPECT_EQ(20u, set.size());
+    EXPECT_FALSE(set.configs.isInline());
+    EXPECT_TRUE(set.configLookup != NULL);
+
+    for (antlr_int32_t i = 0; i < 20; i++) {
+        set.add(ATNConfig(states[i], 1, PredictionContext::EMPTY));
+        EXPECT_TRUE(set.contains(ATNConfig(states[i], 1, PredictionContext::EMPTY)));
+    }
+    EXPECT_EQ(20u, set.size());
+
+    set.setReadonly(true);
+    EXPECT_TRUE(set.configLookup == NULL);
+    EXPECT_THROW(set.contains(ATNConfig(states[0], 1, PredictionContext::EMPTY)), std::logic_error);
+}
+
+TEST_F(TestATNConfigSet, testMergeContexts)
+{
+    States states(10);
+    PredictionContextCache cache;
+    SingletonPredictionContext ctx1(PredictionContext::EMPTY, 1);
+    SingletonPredictionContext ctx2(PredictionContext::EMPTY, 2);
+
+    // merge into a small set, and into the same config after promotion
+    ATNConfigSet set(true, &cache);
+    set.add(ATNConfig(states[0], 1, &ctx1));
+    set.add(ATNConfig(states[0], 1, &ctx2));
+    EXPECT_EQ(1u, set.size());
+    const PredictionContext* merged = set.get(0).context;
+    EXPECT_EQ(2, merged->size());
+
+    for (antlr_int32_t i = 1; i < 10; i++)
+        set.add(ATNConfig(states[i], 1, &ctx1));
+    set.add(ATNConfig(states[9], 1, &ctx2));
+    EXPECT_EQ(10u, set.size());
+    EXPECT_EQ(2, set.get(9).context->size());
+}
+
+TEST_F(TestATNConfigSet, testClear)
+{
+    States states(10);
+    ATNConfigSet set(true);
+    for (antlr_int32_t i = 0; i < 10; i++)
+        set.add(ATNConfig(states[i], 1, PredictionContext::EMPTY));
+    set.clear();
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_TRUE(set.configLookup == NULL);
+    set.add(ATNConfig(states[4], 1, PredictionContext::EMPTY));
+    EXPECT_TRUE(set.contains(ATNConfig(states[4], 1, PredictionContext::EMPTY)));
+}
+
+TEST_F(TestATNConfigSet, testAltTrackingStaysInArena)
+{
+    States states(2);
+    Arena arena;
+    arena.allocate(1); // the arena's first block
+
+    allocationCount = 0;
+    countingAllocations = true;
+    {
+        ATNConfigSet set(true, NULL, &arena);
+        set.add(ATNConfig(states[0], 1, PredictionContext::EMPTY));
+        EXPECT_EQ(1, set.getUniqueAlt());
+        EXPECT_TRUE(set.hasNonConflictingAltSubset());
+    }
+    EXPECT_EQ(0, allocationCount);
+    {
+        ATNConfigSet set(true, NULL, &arena);
+        set.add(ATNConfig(states[0], 1, PredictionContext::EMPTY));
+        set.add(ATNConfig(states[0], 2, PredictionContext::EMPTY));
+        EXPECT_EQ(ATN::INVALID_ALT_NUMBER, set.getUniqueAlt());
+        EXPECT_TRUE(set.hasConflictingAltSubset());
+        EXPECT_FALSE(set.hasStateAssociatedWithOneAlt());
+    }
+    countingAllocations = false;
+    EXPECT_EQ(0, allocationCount);
+}
+
+TEST_F(TestATNConfigSet, testReadonlyReleasesAltTracking)
+{
+    States states(2);
+    ATNConfigSet set(true);
+    set.add(ATNConfig(states[0], 1, PredictionContext::EMPTY));
+    set.add(ATNConfig(states[1], 1, PredictionContext::EMPTY));
+    EXPECT_GT(set.getBytesUsed(), sizeof(ATNConfigSet));
+
+    set.setReadonly(true);
+    EXPECT_FALSE(set.tracksAltSubsets());
+    EXPECT_EQ(sizeof(ATNConfigSet), set.getBytesUsed());
+    // answered from the configs
+    EXPECT_EQ(1, set.getUniqueAlt());
+    EXPECT_EQ("{1}", set.getAlts().toString());
+}
+
+TEST_F(TestATNConfigSet, testTracksHighAlts)
+{
+    States states(2);
+    Arena arena;
+    ATNConfigSet set(true, NULL, &arena);
+    set.add(ATNConfig(states[0], 100, PredictionContext::EMPTY));
+    EXPECT_EQ(100, set.getUniqueAlt());
+    set.add(ATNConfig(states[0], 3, PredictionContext::EMPTY));
+    set.add(ATNConfig(states[1], 70, PredictionContext::EMPTY));
+    EXPECT_EQ("{3, 70, 100}", set.getAlts().toString());
+    EXPECT_TRUE(set.hasConflictingAltSubset());
+    EXPECT_TRUE(set.hasStateAssociatedWithOneAlt());
+
+    std::vector<BitSet> altsets;
+    set.getAltSubsets(altsets);
+    ASSERT_EQ(2u, altsets.size());
+    EXPECT_EQ("{3, 100}", altsets[0].toString());
+    EXPECT_EQ("{70}", altsets[1].toString());
+}
+
+TEST_F(TestATNConfigSet, testConfigIsPlainValue)
+{
+    // the context pointer and two packed words, no vtable or virtual base
+    EXPECT_EQ(sizeof(void*) + 2 * sizeof(antlr_int32_t), sizeof(ATNConfig));
+
+    States states(2);
+    ATNConfig a(states[1], 2, PredictionContext::EMPTY, 5);
+    a.reachesIntoOuterContext = true;
+    ATNConfig b;
+    std::memcpy(static_cast<void*>(&b), &a, sizeof(ATNConfig));
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(a.hashCode(), b.hashCode());
+    EXPECT_EQ(1u, b.stateNumber);
+    EXPECT_EQ(2u, b.alt);
+    EXPECT_EQ(5u, b.semanticContextIndex);
+    EXPECT_TRUE(b.reachesIntoOuterContext);
+
+    EXPECT_NO_THROW(ATNConfig(states[0], ATNConfig::MAX_ALT, PredictionContext::EMPTY));
+    EXPECT_THROW(ATNConfig(states[0], ATNConfig::MAX_ALT + 1, PredictionContext::EMPTY), std::out_of_range);
+    EXPECT_THROW(b.setLexerActionIndex(ATNConfig::MAX_LEXER_ACTION_INDEX + 1), std::out_of_range);
+
+    // semantic context indexes and lexer actions aren't limited to 15 bits
+    ATNConfig c(states[1], 2, PredictionContext::EMPTY, SemanticContextCache::MAX_INDEX);
+    EXPECT_EQ(SemanticContextCache::MAX_INDEX, c.semanticContextIndex);
+    EXPECT_EQ(2u, c.alt);
+    EXPECT_FALSE(c.reachesIntoOuterContext);
+    c.setLexerActionIndex(0x10000);
+    EXPECT_EQ(0x10000, c.getLexerActionIndex());
+    EXPECT_FALSE(a == c);
+}
+
+TEST_F(TestATNConfigSet, testATNStateNumbersFitConfigs)
+{
+    ATN atn;
+    for (antlr_int32_t i = 0; i < ATNConfig::MAX_STATE_NUMBER; i++) {
+        atn.addState(NULL);
+    }
+    BasicState* last = new BasicState();
+    atn.addState(last);
+    EXPECT_EQ(ATNConfig::MAX_STATE_NUMBER, last->stateNumber);
+    EXPECT_THROW(atn.addState(new BasicState()), std::length_error);
+    EXPECT_EQ(static_cast<size_t>(ATNConfig::MAX_STATE_NUMBER) + 1, atn.states.size());
+}
+
+TEST_F(TestATNConfigSet, testConfigEquality)
+{
+    States states(2);
+    PredictionContextCache cache;
+    const PredictionContext* ctx1 = cache.add(SingletonPredictionContext::create(PredictionContext::EMPTY, 1));
+    const PredictionContext* ctx2 = cache.add(SingletonPredictionContext::create(PredictionContext::EMPTY, 2));
+    ATNConfig a(states[0], 1, ctx1);
+
+    EXPECT_TRUE(a == ATNConfig(states[0], 1, ctx1));
+    EXPECT_TRUE(a != ATNConfig(states[1], 1, ctx1));
+    EXPECT_TRUE(a != ATNConfig(states[0], 2, ctx1));
+    EXPECT_TRUE(a != ATNConfig(states[0], 1, ctx2));
+    EXPECT_TRUE(a != ATNConfig(states[0], 1, ctx1, 1));
+
+    // reachesIntoOuterContext isn't part of the identity
+    ATNConfig c(a);
+    c.reachesIntoOuterContext = true;
+    EXPECT_TRUE(a == c);
+    EXPECT_EQ(a.hashCode(), c.hashCode());
+
+    // the lexer action is
+    ATNConfig d(a);
+    EXPECT_EQ(-1, d.getLexerActionIndex());
+    d.setLexerActionIndex(4);
+    EXPECT_EQ(4, d.getLexerActionIndex());
+    EXPECT_TRUE(a != d);
+
+    HashSet<ATNConfig> busy;
+    EXPECT_TRUE(busy.add(a));
+    EXPECT_FALSE(busy.add(c));
+    EXPECT_TRUE(busy.add(ATNConfig(states[0], 1, ctx2)));
+    EXPECT_EQ(2u, busy.size());
+}
+
+TEST_F(TestATNConfigSet, testTracksUniqueAlt)
+{
+    States states(10);
+    ATNConfigSet set(true);
+    EXPECT_TRUE(set.tracksAltSubsets());
+    EXPECT_EQ(ATN::INVALID_ALT_NUMBER, set.getUniqueAlt());
+    for (antlr_int32_t i = 0; i < 10; i++)
+        set.add(ATNConfig(states[i], 2, PredictionContext::EMPTY));
+    EXPECT_EQ(2, set.getUniqueAlt());
+    EXPECT_FALSE(set.hasConflictingAltSubset());
+    EXPECT_TRUE(set.hasNonConflictingAltSubset());
+    EXPECT_TRUE(set.hasStateAssociatedWithOneAlt());
+
+    set.add(ATNConfig(states[9], 3, PredictionContext::EMPTY));
+    EXPECT_EQ(ATN::INVALID_ALT_NUMBER, set.getUniqueAlt());
+    EXPECT_EQ("{2, 3}", set.getAlts().toString());
+    EXPECT_TRUE(set.hasConflictingAltSubset());
+
+    std::vector<BitSet> altsets;
+    set.getAltSubsets(altsets);
+    EXPECT_EQ(10u, altsets.size());
+    EXPECT_EQ("{2, 3}", altsets[9].toString());
+
+    set.clear();
+    EXPECT_EQ(ATN::INVALID_ALT_NUMBER, set.getUniqueAlt());
+    EXPECT_FALSE(set.hasConflictingAltSubset());
+    EXPECT_FALSE(set.hasNonConflictingAltSubset());
+    EXPECT_FALSE(set.hasStateAssociatedWithOneAlt());
+}
+
+TEST_F(TestATNConfigSet, testMergeMovesAltSubset)
+{
+    States states(2);
+    PredictionContextCache cache;
+    const PredictionContext* ctx1 = cache.add(SingletonPredictionContext::create(PredictionContext::EMPTY, 1));
+    const PredictionContext* ctx2 = cache.add(SingletonPredictionContext::create(PredictionContext::EMPTY, 2));
+
+    ATNConfigSet set(true, &cache);
+    set.add(ATNConfig(states[0], 1, ctx1));
+    set.add(ATNConfig(states[0], 2, ctx1));
+    EXPECT_TRUE(set.hasConflictingAltSubset());
+    EXPECT_FALSE(set.hasStateAssociatedWithOneAlt());
+
+    // alt 1 moves to (s0, [1 2]), leaving alt 2 alone in (s0, 1)
+    set.add(ATNConfig(states[0], 1, ctx2));
+    EXPECT_FALSE(set.hasConflictingAltSubset());
+    EXPECT_TRUE(set.hasNonConflictingAltSubset());
+
+    // both alts end up in (s0, [1 2]); (s0, 1) is empty and not reported
+    set.add(ATNConfig(states[0], 2, ctx2));
+    EXPECT_TRUE(set.hasConflictingAltSubset());
+    EXPECT_FALSE(set.hasNonConflictingAltSubset());
+    std::vector<BitSet> altsets;
+    set.getAltSubsets(altsets);
+    ASSERT_EQ(1u, altsets.size());
+    EXPECT_EQ("{1, 2}", altsets[0].toString());
+    EXPECT_FALSE(set.hasStateAssociatedWithOneAlt());
+}
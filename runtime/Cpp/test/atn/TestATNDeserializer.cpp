@@ -0,0 +1,279 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/Token.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ATNDeserializer.h>
+#include <antlr/atn/BlockEndState.h>
+#include <antlr/atn/BlockStartState.h>
+#include <antlr/atn/DecisionState.h>
+#include <antlr/atn/RuleStartState.h>
+#include <antlr/atn/RuleStopState.h>
+#include <antlr/atn/RuleTransition.h>
+#include <antlr/atn/TokensStartState.h>
+#include <antlr/atn/Transition.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace antlr4;
+using namespace antlr4::atn;
+
+namespace {
+
+const antlr_int32_t A = 1;
+const antlr_int32_t B = 2;
+const antlr_int32_t C = 3;
+
+/** Writes values in the serialized ATN format */
+class Serialized
+{
+public:
+
+    Serialized(ATNType grammarType, antlr_int32_t maxTokenType)
+    {
+        data.push_back(ATNDeserializer::SERIALIZED_VERSION);
+        for (size_t i = 0; i < 8; i++) {
+            data.push_back((ATNDeserializer::SERIALIZED_UUID[i] + 2) & 0xFFFF);
+        }
+        add(grammarType);
+        add(maxTokenType);
+    }
+
+    Serialized& add(antlr_int32_t v)
+    {
+        data.push_back(static_cast<antlr_uint32_t>(v + 2) & 0xFFFF);
+        return *this;
+    }
+
+    Serialized& state(antlr_int32_t type, antlr_int32_t ruleIndex)
+    {
+        return add(type).add(ruleIndex);
+    }
+
+    Serialized& edge(antlr_int32_t src, antlr_int32_t trg, antlr_int32_t type,
+                     antlr_int32_t arg1 = 0, antlr_int32_t arg2 = 0, antlr_int32_t arg3 = 0)
+    {
+        return add(src).add(trg).add(type).add(arg1).add(arg2).add(arg3);
+    }
+
+    std::vector<antlr_uint32_t> data;
+};
+
+/** Serializes the parser ATN for
+ *
+ *  <pre>
+ *  s : A x B | C x ;
+ *  x : B | ;
+ *  </pre>
+ */
+std::vector<antlr_uint32_t> serializeParserATN()
+{
+    Serialized atn(PARSER, C);
+    atn.add(17); // states
+    atn.state(ATNState::RULE_START, 0);         // 0
+    atn.state(ATNState::RULE_STOP, 0);          // 1
+    atn.state(ATNState::RULE_START, 1);         // 2
+    atn.state(ATNState::RULE_STOP, 1);          // 3
+    atn.state(ATNState::BLOCK_START, 0).add(10);// 4
+    atn.state(ATNState::BASIC, 0);              // 5
+    atn.state(ATNState::BASIC, 0);              // 6
+    atn.state(ATNState::BASIC, 0);              // 7
+    atn.state(ATNState::BASIC, 0);              // 8
+    atn.state(ATNState::BASIC, 0);              // 9
+    atn.state(ATNState::BLOCK_END, 0);          // 10
+    atn.state(ATNState::BASIC, 0);              // 11
+    atn.state(ATNState::BASIC, 0);              // 12
+    atn.state(ATNState::BLOCK_START, 1).add(16);// 13
+    atn.state(ATNState::BASIC, 1);              // 14
+    atn.state(ATNState::BASIC, 1);              // 15
+    atn.state(ATNState::BLOCK_END, 1);          // 16
+    atn.add(0); // non-greedy states
+    atn.add(2).add(0).add(2); // rules
+    atn.add(0); // modes
+    atn.add(0); // sets
+    atn.add(17); // edges
+    atn.edge(0, 4, Transition::EPSILON);
+    atn.edge(4, 5, Transition::EPSILON);
+    atn.edge(4, 9, Transition::EPSILON);
+    atn.edge(5, 6, Transition::ATOM, A);
+    atn.edge(6, 7, Transition::RULE, 2, 1);
+    atn.edge(7, 8, Transition::ATOM, B);
+    atn.edge(8, 10, Transition::EPSILON);
+    atn.edge(9, 11, Transition::ATOM, C);
+    atn.edge(11, 12, Transition::RULE, 2, 1);
+    atn.edge(12, 10, Transition::EPSILON);
+    atn.edge(10, 1, Transition::EPSILON);
+    atn.edge(2, 13, Transition::EPSILON);
+    atn.edge(13, 14, Transition::EPSILON);
+    atn.edge(13, 16, Transition::EPSILON);
+    atn.edge(14, 15, Transition::ATOM, B);
+    atn.edge(15, 16, Transition::EPSILON);
+    atn.edge(16, 3, Transition::EPSILON);
+    atn.add(2).add(4).add(13); // decisions
+    return atn.data;
+}
+
+/** Serializes the lexer ATN for {@code ID : ~[0-9]+ ;} with token type 5 */
+std::vector<antlr_uint32_t> serializeLexerATN()
+{
+    Serialized atn(LEXER, 5);
+    atn.add(5); // states
+    atn.state(ATNState::TOKEN_START, -1);       // 0
+    atn.state(ATNState::RULE_START, 0);         // 1
+    atn.state(ATNState::RULE_STOP, 0);          // 2
+    atn.state(ATNState::BASIC, 0);              // 3
+    atn.add(ATNState::INVALID_TYPE);            // 4, removed
+    atn.add(0); // non-greedy states
+    atn.add(1).add(1).add(5).add(-1); // rules: start, token type, action
+    atn.add(1).add(0); // modes
+    atn.add(1).add(1).add(0).add('0').add('9'); // sets
+    atn.add(3); // edges
+    atn.edge(0, 1, Transition::EPSILON);
+    atn.edge(1, 3, Transition::NOT_SET, 0);
+    atn.edge(3, 2, Transition::EPSILON);
+    atn.add(1).add(0); // decisions
+    return atn.data;
+}
+
+} /* anonymous namespace */
+
+class TestATNDeserializer : public BaseTest
+{
+};
+
+
+TEST_F(TestATNDeserializer, testParserATN)
+{
+    antlr_auto_ptr<ATN> atn = ATNDeserializer::deserialize(serializeParserATN());
+    EXPECT_EQ(PARSER, atn->grammarType);
+    EXPECT_EQ(C, atn->maxTokenType);
+    ASSERT_EQ(17u, atn->states.size());
+    ASSERT_EQ(2u, atn->ruleToStartState.size());
+    EXPECT_EQ(atn->states[3], atn->ruleToStopState[1]);
+    EXPECT_EQ(atn->states[3], atn->ruleToStartState[1]->stopState);
+
+    // blocks are linked both ways and numbered as decisions
+    ASSERT_EQ(2, atn->getNumberOfDecisions());
+    EXPECT_EQ(atn->states[13], atn->getDecisionState(1));
+    EXPECT_EQ(1, atn->getDecisionState(1)->decision);
+    const BlockStartState* block = static_cast<const BlockStartState*>(atn->states[4]);
+    EXPECT_EQ(atn->states[10], block->endState);
+    EXPECT_EQ(block, block->endState->startState);
+
+    // rule transitions and the derived return edges of rule x
+    const RuleTransition* call = static_cast<const RuleTransition*>(atn->states[6]->transition(0));
+    EXPECT_EQ(Transition::RULE, call->getSerializationType());
+    EXPECT_EQ(atn->states[2], call->target);
+    EXPECT_EQ(atn->states[7], call->followState);
+    EXPECT_EQ(1, call->ruleIndex);
+    ASSERT_EQ(2, atn->states[3]->getNumberOfTransitions());
+    EXPECT_EQ(atn->states[7], atn->states[3]->transition(0)->target);
+    EXPECT_EQ(atn->states[12], atn->states[3]->transition(1)->target);
+    EXPECT_TRUE(atn->states[5]->transition(0)->matches(A, 1, C));
+    EXPECT_FALSE(atn->states[5]->transition(0)->matches(B, 1, C));
+}
+
+TEST_F(TestATNDeserializer, testLayout)
+{
+    antlr_auto_ptr<ATN> atn = ATNDeserializer::deserialize(serializeParserATN());
+    ASSERT_EQ(17u, atn->stateType.size());
+    ASSERT_EQ(18u, atn->transitionOffsets.size());
+    EXPECT_EQ(ATNState::BLOCK_START, atn->stateType[4]);
+    EXPECT_EQ(ATNState::RULE_STOP, atn->stateType[3]);
+    EXPECT_EQ(1, atn->stateRuleIndex[13]);
+    EXPECT_EQ(19, atn->transitionOffsets[17]); // 17 serialized + 2 derived
+    EXPECT_EQ(19u, atn->packedTransitions.size());
+
+    for (antlr_int32_t s = 0; s < 17; s++) {
+        const ATNState* state = atn->states[s];
+        ASSERT_EQ(state->getNumberOfTransitions(), atn->getNumberOfPackedTransitions(s));
+        for (antlr_int32_t i = 0; i < state->getNumberOfTransitions(); i++) {
+            const ATN::PackedTransition& t = atn->packedTransitions[atn->transitionOffsets[s] + i];
+            EXPECT_EQ(state->transition(i)->getSerializationType(), t.type);
+            EXPECT_EQ(state->transition(i)->target->stateNumber, t.target);
+        }
+    }
+
+    const ATN::PackedTransition& atom = atn->packedTransitions[atn->transitionOffsets[5]];
+    EXPECT_EQ(Transition::ATOM, atom.type);
+    EXPECT_EQ(A, atom.arg1);
+    const ATN::PackedTransition& call = atn->packedTransitions[atn->transitionOffsets[11]];
+    EXPECT_EQ(Transition::RULE, call.type);
+    EXPECT_EQ(2, call.target);
+    EXPECT_EQ(12, call.arg1);
+    EXPECT_EQ(1, call.arg2);
+}
+
+TEST_F(TestATNDeserializer, testLexerATN)
+{
+    antlr_auto_ptr<ATN> atn = ATNDeserializer::deserialize(serializeLexerATN());
+    EXPECT_EQ(LEXER, atn->grammarType);
+    ASSERT_EQ(5u, atn->states.size());
+    EXPECT_EQ(NULL, atn->states[4]);
+    EXPECT_EQ(ATNState::INVALID_TYPE, atn->stateType[4]);
+    ASSERT_EQ(1u, atn->modeToStartState.size());
+    EXPECT_EQ(atn->states[0], atn->modeToStartState[0]);
+    ASSERT_EQ(1u, atn->ruleToTokenType.size());
+    EXPECT_EQ(5, atn->ruleToTokenType[0]);
+    EXPECT_EQ(-1, atn->ruleToActionIndex[0]);
+
+    const Transition* t = atn->states[1]->transition(0);
+    EXPECT_EQ(Transition::NOT_SET, t->getSerializationType());
+    EXPECT_FALSE(t->matches('5', 0, 0xFFFF));
+    EXPECT_TRUE(t->matches('q', 0, 0xFFFF));
+
+    const ATN::PackedTransition& packed = atn->packedTransitions[atn->transitionOffsets[1]];
+    EXPECT_EQ(Transition::NOT_SET, packed.type);
+    ASSERT_EQ(1u, atn->transitionSets.size());
+    EXPECT_TRUE(atn->transitionSets[packed.arg1]->contains('7'));
+}
+
+TEST_F(TestATNDeserializer, testInvalidData)
+{
+    std::vector<antlr_uint32_t> data = serializeParserATN();
+    std::vector<antlr_uint32_t> badVersion(data);
+    badVersion[0] = ATNDeserializer::SERIALIZED_VERSION + 1;
+    EXPECT_THROW(ATNDeserializer::deserialize(badVersion), std::invalid_argument);
+
+    std::vector<antlr_uint32_t> badUUID(data);
+    badUUID[3]++;
+    EXPECT_THROW(ATNDeserializer::deserialize(badUUID), std::invalid_argument);
+
+    std::vector<antlr_uint32_t> truncated(data.begin(), data.end() - 1);
+    EXPECT_THROW(ATNDeserializer::deserialize(truncated), std::invalid_argument);
+
+    EXPECT_THROW(ATNDeserializer::deserialize(std::vector<antlr_uint32_t>()), std::invalid_argument);
+}
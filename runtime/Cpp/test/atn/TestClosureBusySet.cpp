@@ -0,0 +1,98 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/atn/ATNConfig.h>
+#include <antlr/atn/BasicState.h>
+#include <antlr/atn/ClosureBusySet.h>
+#include <antlr/atn/PredictionContext.h>
+#include <antlr/atn/SingletonPredictionContext.h>
+
+using namespace antlr4::atn;
+
+class TestClosureBusySet : public BaseTest
+{
+};
+
+
+TEST_F(TestClosureBusySet, testConfigs)
+{
+    BasicState s1;
+    s1.stateNumber = 1;
+    BasicState s3;
+    s3.stateNumber = 3;
+    SingletonPredictionContext ctx(PredictionContext::EMPTY, 4);
+
+    ClosureBusySet busy(2);
+    EXPECT_TRUE(busy.add(ATNConfig(&s1, 1, PredictionContext::EMPTY)));
+    EXPECT_TRUE(busy.add(ATNConfig(&s1, 2, PredictionContext::EMPTY)));
+    EXPECT_TRUE(busy.add(ATNConfig(&s1, 1, &ctx)));
+    EXPECT_FALSE(busy.add(ATNConfig(&s1, 2, PredictionContext::EMPTY)));
+    // grows past the initial state count
+    EXPECT_TRUE(busy.add(ATNConfig(&s3, 1, PredictionContext::EMPTY)));
+    EXPECT_FALSE(busy.add(ATNConfig(&s3, 1, PredictionContext::EMPTY)));
+    EXPECT_EQ(4u, busy.size());
+    EXPECT_TRUE(busy.contains(ATNConfig(&s1, 1, &ctx)));
+    EXPECT_FALSE(busy.contains(ATNConfig(&s3, 2, PredictionContext::EMPTY)));
+
+    busy.reset();
+    EXPECT_EQ(0u, busy.size());
+    EXPECT_FALSE(busy.contains(ATNConfig(&s1, 1, &ctx)));
+    EXPECT_TRUE(busy.add(ATNConfig(&s1, 1, &ctx)));
+    EXPECT_FALSE(busy.contains(ATNConfig(&s1, 2, PredictionContext::EMPTY)));
+}
+
+TEST_F(TestClosureBusySet, testStates)
+{
+    BasicState s0;
+    s0.stateNumber = 0;
+    BasicState s5;
+    s5.stateNumber = 5;
+
+    ClosureBusySet visited;
+    EXPECT_TRUE(visited.add(&s5));
+    EXPECT_FALSE(visited.add(&s5));
+    EXPECT_FALSE(visited.contains(&s0));
+    EXPECT_TRUE(visited.add(&s0));
+    EXPECT_EQ(2u, visited.size());
+
+    for (antlr_int32_t i = 0; i < 3; i++) {
+        antlr_uint32_t epoch = visited.getEpoch();
+        visited.reset();
+        EXPECT_EQ(epoch + 1, visited.getEpoch());
+        EXPECT_FALSE(visited.contains(&s5));
+        EXPECT_TRUE(visited.add(&s5));
+    }
+}
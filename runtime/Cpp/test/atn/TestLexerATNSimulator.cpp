@@ -0,0 +1,643 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <BaseTest.h>
+#include <antlr/CharStream.h>
+#include <antlr/IntStream.h>
+#include <antlr/LexerNoViableAltException.h>
+#include <antlr/Token.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/ActionTransition.h>
+#include <antlr/atn/AtomTransition.h>
+#include <antlr/atn/BasicState.h>
+#include <antlr/atn/EpsilonTransition.h>
+#include <antlr/atn/LexerATNSimulator.h>
+#include <antlr/atn/RangeTransition.h>
+#include <antlr/atn/RuleStartState.h>
+#include <antlr/atn/RuleStopState.h>
+#include <antlr/atn/TokensStartState.h>
+#include <antlr/dfa/DFA.h>
+#include <antlr/dfa/DFASnapshot.h>
+#include <antlr/dfa/DFAState.h>
+#include <antlr/dfa/DFAWarmUp.h>
+#include <antlr/misc/Interval.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace antlr4;
+using namespace antlr4::atn;
+using namespace antlr4::dfa;
+using namespace antlr4::misc;
+
+namespace {
+
+/** Code point stream used to drive the simulator without a lexer */
+class CodePointStream : public CharStream
+{
+public:
+
+    CodePointStream(const std::vector<antlr_int32_t>& data)
+        :   data(data),
+            p(0)
+    {
+    }
+
+    void consume()
+    {
+        p++;
+    }
+
+    antlr_int32_t LA(antlr_int32_t i)
+    {
+        antlr_int32_t j = p + (i > 0 ? i - 1 : i);
+        if (j < 0 || j >= static_cast<antlr_int32_t>(data.size())) {
+            return IntStream::EOF_;
+        }
+        return data[j];
+    }
+
+    antlr_int32_t mark()
+    {
+        return -1;
+    }
+
+    void release(antlr_int32_t)
+    {
+    }
+
+    antlr_int32_t index()
+    {
+        return p;
+    }
+
+    void seek(antlr_int32_t index)
+    {
+        p = index;
+    }
+
+    antlr_int32_t size()
+    {
+        return static_cast<antlr_int32_t>(data.size());
+    }
+
+    std::string getSourceName()
+    {
+        return "<test>";
+    }
+
+    std::string getText(const Interval& interval)
+    {
+        std::string text;
+        for (antlr_int32_t i = interval.a; i <= interval.b; i++) {
+            antlr_int32_t c = data[i];
+            if (c < 0x80) {
+                text += static_cast<char>(c);
+            } else if (c < 0x800) {
+                text += static_cast<char>(0xC0 | (c >> 6));
+                text += static_cast<char>(0x80 | (c & 0x3F));
+            } else {
+                text += static_cast<char>(0xE0 | (c >> 12));
+                text += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                text += static_cast<char>(0x80 | (c & 0x3F));
+            }
+        }
+        return text;
+    }
+
+private:
+
+    std::vector<antlr_int32_t> data;
+    antlr_int32_t p;
+};
+
+/** Adds lexer rule {@code ruleIndex} to {@code atn} as
+ *  {@code start -> a -(labels)-> b -> (a | stop)} and returns state {@code a};
+ *  the caller adds the labelled transitions from {@code a} to {@code b}.
+ */
+ATNState* addLoopRule(ATN* atn, TokensStartState* tokensStart, antlr_int32_t ruleIndex, antlr_int32_t tokenType,
+                      BasicState*& b)
+{
+    RuleStartState* start = new RuleStartState();
+    RuleStopState* stop = new RuleStopState();
+    BasicState* a = new BasicState();
+    b = new BasicState();
+    atn->addState(start);
+    atn->addState(stop);
+    atn->addState(a);
+    atn->addState(b);
+    start->setRuleIndex(ruleIndex);
+    stop->setRuleIndex(ruleIndex);
+    a->setRuleIndex(ruleIndex);
+    b->setRuleIndex(ruleIndex);
+    start->stopState = stop;
+    atn->ruleToStartState.push_back(start);
+    atn->ruleToStopState.push_back(stop);
+    atn->ruleToTokenType.push_back(tokenType);
+
+    tokensStart->addTransition(new EpsilonTransition(start));
+    start->addTransition(new EpsilonTransition(a));
+    b->addTransition(new EpsilonTransition(a));
+    b->addTransition(new EpsilonTransition(stop));
+    return a;
+}
+
+/** ID : [a-zà-ÿ一-丐]+ ; INT : [0-9]+ ; WS : ' ' {action} ; */
+ATN* createLexerATN()
+{
+    ATN* atn = new ATN();
+    atn->grammarType = LEXER;
+    TokensStartState* tokensStart = new TokensStartState();
+    atn->addState(tokensStart);
+    atn->defineDecisionState(tokensStart);
+    atn->modeToStartState.push_back(tokensStart);
+
+    BasicState* b;
+    ATNState* a = addLoopRule(atn, tokensStart, 0, 1, b);
+    a->addTransition(new RangeTransition(b, 'a', 'z'));
+    a->addTransition(new RangeTransition(b, 0x00E0, 0x00FF));
+    a->addTransition(new RangeTransition(b, 0x4E00, 0x4E10));
+
+    a = addLoopRule(atn, tokensStart, 1, 2, b);
+    a->addTransition(new RangeTransition(b, '0', '9'));
+
+    // WS is not a loop: start -> c -(' ')-> d -(action)-> stop
+    RuleStartState* start = new RuleStartState();
+    RuleStopState* stop = new RuleStopState();
+    BasicState* c = new BasicState();
+    BasicState* d = new BasicState();
+    atn->addState(start);
+    atn->addState(stop);
+    atn->addState(c);
+    atn->addState(d);
+    start->setRuleIndex(2);
+    stop->setRuleIndex(2);
+    c->setRuleIndex(2);
+    d->setRuleIndex(2);
+    start->stopState = stop;
+    atn->ruleToStartState.push_back(start);
+    atn->ruleToStopState.push_back(stop);
+    atn->ruleToTokenType.push_back(3);
+    tokensStart->addTransition(new EpsilonTransition(start));
+    start->addTransition(new EpsilonTransition(c));
+    c->addTransition(new AtomTransition(d, ' '));
+    d->addTransition(new ActionTransition(stop, 2, 0, false));
+
+    atn->maxTokenType = 3;
+    return atn;
+}
+
+std::vector<antlr_int32_t> codePoints(const std::string& s)
+{
+    return std::vector<antlr_int32_t>(s.begin(), s.end());
+}
+
+/** Warm-up that runs the lexer simulator alone over each file */
+class LexerWarmUp : public DFAWarmUp
+{
+public:
+
+    LexerWarmUp(const ATN* atn, std::vector<DFA*>& decisionToDFA)
+        :   atn(atn),
+            decisionToDFA(decisionToDFA),
+            numTokens(0)
+    {
+    }
+
+    antlr_int32_t getNumTokens() const
+    {
+        return numTokens;
+    }
+
+protected:
+
+    void recognize(CharStream* input)
+    {
+        LexerATNSimulator sim(atn, decisionToDFA, NULL);
+        while (sim.match(input, 0) != Token::EOF_) {
+            numTokens++;
+        }
+    }
+
+private:
+
+    const ATN* atn;
+    std::vector<DFA*>& decisionToDFA;
+    antlr_int32_t numTokens;
+};
+
+} /* anonymous namespace */
+
+class TestLexerATNSimulator : public BaseTest
+{
+protected:
+
+    void SetUp()
+    {
+        atn.reset(createLexerATN());
+        decisionToDFA.push_back(new DFA(atn->getDecisionState(0), 0));
+    }
+
+    void TearDown()
+    {
+        for (std::vector<DFA*>::iterator it = decisionToDFA.begin(); it != decisionToDFA.end(); it++) {
+            delete *it;
+        }
+    }
+
+protected:
+
+    antlr_auto_ptr<ATN> atn;
+    std::vector<DFA*> decisionToDFA;
+};
+
+TEST_F(TestLexerATNSimulator, testMatchTokens)
+{
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    CodePointStream input(codePoints("abc 42\nx"));
+
+    EXPECT_EQ(1, sim.match(&input, 0));
+    EXPECT_EQ(3, input.index());
+    EXPECT_EQ("abc", sim.getText(&input));
+    EXPECT_EQ(3, sim.match(&input, 0));
+    EXPECT_EQ(4, input.index());
+    EXPECT_EQ(2, sim.match(&input, 0));
+    EXPECT_EQ(6, input.index());
+    EXPECT_EQ("42", sim.getText(&input));
+    EXPECT_EQ(6, sim.getCharPositionInLine());
+    EXPECT_THROW(sim.match(&input, 0), LexerNoViableAltException);
+
+    sim.consume(&input);
+    EXPECT_EQ(2, sim.getLine());
+    EXPECT_EQ(0, sim.getCharPositionInLine());
+    EXPECT_EQ(1, sim.match(&input, 0));
+    EXPECT_EQ(Token::EOF_, sim.match(&input, 0));
+}
+
+TEST_F(TestLexerATNSimulator, testAsciiEdgesAreCached)
+{
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    CodePointStream input(codePoints("ab 12"));
+    while (sim.match(&input, 0) != Token::EOF_) {
+    }
+
+    const DFA* dfa = decisionToDFA[0];
+    const DFAState* s0 = dfa->s0.load();
+    ASSERT_TRUE(s0 != NULL);
+    ASSERT_TRUE(s0->edges.load() != NULL);
+    EXPECT_TRUE(s0->getEdge('a') != NULL);
+    EXPECT_TRUE(s0->getEdge('1') != NULL);
+    EXPECT_TRUE(s0->getEdge('z') == NULL);
+    EXPECT_TRUE(s0->edgePages.load() == NULL);
+
+    // a second run walks the cached edges and adds no states
+    size_t numStates = dfa->states->size();
+    CodePointStream input2(codePoints("ba 21"));
+    sim.reset();
+    EXPECT_EQ(1, sim.match(&input2, 0));
+    EXPECT_EQ(3, sim.match(&input2, 0));
+    EXPECT_EQ(2, sim.match(&input2, 0));
+    EXPECT_EQ(numStates, dfa->states->size());
+}
+
+TEST_F(TestLexerATNSimulator, testBmpEdgesUsePageTable)
+{
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    std::vector<antlr_int32_t> data;
+    data.push_back(0x00E9);
+    data.push_back(0x4E01);
+    CodePointStream input(data);
+
+    EXPECT_EQ(1, sim.match(&input, 0));
+    EXPECT_EQ(2, input.index());
+    EXPECT_EQ("\xC3\xA9\xE4\xB8\x81", sim.getText(&input));
+
+    const DFAState* s0 = decisionToDFA[0]->s0.load();
+    ASSERT_TRUE(s0->edgePages.load() != NULL);
+    ASSERT_TRUE(s0->edgePages.load()[0].load() != NULL);
+    const DFAState* target = s0->getPagedEdge(0xE9);
+    ASSERT_TRUE(target != NULL);
+    ASSERT_TRUE(target->edgePages.load() != NULL);
+    EXPECT_TRUE(target->edgePages.load()[0x4E].load() != NULL);
+    EXPECT_TRUE(target->edgePages.load()[0x4F].load() == NULL);
+    EXPECT_TRUE(target->getPagedEdge(0x4E01) != NULL);
+    EXPECT_TRUE(s0->edges.load() == NULL);
+}
+
+TEST_F(TestLexerATNSimulator, testBmpEdgeCacheDisabled)
+{
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    sim.setBmpEdgeCacheEnabled(false);
+    EXPECT_FALSE(sim.isBmpEdgeCacheEnabled());
+    std::vector<antlr_int32_t> data;
+    data.push_back(0x00E9);
+    data.push_back('a');
+    CodePointStream input(data);
+
+    EXPECT_EQ(1, sim.match(&input, 0));
+    EXPECT_EQ(2, input.index());
+    EXPECT_TRUE(decisionToDFA[0]->s0.load()->edgePages.load() == NULL);
+}
+
+TEST_F(TestLexerATNSimulator, testFrozenDFA)
+{
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    CodePointStream warmUp(codePoints("ab ba 12 21 "));
+    while (sim.match(&warmUp, 0) != Token::EOF_) {
+    }
+
+    DFA* dfa = decisionToDFA[0];
+    size_t numStates = dfa->states->size();
+    // a few states with small configs cost about as much as their 128
+    // column table, so this doesn't check what freezing saved
+    dfa->freeze();
+    ASSERT_TRUE(dfa->isFrozen());
+    EXPECT_EQ(numStates, dfa->getFrozen()->getNumStates());
+    EXPECT_EQ(0u, dfa->states->size());
+    EXPECT_TRUE(dfa->s0.load() == NULL);
+    EXPECT_EQ(0u, dfa->freeze());
+
+    // every edge up to the last token is in the table
+    CodePointStream input(codePoints("ba 21 ba"));
+    sim.reset();
+    EXPECT_EQ(1, sim.match(&input, 0));
+    EXPECT_EQ("ba", sim.getText(&input));
+    EXPECT_EQ(3, sim.match(&input, 0));
+    EXPECT_EQ(2, sim.match(&input, 0));
+    EXPECT_EQ(3, sim.match(&input, 0));
+    EXPECT_EQ(6, input.index());
+    EXPECT_EQ(6, sim.getCharPositionInLine());
+    EXPECT_EQ(0u, dfa->states->size());
+
+    // no rule matches EOF, so EOF ends the last token in the table too
+    EXPECT_EQ(1, sim.match(&input, 0));
+    EXPECT_EQ(8, input.index());
+    EXPECT_EQ(8, sim.getCharPositionInLine());
+    EXPECT_EQ("ba", sim.getText(&input));
+    EXPECT_EQ(Token::EOF_, sim.match(&input, 0));
+    EXPECT_EQ(8, input.index());
+    EXPECT_EQ(0u, dfa->states->size());
+}
+
+TEST_F(TestLexerATNSimulator, testFrozenDFAMatchingEOF)
+{
+    // END : '!' EOF ;
+    RuleStartState* start = new RuleStartState();
+    RuleStopState* stop = new RuleStopState();
+    BasicState* e = new BasicState();
+    BasicState* f = new BasicState();
+    atn->addState(start);
+    atn->addState(stop);
+    atn->addState(e);
+    atn->addState(f);
+    start->setRuleIndex(3);
+    stop->setRuleIndex(3);
+    e->setRuleIndex(3);
+    f->setRuleIndex(3);
+    start->stopState = stop;
+    atn->ruleToStartState.push_back(start);
+    atn->ruleToStopState.push_back(stop);
+    atn->ruleToTokenType.push_back(4);
+    atn->modeToStartState[0]->addTransition(new EpsilonTransition(start));
+    start->addTransition(new EpsilonTransition(e));
+    e->addTransition(new AtomTransition(f, '!'));
+    f->addTransition(new AtomTransition(stop, IntStream::EOF_));
+
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    CodePointStream warmUp(codePoints("ab!"));
+    EXPECT_EQ(1, sim.match(&warmUp, 0));
+    EXPECT_EQ(4, sim.match(&warmUp, 0));
+    EXPECT_EQ(Token::EOF_, sim.match(&warmUp, 0));
+
+    DFA* dfa = decisionToDFA[0];
+    dfa->freeze();
+    ASSERT_TRUE(dfa->isFrozen());
+
+    // ID ends at EOF in the table
+    CodePointStream input(codePoints("abb"));
+    sim.reset();
+    EXPECT_EQ(1, sim.match(&input, 0));
+    EXPECT_EQ(Token::EOF_, sim.match(&input, 0));
+    EXPECT_EQ(0u, dfa->states->size());
+
+    // only the ATN knows that '!' continues on EOF
+    CodePointStream end(codePoints("!"));
+    sim.reset();
+    EXPECT_EQ(4, sim.match(&end, 0));
+    EXPECT_EQ(1, end.index());
+    EXPECT_GT(dfa->states->size(), 0u);
+}
+
+TEST_F(TestLexerATNSimulator, testDFASnapshot)
+{
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    CodePointStream warmUp(codePoints("ab ba 12 21 "));
+    while (sim.match(&warmUp, 0) != Token::EOF_) {
+    }
+
+    // stands in for the serialized form of the ATN
+    std::vector<antlr_uint32_t> serializedATN;
+    serializedATN.push_back(3);
+    serializedATN.push_back(1);
+    serializedATN.push_back(4);
+    const std::string fileName = "TestDFASnapshot.bin";
+    {
+        std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary);
+        DFASnapshot::write(out, decisionToDFA, &serializedATN[0], serializedATN.size());
+    }
+
+    {
+        DFASnapshot snapshot(fileName);
+        EXPECT_EQ(1u, snapshot.size());
+        EXPECT_TRUE(snapshot.matches(&serializedATN[0], serializedATN.size()));
+
+        std::vector<antlr_uint32_t> otherATN(serializedATN);
+        otherATN.push_back(1);
+        std::vector<DFA*> restarted;
+        restarted.push_back(new DFA(atn->getDecisionState(0), 0));
+        EXPECT_EQ(0u, snapshot.apply(restarted, &otherATN[0], otherATN.size()));
+        EXPECT_FALSE(restarted[0]->isFrozen());
+        EXPECT_EQ(1u, snapshot.apply(restarted, &serializedATN[0], serializedATN.size()));
+        ASSERT_TRUE(restarted[0]->isFrozen());
+        EXPECT_EQ(decisionToDFA[0]->states->size(), restarted[0]->getFrozen()->getNumStates());
+
+        // a new simulator predicts from the snapshot without learning anything
+        LexerATNSimulator warm(atn.get(), restarted, NULL);
+        CodePointStream input(codePoints("ba 21 ba"));
+        EXPECT_EQ(1, warm.match(&input, 0));
+        EXPECT_EQ(3, warm.match(&input, 0));
+        EXPECT_EQ(2, warm.match(&input, 0));
+        EXPECT_EQ(3, warm.match(&input, 0));
+        EXPECT_EQ(0u, restarted[0]->states->size());
+        EXPECT_EQ(1, warm.match(&input, 0));
+        EXPECT_EQ(Token::EOF_, warm.match(&input, 0));
+        delete restarted[0];
+    }
+
+    {
+        std::fstream file(fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7F');
+    }
+    EXPECT_THROW(DFASnapshot snapshot(fileName), std::runtime_error);
+    std::remove(fileName.c_str());
+    EXPECT_THROW(DFASnapshot snapshot(fileName), std::runtime_error);
+}
+
+TEST_F(TestLexerATNSimulator, testStaticDFASnapshot)
+{
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    CodePointStream warmUp(codePoints("ab 12 "));
+    while (sim.match(&warmUp, 0) != Token::EOF_) {
+    }
+
+    std::vector<antlr_uint32_t> serializedATN(1, 42);
+    std::stringstream out;
+    DFASnapshot::write(out, decisionToDFA, &serializedATN[0], serializedATN.size());
+    std::string bytes = out.str();
+    std::vector<antlr_int32_t> words(bytes.size() / sizeof(antlr_int32_t));
+    std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char*>(&words[0]));
+
+    // the words are read in place, like a table compiled into the program
+    DFASnapshot snapshot(&words[0], words.size());
+    std::vector<DFA*> restarted;
+    restarted.push_back(new DFA(atn->getDecisionState(0), 0));
+    EXPECT_EQ(1u, snapshot.apply(restarted, &serializedATN[0], serializedATN.size()));
+    LexerATNSimulator warm(atn.get(), restarted, NULL);
+    CodePointStream input(codePoints("ab 12 "));
+    EXPECT_EQ(1, warm.match(&input, 0));
+    EXPECT_EQ(3, warm.match(&input, 0));
+    EXPECT_EQ(2, warm.match(&input, 0));
+    EXPECT_EQ(0u, restarted[0]->states->size());
+    delete restarted[0];
+
+    words.pop_back();
+    EXPECT_THROW(DFASnapshot truncated(&words[0], words.size()), std::runtime_error);
+}
+
+TEST_F(TestLexerATNSimulator, testDFAWarmUp)
+{
+    std::vector<std::string> corpus;
+    corpus.push_back("TestDFAWarmUp1.txt");
+    corpus.push_back("TestDFAWarmUp2.txt");
+    {
+        std::ofstream out1(corpus[0].c_str(), std::ios::out | std::ios::binary);
+        out1 << "ab 12 ";
+        std::ofstream out2(corpus[1].c_str(), std::ios::out | std::ios::binary);
+        out2 << "ba 21";
+    }
+
+    std::vector<antlr_uint32_t> serializedATN(1, 42);
+    LexerWarmUp warmUp(atn.get(), decisionToDFA);
+    warmUp.addRecognizer("TestDFAWarmUp", decisionToDFA, &serializedATN[0], serializedATN.size());
+    warmUp.run(corpus);
+    EXPECT_EQ(7, warmUp.getNumTokens());
+    std::vector<std::string> fileNames = warmUp.write("");
+    ASSERT_EQ(1u, fileNames.size());
+    EXPECT_EQ("TestDFAWarmUp.dfa", fileNames[0]);
+
+    // read back the way a recognizer embedding the file reads it
+    std::vector<antlr_int32_t> words;
+    {
+        std::ifstream in(fileNames[0].c_str(), std::ios::in | std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        words.resize(bytes.size() / sizeof(antlr_int32_t));
+        std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char*>(&words[0]));
+    }
+    DFASnapshot snapshot(&words[0], words.size());
+    std::vector<DFA*> restarted;
+    restarted.push_back(new DFA(atn->getDecisionState(0), 0));
+    EXPECT_EQ(1u, snapshot.apply(restarted, &serializedATN[0], serializedATN.size()));
+    LexerATNSimulator warm(atn.get(), restarted, NULL);
+    CodePointStream input(codePoints("ab 21"));
+    EXPECT_EQ(1, warm.match(&input, 0));
+    EXPECT_EQ(3, warm.match(&input, 0));
+    EXPECT_EQ(2, warm.match(&input, 0));
+    EXPECT_EQ(0u, restarted[0]->states->size());
+    delete restarted[0];
+
+    std::remove(fileNames[0].c_str());
+    std::remove(corpus[0].c_str());
+    std::remove(corpus[1].c_str());
+
+    EXPECT_THROW(warmUp.run(corpus), std::runtime_error);
+    EXPECT_THROW(warmUp.write("TestDFAWarmUpMissingDirectory"), std::runtime_error);
+}
+
+TEST_F(TestLexerATNSimulator, testInvalidDFASnapshot)
+{
+    LexerATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    CodePointStream warmUp(codePoints("ab 12 "));
+    while (sim.match(&warmUp, 0) != Token::EOF_) {
+    }
+
+    std::vector<antlr_uint32_t> serializedATN(1, 42);
+    std::stringstream out;
+    DFASnapshot::write(out, decisionToDFA, &serializedATN[0], serializedATN.size());
+    std::string bytes = out.str();
+    std::vector<antlr_uint32_t> words(bytes.size() / sizeof(antlr_uint32_t));
+    std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char*>(&words[0]));
+
+    // the snapshot header is 5 words, followed by the decision, start
+    // state, number of states, columns and overflow edges of the DFA
+    const size_t headerSize = 5;
+    const size_t edgesStart = headerSize + 5;
+    antlr_uint32_t numStates = words[headerSize + 2];
+    antlr_uint32_t numColumns = words[headerSize + 3];
+    ASSERT_GT(numStates * numColumns, 0u);
+    size_t overflowStart = edgesStart + numStates * numColumns;
+
+    // each corruption comes with a matching checksum, so only the
+    // validation of the tables can catch it
+    std::vector<antlr_uint32_t> corrupted[2];
+    corrupted[0] = words;
+    corrupted[0][edgesStart] = numStates;
+    corrupted[1] = words;
+    corrupted[1][overflowStart + numStates] += 1;
+    for (size_t i = 0; i < 2; i++) {
+        std::vector<antlr_uint32_t>& w = corrupted[i];
+        w[4] = static_cast<antlr_uint32_t>(DFASnapshot::checksum(&w[headerSize], w.size() - headerSize));
+        EXPECT_THROW(DFASnapshot snapshot(reinterpret_cast<const antlr_int32_t*>(&w[0]), w.size()),
+                     std::runtime_error);
+    }
+
+    DFASnapshot snapshot(reinterpret_cast<const antlr_int32_t*>(&words[0]), words.size());
+    EXPECT_EQ(1u, snapshot.size());
+}
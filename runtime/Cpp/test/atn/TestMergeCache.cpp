@@ -0,0 +1,191 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/atn/MergeCache.h>
+#include <antlr/atn/PredictionContext.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/atn/SingletonPredictionContext.h>
+#include <vector>
+
+using namespace antlr4::atn;
+
+class TestMergeCache : public BaseTest
+{
+protected:
+
+    /** Interns {@code returnState $} in {@code cache} */
+    const PredictionContext* context(antlr_int32_t returnState, PredictionContextCache* cache)
+    {
+        return cache->add(SingletonPredictionContext::create(PredictionContext::EMPTY, returnState));
+    }
+
+    const PredictionContext* context(antlr_int32_t returnState)
+    {
+        return context(returnState, &contexts);
+    }
+
+    PredictionContextCache contexts;
+};
+
+
+TEST_F(TestMergeCache, testGetAndPut)
+{
+    MergeCache cache;
+    const PredictionContext* a = context(1);
+    const PredictionContext* b = context(2);
+    const PredictionContext* c = context(3);
+    EXPECT_EQ(NULL, cache.get(a, b, true));
+    cache.put(a, b, true, c);
+    EXPECT_EQ(c, cache.get(a, b, true));
+    EXPECT_EQ(c, cache.get(b, a, true));
+    EXPECT_EQ(NULL, cache.get(a, b, false));
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(2u, cache.getHits());
+    EXPECT_EQ(2u, cache.getMisses());
+
+    cache.put(b, a, true, a);
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(a, cache.get(a, b, true));
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(NULL, cache.get(a, b, true));
+    cache.resetStatistics();
+    EXPECT_EQ(0u, cache.getHits());
+    EXPECT_EQ(0u, cache.getMisses());
+}
+
+TEST_F(TestMergeCache, testBounded)
+{
+    MergeCache cache(10);
+    EXPECT_EQ(16u, cache.getCapacity());
+    std::vector<const PredictionContext*> v;
+    for (antlr_int32_t i = 0; i < 101; i++)
+        v.push_back(context(i));
+    for (antlr_int32_t i = 0; i < 100; i++)
+        cache.put(v[i], v[i+1], true, v[i]);
+    EXPECT_TRUE(cache.size() <= cache.getCapacity());
+    EXPECT_EQ(100u, cache.size() + cache.getEvictions());
+}
+
+TEST_F(TestMergeCache, testSecondChance)
+{
+    // a single set, so every entry competes for the same ways
+    MergeCache cache(MergeCache::WAYS);
+    const PredictionContext* x = context(100);
+    std::vector<const PredictionContext*> v;
+    for (antlr_uint32_t i = 0; i <= MergeCache::WAYS; i++)
+        v.push_back(context(i));
+    for (antlr_uint32_t i = 0; i < MergeCache::WAYS; i++)
+        cache.put(x, v[i], true, x);
+    EXPECT_EQ(x, cache.get(x, v[0], true));
+    cache.put(x, v[MergeCache::WAYS], true, x);
+    EXPECT_EQ(1u, cache.getEvictions());
+    EXPECT_EQ(x, cache.get(x, v[0], true)); // referenced, so spared
+    EXPECT_EQ(NULL, cache.get(x, v[1], true));
+    EXPECT_EQ(x, cache.get(x, v[MergeCache::WAYS], true));
+}
+
+TEST_F(TestMergeCache, testRemoveContextsOf)
+{
+    MergeCache cache;
+    PredictionContextCache transient(&contexts);
+    const PredictionContext* a = context(1);
+    const PredictionContext* b = context(2);
+    const PredictionContext* t = context(3, &transient);
+    cache.put(a, b, true, a);
+    cache.put(a, t, true, a);
+    cache.put(b, a, false, t);
+    EXPECT_EQ(3u, cache.size());
+    cache.removeContextsOf(&transient);
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(a, cache.get(a, b, true));
+    EXPECT_EQ(NULL, cache.get(a, t, true));
+    EXPECT_EQ(NULL, cache.get(a, b, false));
+}
+
+TEST_F(TestMergeCache, testCountsTransientEntries)
+{
+    MergeCache cache(4);
+    PredictionContextCache transient(&contexts);
+    cache.setTransientCache(&transient);
+    const PredictionContext* a = context(1);
+    const PredictionContext* b = context(2);
+    const PredictionContext* t = context(3, &transient);
+    cache.put(a, b, true, a);
+    EXPECT_EQ(0u, cache.transientSize());
+    cache.removeContextsOf(&transient);
+    EXPECT_EQ(1u, cache.size());
+
+    cache.put(a, t, true, a);
+    cache.put(a, b, false, t);
+    EXPECT_EQ(2u, cache.transientSize());
+    // overwriting the result drops the transient context from the entry
+    cache.put(a, b, false, b);
+    EXPECT_EQ(1u, cache.transientSize());
+    cache.put(b, t, true, t);
+    EXPECT_EQ(2u, cache.transientSize());
+    EXPECT_EQ(4u, cache.size());
+
+    // the set is full: the next entry evicts the oldest, (a,b,true)
+    cache.put(a, a, true, a);
+    EXPECT_EQ(4u, cache.size());
+    EXPECT_EQ(1u, cache.getEvictions());
+    EXPECT_EQ(2u, cache.transientSize());
+    cache.removeContextsOf(&transient);
+    EXPECT_EQ(0u, cache.transientSize());
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_EQ(b, cache.get(a, b, false));
+    EXPECT_EQ(NULL, cache.get(a, t, true));
+    EXPECT_EQ(NULL, cache.get(b, t, true));
+    EXPECT_EQ(a, cache.get(a, a, true));
+
+    cache.put(a, t, true, a);
+    cache.clear();
+    EXPECT_EQ(0u, cache.transientSize());
+}
+
+TEST_F(TestMergeCache, testMerge)
+{
+    MergeCache cache;
+    const PredictionContext* a = context(1);
+    const PredictionContext* b = context(2);
+    const PredictionContext* merged = PredictionContext::merge(a, b, false, &cache, &contexts);
+    EXPECT_EQ(2, merged->size());
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(merged, PredictionContext::merge(b, a, false, &cache, &contexts));
+    EXPECT_EQ(1u, cache.getHits());
+}
@@ -0,0 +1,503 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <BaseTest.h>
+#include <antlr/IntStream.h>
+#include <antlr/NoViableAltException.h>
+#include <antlr/ParserRuleContext.h>
+#include <antlr/Token.h>
+#include <antlr/TokenStream.h>
+#include <antlr/atn/ATN.h>
+#include <antlr/atn/AtomTransition.h>
+#include <antlr/atn/BasicBlockStartState.h>
+#include <antlr/atn/BasicState.h>
+#include <antlr/atn/EpsilonTransition.h>
+#include <antlr/atn/ParserATNSimulator.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/atn/PredictionMode.h>
+#include <antlr/atn/RuleStartState.h>
+#include <antlr/atn/RuleStopState.h>
+#include <antlr/atn/RuleTransition.h>
+#include <antlr/atn/Transition.h>
+#include <antlr/dfa/DFA.h>
+#include <antlr/misc/Interval.h>
+#include <antlr/misc/Thread.h>
+#include <string>
+#include <vector>
+
+using namespace antlr4;
+using namespace antlr4::atn;
+using namespace antlr4::dfa;
+using namespace antlr4::misc;
+
+namespace {
+
+const antlr_int32_t A = 1;
+const antlr_int32_t B = 2;
+const antlr_int32_t C = 3;
+
+/** Token carrying only a type and an index */
+class TypeToken : public Token
+{
+public:
+
+    TypeToken(antlr_int32_t type, antlr_int32_t index)
+        :   type(type),
+            index(index)
+    {
+    }
+
+    std::string getText() const { return ""; }
+    antlr_int32_t getType() const { return type; }
+    antlr_int32_t getLine() const { return 1; }
+    antlr_int32_t getCharPositionInLine() const { return index; }
+    antlr_int32_t getChannel() const { return DEFAULT_CHANNEL; }
+    antlr_int32_t getTokenIndex() const { return index; }
+    antlr_int32_t getStartIndex() const { return index; }
+    antlr_int32_t getStopIndex() const { return index; }
+    TokenSource* getTokenSource() const { return NULL; }
+    CharStream* getInputStream() const { return NULL; }
+
+private:
+
+    antlr_int32_t type;
+    antlr_int32_t index;
+};
+
+/** Token stream over a fixed list of token types, terminated by EOF */
+class TypeTokenStream : public TokenStream
+{
+public:
+
+    TypeTokenStream(const std::vector<antlr_int32_t>& types)
+        :   p(0)
+    {
+        for (size_t i = 0; i < types.size(); i++) {
+            tokens.push_back(new TypeToken(types[i], static_cast<antlr_int32_t>(i)));
+        }
+        tokens.push_back(new TypeToken(Token::EOF_, static_cast<antlr_int32_t>(types.size())));
+    }
+
+    ~TypeTokenStream()
+    {
+        for (size_t i = 0; i < tokens.size(); i++) {
+            delete tokens[i];
+        }
+    }
+
+    void consume()
+    {
+        p++;
+    }
+
+    antlr_int32_t LA(antlr_int32_t i)
+    {
+        return LT(i)->getType();
+    }
+
+    const Token* LT(antlr_int32_t k)
+    {
+        antlr_int32_t j = p + (k > 0 ? k - 1 : k);
+        if (j >= static_cast<antlr_int32_t>(tokens.size())) {
+            return tokens.back();
+        }
+        return tokens[j];
+    }
+
+    const Token* get(antlr_int32_t index)
+    {
+        return tokens[index];
+    }
+
+    TokenSource* getTokenSource()
+    {
+        return NULL;
+    }
+
+    antlr_int32_t mark()
+    {
+        return -1;
+    }
+
+    void release(antlr_int32_t)
+    {
+    }
+
+    antlr_int32_t index()
+    {
+        return p;
+    }
+
+    void seek(antlr_int32_t index)
+    {
+        p = index;
+    }
+
+    antlr_int32_t size()
+    {
+        return static_cast<antlr_int32_t>(tokens.size());
+    }
+
+    std::string getSourceName()
+    {
+        return "<test>";
+    }
+
+    std::string getText(const Interval&)
+    {
+        return "";
+    }
+
+    std::string getText()
+    {
+        return "";
+    }
+
+    std::string getText(const Token*, const Token*)
+    {
+        return "";
+    }
+
+private:
+
+    std::vector<Token*> tokens;
+    antlr_int32_t p;
+};
+
+template<typename T>
+T* addState(ATN* atn, antlr_int32_t ruleIndex)
+{
+    T* state = new T();
+    atn->addState(state);
+    state->setRuleIndex(ruleIndex);
+    return state;
+}
+
+/** Builds the parser ATN for
+ *
+ *  <pre>
+ *  s : A x B | C x ;
+ *  x : B | ;
+ *  </pre>
+ *
+ *  with the block in {@code x} as decision 0. The decision is LL(1) given
+ *  the invoking context but needs full context when predicted with SLL,
+ *  because both alternatives can be followed by {@code B} in {@code s}.
+ *  {@code callSite} receives the state in {@code s} invoking {@code x}
+ *  from the first alternative.
+ */
+ATN* createParserATN(ATNState*& callSite)
+{
+    ATN* atn = new ATN();
+    atn->grammarType = PARSER;
+
+    RuleStartState* sStart = addState<RuleStartState>(atn, 0);
+    RuleStopState* sStop = addState<RuleStopState>(atn, 0);
+    RuleStartState* xStart = addState<RuleStartState>(atn, 1);
+    RuleStopState* xStop = addState<RuleStopState>(atn, 1);
+    sStart->stopState = sStop;
+    xStart->stopState = xStop;
+    atn->ruleToStartState.push_back(sStart);
+    atn->ruleToStartState.push_back(xStart);
+    atn->ruleToStopState.push_back(sStop);
+    atn->ruleToStopState.push_back(xStop);
+
+    // s alt 1: A x B
+    BasicState* a1 = addState<BasicState>(atn, 0);
+    BasicState* a2 = addState<BasicState>(atn, 0);
+    BasicState* a3 = addState<BasicState>(atn, 0);
+    BasicState* a4 = addState<BasicState>(atn, 0);
+    sStart->addTransition(new EpsilonTransition(a1));
+    a1->addTransition(new AtomTransition(a2, A));
+    a2->addTransition(new RuleTransition(xStart, 1, a3));
+    a3->addTransition(new AtomTransition(a4, B));
+    a4->addTransition(new EpsilonTransition(sStop));
+
+    // s alt 2: C x
+    BasicState* c1 = addState<BasicState>(atn, 0);
+    BasicState* c2 = addState<BasicState>(atn, 0);
+    BasicState* c3 = addState<BasicState>(atn, 0);
+    sStart->addTransition(new EpsilonTransition(c1));
+    c1->addTransition(new AtomTransition(c2, C));
+    c2->addTransition(new RuleTransition(xStart, 1, c3));
+    c3->addTransition(new EpsilonTransition(sStop));
+
+    // x : B | ;
+    BasicBlockStartState* block = addState<BasicBlockStartState>(atn, 1);
+    BasicState* b1 = addState<BasicState>(atn, 1);
+    BasicState* b2 = addState<BasicState>(atn, 1);
+    BasicState* blockEnd = addState<BasicState>(atn, 1);
+    xStart->addTransition(new EpsilonTransition(block));
+    block->addTransition(new EpsilonTransition(b1));
+    block->addTransition(new EpsilonTransition(blockEnd));
+    b1->addTransition(new AtomTransition(b2, B));
+    b2->addTransition(new EpsilonTransition(blockEnd));
+    blockEnd->addTransition(new EpsilonTransition(xStop));
+    atn->defineDecisionState(block);
+
+    // follow links used by SLL prediction once the local context is exhausted
+    xStop->addTransition(new EpsilonTransition(a3));
+    xStop->addTransition(new EpsilonTransition(c3));
+
+    atn->maxTokenType = C;
+    callSite = a2;
+    return atn;
+}
+
+std::vector<antlr_int32_t> tokenTypes(antlr_int32_t t1, antlr_int32_t t2 = 0)
+{
+    std::vector<antlr_int32_t> types;
+    types.push_back(t1);
+    if (t2 != 0) {
+        types.push_back(t2);
+    }
+    return types;
+}
+
+#if defined(HAVE_PTHREAD)
+
+/** One worker of {@code testSharedDFAAcrossThreads} */
+struct PredictionWorker
+{
+    const ATN* atn;
+    std::vector<DFA*>* decisionToDFA;
+    PredictionContextCache* sharedContextCache;
+    ParserRuleContext* ctx;
+    antlr_int32_t mispredictions;
+};
+
+void runPredictions(PredictionWorker* worker)
+{
+    ParserATNSimulator sim(worker->atn, *worker->decisionToDFA, worker->sharedContextCache);
+    TypeTokenStream fallback(tokenTypes(B));
+    TypeTokenStream sll(tokenTypes(B, B));
+    for (antlr_int32_t i = 0; i < 200; i++) {
+        if (sim.adaptivePredict(&fallback, 0, worker->ctx) != 2) {
+            worker->mispredictions++;
+        }
+        if (sim.adaptivePredict(&sll, 0, worker->ctx) != 1) {
+            worker->mispredictions++;
+        }
+    }
+}
+
+#endif /* defined(HAVE_PTHREAD) */
+
+} /* anonymous namespace */
+
+class TestParserATNSimulator : public BaseTest
+{
+protected:
+
+    void SetUp()
+    {
+        ATNState* callSite;
+        atn.reset(createParserATN(callSite));
+        decisionToDFA.push_back(new DFA(atn->getDecisionState(0), 0));
+        ctx.reset(new ParserRuleContext(&root, callSite->stateNumber));
+    }
+
+    void TearDown()
+    {
+        for (std::vector<DFA*>::iterator it = decisionToDFA.begin(); it != decisionToDFA.end(); it++) {
+            delete *it;
+        }
+    }
+
+protected:
+
+    antlr_auto_ptr<ATN> atn;
+    std::vector<DFA*> decisionToDFA;
+    ParserRuleContext root;
+    antlr_auto_ptr<ParserRuleContext> ctx;
+};
+
+TEST_F(TestParserATNSimulator, testSLLPrediction)
+{
+    ParserATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    TypeTokenStream input(tokenTypes(B, B));
+
+    EXPECT_EQ(1, sim.adaptivePredict(&input, 0, ctx.get()));
+    EXPECT_EQ(0, input.index());
+    EXPECT_EQ(1u, sim.getSLLPredictionCount());
+    EXPECT_EQ(0u, sim.getLLFallbackCount());
+}
+
+TEST_F(TestParserATNSimulator, testFullContextFallback)
+{
+    ParserATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    TypeTokenStream input(tokenTypes(B));
+
+    EXPECT_EQ(2, sim.adaptivePredict(&input, 0, ctx.get()));
+    EXPECT_EQ(0, input.index());
+    EXPECT_EQ(1u, sim.getLLFallbackCount());
+
+    // the conflict is cached in the DFA, so the next prediction walks the
+    // existing states and goes straight to full context
+    size_t numStates = decisionToDFA[0]->states->size();
+    EXPECT_EQ(2, sim.adaptivePredict(&input, 0, ctx.get()));
+    EXPECT_EQ(numStates, decisionToDFA[0]->states->size());
+    EXPECT_EQ(2u, sim.getSLLPredictionCount());
+    EXPECT_EQ(2u, sim.getLLFallbackCount());
+
+    sim.resetPredictionCounters();
+    EXPECT_EQ(0u, sim.getSLLPredictionCount());
+    EXPECT_EQ(0u, sim.getLLFallbackCount());
+}
+
+TEST_F(TestParserATNSimulator, testSLLModeResolvesConflictToMinAlt)
+{
+    ParserATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    sim.setPredictionMode(PredictionMode::SLL);
+    EXPECT_EQ(PredictionMode::SLL, sim.getPredictionMode());
+    TypeTokenStream input(tokenTypes(B));
+
+    EXPECT_EQ(1, sim.adaptivePredict(&input, 0, ctx.get()));
+    EXPECT_EQ(0u, sim.getLLFallbackCount());
+}
+
+TEST_F(TestParserATNSimulator, testNoViableAlt)
+{
+    ParserATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    TypeTokenStream input(tokenTypes(A));
+
+    EXPECT_THROW(sim.adaptivePredict(&input, 0, ctx.get()), NoViableAltException);
+    EXPECT_EQ(0, input.index());
+}
+
+TEST_F(TestParserATNSimulator, testDeepOuterContext)
+{
+    // x invoked from "C x" thousands of times over: every return from x
+    // falls off the end of s and pops another level, which a recursive
+    // closure would follow with as many native stack frames
+    const ATNState* tailCallSite = NULL;
+    for (size_t i = 0; i < atn->states.size(); i++) {
+        const ATNState* state = atn->states[i];
+        if (state->getNumberOfTransitions() == 1
+                && state->transition(0)->getSerializationType() == Transition::RULE
+                && state->stateNumber != ctx->invokingState) {
+            tailCallSite = state;
+        }
+    }
+    ASSERT_TRUE(tailCallSite != NULL);
+
+    const antlr_int32_t depth = 20000;
+    std::vector<ParserRuleContext*> nested;
+    ParserRuleContext* outer = &root;
+    for (antlr_int32_t i = 0; i < depth; i++) {
+        outer = new ParserRuleContext(outer, tailCallSite->stateNumber);
+        nested.push_back(outer);
+    }
+
+    ParserATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    std::vector<antlr_int32_t> none;
+    TypeTokenStream empty(none);
+    EXPECT_EQ(2, sim.adaptivePredict(&empty, 0, outer));
+    TypeTokenStream input(tokenTypes(B));
+    EXPECT_EQ(1, sim.adaptivePredict(&input, 0, outer));
+
+    for (size_t i = 0; i < nested.size(); i++) {
+        delete nested[i];
+    }
+}
+
+TEST_F(TestParserATNSimulator, testFrozenDFA)
+{
+    ParserATNSimulator sim(atn.get(), decisionToDFA, NULL);
+    TypeTokenStream sll(tokenTypes(B, B));
+    TypeTokenStream fallback(tokenTypes(B));
+    TypeTokenStream error(tokenTypes(A));
+    EXPECT_EQ(1, sim.adaptivePredict(&sll, 0, ctx.get()));
+    EXPECT_EQ(2, sim.adaptivePredict(&fallback, 0, ctx.get()));
+    EXPECT_THROW(sim.adaptivePredict(&error, 0, ctx.get()), NoViableAltException);
+
+    DFA* dfa = decisionToDFA[0];
+    size_t numStates = dfa->states->size();
+    EXPECT_GT(dfa->freeze(), 0u);
+    ASSERT_TRUE(dfa->isFrozen());
+    EXPECT_EQ(numStates, dfa->getFrozen()->getNumStates());
+    EXPECT_EQ(0u, dfa->states->size());
+
+    // the same predictions come from the table alone
+    sim.resetPredictionCounters();
+    EXPECT_EQ(1, sim.adaptivePredict(&sll, 0, ctx.get()));
+    EXPECT_EQ(2, sim.adaptivePredict(&fallback, 0, ctx.get()));
+    EXPECT_EQ(1u, sim.getLLFallbackCount());
+    EXPECT_THROW(sim.adaptivePredict(&error, 0, ctx.get()), NoViableAltException);
+    EXPECT_EQ(0, error.index());
+    EXPECT_EQ(0u, dfa->states->size());
+
+    // an edge missing from the table is computed from the ATN
+    TypeTokenStream unseen(tokenTypes(C));
+    EXPECT_THROW(sim.adaptivePredict(&unseen, 0, ctx.get()), NoViableAltException);
+    EXPECT_GT(dfa->states->size(), 0u);
+}
+
+#if defined(HAVE_PTHREAD)
+
+TEST_F(TestParserATNSimulator, testSharedDFAAcrossThreads)
+{
+    const antlr_int32_t numThreads = 4;
+    PredictionContextCache sharedContextCache;
+    std::vector<PredictionWorker> workers(numThreads);
+    std::vector<ThreadWithParam<PredictionWorker*>*> threads;
+    for (antlr_int32_t i = 0; i < numThreads; i++) {
+        PredictionWorker& worker = workers[i];
+        worker.atn = atn.get();
+        worker.decisionToDFA = &decisionToDFA;
+        worker.sharedContextCache = &sharedContextCache;
+        worker.ctx = ctx.get();
+        worker.mispredictions = 0;
+        threads.push_back(new ThreadWithParam<PredictionWorker*>(&runPredictions, &worker));
+    }
+    for (antlr_int32_t i = 0; i < numThreads; i++) {
+        threads[i]->start();
+    }
+    for (antlr_int32_t i = 0; i < numThreads; i++) {
+        threads[i]->join();
+        delete threads[i];
+        EXPECT_EQ(0, workers[i].mispredictions);
+    }
+
+    // the threads built a single DFA; a fresh simulator adds nothing to it
+    size_t numStates = decisionToDFA[0]->states->size();
+    ParserATNSimulator sim(atn.get(), decisionToDFA, &sharedContextCache);
+    TypeTokenStream input(tokenTypes(B, B));
+    EXPECT_EQ(1, sim.adaptivePredict(&input, 0, ctx.get()));
+    EXPECT_EQ(numStates, decisionToDFA[0]->states->size());
+}
+
+#endif /* defined(HAVE_PTHREAD) */
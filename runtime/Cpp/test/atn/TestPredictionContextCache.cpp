@@ -0,0 +1,185 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/atn/ArrayPredictionContext.h>
+#include <antlr/atn/PredictionContext.h>
+#include <antlr/atn/PredictionContextCache.h>
+#include <antlr/atn/SingletonPredictionContext.h>
+#include <antlr/misc/Thread.h>
+#include <vector>
+
+using namespace antlr4::atn;
+using namespace antlr4::misc;
+
+namespace {
+
+/** Interns the stack {@code returnStates[0] ... returnStates[n-1] $} */
+const PredictionContext* stack(PredictionContextCache* cache, const antlr_int32_t* returnStates, size_t n)
+{
+    const PredictionContext* ctx = PredictionContext::EMPTY;
+    for (size_t i = n; i > 0; i--) {
+        ctx = cache->add(SingletonPredictionContext::create(ctx, returnStates[i-1]));
+    }
+    return ctx;
+}
+
+#if defined(HAVE_PTHREAD)
+
+/** One worker of {@code testConcurrentInterning} */
+struct InternWorker
+{
+    PredictionContextCache* cache;
+    std::vector<const PredictionContext*> results;
+};
+
+void internStacks(InternWorker* worker)
+{
+    for (antlr_int32_t i = 0; i < 500; i++) {
+        antlr_int32_t returnStates[] = { i % 50, i % 7, 3 };
+        worker->results.push_back(stack(worker->cache, returnStates, 3));
+    }
+}
+
+#endif /* defined(HAVE_PTHREAD) */
+
+} /* anonymous namespace */
+
+class TestPredictionContextCache : public BaseTest
+{
+};
+
+
+TEST_F(TestPredictionContextCache, testInternsEqualContexts)
+{
+    PredictionContextCache cache;
+    antlr_int32_t returnStates[] = { 5, 8, 13 };
+    const PredictionContext* a = stack(&cache, returnStates, 3);
+    const PredictionContext* b = stack(&cache, returnStates, 3);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(3, cache.size());
+    EXPECT_EQ(a, cache.get(a));
+    EXPECT_EQ(PredictionContext::EMPTY, cache.add(PredictionContext::EMPTY));
+
+    antlr_int32_t other[] = { 5, 8, 21 };
+    const PredictionContext* c = stack(&cache, other, 3);
+    EXPECT_NE(a, c);
+    EXPECT_FALSE(a->equals(c));
+    EXPECT_EQ(6, cache.size());
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(TestPredictionContextCache, testEqualsAcrossCaches)
+{
+    PredictionContextCache first;
+    PredictionContextCache second;
+    antlr_int32_t returnStates[] = { 1, 2 };
+    const PredictionContext* a = stack(&first, returnStates, 2);
+    const PredictionContext* b = stack(&second, returnStates, 2);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(a->equals(b));
+    EXPECT_EQ(a->hashCode(), b->hashCode());
+    EXPECT_EQ(a, first.get(b));
+    EXPECT_EQ(b, second.get(a));
+}
+
+TEST_F(TestPredictionContextCache, testSharedCache)
+{
+    PredictionContextCache shared;
+    antlr_int32_t returnStates[] = { 4, 9 };
+    const PredictionContext* a = stack(&shared, returnStates, 2);
+
+    PredictionContextCache transient(&shared);
+    const PredictionContext* b = stack(&transient, returnStates, 2);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(0, transient.size());
+    EXPECT_EQ(a, transient.get(a));
+
+    const PredictionContext* c = transient.add(SingletonPredictionContext::create(a, 7));
+    EXPECT_EQ(1, transient.size());
+    EXPECT_EQ(NULL, shared.get(c));
+    EXPECT_EQ(2, shared.size());
+}
+
+TEST_F(TestPredictionContextCache, testMergeInternsResult)
+{
+    PredictionContextCache cache;
+    antlr_int32_t x[] = { 1, 10 };
+    antlr_int32_t y[] = { 2, 10 };
+    const PredictionContext* a = stack(&cache, x, 2);
+    const PredictionContext* b = stack(&cache, y, 2);
+    const PredictionContext* merged = PredictionContext::merge(a, b, false, NULL, &cache);
+    ASSERT_EQ(2, merged->size());
+    EXPECT_EQ(merged->getParent(0), merged->getParent(1));
+    EXPECT_EQ(merged, PredictionContext::merge(b, a, false, NULL, &cache));
+
+    std::vector<const PredictionContext*> parents(2, a->getParent(0));
+    std::vector<antlr_int32_t> returnStates;
+    returnStates.push_back(1);
+    returnStates.push_back(2);
+    EXPECT_EQ(merged, cache.add(new ArrayPredictionContext(parents, returnStates)));
+}
+
+#if defined(HAVE_PTHREAD)
+
+TEST_F(TestPredictionContextCache, testConcurrentInterning)
+{
+    const antlr_int32_t numThreads = 4;
+    PredictionContextCache cache;
+    std::vector<InternWorker> workers(numThreads);
+    std::vector<ThreadWithParam<InternWorker*>*> threads;
+    for (antlr_int32_t i = 0; i < numThreads; i++) {
+        workers[i].cache = &cache;
+        threads.push_back(new ThreadWithParam<InternWorker*>(&internStacks, &workers[i]));
+    }
+    for (antlr_int32_t i = 0; i < numThreads; i++) {
+        threads[i]->start();
+    }
+    for (antlr_int32_t i = 0; i < numThreads; i++) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    // every thread got the same node for the same stack
+    for (antlr_int32_t i = 1; i < numThreads; i++) {
+        EXPECT_TRUE(workers[0].results == workers[i].results);
+    }
+    // 50 distinct tops over 7 distinct middles over the single bottom
+    EXPECT_EQ(1 + 7 + 350, cache.size());
+}
+
+#endif /* defined(HAVE_PTHREAD) */
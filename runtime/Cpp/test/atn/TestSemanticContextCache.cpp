@@ -0,0 +1,131 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <BaseTest.h>
+#include <antlr/atn/SemanticContext.h>
+#include <antlr/atn/SemanticContextCache.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace antlr4::atn;
+
+
+class TestSemanticContextCache : public BaseTest
+{
+};
+
+
+TEST_F(TestSemanticContextCache, testInternsEqualCombinations)
+{
+    SemanticContextCache cache;
+    SemanticContext::Predicate p1(0, 1, false);
+    SemanticContext::Predicate p2(0, 2, false);
+    SemanticContext::Predicate p2Copy(0, 2, false);
+
+    const SemanticContext* a = SemanticContext::and_(&p1, &p2, cache);
+    const SemanticContext* b = SemanticContext::and_(&p2Copy, &p1, cache);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(1, cache.size());
+
+    const SemanticContext* o = SemanticContext::or_(&p1, &p2, cache);
+    EXPECT_NE(a, o);
+    EXPECT_EQ(o, SemanticContext::or_(&p2, &p1, cache));
+    EXPECT_EQ(2, cache.size());
+
+    // nested combinations flatten into the same operands
+    EXPECT_EQ(a, SemanticContext::and_(a, &p2, cache));
+    EXPECT_EQ(2, cache.size());
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(TestSemanticContextCache, testTrivialCombinationsAreNotCached)
+{
+    SemanticContextCache cache;
+    SemanticContext::Predicate p(0, 1, false);
+    SemanticContext::Predicate pCopy(0, 1, false);
+
+    EXPECT_EQ(&p, SemanticContext::and_(&p, &SemanticContext::NONE, cache));
+    EXPECT_EQ(&p, SemanticContext::and_(NULL, &p, cache));
+    EXPECT_EQ(&SemanticContext::NONE, SemanticContext::or_(&p, &SemanticContext::NONE, cache));
+    EXPECT_EQ(&p, SemanticContext::or_(&p, &pCopy, cache));
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(TestSemanticContextCache, testNumbersContexts)
+{
+    SemanticContextCache cache;
+    SemanticContext::Predicate p1(0, 1, false);
+    SemanticContext::Predicate p1Copy(0, 1, false);
+    SemanticContext::Predicate p2(0, 2, false);
+
+    EXPECT_EQ(SemanticContextCache::NONE_INDEX, cache.getIndex(&SemanticContext::NONE));
+    EXPECT_EQ(&SemanticContext::NONE, cache.get(SemanticContextCache::NONE_INDEX));
+
+    antlr_uint32_t i1 = cache.getIndex(&p1);
+    antlr_uint32_t i2 = cache.getIndex(&p2);
+    EXPECT_NE(SemanticContextCache::NONE_INDEX, i1);
+    EXPECT_NE(i1, i2);
+    EXPECT_EQ(i1, cache.getIndex(&p1Copy));
+    EXPECT_EQ(&p1, cache.get(i1));
+    EXPECT_EQ(&p2, cache.get(i2));
+
+    antlr_uint32_t i3 = cache.getIndex(SemanticContext::and_(&p1, &p2, cache));
+    EXPECT_EQ(i3, cache.getIndex(SemanticContext::and_(&p2, &p1Copy, cache)));
+    EXPECT_EQ(SemanticContext::and_(&p1, &p2, cache), cache.get(i3));
+    EXPECT_THROW(cache.get(i3 + 1), std::out_of_range);
+}
+
+TEST_F(TestSemanticContextCache, testNumbersManyContexts)
+{
+    SemanticContextCache cache;
+    std::vector<SemanticContext::Predicate*> predicates;
+    // more than fit in 15 bits
+    const antlr_int32_t n = 40000;
+    for (antlr_int32_t i = 0; i < n; i++) {
+        predicates.push_back(new SemanticContext::Predicate(0, i, false));
+        ASSERT_EQ(static_cast<antlr_uint32_t>(i + 1), cache.getIndex(predicates.back()));
+    }
+    for (antlr_int32_t i = 0; i < n; i++) {
+        ASSERT_EQ(predicates[i], cache.get(static_cast<antlr_uint32_t>(i + 1)));
+    }
+    cache.clear();
+    EXPECT_THROW(cache.get(1), std::out_of_range);
+    for (size_t i = 0; i < predicates.size(); i++) {
+        delete predicates[i];
+    }
+}
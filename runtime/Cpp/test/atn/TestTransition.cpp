@@ -0,0 +1,126 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/Token.h>
+#include <antlr/atn/ActionTransition.h>
+#include <antlr/atn/AtomTransition.h>
+#include <antlr/atn/BasicState.h>
+#include <antlr/atn/EpsilonTransition.h>
+#include <antlr/atn/NotSetTransition.h>
+#include <antlr/atn/PredicateTransition.h>
+#include <antlr/atn/RangeTransition.h>
+#include <antlr/atn/RuleStartState.h>
+#include <antlr/atn/RuleTransition.h>
+#include <antlr/atn/SetTransition.h>
+#include <antlr/atn/WildcardTransition.h>
+#include <antlr/misc/IntervalSet.h>
+
+using namespace antlr4;
+using namespace antlr4::atn;
+using namespace antlr4::misc;
+
+class TestTransition : public BaseTest {};
+
+TEST_F(TestTransition, testEpsilonKinds)
+{
+    BasicState target;
+    RuleStartState ruleStart;
+    EpsilonTransition epsilon(&target);
+    RuleTransition rule(&ruleStart, 0, &target);
+    PredicateTransition pred(&target, 0, 1, false);
+    ActionTransition action(&target, 0, 2, false);
+
+    const Transition* transitions[] = { &epsilon, &rule, &pred, &action };
+    const antlr_int32_t types[] = { Transition::EPSILON, Transition::RULE, Transition::PREDICATE, Transition::ACTION };
+    for (size_t i = 0; i < sizeof(transitions)/sizeof(transitions[0]); i++) {
+        EXPECT_EQ(types[i], transitions[i]->getSerializationType());
+        EXPECT_TRUE(transitions[i]->isEpsilon());
+        EXPECT_FALSE(transitions[i]->matches(1, 0, 10));
+    }
+}
+
+TEST_F(TestTransition, testAtomAndRange)
+{
+    BasicState target;
+    AtomTransition atom(&target, 'x');
+    RangeTransition range(&target, 'a', 'f');
+
+    EXPECT_EQ(Transition::ATOM, atom.getSerializationType());
+    EXPECT_FALSE(atom.isEpsilon());
+    EXPECT_TRUE(atom.matches('x', 0, 0xFFFF));
+    EXPECT_FALSE(atom.matches('y', 0, 0xFFFF));
+
+    EXPECT_EQ(Transition::RANGE, range.getSerializationType());
+    EXPECT_FALSE(range.isEpsilon());
+    EXPECT_TRUE(range.matches('a', 0, 0xFFFF));
+    EXPECT_TRUE(range.matches('f', 0, 0xFFFF));
+    EXPECT_FALSE(range.matches('a' - 1, 0, 0xFFFF));
+    EXPECT_FALSE(range.matches('g', 0, 0xFFFF));
+}
+
+TEST_F(TestTransition, testSetAndNotSet)
+{
+    BasicState target;
+    IntervalSet labels = IntervalSet::of(3, 5);
+    SetTransition set(&target, &labels);
+    NotSetTransition notSet(&target, &labels);
+
+    EXPECT_EQ(Transition::SET, set.getSerializationType());
+    EXPECT_EQ(Transition::NOT_SET, notSet.getSerializationType());
+    for (antlr_int32_t symbol = 1; symbol <= 7; symbol++) {
+        bool inSet = symbol >= 3 && symbol <= 5;
+        EXPECT_EQ(inSet, set.matches(symbol, 1, 7));
+        EXPECT_EQ(!inSet, notSet.matches(symbol, 1, 7));
+    }
+    // outside the vocabulary a negated set never matches
+    EXPECT_FALSE(notSet.matches(8, 1, 7));
+
+    SetTransition invalid(&target, NULL);
+    EXPECT_TRUE(invalid.matches(Token::INVALID_TYPE, 0, 10));
+}
+
+TEST_F(TestTransition, testWildcard)
+{
+    BasicState target;
+    WildcardTransition wildcard(&target);
+
+    EXPECT_EQ(Transition::WILDCARD, wildcard.getSerializationType());
+    EXPECT_FALSE(wildcard.isEpsilon());
+    EXPECT_TRUE(wildcard.matches(1, 1, 7));
+    EXPECT_TRUE(wildcard.matches(7, 1, 7));
+    EXPECT_FALSE(wildcard.matches(0, 1, 7));
+    EXPECT_FALSE(wildcard.matches(8, 1, 7));
+}
@@ -0,0 +1,96 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <Benchmark.h>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+Benchmark*& registered()
+{
+    static Benchmark* first = NULL;
+    return first;
+}
+
+volatile antlr_int32_t sink;
+
+/** Shortest run, in seconds, considered long enough to time */
+const double MIN_SECONDS = 0.2;
+
+}
+
+Benchmark::Benchmark(const char* name, Function function)
+    :   name(name),
+        function(function),
+        next(NULL)
+{
+    // keep registration order so output follows the source
+    Benchmark** last = &registered();
+    while (*last != NULL) {
+        last = &(*last)->next;
+    }
+    *last = this;
+}
+
+antlr_int32_t Benchmark::runAll(const std::string& filter)
+{
+    antlr_int32_t count = 0;
+    for (Benchmark* b = registered(); b != NULL; b = b->next) {
+        if (std::string(b->name).find(filter) == std::string::npos) {
+            continue;
+        }
+        b->function(1); // warm up
+        antlr_uint32_t iterations = 1;
+        double seconds = 0;
+        for (;;) {
+            std::clock_t start = std::clock();
+            b->function(iterations);
+            seconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+            if (seconds >= MIN_SECONDS || iterations >= (1u << 30)) {
+                break;
+            }
+            iterations *= 2;
+        }
+        std::printf("%-40s %12u %14.1f ns/op\n", b->name, iterations, seconds * 1e9 / iterations);
+        count++;
+    }
+    return count;
+}
+
+void Benchmark::consume(antlr_int32_t value)
+{
+    sink = sink + value;
+}
@@ -0,0 +1,77 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <antlr/Definitions.h>
+#include <string>
+
+/** A minimal timing harness.  Each benchmark is a function running its
+ *  body a given number of times; the runner grows the count until a run
+ *  takes long enough to time, then reports the time per iteration.
+ */
+class Benchmark
+{
+public:
+
+    typedef void (*Function)(antlr_uint32_t iterations);
+
+    /** Register function under name; used by {@link BENCHMARK}. */
+    Benchmark(const char* name, Function function);
+
+    /** Run every benchmark whose name contains filter and print the
+     *  results; returns the number of benchmarks run.
+     */
+    static antlr_int32_t runAll(const std::string& filter);
+
+    /** Keep the compiler from optimizing away a computed value. */
+    static void consume(antlr_int32_t value);
+
+private:
+
+    const char* name;
+    Function function;
+    Benchmark* next;
+
+};
+
+#define BENCHMARK(name) \
+    static void name(antlr_uint32_t iterations); \
+    static Benchmark name##Registration(#name, name); \
+    static void name(antlr_uint32_t iterations)
+
+
+#endif /* ifndef BENCHMARK_H */
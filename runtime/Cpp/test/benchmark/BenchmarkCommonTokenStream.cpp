@@ -0,0 +1,243 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <Benchmark.h>
+#include <antlr/BufferedTokenStream.h>
+#include <antlr/CommonToken.h>
+#include <antlr/CommonTokenStream.h>
+#include <antlr/Token.h>
+#include <antlr/TokenSource.h>
+#include <string>
+#include <vector>
+
+using namespace antlr4;
+
+namespace {
+
+const antlr_int32_t ID = 1;
+const antlr_int32_t WS = 2;
+const antlr_int32_t COMMENT = 3;
+
+/** Replays a fixed sequence of token types; whitespace and comments go
+ *  to the hidden channel. When {@code batched}, tokens are also produced
+ *  in batches.
+ */
+class ReplaySource : public TokenSource
+{
+public:
+
+    explicit ReplaySource(const std::vector<antlr_int32_t>& types, bool batched = false)
+        :   types(types), next(0), batched(batched)
+    {
+    }
+
+    antlr_auto_ptr<Token> nextToken()
+    {
+        antlr_auto_ptr<Token> token(new CommonToken(replay()));
+        return token;
+    }
+
+    antlr_int32_t nextTokens(CommonToken* buffer, antlr_int32_t maxCount)
+    {
+        if (!batched) {
+            return TokenSource::nextTokens(buffer, maxCount);
+        }
+
+        antlr_int32_t count = 0;
+        while (count < maxCount) {
+            buffer[count] = replay();
+            if (buffer[count++].getType() == Token::EOF_) {
+                break;
+            }
+        }
+        return count;
+    }
+
+    CommonToken replay()
+    {
+        antlr_int32_t type = next < types.size() ? types[next] : Token::EOF_;
+        antlr_int32_t channel = type == WS || type == COMMENT ? Token::HIDDEN_CHANNEL : Token::DEFAULT_CHANNEL;
+        antlr_int32_t start = static_cast<antlr_int32_t>(next++);
+        return CommonToken(NULL, type, channel, start, start);
+    }
+
+    antlr_int32_t getLine() const
+    {
+        return 1;
+    }
+
+    antlr_int32_t getCharPositionInLine() const
+    {
+        return 0;
+    }
+
+    CharStream* getInputStream()
+    {
+        return NULL;
+    }
+
+    std::string getSourceName()
+    {
+        return "replay";
+    }
+
+private:
+
+    const std::vector<antlr_int32_t>& types;
+    size_t next;
+    bool batched;
+};
+
+/** Commented code: about 60% of the tokens are on the hidden channel. */
+const std::vector<antlr_int32_t>& commentHeavyTypes()
+{
+    static std::vector<antlr_int32_t> types;
+    if (types.empty()) {
+        antlr_uint32_t seed = 42;
+        for (antlr_int32_t i = 0; i < 100000; i++) {
+            seed = seed * 1103515245 + 12345;
+            antlr_int32_t r = static_cast<antlr_int32_t>((seed >> 16) % 10);
+            types.push_back(r < 4 ? ID : (r < 8 ? WS : COMMENT));
+        }
+    }
+    return types;
+}
+
+// CommonTokenStream before it indexed on-channel tokens, as the baseline:
+// every lookahead walks over the hidden tokens in between.
+
+class WalkingTokenStream : public BufferedTokenStream
+{
+public:
+
+    explicit WalkingTokenStream(TokenSource* tokenSource)
+        :   BufferedTokenStream(tokenSource)
+    {
+    }
+
+protected:
+
+    antlr_int32_t adjustSeekIndex(antlr_int32_t i)
+    {
+        return nextTokenOnChannel(i, Token::DEFAULT_CHANNEL);
+    }
+
+    antlr_int32_t lookbackIndex(antlr_int32_t k)
+    {
+        if (k == 0 || (p - k) < 0) {
+            return -1;
+        }
+
+        antlr_int32_t i = p;
+        for (antlr_int32_t n = 1; n <= k; n++) {
+            i = previousTokenOnChannel(i - 1, Token::DEFAULT_CHANNEL);
+        }
+        return i < 0 ? -1 : i;
+    }
+
+    antlr_int32_t lookaheadIndex(antlr_int32_t k)
+    {
+        lazyInit();
+        if (k == 0) {
+            return -1;
+        }
+        if (k < 0) {
+            return lookbackIndex(-k);
+        }
+
+        antlr_int32_t i = p;
+        for (antlr_int32_t n = 1; n < k; n++) {
+            if (sync(i + 1)) {
+                i = nextTokenOnChannel(i + 1, Token::DEFAULT_CHANNEL);
+            }
+        }
+        return i;
+    }
+};
+
+/** Walks the whole stream the way prediction does: a few tokens of
+ *  lookahead and one of lookbehind before each consume.
+ */
+antlr_int32_t scan(TokenStream& tokens)
+{
+    antlr_int32_t sum = 0;
+    tokens.seek(0);
+    while (tokens.LA(1) != Token::EOF_) {
+        sum += tokens.LA(2) + tokens.LA(4) + tokens.LA(-1);
+        tokens.consume();
+    }
+    return sum;
+}
+
+}
+
+BENCHMARK(TokenStreamLookaheadWalking)
+{
+    static ReplaySource source(commentHeavyTypes());
+    static WalkingTokenStream tokens(&source);
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(scan(tokens));
+    }
+}
+
+BENCHMARK(TokenStreamLookaheadIndexed)
+{
+    static ReplaySource source(commentHeavyTypes());
+    static CommonTokenStream tokens(&source);
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(scan(tokens));
+    }
+}
+
+BENCHMARK(TokenStreamFillSingle)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        ReplaySource source(commentHeavyTypes());
+        CommonTokenStream tokens(&source);
+        tokens.fill();
+        Benchmark::consume(tokens.size());
+    }
+}
+
+BENCHMARK(TokenStreamFillBatched)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        ReplaySource source(commentHeavyTypes(), true);
+        CommonTokenStream tokens(&source);
+        tokens.fill();
+        Benchmark::consume(tokens.size());
+    }
+}
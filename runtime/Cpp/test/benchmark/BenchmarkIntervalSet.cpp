@@ -0,0 +1,228 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <Benchmark.h>
+#include <antlr/Lexer.h>
+#include <antlr/misc/Interval.h>
+#include <antlr/misc/IntervalSet.h>
+#include <vector>
+
+using namespace antlr4;
+using namespace antlr4::misc;
+
+namespace {
+
+/** Sets shaped like large Unicode character classes: a few hundred
+ *  intervals spread over the BMP.
+ */
+std::vector<IntervalSet> makeSets(antlr_int32_t count, antlr_int32_t intervals)
+{
+    std::vector<IntervalSet> sets(count);
+    antlr_uint32_t seed = 42;
+    for (antlr_int32_t k = 0; k < count; k++) {
+        antlr_int32_t c = 0;
+        for (antlr_int32_t i = 0; i < intervals; i++) {
+            seed = seed * 1103515245 + 12345;
+            c += 2 + static_cast<antlr_int32_t>((seed >> 16) % 200);
+            seed = seed * 1103515245 + 12345;
+            antlr_int32_t length = static_cast<antlr_int32_t>((seed >> 16) % 64);
+            sets[k].add(c, c + length);
+            c += length;
+        }
+    }
+    return sets;
+}
+
+const std::vector<IntervalSet>& sets()
+{
+    static const std::vector<IntervalSet> s = makeSets(16, 300);
+    return s;
+}
+
+// The algorithms IntervalSet used before its operations became linear
+// merges, as the baseline.
+
+IntervalSet legacyOr(const std::vector<IntervalSet>& sets)
+{
+    IntervalSet r;
+    for (std::vector<IntervalSet>::const_iterator it = sets.begin(); it != sets.end(); it++) {
+        const std::vector<Interval>& intervals = it->getIntervals();
+        for (size_t i = 0; i < intervals.size(); i++) {
+            r.add(intervals[i].a, intervals[i].b);
+        }
+    }
+    return r;
+}
+
+IntervalSet legacyAnd(const IntervalSet& left, const IntervalSet& right)
+{
+    const std::vector<Interval>& myIntervals = left.getIntervals();
+    const std::vector<Interval>& theirIntervals = right.getIntervals();
+    IntervalSet intersection;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < myIntervals.size() && j < theirIntervals.size()) {
+        const Interval& mine = myIntervals[i];
+        const Interval& theirs = theirIntervals[j];
+        if (mine.startsBeforeDisjoint(theirs)) {
+            i++;
+        }
+        else if (theirs.startsBeforeDisjoint(mine)) {
+            j++;
+        }
+        else if (mine.properlyContains(theirs)) {
+            Interval I = mine.intersection(theirs);
+            intersection.add(I.a, I.b);
+            j++;
+        }
+        else if (theirs.properlyContains(mine)) {
+            Interval I = mine.intersection(theirs);
+            intersection.add(I.a, I.b);
+            i++;
+        }
+        else if (!mine.disjoint(theirs)) {
+            Interval I = mine.intersection(theirs);
+            intersection.add(I.a, I.b);
+            if (mine.startsAfterNonDisjoint(theirs)) {
+                j++;
+            }
+            else if (theirs.startsAfterNonDisjoint(mine)) {
+                i++;
+            }
+        }
+    }
+    return intersection;
+}
+
+IntervalSet legacyComplement(const IntervalSet& set, const IntervalSet& vocabulary)
+{
+    const std::vector<Interval>& intervals = set.getIntervals();
+    IntervalSet comp;
+    if (intervals.empty()) {
+        return comp;
+    }
+    if (intervals[0].a > 0) {
+        IntervalSet s = legacyAnd(IntervalSet::of(0, intervals[0].a - 1), vocabulary);
+        comp.addAll(&s);
+    }
+    for (size_t i = 1; i < intervals.size(); i++) {
+        IntervalSet s = legacyAnd(IntervalSet::of(intervals[i-1].b + 1, intervals[i].a - 1), vocabulary);
+        comp.addAll(&s);
+    }
+    if (intervals.back().b < vocabulary.getMaxElement()) {
+        IntervalSet s = legacyAnd(IntervalSet::of(intervals.back().b + 1, vocabulary.getMaxElement()), vocabulary);
+        comp.addAll(&s);
+    }
+    return comp;
+}
+
+IntervalSet legacySubtract(const IntervalSet& left, const IntervalSet& right)
+{
+    return legacyAnd(left, legacyComplement(right, IntervalSet::COMPLETE_CHAR_SET));
+}
+
+}
+
+BENCHMARK(IntervalSetOrLegacy)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(legacyOr(sets()).size());
+    }
+}
+
+BENCHMARK(IntervalSetOrKWay)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(IntervalSet::or_(sets()).size());
+    }
+}
+
+BENCHMARK(IntervalSetAndLegacy)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(legacyAnd(sets()[0], sets()[1]).size());
+    }
+}
+
+BENCHMARK(IntervalSetAnd)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(sets()[0].and_(sets()[1]).size());
+    }
+}
+
+BENCHMARK(IntervalSetAndSmallLegacy)
+{
+    IntervalSet small = IntervalSet::of(0x3000, 0x3100);
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(legacyAnd(small, sets()[0]).size());
+    }
+}
+
+BENCHMARK(IntervalSetAndSmall)
+{
+    IntervalSet small = IntervalSet::of(0x3000, 0x3100);
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(small.and_(sets()[0]).size());
+    }
+}
+
+BENCHMARK(IntervalSetSubtractLegacy)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(legacySubtract(sets()[0], sets()[1]).size());
+    }
+}
+
+BENCHMARK(IntervalSetSubtract)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(sets()[0].subtract(sets()[1]).size());
+    }
+}
+
+BENCHMARK(IntervalSetComplementLegacy)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(legacyComplement(sets()[0], IntervalSet::COMPLETE_CHAR_SET).size());
+    }
+}
+
+BENCHMARK(IntervalSetComplement)
+{
+    for (antlr_uint32_t i = 0; i < iterations; i++) {
+        Benchmark::consume(sets()[0].complement(IntervalSet::COMPLETE_CHAR_SET).size());
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/misc/Arena.h>
+
+using namespace antlr4::misc;
+
+class TestArena : public BaseTest
+{
+};
+
+
+TEST_F(TestArena, testAllocate)
+{
+    Arena arena(256);
+    char* a = static_cast<char*>(arena.allocate(10));
+    char* b = static_cast<char*>(arena.allocate(10));
+    EXPECT_TRUE(a + 10 <= b);
+    EXPECT_EQ(0u, reinterpret_cast<size_t>(b) % Arena::DEFAULT_ALIGNMENT);
+    EXPECT_EQ(20u, arena.getBytesAllocated());
+}
+
+TEST_F(TestArena, testAlignment)
+{
+    Arena arena(256);
+    arena.allocate(1, 1);
+    void* p = arena.allocate(8, 8);
+    EXPECT_EQ(0u, reinterpret_cast<size_t>(p) % 8);
+    arena.allocate(3, 1);
+    p = arena.allocate(4, 32);
+    EXPECT_EQ(0u, reinterpret_cast<size_t>(p) % 32);
+}
+
+TEST_F(TestArena, testNewArray)
+{
+    Arena arena(256);
+    const antlr_int32_t** table = arena.newArray<const antlr_int32_t*>(16);
+    for (antlr_int32_t i = 0; i < 16; i++) {
+        EXPECT_TRUE(table[i] == NULL);
+    }
+}
+
+TEST_F(TestArena, testLargeAllocation)
+{
+    Arena arena(256);
+    char* large = static_cast<char*>(arena.allocate(1000));
+    large[999] = 'x';
+    EXPECT_TRUE(arena.getBytesReserved() >= 1000u);
+    // the large block doesn't take the place of the current block
+    char* a = static_cast<char*>(arena.allocate(8));
+    char* b = static_cast<char*>(arena.allocate(8));
+    EXPECT_EQ(a + Arena::DEFAULT_ALIGNMENT, b);
+}
+
+TEST_F(TestArena, testReset)
+{
+    Arena arena(256);
+    for (antlr_int32_t i = 0; i < 100; i++) {
+        arena.allocate(32);
+    }
+    arena.allocate(1000);
+    size_t reserved = arena.getBytesReserved();
+    arena.reset();
+    EXPECT_EQ(0u, arena.getBytesAllocated());
+    EXPECT_TRUE(arena.getBytesReserved() > 0u);
+    EXPECT_TRUE(arena.getBytesReserved() < reserved);
+
+    // memory is handed out again from the block that was kept
+    size_t kept = arena.getBytesReserved();
+    arena.allocate(32);
+    EXPECT_EQ(kept, arena.getBytesReserved());
+}
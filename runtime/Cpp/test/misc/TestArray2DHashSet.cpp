@@ -325,3 +325,24 @@ TEST_F(TestArray2DHashSet, testToCustomArray)
     std::sort(v.begin(), v.end());
     EXPECT_EQ("[-3, -2, -1, 0, 1, 2, 3]", Utils::stringValueOf(v));
 }
+
+TEST_F(TestArray2DHashSet, testArenaBuckets)
+{
+    Arena arena(1024);
+    {
+        Array2DHashSet<StringKey> set(NULL, 4, 1, &arena);
+        for (antlr_int32_t i = 0; i < 100; i++)
+            EXPECT_TRUE(set.add(Utils::stringValueOf(i)));
+        EXPECT_EQ(100u, set.size());
+        for (antlr_int32_t i = 0; i < 100; i++)
+            EXPECT_TRUE(set.contains(Utils::stringValueOf(i)));
+        EXPECT_FALSE(set.add("42"));
+        EXPECT_TRUE(arena.getBytesAllocated() > 0u);
+        set.clear();
+        EXPECT_TRUE(set.isEmpty());
+        set.add("five");
+        EXPECT_TRUE(set.contains("five"));
+    }
+    arena.reset();
+    EXPECT_EQ(0u, arena.getBytesAllocated());
+}
@@ -0,0 +1,113 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+
+#include <BaseTest.h>
+#include <antlr/misc/BitSet.h>
+#include <stdexcept>
+
+using namespace antlr4::misc;
+
+class TestBitSet : public BaseTest
+{
+};
+
+TEST_F(TestBitSet, testSetAndGet)
+{
+    BitSet bits;
+    EXPECT_TRUE(bits.isEmpty());
+    bits.set(1);
+    bits.set(3);
+    bits.set(70);
+    EXPECT_FALSE(bits.isEmpty());
+    EXPECT_TRUE(bits.get(1));
+    EXPECT_FALSE(bits.get(2));
+    EXPECT_TRUE(bits.get(70));
+    EXPECT_FALSE(bits.get(1000));
+    EXPECT_EQ(3, bits.cardinality());
+    EXPECT_EQ("{1, 3, 70}", bits.toString());
+    EXPECT_THROW(bits.set(-1), std::out_of_range);
+}
+
+TEST_F(TestBitSet, testClear)
+{
+    BitSet bits;
+    bits.set(2);
+    bits.set(40);
+    bits.clear(40);
+    EXPECT_EQ("{2}", bits.toString());
+    bits.clear();
+    EXPECT_TRUE(bits.isEmpty());
+}
+
+TEST_F(TestBitSet, testNextSetBit)
+{
+    BitSet bits;
+    EXPECT_EQ(-1, bits.nextSetBit(0));
+    bits.set(0);
+    bits.set(31);
+    bits.set(32);
+    bits.set(95);
+    EXPECT_EQ(0, bits.nextSetBit(0));
+    EXPECT_EQ(31, bits.nextSetBit(1));
+    EXPECT_EQ(32, bits.nextSetBit(32));
+    EXPECT_EQ(95, bits.nextSetBit(33));
+    EXPECT_EQ(-1, bits.nextSetBit(96));
+}
+
+TEST_F(TestBitSet, testOr)
+{
+    BitSet a;
+    a.set(1);
+    BitSet b;
+    b.set(2);
+    b.set(64);
+    a.or_(b);
+    EXPECT_EQ("{1, 2, 64}", a.toString());
+}
+
+TEST_F(TestBitSet, testEqualsIgnoresTrailingWords)
+{
+    BitSet a;
+    a.set(3);
+    BitSet b;
+    b.set(3);
+    b.set(100);
+    b.clear(100);
+    EXPECT_TRUE(a.equals(&b));
+    EXPECT_EQ(a.hashCode(), b.hashCode());
+    b.set(4);
+    EXPECT_FALSE(a.equals(&b));
+}
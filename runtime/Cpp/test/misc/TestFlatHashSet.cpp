@@ -0,0 +1,220 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/misc/FlatHashSet.h>
+#include <antlr/misc/Utils.h>
+#include <algorithm>
+#include "HashRangeKey.h"
+#include "IntKey.h"
+#include "StringKey.h"
+#include "ZeroKey.h"
+
+using namespace antlr4::misc;
+
+namespace {
+
+/** Compares ints by their value modulo 1000 */
+class ModuloComparator : public AbstractEqualityComparator<antlr_int32_t>
+{
+public:
+
+    ANTLR_OVERRIDE
+    antlr_int32_t hashCode(const antlr_int32_t& o) const { return o % 1000; }
+
+    ANTLR_OVERRIDE
+    bool equals(const antlr_int32_t& a, const antlr_int32_t& b) const { return a % 1000 == b % 1000; }
+};
+
+}
+
+class TestFlatHashSet : public BaseTest
+{
+};
+
+
+TEST_F(TestFlatHashSet, testSize)
+{
+    FlatHashSet<antlr_int32_t> set;
+    EXPECT_EQ(0u, set.size());
+    EXPECT_TRUE(set.isEmpty());
+    set.add(-3);
+    set.add(1);
+    set.add(2);
+    set.add(5);
+    EXPECT_EQ(4u, set.size());
+    set.remove(1);
+    set.remove(5);
+    EXPECT_EQ(2u, set.size());
+    set.clear();
+    EXPECT_TRUE(set.isEmpty());
+}
+
+TEST_F(TestFlatHashSet, testContains)
+{
+    FlatHashSet<StringKey> set;
+    StringKey v("five");
+    EXPECT_FALSE(set.contains(v));
+    set.add(v);
+    EXPECT_TRUE(set.contains("five"));
+    EXPECT_TRUE(set.containsFast(&v));
+    EXPECT_FALSE(set.containsFast(NULL));
+}
+
+TEST_F(TestFlatHashSet, testGetOrAdd)
+{
+    FlatHashSet<IntKey> set;
+    bool added = false;
+    const IntKey* v1 = set.getOrAdd(1, added);
+    EXPECT_TRUE(added);
+    EXPECT_EQ(1, v1->value);
+    EXPECT_EQ(v1, set.getOrAdd(1, added));
+    EXPECT_FALSE(added);
+    EXPECT_EQ(v1, set.get(1));
+    EXPECT_EQ(NULL, set.get(2));
+    EXPECT_EQ(1u, set.size());
+}
+
+TEST_F(TestFlatHashSet, testGrow)
+{
+    FlatHashSet<antlr_int32_t> set;
+    for (antlr_int32_t i = 0; i < 1000; i++)
+        EXPECT_TRUE(set.add(i * 7));
+    EXPECT_EQ(1000u, set.size());
+    EXPECT_TRUE(set.getCapacity() >= 1000u);
+    for (antlr_int32_t i = 0; i < 1000; i++) {
+        EXPECT_TRUE(set.contains(i * 7));
+        EXPECT_FALSE(set.contains(i * 7 + 1));
+    }
+}
+
+TEST_F(TestFlatHashSet, testCollisions)
+{
+    FlatHashSet<HashRangeKey> set;
+    for (antlr_int32_t i = 0; i < 100; i++)
+        set.add(i);
+    EXPECT_EQ(100u, set.size());
+    for (antlr_int32_t i = 0; i < 100; i++)
+        EXPECT_TRUE(set.contains(i));
+
+    FlatHashSet<ZeroKey> zeros;
+    zeros.add(0);
+    zeros.add(1);
+    EXPECT_EQ(1u, zeros.size());
+    EXPECT_TRUE(zeros.remove(100));
+    EXPECT_EQ(0u, zeros.size());
+}
+
+TEST_F(TestFlatHashSet, testRemoveAndReAdd)
+{
+    FlatHashSet<IntKey> set;
+    EXPECT_FALSE(set.remove(5));
+    // churn through many more values than the set ever holds, so
+    // tombstones have to be reclaimed without growing
+    for (antlr_int32_t i = 0; i < 10000; i++) {
+        EXPECT_TRUE(set.add(i));
+        if (i >= 8) {
+            EXPECT_TRUE(set.remove(i - 8));
+        }
+    }
+    EXPECT_EQ(8u, set.size());
+    EXPECT_EQ(FlatHashSet<IntKey>::INITIAL_CAPACITY, set.getCapacity());
+    for (antlr_int32_t i = 9992; i < 10000; i++)
+        EXPECT_TRUE(set.contains(i));
+    EXPECT_FALSE(set.contains(9991));
+}
+
+TEST_F(TestFlatHashSet, testComparator)
+{
+    ModuloComparator comparator;
+    FlatHashSet<antlr_int32_t> set(&comparator);
+    EXPECT_TRUE(set.add(5));
+    EXPECT_FALSE(set.add(1005));
+    EXPECT_TRUE(set.contains(2005));
+    EXPECT_EQ(5, *set.get(3005));
+}
+
+TEST_F(TestFlatHashSet, testHashCodeAndEquals)
+{
+    FlatHashSet<IntKey> a;
+    FlatHashSet<IntKey> b;
+    for (antlr_int32_t i = 0; i < 200; i++) {
+        a.add(i);
+        b.add(200-i-1);
+    }
+    EXPECT_EQ(a.hashCode(), b.hashCode());
+    EXPECT_TRUE(a.equals(&b));
+    a.remove(100);
+    EXPECT_NE(a.hashCode(), b.hashCode());
+    EXPECT_FALSE(a.equals(&b));
+    b.remove(100);
+    EXPECT_EQ(a.hashCode(), b.hashCode());
+    EXPECT_TRUE(a.equals(&b));
+    EXPECT_THROW(a.clone(), std::logic_error);
+}
+
+TEST_F(TestFlatHashSet, testToArray)
+{
+    FlatHashSet<antlr_int32_t> set;
+    for (antlr_int32_t i = -3; i < 4; i++)
+        set.add(i);
+    antlr_auto_ptr< std::vector<antlr_int32_t> > v = set.toArray();
+    std::sort(v->begin(), v->end());
+    EXPECT_EQ("[-3, -2, -1, 0, 1, 2, 3]", Utils::stringValueOf(*v));
+
+    std::vector<double> d;
+    set.toArray(d);
+    std::sort(d.begin(), d.end());
+    EXPECT_EQ("[-3, -2, -1, 0, 1, 2, 3]", Utils::stringValueOf(d));
+
+    EXPECT_EQ(7u, set.toPtrArray()->size());
+}
+
+TEST_F(TestFlatHashSet, testArena)
+{
+    Arena arena(1024);
+    {
+        FlatHashSet<StringKey> set(NULL, 4, &arena);
+        for (antlr_int32_t i = 0; i < 100; i++)
+            EXPECT_TRUE(set.add(Utils::stringValueOf(i)));
+        EXPECT_EQ(100u, set.size());
+        for (antlr_int32_t i = 0; i < 100; i++)
+            EXPECT_TRUE(set.contains(Utils::stringValueOf(i)));
+        EXPECT_TRUE(arena.getBytesAllocated() > 0u);
+        set.clear();
+        EXPECT_TRUE(set.isEmpty());
+    }
+    arena.reset();
+}
@@ -38,6 +38,8 @@
 #include <antlr/misc/IntervalSet.h>
 #include <antlr/misc/Utils.h>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 
 using namespace antlr4;
 using namespace antlr4::misc;
@@ -499,3 +501,127 @@ TEST_F(TestIntervalSet, testRmMiddleRange)
     std::string result = s.toString();
     EXPECT_EQ(expecting, result);
 }
+
+TEST_F(TestIntervalSet, testContainsSearch)
+{
+    IntervalSet s;
+    s.add(-3);
+    s.add(5, 9);
+    s.add(20);
+    s.add(100, 200);
+    s.add(0x3000, 0x30FF);
+    s.add(0x20000, 0x2A6DF);
+    antlr_int32_t probes[] = { -4, -3, -2, 4, 5, 9, 10, 19, 20, 21, 99, 100, 200, 201,
+                               0x2FFF, 0x3000, 0x30FF, 0x3100, 0x1FFFF, 0x20000, 0x2A6DF, 0x2A6E0 };
+    bool expected[] = { false, true, false, false, true, true, false, false, true, false, false, true, true, false,
+                        false, true, true, false, false, true, true, false };
+    for (size_t i = 0; i < sizeof(probes)/sizeof(probes[0]); i++) {
+        EXPECT_EQ(expected[i], s.contains(probes[i])) << probes[i];
+    }
+    EXPECT_FALSE(IntervalSet().contains(0));
+}
+
+TEST_F(TestIntervalSet, testReadonlyBitmaps)
+{
+    IntervalSet s;
+    s.add('_');
+    s.add('a', 'z');
+    s.add('A', 'Z');
+    s.add(0xC0, 0xD6);
+    s.add(0x4E00, 0x9FFF);
+    s.add(0x10000, 0x1000B);
+    IntervalSet copy(s);
+    s.setReadonly(true);
+    EXPECT_TRUE(s.hasBmpBitmap());
+
+    for (antlr_int32_t c = -2; c <= 0x10010; c++) {
+        EXPECT_EQ(copy.contains(c), s.contains(c)) << c;
+    }
+
+    // readonly copies share the bitmaps; making a set writable drops them
+    IntervalSet readonlyCopy(s);
+    EXPECT_TRUE(readonlyCopy.hasBmpBitmap());
+    EXPECT_TRUE(readonlyCopy.contains(0x5000));
+    readonlyCopy.setReadonly(false);
+    EXPECT_FALSE(readonlyCopy.hasBmpBitmap());
+    readonlyCopy.add('0', '9');
+    readonlyCopy.setReadonly(true);
+    EXPECT_TRUE(readonlyCopy.contains('5'));
+    EXPECT_FALSE(s.contains('5'));
+}
+
+TEST_F(TestIntervalSet, testReadonlySmallSetHasNoBmpBitmap)
+{
+    IntervalSet s = IntervalSet::of('a', 'z');
+    s.add(0x4E00, 0x9FFF);
+    s.setReadonly(true);
+    EXPECT_FALSE(s.hasBmpBitmap());
+    EXPECT_TRUE(s.contains('q'));
+    EXPECT_TRUE(s.contains(0x4E00));
+    EXPECT_FALSE(s.contains(0xA000));
+    EXPECT_THROW(s.add('0'), std::logic_error);
+}
+
+TEST_F(TestIntervalSet, testValueOperations)
+{
+    IntervalSet s = IntervalSet::of(10,20);
+    s.add(30,40);
+    s.add(50,60);
+    IntervalSet s2 = IntervalSet::of(15,35);
+    s2.add(58);
+    s2.add(61,70);
+
+    EXPECT_EQ("{10..40, 50..70}", s.or_(s2).toString());
+    EXPECT_EQ("{15..20, 30..35, 58}", s.and_(s2).toString());
+    EXPECT_EQ("{10..14, 36..40, 50..57, 59..60}", s.subtract(s2).toString());
+    EXPECT_EQ("{}", s.subtract(s).toString());
+    EXPECT_EQ(s.toString(), s.subtract(IntervalSet()).toString());
+
+    IntervalSet vocabulary = IntervalSet::of(-1,100);
+    EXPECT_EQ("{0..9, 21..29, 41..49, 61..100}", s.complement(vocabulary).toString());
+    EXPECT_EQ("{}", IntervalSet().complement(vocabulary).toString());
+}
+
+TEST_F(TestIntervalSet, testOrMany)
+{
+    std::vector<IntervalSet> sets;
+    sets.push_back(IntervalSet::of(1,3));
+    sets.push_back(IntervalSet());
+    sets.push_back(IntervalSet::of(4,4));
+    sets.push_back(IntervalSet::of(10,20));
+    sets.back().add(100);
+    sets.push_back(IntervalSet::of(2,8));
+    sets.push_back(IntervalSet::of(15,30));
+    EXPECT_EQ("{1..8, 10..30, 100}", IntervalSet::or_(sets).toString());
+    EXPECT_EQ("{}", IntervalSet::or_(std::vector<IntervalSet>()).toString());
+}
+
+TEST_F(TestIntervalSet, testOperationsAgainstMembership)
+{
+    // pseudo-random sets over a small universe, checked element by element
+    antlr_uint32_t seed = 12345;
+    for (antlr_int32_t round = 0; round < 50; round++) {
+        IntervalSet sets[2];
+        for (antlr_int32_t k = 0; k < 2; k++) {
+            for (antlr_int32_t i = 0; i < 12; i++) {
+                seed = seed * 1103515245 + 12345;
+                antlr_int32_t a = static_cast<antlr_int32_t>((seed >> 16) % 200);
+                seed = seed * 1103515245 + 12345;
+                sets[k].add(a, a + static_cast<antlr_int32_t>((seed >> 16) % 8));
+            }
+        }
+        IntervalSet unionSet = sets[0].or_(sets[1]);
+        IntervalSet intersection = sets[0].and_(sets[1]);
+        IntervalSet difference = sets[0].subtract(sets[1]);
+        antlr_auto_ptr<IntervalSet> added(new IntervalSet(sets[0]));
+        added->addAll(&sets[1]);
+        EXPECT_EQ(unionSet.toString(), added->toString());
+        for (antlr_int32_t el = -1; el <= 210; el++) {
+            bool in0 = sets[0].contains(el);
+            bool in1 = sets[1].contains(el);
+            EXPECT_EQ(in0 || in1, unionSet.contains(el));
+            EXPECT_EQ(in0 && in1, intersection.contains(el));
+            EXPECT_EQ(in0 && !in1, difference.contains(el));
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * [The "BSD license"]
+ *  Copyright (c) 2012 Terence Parr
+ *  Copyright (c) 2012 Sam Harwell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ *  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ *  OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ *  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ *  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Antlr 4 C++ Runtime
+ * Gael Hatchue
+ */
+
+#include <BaseTest.h>
+#include <antlr/misc/SmallVector.h>
+#include <antlr/misc/Utils.h>
+#include <stdexcept>
+#include <string>
+
+using namespace antlr4::misc;
+
+class TestSmallVector : public BaseTest
+{
+};
+
+
+TEST_F(TestSmallVector, testInline)
+{
+    SmallVector<antlr_int32_t, 4> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_TRUE(v.isInline());
+    for (antlr_int32_t i = 0; i < 4; i++)
+        v.push_back(i);
+    EXPECT_TRUE(v.isInline());
+    EXPECT_EQ(4u, v.size());
+    EXPECT_EQ("[0, 1, 2, 3]", Utils::stringValueOfList(v));
+}
+
+TEST_F(TestSmallVector, testGrow)
+{
+    SmallVector<std::string, 2> v;
+    for (antlr_int32_t i = 0; i < 10; i++)
+        v.push_back(Utils::stringValueOf(i));
+    EXPECT_FALSE(v.isInline());
+    EXPECT_EQ(10u, v.size());
+    EXPECT_TRUE(v.capacity() >= 10u);
+    EXPECT_EQ("9", v.back());
+    EXPECT_EQ("[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]", Utils::stringValueOfList(v));
+}
+
+TEST_F(TestSmallVector, testPushOwnElement)
+{
+    SmallVector<std::string, 2> v;
+    v.push_back("a");
+    v.push_back("b");
+    v.push_back(v[0]); // grows while reading from the old storage
+    EXPECT_EQ("[a, b, a]", Utils::stringValueOfList(v));
+}
+
+TEST_F(TestSmallVector, testPopAndClear)
+{
+    SmallVector<std::string, 2> v;
+    v.push_back("a");
+    v.push_back("b");
+    v.push_back("c");
+    v.pop_back();
+    EXPECT_EQ(2u, v.size());
+    EXPECT_EQ("b", v.back());
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    v.push_back("d");
+    EXPECT_EQ("[d]", Utils::stringValueOfList(v));
+}
+
+TEST_F(TestSmallVector, testCopyAndEquals)
+{
+    SmallVector<antlr_int32_t, 2> a;
+    for (antlr_int32_t i = 0; i < 5; i++)
+        a.push_back(i);
+    SmallVector<antlr_int32_t, 2> b(a);
+    EXPECT_TRUE(a == b);
+    b.pop_back();
+    EXPECT_TRUE(a != b);
+    SmallVector<antlr_int32_t, 2> c;
+    c.push_back(7);
+    c = a;
+    EXPECT_TRUE(a == c);
+}
+
+TEST_F(TestSmallVector, testAt)
+{
+    SmallVector<antlr_int32_t, 2> v;
+    v.push_back(3);
+    EXPECT_EQ(3, v.at(0));
+    EXPECT_THROW(v.at(1), std::out_of_range);
+}